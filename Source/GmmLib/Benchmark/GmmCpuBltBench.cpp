@@ -0,0 +1,499 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+//  GMMBENCH -- CpuSwizzleBlt throughput benchmark.
+//
+//  Sweeps tile type (X, Y, W, Yf, Ys, 3D Yf/Ys), bpp, surface size, alignment
+//  of the linear buffer, direction and sub-element mode, timing each transfer
+//  through the same kernel selection GmmResCpuBlt uses, and reports GB/s,
+//  TSC ticks per byte, and the ratio to a plain memcpy of the same payload.
+//
+//  Usage: GMMBENCH [--json <file>|-] [--filter <substring>] [--min-time <sec>]
+//                  [--quick] [--generic]
+//
+//      --json      Also write results as JSON (to stdout if "-"), for tracking
+//                  kernel and compiler flag (GMMLIB_MARCH) regressions.
+//      --filter    Run only cases whose name contains substring.
+//      --min-time  Minimum measuring time per case (default 0.2s).
+//      --quick     Smallest surface size only.
+//      --generic   Force generic CpuSwizzleBlt (no specialized kernels).
+
+#ifndef _WIN32
+#include "../../inc/portable_windef.h"
+#include "../../inc/portable_compiler.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "sharedata.h"
+#include "../../inc/common/igfxfmid.h"
+#include "../../inc/common/sku_wa.h"
+#include "../../inc/common/gfxmacro.h"
+#include "../inc/External/Common/GmmDebug.h"
+#include "../inc/External/Common/GmmCommonExt.h"
+}
+
+using namespace std;
+
+#ifdef _DEBUG
+GFX_DEBUG_CONTROL *pDebugControl = NULL; // (Debug builds of GmmLib assert through it.)
+#endif
+
+#ifndef GMMBENCH_MARCH
+#define GMMBENCH_MARCH ""
+#endif
+
+#define GMMBENCH_REPS   5   // Timed repetitions per case (best one reported).
+
+//===========================================================================
+// typedef:
+//        BENCH_TILE
+//
+// Description:
+//     Tile type/bpp swept by the benchmark.
+//---------------------------------------------------------------------------
+typedef struct BENCH_TILE_REC
+{
+    const char                  *pName;
+    const SWIZZLE_DESCRIPTOR    *pSwizzle;
+    int                         Bpp;        // 0 = Byte swizzle (X/Y/W).
+    bool                        Volume;     // 3D tile, transferred via CpuSwizzleBltVolume.
+} BENCH_TILE;
+
+//===========================================================================
+// typedef:
+//        BENCH_CASE
+//
+// Description:
+//     One measured configuration and its results.
+//---------------------------------------------------------------------------
+typedef struct BENCH_CASE_REC
+{
+    string              Name;
+    const BENCH_TILE    *pTile;
+    const char          *pSize;
+    int                 WidthBytes, Height, Depth;  // Swizzled surface dimensions.
+    int                 LinearAlign;                // Alignment of linear buffer base, in bytes.
+    bool                Upload;
+    bool                SubElement;                 // Transfer one byte of each 4-byte pixel (stencil of D24S8).
+    const char          *pKernel;
+    uint64_t            Bytes;                      // Payload bytes per transfer.
+    double              Seconds, Ticks;             // Per transfer.
+    double              MemcpySeconds;
+} BENCH_CASE;
+
+typedef struct BENCH_TIMING_REC
+{
+    double  Seconds;
+    double  Ticks;
+} BENCH_TIMING;
+
+static const BENCH_TILE Tiles[] =
+{
+    { "X",          &INTEL_TILE_X,          0,      false },
+    { "Y",          &INTEL_TILE_Y,          0,      false },
+    { "W",          &INTEL_TILE_W,          0,      false },
+    { "Yf",         &ST_2D_4KB_8bpp,        8,      false },
+    { "Yf",         &ST_2D_4KB_16bpp,       16,     false },
+    { "Yf",         &ST_2D_4KB_32bpp,       32,     false },
+    { "Yf",         &ST_2D_4KB_64bpp,       64,     false },
+    { "Yf",         &ST_2D_4KB_128bpp,      128,    false },
+    { "Ys",         &ST_2D_64KB_8bpp,       8,      false },
+    { "Ys",         &ST_2D_64KB_16bpp,      16,     false },
+    { "Ys",         &ST_2D_64KB_32bpp,      32,     false },
+    { "Ys",         &ST_2D_64KB_64bpp,      64,     false },
+    { "Ys",         &ST_2D_64KB_128bpp,     128,    false },
+    { "Yf3D",       &ST_3D_4KB_8bpp,        8,      true },
+    { "Yf3D",       &ST_3D_4KB_32bpp,       32,     true },
+    { "Yf3D",       &ST_3D_4KB_128bpp,      128,    true },
+    { "Ys3D",       &ST_3D_64KB_8bpp,       8,      true },
+    { "Ys3D",       &ST_3D_64KB_32bpp,      32,     true },
+    { "Ys3D",       &ST_3D_64KB_128bpp,     128,    true },
+};
+
+static const struct
+{
+    const char  *pName;
+    int         WidthBytes, Rows;   // Multiples of every tile's width/height.
+} Sizes[] =
+{
+    { "256KB",  1024,   256 },  // Cache-resident.
+    { "4MB",    4096,   1024 },
+    { "32MB",   16384,  2048 }, // Memory-bound.
+};
+
+static const int LinearAligns[] = { 64, 16, 1 };
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns pointer into Buffer aligned to Alignment (power of two), plus Skew
+/// bytes. Buffer is resized to hold Size bytes past the returned pointer.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint8_t *AlignedBuffer(vector<uint8_t> &Buffer, size_t Size, size_t Alignment, size_t Skew = 0)
+{
+    Buffer.resize(Size + Alignment + Skew);
+    return reinterpret_cast<uint8_t *>(
+        (reinterpret_cast<uintptr_t>(Buffer.data()) + Alignment - 1) & ~(uintptr_t)(Alignment - 1)) + Skew;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns tile width (in bytes), height (in rows), and depth (in slices) of given
+/// swizzle descriptor.
+/////////////////////////////////////////////////////////////////////////////////////
+static void GetSwizzleTileDimensions(const SWIZZLE_DESCRIPTOR *pSwizzle, int &TileWidth, int &TileHeight, int &TileDepth)
+{
+    TileWidth = TileHeight = TileDepth = 1;
+    for(int Bit = 0; Bit < 16; Bit++)
+    {
+        TileWidth  <<= (pSwizzle->Mask.x >> Bit) & 1;
+        TileHeight <<= (pSwizzle->Mask.y >> Bit) & 1;
+        TileDepth  <<= (pSwizzle->Mask.z >> Bit) & 1;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Times Op: after a warm-up call, calibrates an iteration count filling about
+/// MinSeconds / GMMBENCH_REPS, then returns the best per-call time of
+/// GMMBENCH_REPS repetitions (best, since noise only ever adds time).
+/////////////////////////////////////////////////////////////////////////////////////
+template<typename OP>
+static BENCH_TIMING Measure(OP Op, double MinSeconds)
+{
+    typedef chrono::steady_clock CLOCK;
+    BENCH_TIMING Best = { 0, 0 };
+    uint64_t Iterations = 1;
+
+    Op(); // Warm-up (page faults, offset table caching, etc.).
+
+    for(;;) // Calibrate...
+    {
+        CLOCK::time_point Start = CLOCK::now();
+        for(uint64_t i = 0; i < Iterations; i++) Op();
+        double Seconds = chrono::duration<double>(CLOCK::now() - Start).count();
+
+        if(Seconds >= MinSeconds / GMMBENCH_REPS) break;
+        Iterations = (Seconds > 0) ? 
+            (uint64_t) (Iterations * 1.2 * (MinSeconds / GMMBENCH_REPS) / Seconds) + 1 : 
+            Iterations * 10;
+    }
+
+    for(int Rep = 0; Rep < GMMBENCH_REPS; Rep++)
+    {
+        CLOCK::time_point Start = CLOCK::now();
+        uint64_t StartTicks = __rdtsc();
+        for(uint64_t i = 0; i < Iterations; i++) Op();
+        uint64_t Ticks = __rdtsc() - StartTicks;
+        double Seconds = chrono::duration<double>(CLOCK::now() - Start).count() / Iterations;
+
+        if(!Rep || (Seconds < Best.Seconds))
+        {
+            Best.Seconds = Seconds;
+            Best.Ticks = (double) Ticks / Iterations;
+        }
+    }
+
+    return Best;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Measures one case (filling in its kernel, payload size and timings).
+///
+/// @param[in,out]  Case: Configuration to measure.
+/// @param[in]      MinSeconds: Minimum measuring time.
+/// @param[in]      Generic: Force generic CpuSwizzleBlt.
+/////////////////////////////////////////////////////////////////////////////////////
+static void RunCase(BENCH_CASE &Case, double MinSeconds, bool Generic)
+{
+    const BENCH_TILE *pTile = Case.pTile;
+    const bool TileW = (pTile->pSwizzle == &INTEL_TILE_W);
+    int SwizzledElementPitch = 1, LinearElementPitch = 1, ElementSize = 1, Pixels;
+    int LinearPitch, LinearSlicePitch, CopyWidthBytes;
+    vector<uint8_t> SwizzledBuffer, LinearBuffer;
+
+    if(!Case.SubElement)
+    {
+        Pixels = Case.WidthBytes;
+    }
+    else if(TileW) // TileW stencil <--> S8 of linear D24S8.
+    {
+        LinearElementPitch = 4;
+        Pixels = Case.WidthBytes;
+    }
+    else // S8 of swizzled D24S8 <--> packed linear S8.
+    {
+        SwizzledElementPitch = 4;
+        Pixels = Case.WidthBytes / 4;
+    }
+
+    CopyWidthBytes = Pixels * LinearElementPitch;
+    LinearPitch = CopyWidthBytes;
+    LinearSlicePitch = LinearPitch * Case.Height;
+    Case.Bytes = (uint64_t) Pixels * ElementSize * Case.Height * Case.Depth;
+
+    uint8_t *pSwizzled = AlignedBuffer(SwizzledBuffer, (size_t) Case.WidthBytes * Case.Height * Case.Depth, 64 * 1024); // Ys tile alignment.
+    uint8_t *pLinear = AlignedBuffer(LinearBuffer, (size_t) LinearSlicePitch * Case.Depth, 64, Case.LinearAlign % 64);
+
+    for(size_t i = 0; i < (size_t) LinearSlicePitch * Case.Depth; i++)
+    {
+        pLinear[i] = (uint8_t) (i * 7 + i / 251);
+    }
+    memset(pSwizzled, 0, (size_t) Case.WidthBytes * Case.Height * Case.Depth);
+
+    CPU_SWIZZLE_BLT_SURFACE Swizzled = {}, Linear = {};
+
+    Swizzled.pBase = pSwizzled;
+    Swizzled.pSwizzle = pTile->pSwizzle;
+    Swizzled.Pitch = Case.WidthBytes;
+    Swizzled.Height = Case.Height;
+    Swizzled.Element.Pitch = SwizzledElementPitch;
+    Swizzled.Element.Size = ElementSize;
+    Swizzled.OffsetX = (SwizzledElementPitch > ElementSize) ? 3 : 0;
+
+    Linear.pBase = pLinear;
+    Linear.Pitch = LinearPitch;
+    Linear.Height = Case.Height;
+    Linear.Element.Pitch = LinearElementPitch;
+    Linear.Element.Size = ElementSize;
+    Linear.OffsetX = (LinearElementPitch > ElementSize) ? 3 : 0;
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest = Case.Upload ? &Swizzled : &Linear;
+    CPU_SWIZZLE_BLT_SURFACE *pSrc = Case.Upload ? &Linear : &Swizzled;
+    BENCH_TIMING Timing;
+
+    if(pTile->Volume)
+    {
+        Case.pKernel = "volume";
+        Timing = Measure([&]() { CpuSwizzleBltVolume(pDest, pSrc, CopyWidthBytes, Case.Height, Case.Depth, LinearSlicePitch); }, MinSeconds);
+    }
+    else
+    {
+        PFN_CPU_SWIZZLE_BLT pfnBlt = Generic ? CpuSwizzleBlt : CpuSwizzleBltSelectKernel(pDest, pSrc);
+
+        Case.pKernel = (pfnBlt == (PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt) ? "generic" : "specialized";
+        Timing = Measure([&]() { pfnBlt(pDest, pSrc, CopyWidthBytes, Case.Height); }, MinSeconds);
+    }
+
+    Case.Seconds = Timing.Seconds;
+    Case.Ticks = Timing.Ticks;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns per-call time of memcpy of Bytes from a source aligned as given, to a
+/// 64-byte-aligned destination--the baseline each BLT is compared against.
+/////////////////////////////////////////////////////////////////////////////////////
+static double MeasureMemcpy(uint64_t Bytes, int SrcAlign, double MinSeconds)
+{
+    static map<pair<uint64_t, int>, double> Cache;
+    pair<uint64_t, int> Key(Bytes, SrcAlign % 64);
+    map<pair<uint64_t, int>, double>::iterator Found = Cache.find(Key);
+
+    if(Found == Cache.end())
+    {
+        vector<uint8_t> SrcBuffer, DestBuffer;
+        uint8_t *pSrc = AlignedBuffer(SrcBuffer, (size_t) Bytes, 64, SrcAlign % 64);
+        uint8_t *pDest = AlignedBuffer(DestBuffer, (size_t) Bytes, 64);
+
+        memset(pSrc, 0x5a, (size_t) Bytes);
+        Found = Cache.insert(make_pair(Key, Measure([&]() { memcpy(pDest, pSrc, (size_t) Bytes); }, MinSeconds).Seconds)).first;
+    }
+
+    return Found->second;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Writes results as JSON.
+/////////////////////////////////////////////////////////////////////////////////////
+static void WriteJson(FILE *pFile, const vector<BENCH_CASE> &Cases, double MinSeconds, bool Generic)
+{
+    fprintf(pFile, "{\n");
+    fprintf(pFile, "  \"benchmark\": \"GMMBENCH\",\n");
+    fprintf(pFile, "  \"march\": \"%s\",\n", GMMBENCH_MARCH);
+    #ifdef __VERSION__
+        fprintf(pFile, "  \"compiler\": \"%s\",\n", __VERSION__);
+    #endif
+    fprintf(pFile, "  \"min_time\": %g,\n", MinSeconds);
+    fprintf(pFile, "  \"generic\": %s,\n", Generic ? "true" : "false");
+    fprintf(pFile, "  \"results\": [\n");
+
+    for(size_t i = 0; i < Cases.size(); i++)
+    {
+        const BENCH_CASE &Case = Cases[i];
+        double GBps = Case.Bytes / Case.Seconds / 1e9;
+        double MemcpyGBps = Case.Bytes / Case.MemcpySeconds / 1e9;
+
+        fprintf(pFile,
+            "    { \"name\": \"%s\", \"tile\": \"%s\", \"bpp\": %d, \"size\": \"%s\", "
+            "\"width_bytes\": %d, \"height\": %d, \"depth\": %d, \"linear_align\": %d, "
+            "\"direction\": \"%s\", \"sub_element\": %s, \"kernel\": \"%s\", \"bytes\": %llu, "
+            "\"seconds\": %.9g, \"gbps\": %.4f, \"cycles_per_byte\": %.4f, "
+            "\"memcpy_gbps\": %.4f, \"vs_memcpy\": %.4f }%s\n",
+            Case.Name.c_str(), Case.pTile->pName, Case.pTile->Bpp, Case.pSize,
+            Case.WidthBytes, Case.Height, Case.Depth, Case.LinearAlign,
+            Case.Upload ? "upload" : "download", Case.SubElement ? "true" : "false", Case.pKernel, (unsigned long long) Case.Bytes,
+            Case.Seconds, GBps, Case.Ticks / Case.Bytes,
+            MemcpyGBps, GBps / MemcpyGBps,
+            (i + 1 < Cases.size()) ? "," : "");
+    }
+
+    fprintf(pFile, "  ]\n}\n");
+}
+
+static void Usage()
+{
+    fprintf(stderr, 
+        "Usage: GMMBENCH [--json <file>|-] [--filter <substring>] [--min-time <sec>] [--quick] [--generic]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pJsonFile = NULL, *pFilter = NULL;
+    double MinSeconds = 0.2;
+    bool Quick = false, Generic = false;
+    vector<BENCH_CASE> Cases;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--json") && (i + 1 < argc))
+        {
+            pJsonFile = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--filter") && (i + 1 < argc))
+        {
+            pFilter = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--min-time") && (i + 1 < argc))
+        {
+            MinSeconds = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--quick"))
+        {
+            Quick = true;
+        }
+        else if(!strcmp(argv[i], "--generic"))
+        {
+            Generic = true;
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    for(size_t t = 0; t < sizeof(Tiles) / sizeof(Tiles[0]); t++)
+    {
+        const BENCH_TILE *pTile = &Tiles[t];
+        int TileWidth, TileHeight, TileDepth;
+        bool SubElementCapable = // Stencil of D24S8 (or TileW stencil)...
+            !pTile->Volume && 
+            ((pTile->pSwizzle == &INTEL_TILE_Y) || (pTile->pSwizzle == &INTEL_TILE_W) || (pTile->Bpp == 32));
+
+        GetSwizzleTileDimensions(pTile->pSwizzle, TileWidth, TileHeight, TileDepth);
+
+        for(size_t s = 0; s < (Quick ? 1 : sizeof(Sizes) / sizeof(Sizes[0])); s++)
+        {
+            for(size_t a = 0; a < sizeof(LinearAligns) / sizeof(LinearAligns[0]); a++)
+            {
+                for(int Upload = 1; Upload >= 0; Upload--)
+                {
+                    for(int SubElement = 0; SubElement <= (SubElementCapable ? 1 : 0); SubElement++)
+                    {
+                        BENCH_CASE Case = {};
+                        char Tile[32], Name[128];
+
+                        Case.pTile = pTile;
+                        Case.pSize = Sizes[s].pName;
+                        Case.WidthBytes = Sizes[s].WidthBytes;
+                        Case.Depth = pTile->Volume ? TileDepth : 1;
+                        Case.Height = GFX_MAX(Sizes[s].Rows / Case.Depth / TileHeight, 1) * TileHeight; // Same footprint, whole tiles.
+                        Case.LinearAlign = LinearAligns[a];
+                        Case.Upload = !!Upload;
+                        Case.SubElement = !!SubElement;
+
+                        if(pTile->Bpp)
+                        {
+                            snprintf(Tile, sizeof(Tile), "%s_%dbpp", pTile->pName, pTile->Bpp);
+                        }
+                        else
+                        {
+                            snprintf(Tile, sizeof(Tile), "%s", pTile->pName);
+                        }
+                        snprintf(Name, sizeof(Name), "%s/%s/align%d/%s%s",
+                            Tile, Case.pSize, Case.LinearAlign, Upload ? "upload" : "download", SubElement ? "/sub" : "");
+                        Case.Name = Name;
+
+                        if(!pFilter || strstr(Case.Name.c_str(), pFilter))
+                        {
+                            Cases.push_back(Case);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    FILE *pTable = (pJsonFile && !strcmp(pJsonFile, "-")) ? stderr : stdout; // Keep stdout pure JSON if that's where it goes.
+
+    fprintf(pTable, "%-36s %-12s %10s %10s %12s %10s\n", "Case", "Kernel", "GB/s", "Ticks/B", "memcpy GB/s", "vs memcpy");
+    for(size_t i = 0; i < Cases.size(); i++)
+    {
+        BENCH_CASE &Case = Cases[i];
+
+        RunCase(Case, MinSeconds, Generic);
+        Case.MemcpySeconds = MeasureMemcpy(Case.Bytes, Case.LinearAlign, MinSeconds);
+
+        fprintf(pTable, "%-36s %-12s %10.2f %10.3f %12.2f %9.0f%%\n",
+            Case.Name.c_str(), Case.pKernel,
+            Case.Bytes / Case.Seconds / 1e9, Case.Ticks / Case.Bytes,
+            Case.Bytes / Case.MemcpySeconds / 1e9, 100 * Case.MemcpySeconds / Case.Seconds);
+        fflush(pTable);
+    }
+
+    if(pJsonFile)
+    {
+        FILE *pFile = strcmp(pJsonFile, "-") ? fopen(pJsonFile, "w") : stdout;
+
+        if(!pFile)
+        {
+            fprintf(stderr, "GMMBENCH: Can't open %s\n", pJsonFile);
+            return 1;
+        }
+
+        WriteJson(pFile, Cases, MinSeconds, Generic);
+        if(pFile != stdout) fclose(pFile);
+    }
+
+    return 0;
+}
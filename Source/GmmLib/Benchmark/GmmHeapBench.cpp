@@ -0,0 +1,291 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+//  GMMHEAPBENCH -- GmmHeap VA sub-allocation scaling benchmark.
+//
+//  Threads each churn their own working set of small allocations (freeing
+//  the oldest, allocating a new one of random 4KB..64KB size) on one shared
+//  heap--best-fit with and without per-thread magazines, and buddy without--
+//  and reports aggregate alloc+free pairs per second and the speedup over
+//  one thread.
+//
+//  Usage: GMMHEAPBENCH [--json <file>|-] [--min-time <sec>] [--threads <max>]
+//
+//      --json      Also write results as JSON (to stdout if "-").
+//      --min-time  Measuring time per case (default 0.5s).
+//      --threads   Maximum thread count (default: hardware threads).
+
+#ifndef _WIN32
+#include "../../inc/portable_windef.h"
+#include "../../inc/portable_compiler.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "sharedata.h"
+#include "../../inc/common/igfxfmid.h"
+#include "../../inc/common/sku_wa.h"
+#include "../../inc/common/gfxmacro.h"
+#include "../inc/External/Common/GmmDebug.h"
+#include "../inc/External/Common/GmmCommonExt.h"
+#include "../inc/External/Common/GmmUtil.h"
+}
+#ifndef _WIN32
+#include "../inc/External/Linux/GmmHeapLin.h"
+#endif
+
+using namespace std;
+
+#ifdef _DEBUG
+// Debug builds of GmmLib assert and print through these...
+GFX_DEBUG_CONTROL *pDebugControl = NULL;
+
+void GMMPrintMessage(ULONG DebugLevel, const char *DebugMessageFmt, ...)
+{
+
+}
+#endif
+
+#define GMMHEAPBENCH_BASE           0x100000000ull
+#define GMMHEAPBENCH_SIZE           GMM_MBYTE(1024)
+#define GMMHEAPBENCH_WORKING_SET    64  // Live allocations per thread.
+
+//===========================================================================
+// typedef:
+//        HEAP_BENCH_CASE
+//
+// Description:
+//     One measured configuration and its results.
+//---------------------------------------------------------------------------
+typedef struct HEAP_BENCH_CASE_REC
+{
+    string      Name;
+    int         Threads;
+    uint32_t    HeapType;           // GMM_FLAT_HEAP or GMM_BUDDY_HEAP.
+    bool        ThreadCache;
+    double      PairsPerSecond;     // Aggregate alloc+free pairs.
+    double      Speedup;            // Over same configuration with one thread.
+} HEAP_BENCH_CASE;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Measures one case, filling in its PairsPerSecond.
+///
+/// @param[in,out]  Case: Configuration to measure.
+/// @param[in]      Seconds: Measuring time.
+/////////////////////////////////////////////////////////////////////////////////////
+static void RunCase(HEAP_BENCH_CASE &Case, double Seconds)
+{
+    GMM_HEAP            *pHeapObj;
+    atomic<int>         Ready(0);
+    atomic<bool>        Start(false), Stop(false);
+    atomic<uint64_t>    Pairs(0);
+    vector<thread>      Threads;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, GMMHEAPBENCH_BASE, GMMHEAPBENCH_SIZE,
+        Case.HeapType | (Case.ThreadCache ? 0 : GMM_HEAP_NO_THREAD_CACHE), NULL);
+    if(!pHeapObj)
+    {
+        fprintf(stderr, "GMMHEAPBENCH: Heap setup failed\n");
+        exit(1);
+    }
+
+    for(int t = 0; t < Case.Threads; t++)
+    {
+        Threads.push_back(thread([&, t]() {
+            GMM_GFX_ADDRESS Block[GMMHEAPBENCH_WORKING_SET];
+            GMM_GFX_SIZE_T  Size[GMMHEAPBENCH_WORKING_SET];
+            minstd_rand     Rng(t + 1);
+            uint64_t        Count = 0;
+
+            for(int i = 0; i < GMMHEAPBENCH_WORKING_SET; i++)
+            {
+                Size[i] = (1 + Rng() % 16) * GMM_KBYTE(4);
+                Block[i] = GmmAllocateHeapVA(pHeapObj, Size[i]);
+            }
+
+            Ready++;
+            while(!Start) this_thread::yield();
+
+            for(int i = 0; !Stop; i = (i + 1) % GMMHEAPBENCH_WORKING_SET, Count++)
+            {
+                GmmFreeHeapVA(pHeapObj, Block[i], Size[i]);
+                Size[i] = (1 + Rng() % 16) * GMM_KBYTE(4);
+                Block[i] = GmmAllocateHeapVA(pHeapObj, Size[i]);
+            }
+
+            Pairs += Count;
+
+            for(int i = 0; i < GMMHEAPBENCH_WORKING_SET; i++)
+            {
+                GmmFreeHeapVA(pHeapObj, Block[i], Size[i]);
+            }
+        }));
+    }
+
+    while(Ready < Case.Threads) this_thread::yield();
+
+    chrono::steady_clock::time_point Begin = chrono::steady_clock::now();
+    Start = true;
+    this_thread::sleep_for(chrono::duration<double>(Seconds));
+    Stop = true;
+    double Elapsed = chrono::duration<double>(chrono::steady_clock::now() - Begin).count();
+
+    for(size_t t = 0; t < Threads.size(); t++)
+    {
+        Threads[t].join();
+    }
+
+    Case.PairsPerSecond = Pairs / Elapsed;
+
+    GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Writes results as JSON.
+/////////////////////////////////////////////////////////////////////////////////////
+static void WriteJson(FILE *pFile, const vector<HEAP_BENCH_CASE> &Cases, double Seconds)
+{
+    fprintf(pFile, "{\n");
+    fprintf(pFile, "  \"benchmark\": \"GMMHEAPBENCH\",\n");
+    fprintf(pFile, "  \"min_time\": %g,\n", Seconds);
+    fprintf(pFile, "  \"results\": [\n");
+
+    for(size_t i = 0; i < Cases.size(); i++)
+    {
+        const HEAP_BENCH_CASE &Case = Cases[i];
+
+        fprintf(pFile,
+            "    { \"name\": \"%s\", \"threads\": %d, \"heap\": \"%s\", \"thread_cache\": %s, "
+            "\"pairs_per_second\": %.0f, \"speedup\": %.3f }%s\n",
+            Case.Name.c_str(), Case.Threads, (Case.HeapType == GMM_BUDDY_HEAP) ? "buddy" : "flat",
+            Case.ThreadCache ? "true" : "false",
+            Case.PairsPerSecond, Case.Speedup,
+            (i + 1 < Cases.size()) ? "," : "");
+    }
+
+    fprintf(pFile, "  ]\n}\n");
+}
+
+static void Usage()
+{
+    fprintf(stderr,
+        "Usage: GMMHEAPBENCH [--json <file>|-] [--min-time <sec>] [--threads <max>]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pJsonFile = NULL;
+    double Seconds = 0.5;
+    int MaxThreads = GFX_MAX((int) thread::hardware_concurrency(), 1);
+    vector<HEAP_BENCH_CASE> Cases;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--json") && (i + 1 < argc))
+        {
+            pJsonFile = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--min-time") && (i + 1 < argc))
+        {
+            Seconds = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--threads") && (i + 1 < argc))
+        {
+            MaxThreads = atoi(argv[++i]);
+            MaxThreads = GFX_MAX(MaxThreads, 1);
+        }
+        else
+        {
+            Usage();
+            return 1;
+        }
+    }
+
+    const struct
+    {
+        const char  *pName;
+        uint32_t    HeapType;
+        bool        ThreadCache;
+    } Configs[] = {
+        { "magazine",   GMM_FLAT_HEAP,  true  },
+        { "locked",     GMM_FLAT_HEAP,  false },
+        { "buddy",      GMM_BUDDY_HEAP, false },
+    };
+
+    for(size_t c = 0; c < sizeof(Configs) / sizeof(Configs[0]); c++)
+    {
+        for(int Threads = 1;; Threads = GFX_MIN(Threads * 2, MaxThreads))
+        {
+            HEAP_BENCH_CASE Case = {};
+            char Name[64];
+
+            snprintf(Name, sizeof(Name), "%s/threads%d", Configs[c].pName, Threads);
+            Case.Name = Name;
+            Case.Threads = Threads;
+            Case.HeapType = Configs[c].HeapType;
+            Case.ThreadCache = Configs[c].ThreadCache;
+            Cases.push_back(Case);
+
+            if(Threads == MaxThreads) break;
+        }
+    }
+
+    FILE *pTable = (pJsonFile && !strcmp(pJsonFile, "-")) ? stderr : stdout; // Keep stdout pure JSON if that's where it goes.
+
+    fprintf(pTable, "%-24s %14s %10s\n", "Case", "Mpairs/s", "Speedup");
+    for(size_t i = 0, Base = 0; i < Cases.size(); i++)
+    {
+        HEAP_BENCH_CASE &Case = Cases[i];
+
+        RunCase(Case, Seconds);
+        if(Case.Threads == 1) Base = i;
+        Case.Speedup = Case.PairsPerSecond / Cases[Base].PairsPerSecond;
+
+        fprintf(pTable, "%-24s %14.2f %9.2fx\n", Case.Name.c_str(), Case.PairsPerSecond / 1e6, Case.Speedup);
+        fflush(pTable);
+    }
+
+    if(pJsonFile)
+    {
+        FILE *pFile = strcmp(pJsonFile, "-") ? fopen(pJsonFile, "w") : stdout;
+
+        if(!pFile)
+        {
+            fprintf(stderr, "GMMHEAPBENCH: Can't open %s\n", pJsonFile);
+            return 1;
+        }
+
+        WriteJson(pFile, Cases, Seconds);
+        if(pFile != stdout) fclose(pFile);
+    }
+
+    return 0;
+}
@@ -32,6 +32,17 @@ OTHER DEALINGS IN THE SOFTWARE.
 //----------------------------------------------------------------------------
 GMM_GLOBAL_CONTEXT* pGmmGlobalContext = NULL;
 
+//===========================================================================
+// Global Variable:
+//      GmmCacheSizes
+//
+// Description:
+//     CPU cache sizes captured by Context::InitContext (see 
+//     Context::GetCacheSizes). Kept out of Context, so its layout is unchanged.
+//
+//----------------------------------------------------------------------------
+static GMM_CACHE_SIZES GmmCacheSizes;
+
 #if defined( __ghs__)
 std::atomic<int> GmmLib::Context::RefCount = 0; 
 #else
@@ -194,6 +205,8 @@ GMM_STATUS GMM_STDCALL GmmLib::Context::InitContext(
     this->WaTable = *pWaTable;
     this->GtSysInfo = *pGtSysInfo;
 
+    GmmGetCacheSizes(&GmmCacheSizes);
+
     pGmmGlobalContext->pPlatformInfo = GmmLib::PlatformInfo::Create(Platform, FALSE);
 
     this->pGmmCachePolicy = GmmLib::GmmCachePolicyCommon::Create();
@@ -220,6 +233,15 @@ GMM_STATUS GMM_STDCALL GmmLib::Context::InitContext(
     return GMM_SUCCESS;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the cache sizes (see GmmGetCacheSizes) captured by InitContext.
+/// @return   Ref to cache sizes (zeroed if InitContext hasn't run)
+/////////////////////////////////////////////////////////////////////////////////////
+const GMM_CACHE_SIZES& GMM_STDCALL GmmLib::Context::GetCacheSizes()
+{
+    return GmmCacheSizes;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// Member function to deallcoate the GmmLib::Context's cache policy, platform info, 
 /// Texture calculator etc.
@@ -246,6 +268,10 @@ void GMM_STDCALL GmmLib::Context::DestroyContext()
         }
     }
 
+#if(!defined(__GMM_KMD__))
+    DestroyWorkerPool();
+#endif
+
 #if(defined(__GMM_KMD__) && (_DEBUG || _RELEASE_INTERNAL))
     if (this->Override.pTextureCalc)
     {
@@ -1222,6 +1222,199 @@ BOOLEAN GMM_STDCALL GmmResCpuBlt(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_B
     return pGmmResource->CpuBlt(pBlt);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltParallel
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltParallel()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  pWorkers: Describes workers to use. See ::GMM_RES_CPU_BLT_WORKERS. 
+///                       NULL to use GmmLib's internal worker pool.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltParallel(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuBltParallel(pBlt, pWorkers);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltBatch
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltBatch()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pBlts: Array of blit operations. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  NumBlts: Number of elements in pBlts.
+/// @return     TRUE if all succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltBatch(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuBltBatch(pBlts, NumBlts);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltStream
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltStream()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pStream: Describes the streaming blit. See ::GMM_RES_COPY_BLT_STREAM for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltStream(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT_STREAM *pStream)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuBltStream(pStream);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltFromFile
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltFromFile()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pFileBlt: Describes the file and its layout. See ::GMM_RES_FILE_BLT for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltFromFile(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_FILE_BLT *pFileBlt)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuBltFromFile(pFileBlt);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltAllSubresources
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltAllSubresources()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pSubresourcesBlt: Describes the buffer and its layout. See ::GMM_RES_SUBRESOURCES_BLT for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltAllSubresources(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_SUBRESOURCES_BLT *pSubresourcesBlt)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuBltAllSubresources(pSubresourcesBlt);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltPlanar
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltPlanar()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pPlanarBlt: Describes the frame and its plane images. See ::GMM_RES_PLANAR_BLT for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltPlanar(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_PLANAR_BLT *pPlanarBlt)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuBltPlanar(pPlanarBlt);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuBltAsync
+/// @see    GmmLib::GmmResourceInfoCommon::CpuBltAsync()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  pWorkers: Describes workers to split BLT across. See ::GMM_RES_CPU_BLT_WORKERS.
+/// @param[in]  pfnComplete: Optional completion callback.
+/// @param[in]  pCallbackContext: Passed to pfnComplete.
+/// @return     Completion handle, or NULL on failure
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_RES_CPU_BLT_ASYNC* GMM_STDCALL GmmResCpuBltAsync(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, PFN_GMM_RES_CPU_BLT_COMPLETE pfnComplete, void *pCallbackContext)
+{
+    __GMM_ASSERTPTR(pGmmResource, NULL);
+    return pGmmResource->CpuBltAsync(pBlt, pWorkers, pfnComplete, pCallbackContext);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::CpuFill
+/// @see    GmmLib::GmmResourceInfoCommon::CpuFill()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pFill: Describes the fill operation. See ::GMM_RES_FILL for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuFill(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_FILL *pFill)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->CpuFill(pFill);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::GetTileHashes
+/// @see    GmmLib::GmmResourceInfoCommon::GetTileHashes()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in]  pData: Pointer to base of the mapped resource data.
+/// @param[in,out] pTileHashes: Hash map. See ::GMM_RES_TILE_HASHES for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResGetTileHashes(GMM_RESOURCE_INFO *pGmmResource, const void *pData, GMM_RES_TILE_HASHES *pTileHashes)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->GetTileHashes(pData, pTileHashes);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::DiffTileHashes
+/// @see    GmmLib::GmmResourceInfoCommon::DiffTileHashes()
+///
+/// @param[in]  pOld: Earlier hash map.
+/// @param[in]  pNew: Later hash map.
+/// @param[out] pChangedTiles: NULL, or array receiving indices of changed tiles.
+/// @param[in]  MaxChangedTiles: Number of elements at pChangedTiles.
+/// @return     Number of changed tiles
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmResDiffTileHashes(const GMM_RES_TILE_HASHES *pOld, const GMM_RES_TILE_HASHES *pNew, uint32_t *pChangedTiles, uint32_t MaxChangedTiles)
+{
+    return GmmLib::GmmResourceInfoCommon::DiffTileHashes(pOld, pNew, pChangedTiles, MaxChangedTiles);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::InitDirtyTiles
+/// @see    GmmLib::GmmResourceInfoCommon::InitDirtyTiles()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in,out] pDirty: Dirty-tile tracker. See ::GMM_RES_DIRTY_TILES for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResInitDirtyTiles(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_DIRTY_TILES *pDirty)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->InitDirtyTiles(pDirty);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::MarkDirtyTiles
+/// @see    GmmLib::GmmResourceInfoCommon::MarkDirtyTiles()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in,out] pDirty: Dirty-tile tracker. See ::GMM_RES_DIRTY_TILES for more info.
+/// @param[in]  pRect: Rectangle to mark, as Gpu and Blt members of ::GMM_RES_COPY_BLT.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResMarkDirtyTiles(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_DIRTY_TILES *pDirty, const GMM_RES_COPY_BLT *pRect)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->MarkDirtyTiles(pDirty, pRect);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// C wrapper for GmmResourceInfoCommon::FlushDirtyTiles
+/// @see    GmmLib::GmmResourceInfoCommon::FlushDirtyTiles()
+///
+/// @param[in]  pGmmResource: Pointer to GmmResourceInfo class
+/// @param[in,out] pDirty: Dirty-tile tracker. See ::GMM_RES_DIRTY_TILES for more info.
+/// @param[in]  pBlts: Array of upload BLTs. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  NumBlts: Number of elements in pBlts.
+/// @return     TRUE if all succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResFlushDirtyTiles(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_DIRTY_TILES *pDirty, GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts)
+{
+    __GMM_ASSERTPTR(pGmmResource, FALSE);
+    return pGmmResource->FlushDirtyTiles(pDirty, pBlts, NumBlts);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 /// C wrapper for GmmResourceInfoCommon::GetStdLayoutSize
 /// @see    GmmLib::GmmResourceInfoCommon::GetStdLayoutSize()
@@ -0,0 +1,184 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#include "Internal/Common/GmmLibInc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// State of a GmmResCpuBltAsync operation, behind its GMM_RES_CPU_BLT_ASYNC handle.
+/////////////////////////////////////////////////////////////////////////////////////
+struct GMM_RES_CPU_BLT_ASYNC_REC
+{
+    GmmLib::GmmResourceInfoCommon   *pResource;
+    GMM_RES_COPY_BLT                Blt;
+    GMM_RES_CPU_BLT_WORKERS         Workers;
+    PFN_GMM_RES_CPU_BLT_COMPLETE    pfnComplete;
+    void                            *pCallbackContext;
+    BOOLEAN                         Success;
+    bool                            Done;
+#if(!defined(__GMM_KMD__))
+    std::mutex                      Lock;
+    std::condition_variable         Completed;  ///< Signaled when Done set.
+#endif
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Task function performing a GmmResCpuBltAsync operation.
+///
+/// @param[in]  pTaskContext: GMM_RES_CPU_BLT_ASYNC of operation
+/// @param[in]  TaskIndex: Unused
+/////////////////////////////////////////////////////////////////////////////////////
+static void GMM_STDCALL CpuBltAsyncTask(void *pTaskContext, uint32_t TaskIndex)
+{
+    GMM_RES_CPU_BLT_ASYNC *pAsync = (GMM_RES_CPU_BLT_ASYNC *) pTaskContext;
+
+    GMM_UNREFERENCED_PARAMETER(TaskIndex);
+
+    pAsync->Success = pAsync->pResource->CpuBltParallel(&pAsync->Blt, &pAsync->Workers);
+
+    if(pAsync->pfnComplete)
+    {
+        pAsync->pfnComplete(pAsync->pCallbackContext, pAsync->Success);
+    }
+
+#if(!defined(__GMM_KMD__))
+    std::lock_guard<std::mutex> Locked(pAsync->Lock);
+    pAsync->Done = true;
+    pAsync->Completed.notify_all(); // Under Lock, so waiter can't release handle until we're done with it.
+#else
+    pAsync->Done = true;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Queues a CPU BLT (as CpuBltParallel) to GmmLib's internal worker pool and returns 
+/// without waiting for it, so the caller can overlap the swizzling with e.g. command 
+/// submission or decoding the next image. The BLT runs on a pool thread, which splits 
+/// swizzled transfers into tile-row bands across the pool (or pWorkers) as 
+/// CpuBltParallel does.
+///
+/// The resource, pBlt's GPU and system memory, and any caller-supplied worker pool 
+/// must remain valid until the operation completes--pBlt itself is copied. Without 
+/// an internal pool (e.g. single-core systems, or KMD) the BLT is performed before 
+/// returning, and the handle is already complete.
+///
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  pWorkers: Describes workers to split BLT across. See ::GMM_RES_CPU_BLT_WORKERS. 
+///                       NULL to use all threads of GmmLib's internal worker pool.
+/// @param[in]  pfnComplete: Optional callback invoked on completion, before the 
+///                          handle is signaled. See ::PFN_GMM_RES_CPU_BLT_COMPLETE.
+/// @param[in]  pCallbackContext: Passed to pfnComplete.
+/// @return     Handle to poll/wait on and then release with GmmResCpuBltAsyncRelease, 
+///             or NULL if the operation could not be queued (in which case neither 
+///             the BLT nor the callback is performed)
+/////////////////////////////////////////////////////////////////////////////////////
+GMM_RES_CPU_BLT_ASYNC* GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltAsync(const GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, PFN_GMM_RES_CPU_BLT_COMPLETE pfnComplete, void *pCallbackContext)
+{
+    GMM_RES_CPU_BLT_ASYNC *pAsync;
+
+    __GMM_ASSERTPTR(pBlt, NULL);
+
+    pAsync = new(std::nothrow) GMM_RES_CPU_BLT_ASYNC;
+    if(!pAsync)
+    {
+        return NULL;
+    }
+
+    pAsync->pResource = this;
+    pAsync->Blt = *pBlt;
+    if(pWorkers)
+    {
+        pAsync->Workers = *pWorkers;
+    }
+    else
+    {
+        memset(&pAsync->Workers, 0, sizeof(pAsync->Workers));
+    }
+    pAsync->pfnComplete = pfnComplete;
+    pAsync->pCallbackContext = pCallbackContext;
+    pAsync->Success = FALSE;
+    pAsync->Done = false;
+
+#if(!defined(__GMM_KMD__))
+    WorkerPool *pPool = pGmmGlobalContext->GetWorkerPool();
+
+    if(pPool)
+    {
+        pPool->Submit(CpuBltAsyncTask, pAsync);
+    }
+    else
+#endif
+    {
+        CpuBltAsyncTask(pAsync, 0);
+    }
+
+    return pAsync;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns whether a GmmResCpuBltAsync operation has completed (without blocking).
+///
+/// @param[in]  pAsync: Handle returned by GmmResCpuBltAsync
+/// @return     TRUE if completed, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltAsyncIsComplete(GMM_RES_CPU_BLT_ASYNC *pAsync)
+{
+    __GMM_ASSERTPTR(pAsync, TRUE);
+
+#if(!defined(__GMM_KMD__))
+    std::lock_guard<std::mutex> Locked(pAsync->Lock);
+#endif
+
+    return pAsync->Done ? TRUE : FALSE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Blocks until a GmmResCpuBltAsync operation completes.
+///
+/// @param[in]  pAsync: Handle returned by GmmResCpuBltAsync
+/// @return     TRUE if the BLT succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmResCpuBltAsyncWait(GMM_RES_CPU_BLT_ASYNC *pAsync)
+{
+    __GMM_ASSERTPTR(pAsync, FALSE);
+
+#if(!defined(__GMM_KMD__))
+    std::unique_lock<std::mutex> Locked(pAsync->Lock);
+
+    pAsync->Completed.wait(Locked, [pAsync] { return pAsync->Done; });
+#endif
+
+    return pAsync->Success;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Frees a GmmResCpuBltAsync handle--first waiting for the operation to complete, 
+/// if it hasn't already.
+///
+/// @param[in]  pAsync: Handle returned by GmmResCpuBltAsync, or NULL
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmResCpuBltAsyncRelease(GMM_RES_CPU_BLT_ASYNC *pAsync)
+{
+    if(pAsync)
+    {
+        GmmResCpuBltAsyncWait(pAsync);
+        delete pAsync;
+    }
+}
@@ -22,6 +22,10 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 
 #include "Internal/Common/GmmLibInc.h"
+#include <xmmintrin.h>
+
+#define GMM_CPU_BLT_PREFETCH_BYTES  GMM_KBYTE(4)    // Source bytes of next batched copy to prefetch.
+#define GMM_CPU_BLT_DEFAULT_LLC     GMM_MBYTE(2)    // Assumed LLC size when GtSysInfo doesn't report one.
 
 /////////////////////////////////////////////////////////////////////////////////////
 /// Returns indication of whether resource is eligible for 64KB pages or not.
@@ -824,6 +828,400 @@ GMM_STATUS GMM_STDCALL GmmLib::GmmResourceInfoCommon::GetOffset(GMM_REQ_OFFSET_I
 /// @return     TRUE if succeeded, FALSE otherwise
 /////////////////////////////////////////////////////////////////////////////////////
 BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBlt(GMM_RES_COPY_BLT *pBlt)
+{
+    return CpuBltOnWorkers(pBlt, NULL, NULL);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Performs a CPU BLT like CpuBlt, but splits swizzled transfers into bands along 
+/// tile-row boundaries and runs the bands concurrently on worker threads.
+///
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  pWorkers: Describes workers to use. See ::GMM_RES_CPU_BLT_WORKERS. 
+///                       NULL to use all threads of GmmLib's internal worker pool.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltParallel(GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers)
+{
+    const GMM_RES_CPU_BLT_WORKERS DefaultWorkers = {0};
+
+    return CpuBltOnWorkers(pBlt, pWorkers ? pWorkers : &DefaultWorkers, NULL);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Performs an array of CPU BLTs (e.g. the mips/slices of a texture upload) as one 
+/// operation. All BLTs are resolved up front (reusing the GetOffset result across 
+/// consecutive BLTs of the same subresource), and adjacent rectangles that continue 
+/// each other in both surfaces are merged, so that e.g. a row of sub-rectangles in 
+/// the same tile rows is copied by a single CpuSwizzleBlt pass.
+///
+/// @param[in]  pBlts: Array of blit operations. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  NumBlts: Number of elements in pBlts.
+/// @return     TRUE if all succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltBatch(GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts)
+{
+    CPU_BLT_BATCH Batch;
+    uint32_t i;
+
+    __GMM_ASSERTPTR((pBlts || !NumBlts), FALSE);
+
+    Batch.NumOps = 0;
+    Batch.Success = TRUE;
+    memset(&Batch.OffsetCache, 0, sizeof(Batch.OffsetCache));
+
+    for(i = 0; i < NumBlts; i++)
+    {
+        CpuBltOnWorkers(&pBlts[i], NULL, &Batch);
+    }
+
+    CpuBltFlushBatch(&Batch);
+
+    return Batch.Success;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Context and task function for one band of a CpuBltParallel swizzled transfer.
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct CPU_BLT_BAND_TASK_REC
+{
+    CPU_SWIZZLE_BLT_SURFACE *pDest;
+    CPU_SWIZZLE_BLT_SURFACE *pSrc;
+    int                     CopyWidthBytes;
+    int                     CopyHeight;
+    int                     CopyDepth;          // Non-zero for CpuSwizzleBltVolume (instead of pfnBlt)...
+    int                     LinearSlicePitch;   // ...and its linear slice pitch.
+    int                     NumBands;
+    PFN_CPU_SWIZZLE_BLT     pfnBlt;
+} CPU_BLT_BAND_TASK;
+
+static void GMM_STDCALL CpuBltBandTask(void *pTaskContext, uint32_t TaskIndex)
+{
+    CPU_BLT_BAND_TASK *pTask = (CPU_BLT_BAND_TASK *) pTaskContext;
+    CPU_SWIZZLE_BLT_SURFACE Dest = *pTask->pDest, Src = *pTask->pSrc;
+    int FirstRow, Rows;
+
+    Rows = CpuSwizzleBltBandRows(Dest.pSwizzle ? &Dest : &Src, pTask->CopyHeight, (int) TaskIndex, pTask->NumBands, &FirstRow);
+    if(Rows)
+    {
+        Dest.OffsetY += FirstRow;
+        Src.OffsetY += FirstRow;
+
+        if(pTask->CopyDepth)
+        {
+            CpuSwizzleBltVolume(&Dest, &Src, pTask->CopyWidthBytes, Rows, pTask->CopyDepth, pTask->LinearSlicePitch);
+        }
+        else
+        {
+            pTask->pfnBlt(&Dest, &Src, pTask->CopyWidthBytes, Rows);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the number of bands to split a swizzled transfer into for the given 
+/// workers--one per worker, but no more than the transfer's tile rows.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t CpuBltNumBands(const GMM_RES_CPU_BLT_WORKERS *pWorkers, const CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface, uint32_t CopyHeight)
+{
+    uint32_t NumBands;
+
+    if(!pWorkers)
+    {
+        return 1;
+    }
+
+    NumBands = pWorkers->NumWorkers;
+#if(!defined(__GMM_KMD__))
+    if(!NumBands)
+    {
+        if(pWorkers->pfnRunTasks) // Client pool of unknown size--one per CPU.
+        {
+            NumBands = GmmLib::WorkerPool::GetDefaultNumThreads() + 1;
+        }
+        else
+        {
+            GmmLib::WorkerPool *pPool = pGmmGlobalContext->GetWorkerPool();
+
+            NumBands = pPool ? (pPool->GetNumThreads() + 1) : 1;
+        }
+    }
+#endif
+
+    return GFX_MAX(1, GFX_MIN(NumBands, (uint32_t) CpuSwizzleBltTileRows(pSwizzledSurface, CopyHeight)));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Runs tasks of a CpuBlt operation on the given workers--i.e. the client's 
+/// pfnRunTasks, else GmmLib's internal pool, else serially on calling thread.
+/////////////////////////////////////////////////////////////////////////////////////
+static void RunCpuBltTasks(const GMM_RES_CPU_BLT_WORKERS *pWorkers, uint32_t NumTasks, PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext)
+{
+    GmmLib::WorkerPool *pPool = NULL;
+
+    if(pWorkers && pWorkers->pfnRunTasks)
+    {
+        pWorkers->pfnRunTasks(pWorkers->pPoolContext, NumTasks, pfnTask, pTaskContext);
+        return;
+    }
+
+#if(!defined(__GMM_KMD__))
+    if(pWorkers && (NumTasks > 1))
+    {
+        pPool = pGmmGlobalContext->GetWorkerPool();
+    }
+#endif
+    if(pPool)
+    {
+        pPool->RunTasks(NumTasks, pfnTask, pTaskContext);
+    }
+    else // No internal pool (e.g. KMD)--run tasks serially.
+    {
+        for(uint32_t Task = 0; Task < NumTasks; Task++)
+        {
+            pfnTask(pTaskContext, Task);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Implements CpuBlt and CpuBltParallel.
+///
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  pWorkers: Workers to split swizzled transfers across, or NULL to 
+///                       perform the entire BLT on the calling thread.
+/// @param[in]  pBatch: NULL to perform the BLT immediately, else CpuBltBatch state 
+///                     to which the resolved copies are appended.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltOnWorkers(GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, CPU_BLT_BATCH *pBatch)
+{
+    BOOLEAN Success = TRUE;
+
+    __GMM_ASSERTPTR(pBlt, FALSE);
+
+    if(pBlt->Blt.CacheHint == GMM_RES_CPU_BLT_CACHE_AUTO) // Decide once, from footprint of entire BLT (not its per-slice/sample pieces)...
+    {
+        GMM_RES_COPY_BLT HintedBlt = *pBlt;
+        uint64_t Footprint = 
+            (pBlt->Blt.Height && pBlt->Sys.RowPitch) ? 
+                (uint64_t) pBlt->Blt.Height * pBlt->Sys.RowPitch : 
+                pBlt->Sys.BufferSize;
+        int Temporal;
+        uint32_t PrefetchBytes;
+
+        Footprint *= GFX_MAX(pBlt->Blt.Slices, 1) * GFX_MAX(pBlt->Msaa.Samples, 1);
+        if(pBlt->Sys.BufferSize)
+        {
+            Footprint = GFX_MIN(Footprint, (uint64_t) pBlt->Sys.BufferSize);
+        }
+
+        CpuBltGetCachePolicy(Footprint, pBlt->Blt.Upload, GMM_RES_CPU_BLT_CACHE_AUTO, &Temporal, &PrefetchBytes);
+        HintedBlt.Blt.CacheHint = Temporal ? GMM_RES_CPU_BLT_CACHE_TEMPORAL : GMM_RES_CPU_BLT_CACHE_STREAMING;
+
+        return CpuBltOnWorkers(&HintedBlt, pWorkers, pBatch);
+    }
+
+    if( (pBlt->Blt.Slices > 1) && 
+        (Surf.Type == RESOURCE_3D) && 
+        (Surf.Flags.Info.TiledYf || Surf.Flags.Info.TiledYs) && 
+        (pBlt->Msaa.Samples <= 1)) 
+    {
+        Success = CpuBltVolume(pBlt, pWorkers, pBatch);
+    }
+    else if(pBlt->Blt.Slices > 1) 
+    {
+        GMM_RES_COPY_BLT SliceBlt = *pBlt;
+        uint32_t Slice;
+
+        SliceBlt.Blt.Slices = 1;
+        for(Slice = pBlt->Gpu.Slice; 
+            Slice < (pBlt->Gpu.Slice + pBlt->Blt.Slices); 
+            Slice++) 
+        {
+            SliceBlt.Gpu.Slice = Slice;
+            SliceBlt.Sys.pData = (void *)((char *) pBlt->Sys.pData + (Slice - pBlt->Gpu.Slice) * pBlt->Sys.SlicePitch);
+            SliceBlt.Sys.BufferSize = pBlt->Sys.BufferSize - GFX_ULONG_CAST((char *) SliceBlt.Sys.pData - (char *) pBlt->Sys.pData);
+            CpuBltOnWorkers(&SliceBlt, pWorkers, pBatch);
+        }
+    } 
+    else if(pBlt->Msaa.Samples > 1) 
+    {
+        GMM_RES_COPY_BLT SampleBlt = *pBlt;
+        uint32_t Sample;
+
+        SampleBlt.Msaa.Samples = 1;
+        for(Sample = pBlt->Msaa.Sample; 
+            Sample < (pBlt->Msaa.Sample + pBlt->Msaa.Samples); 
+            Sample++) 
+        {
+            SampleBlt.Msaa.Sample = Sample;
+            SampleBlt.Sys.pData = (void *)((char *) pBlt->Sys.pData + (Sample - pBlt->Msaa.Sample) * pBlt->Msaa.SamplePitch);
+            SampleBlt.Sys.BufferSize = pBlt->Sys.BufferSize - GFX_ULONG_CAST((char *) SampleBlt.Sys.pData - (char *) pBlt->Sys.pData);
+            CpuBltOnWorkers(&SampleBlt, pWorkers, pBatch);
+        }
+    } 
+    else // Single Subresource...
+    {
+        CPU_BLT_OP Op;
+
+        Success = CpuBltResolve(pBlt, &Op, pBatch ? &pBatch->OffsetCache : NULL);
+        if(!Success)
+        {
+            if(pBatch)
+            {
+                pBatch->Success = FALSE;
+            }
+        }
+        else if(!pBatch)
+        {
+            CpuBltExecute(&Op, pWorkers);
+        }
+        else if(!pBatch->NumOps || 
+                !CpuBltCoalesce(&pBatch->Op[pBatch->NumOps - 1], &Op))
+        {
+            if(pBatch->NumOps == GMM_CPU_BLT_BATCH_MAX_OPS)
+            {
+                CpuBltFlushBatch(pBatch);
+            }
+            pBatch->Op[pBatch->NumOps++] = Op;
+        }
+    }
+
+    return Success;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Performs a multi-slice BLT of a Yf/Ys 3D resource a tile layer at a time, so
+/// each 3D tile (whose low bits interleave Z--see ST_3D_*) is walked once for all
+/// of its slices in the BLT, rather than once per slice.
+///
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[in]  pWorkers: Workers to split each tile layer's rows across, or NULL to 
+///                       perform the entire BLT on the calling thread.
+/// @param[in]  pBatch: NULL, or CpuBltBatch state--which is flushed first, since 
+///                     volume copies are performed immediately.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltVolume(GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, CPU_BLT_BATCH *pBatch)
+{
+    const GMM_PLATFORM_INFO *pPlatform;
+    GMM_REQ_OFFSET_INFO *pOffsetCache;
+    BOOLEAN Success = TRUE;
+    uint32_t TileDepth, Slice, LastSlice;
+
+    __GMM_ASSERTPTR(pBlt, FALSE);
+    __GMM_ASSERT(Surf.Type == RESOURCE_3D);
+
+    pPlatform = GMM_OVERRIDE_PLATFORM_INFO(&Surf);
+    TileDepth = GFX_MAX(pPlatform->TileInfo[Surf.TileMode].LogicalTileDepth, 1);
+    pOffsetCache = pBatch ? &pBatch->OffsetCache : NULL;
+
+    if(pBatch)
+    {
+        CpuBltFlushBatch(pBatch); // Preserve BLT ordering.
+    }
+
+    for(Slice = pBlt->Gpu.Slice, LastSlice = pBlt->Gpu.Slice + pBlt->Blt.Slices; 
+        Slice < LastSlice; 
+        )
+    {
+        uint32_t Depth = GFX_MIN(LastSlice - Slice, TileDepth - (Slice % TileDepth));
+        GMM_RES_COPY_BLT LayerBlt = *pBlt, LayerEndBlt;
+        CPU_BLT_OP Op, EndOp;
+
+        LayerBlt.Blt.Slices = 1;
+        LayerBlt.Gpu.Slice = Slice;
+        LayerBlt.Sys.pData = (void *)((char *) pBlt->Sys.pData + (Slice - pBlt->Gpu.Slice) * pBlt->Sys.SlicePitch);
+        LayerBlt.Sys.BufferSize = pBlt->Sys.BufferSize - GFX_ULONG_CAST((char *) LayerBlt.Sys.pData - (char *) pBlt->Sys.pData);
+
+        // Resolve layer's last slice too--validating its bounds, and that it 
+        // does share first slice's tiles...
+        LayerEndBlt = LayerBlt;
+        LayerEndBlt.Gpu.Slice = Slice + Depth - 1;
+        LayerEndBlt.Sys.pData = (void *)((char *) LayerBlt.Sys.pData + (Depth - 1) * pBlt->Sys.SlicePitch);
+        LayerEndBlt.Sys.BufferSize = LayerBlt.Sys.BufferSize - (Depth - 1) * pBlt->Sys.SlicePitch;
+
+        if(!CpuBltResolve(&LayerBlt, &Op, pOffsetCache) || 
+           !CpuBltResolve(&LayerEndBlt, &EndOp, pOffsetCache))
+        {
+            Success = FALSE;
+        }
+        else
+        {
+            const CPU_SWIZZLE_BLT_SURFACE *pSwizzled = Op.Dest.pSwizzle ? &Op.Dest : &Op.Src;
+            const CPU_SWIZZLE_BLT_SURFACE *pEndSwizzled = EndOp.Dest.pSwizzle ? &EndOp.Dest : &EndOp.Src;
+
+            if( pSwizzled->pSwizzle && 
+                (pSwizzled->pBase == pEndSwizzled->pBase) && 
+                (pSwizzled->OffsetZ + Depth - 1 == pEndSwizzled->OffsetZ)) 
+            {
+                CPU_BLT_BAND_TASK BandTask;
+
+                BandTask.pDest = &Op.Dest;
+                BandTask.pSrc = &Op.Src;
+                BandTask.CopyWidthBytes = Op.CopyWidthBytes;
+                BandTask.CopyHeight = Op.CopyHeight;
+                BandTask.CopyDepth = Depth;
+                BandTask.LinearSlicePitch = GFX_ULONG_CAST(pBlt->Sys.SlicePitch);
+                BandTask.NumBands = CpuBltNumBands(pWorkers, pSwizzled, Op.CopyHeight);
+                BandTask.pfnBlt = NULL;
+
+                if(BandTask.NumBands == 1)
+                {
+                    CpuSwizzleBltVolume(&Op.Dest, &Op.Src, Op.CopyWidthBytes, Op.CopyHeight, Depth, BandTask.LinearSlicePitch);
+                }
+                else
+                {
+                    RunCpuBltTasks(pWorkers, BandTask.NumBands, CpuBltBandTask, &BandTask);
+                }
+            }
+            else // Layer's slices not in one tile layer as expected--BLT them individually...
+            {
+                uint32_t i;
+
+                for(i = 0; i < Depth; i++)
+                {
+                    GMM_RES_COPY_BLT SliceBlt = LayerBlt;
+
+                    SliceBlt.Blt.Slices = 1;
+                    SliceBlt.Gpu.Slice = Slice + i;
+                    SliceBlt.Sys.pData = (void *)((char *) LayerBlt.Sys.pData + i * pBlt->Sys.SlicePitch);
+                    SliceBlt.Sys.BufferSize = LayerBlt.Sys.BufferSize - i * pBlt->Sys.SlicePitch;
+                    if(CpuBltResolve(&SliceBlt, &Op, pOffsetCache))
+                    {
+                        CpuBltExecute(&Op, pWorkers);
+                    }
+                    else
+                    {
+                        Success = FALSE;
+                    }
+                }
+            }
+        }
+
+        Slice += Depth;
+    }
+
+    if(pBatch && !Success)
+    {
+        pBatch->Success = FALSE;
+    }
+
+    return Success;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Resolves a single-subresource BLT (i.e. Blt.Slices and Msaa.Samples <= 1)
+/// into the surface pair and dimensions of the copy, without performing it.
+///
+/// @param[in]  pBlt: Describes the blit operation. See ::GMM_RES_COPY_BLT for more info.
+/// @param[out] pOp: Resolved copy.
+/// @param[in,out] pOffsetCache: NULL, or zero-initialized/previous GetOffset result 
+///                       to reuse when pBlt targets the same subresource.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltResolve(GMM_RES_COPY_BLT *pBlt, CPU_BLT_OP *pOp, GMM_REQ_OFFSET_INFO *pOffsetCache)
 {
     #define REQUIRE(e)          \
         if(!(e))                \
@@ -839,6 +1237,8 @@ BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBlt(GMM_RES_COPY_BLT *pBlt
     GMM_TEXTURE_CALC *pTextureCalc;
 
     __GMM_ASSERTPTR(pBlt, FALSE);
+    __GMM_ASSERTPTR(pOp, FALSE);
+    __GMM_ASSERT((pBlt->Blt.Slices <= 1) && (pBlt->Msaa.Samples <= 1));
 
     pPlatform = GMM_OVERRIDE_PLATFORM_INFO(&Surf);
     pTextureCalc = GMM_OVERRIDE_TEXTURE_CALC(&Surf);
@@ -850,7 +1250,13 @@ BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBlt(GMM_RES_COPY_BLT *pBlt
         Surf.Type == RESOURCE_CUBE || 
         Surf.Type == RESOURCE_3D);
     __GMM_ASSERT(pBlt->Gpu.MipLevel <= Surf.MaxLod);
-    __GMM_ASSERT(Surf.MSAA.NumSamples <= 1); // Supported by CpuSwizzleBlt--but not yet this function.
+    __GMM_ASSERT( // Yf/Ys MSAA supported via CpuSwizzleBlt's "S" swizzle bits--legacy MSS/IMS layouts not yet.
+        (Surf.MSAA.NumSamples <= 1) || 
+        Surf.Flags.Info.TiledYf || 
+        Surf.Flags.Info.TiledYs);
+    __GMM_ASSERT(
+        (pBlt->Msaa.Sample + GFX_MAX(pBlt->Msaa.Samples, 1)) <= 
+        GFX_MAX(Surf.MSAA.NumSamples, 1));
     __GMM_ASSERT(!Surf.Flags.Gpu.Depth || Surf.MSAA.NumSamples <= 1); // MSAA depth currently ends up with a few exchange swizzles--CpuSwizzleBlt could support with expanded XOR'ing, but probably no use case.
     __GMM_ASSERT(!(
         pBlt->Blt.Upload && 
@@ -887,335 +1293,867 @@ BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBlt(GMM_RES_COPY_BLT *pBlt
         }
     }
 
-    if(pBlt->Blt.Slices > 1) 
+    uint32_t ResPixelPitch = pTexInfo->BitsPerPixel / CHAR_BIT;
+    uint32_t BlockWidth, BlockHeight, BlockDepth;
+    uint32_t __CopyWidthBytes, __CopyHeight, __OffsetXBytes, __OffsetY;
+    GMM_REQ_OFFSET_INFO GetOffset = {0};
+
+    pTextureCalc->GetCompressionBlockDimensions(pTexInfo->Format, &BlockWidth, &BlockHeight, &BlockDepth);
+
+    #if(LHDM)
+    if( pTexInfo->MsFormat == D3DDDIFMT_G8R8_G8B8 ||
+        pTexInfo->MsFormat == D3DDDIFMT_R8G8_B8G8 )
     {
-        GMM_RES_COPY_BLT SliceBlt = *pBlt;
-        uint32_t Slice;
+        BlockWidth = 2;
+        ResPixelPitch = 4;
+    }
+    #endif
 
-        SliceBlt.Blt.Slices = 1;
-        for(Slice = pBlt->Gpu.Slice; 
-            Slice < (pBlt->Gpu.Slice + pBlt->Blt.Slices); 
-            Slice++) 
+    { // __CopyWidthBytes...
+        uint32_t Width;
+
+        if(!pBlt->Blt.Width) // i.e. "Full Width"
         {
-            SliceBlt.Gpu.Slice = Slice;
-            SliceBlt.Sys.pData = (void *)((char *) pBlt->Sys.pData + (Slice - pBlt->Gpu.Slice) * pBlt->Sys.SlicePitch);
-            SliceBlt.Sys.BufferSize = pBlt->Sys.BufferSize - GFX_ULONG_CAST((char *) SliceBlt.Sys.pData - (char *) pBlt->Sys.pData);
-            CpuBlt(&SliceBlt);
+            __GMM_ASSERT(!GmmIsPlanar(pTexInfo->Format)); // Caller must set Blt.Width--GMM "auto-size on zero" not supported with planars since multiple interpretations would confuse more than help.
+
+            Width = GFX_ULONG_CAST(__GmmTexGetMipWidth(pTexInfo, pBlt->Gpu.MipLevel));
+
+            __GMM_ASSERT(Width >= pBlt->Gpu.OffsetX);
+            Width -= pBlt->Gpu.OffsetX;
+            __GMM_ASSERT(Width);
+        } 
+        else 
+        {
+            Width = pBlt->Blt.Width;
         }
-    } 
-    else // Single Subresource...
-    {
-        uint32_t ResPixelPitch = pTexInfo->BitsPerPixel / CHAR_BIT;
-        uint32_t BlockWidth, BlockHeight, BlockDepth;
-        uint32_t __CopyWidthBytes, __CopyHeight, __OffsetXBytes, __OffsetY;
-        GMM_REQ_OFFSET_INFO GetOffset = {0};
 
-        pTextureCalc->GetCompressionBlockDimensions(pTexInfo->Format, &BlockWidth, &BlockHeight, &BlockDepth);
+        if( ((pBlt->Sys.PixelPitch == 0) || 
+             (pBlt->Sys.PixelPitch == ResPixelPitch)) && 
+            ((pBlt->Blt.BytesPerPixel == 0) || 
+             (pBlt->Blt.BytesPerPixel == ResPixelPitch))) 
+        {
+            // Full-Pixel BLT...
+            __CopyWidthBytes = 
+                GFX_CEIL_DIV(Width, BlockWidth) * ResPixelPitch;
+        } 
+        else // Partial-Pixel BLT...
+        {
+            __GMM_ASSERT(BlockWidth == 1); // No partial-pixel support for block-compressed formats.
+
+            // When copying between surfaces with different pixel pitches, 
+            // specify CopyWidthBytes in terms of unswizzled surface 
+            // (convenient convention used by CpuSwizzleBlt).
+            __CopyWidthBytes = 
+                Width * 
+                (pBlt->Sys.PixelPitch ? 
+                    pBlt->Sys.PixelPitch : 
+                    ResPixelPitch);
+        }
+    }
+
+    { // __CopyHeight...
+        if(!pBlt->Blt.Height) // i.e. "Full Height"
+        {
+            __GMM_ASSERT(!GmmIsPlanar(pTexInfo->Format)); // Caller must set Blt.Height--GMM "auto-size on zero" not supported with planars since multiple interpretations would confuse more than help.
 
-        #if(LHDM)
-        if( pTexInfo->MsFormat == D3DDDIFMT_G8R8_G8B8 ||
-            pTexInfo->MsFormat == D3DDDIFMT_R8G8_B8G8 )
+            __CopyHeight = __GmmTexGetMipHeight(pTexInfo, pBlt->Gpu.MipLevel);
+            __GMM_ASSERT(__CopyHeight >= pBlt->Gpu.OffsetY);
+            __CopyHeight -= pBlt->Gpu.OffsetY;
+            __GMM_ASSERT(__CopyHeight);
+        } 
+        else 
         {
-            BlockWidth = 2;
-            ResPixelPitch = 4;
+            __CopyHeight = pBlt->Blt.Height;
         }
-        #endif
 
-        { // __CopyWidthBytes...
-            uint32_t Width;
+        __CopyHeight = GFX_CEIL_DIV(__CopyHeight, BlockHeight);
+    }
 
-            if(!pBlt->Blt.Width) // i.e. "Full Width"
-            {
-                __GMM_ASSERT(!GmmIsPlanar(pTexInfo->Format)); // Caller must set Blt.Width--GMM "auto-size on zero" not supported with planars since multiple interpretations would confuse more than help.
+    __GMM_ASSERT((pBlt->Gpu.OffsetX % BlockWidth) == 0);
+    __OffsetXBytes = (pBlt->Gpu.OffsetX / BlockWidth) * ResPixelPitch + pBlt->Gpu.OffsetSubpixel;
 
-                Width = GFX_ULONG_CAST(__GmmTexGetMipWidth(pTexInfo, pBlt->Gpu.MipLevel));
+    __GMM_ASSERT((pBlt->Gpu.OffsetY % BlockHeight) == 0);
+    __OffsetY = (pBlt->Gpu.OffsetY / BlockHeight);
 
-                __GMM_ASSERT(Width >= pBlt->Gpu.OffsetX);
-                Width -= pBlt->Gpu.OffsetX;
-                __GMM_ASSERT(Width);
-            } 
-            else 
+    { // Get pResData Offsets to this subresource...
+        GetOffset.ReqLock = pTexInfo->Flags.Info.Linear;
+        GetOffset.ReqStdLayout = !GetOffset.ReqLock && pTexInfo->Flags.Info.StdSwizzle;
+        GetOffset.ReqRender = !GetOffset.ReqLock && !GetOffset.ReqStdLayout;
+        GetOffset.MipLevel = pBlt->Gpu.MipLevel;
+        switch(pTexInfo->Type) 
+        {
+            case RESOURCE_1D:
+            case RESOURCE_2D:
+            case RESOURCE_PRIMARY:
             {
-                Width = pBlt->Blt.Width;
+                GetOffset.ArrayIndex = pBlt->Gpu.Slice;
+                break;
             }
-
-            if( ((pBlt->Sys.PixelPitch == 0) || 
-                 (pBlt->Sys.PixelPitch == ResPixelPitch)) && 
-                ((pBlt->Blt.BytesPerPixel == 0) || 
-                 (pBlt->Blt.BytesPerPixel == ResPixelPitch))) 
+            case RESOURCE_CUBE:
             {
-                // Full-Pixel BLT...
-                __CopyWidthBytes = 
-                    GFX_CEIL_DIV(Width, BlockWidth) * ResPixelPitch;
-            } 
-            else // Partial-Pixel BLT...
+                GetOffset.ArrayIndex = pBlt->Gpu.Slice / 6;
+                GetOffset.CubeFace = (GMM_CUBE_FACE_ENUM)(pBlt->Gpu.Slice % 6);
+                break;
+            }
+            case RESOURCE_3D:
             {
-                __GMM_ASSERT(BlockWidth == 1); // No partial-pixel support for block-compressed formats.
-
-                // When copying between surfaces with different pixel pitches, 
-                // specify CopyWidthBytes in terms of unswizzled surface 
-                // (convenient convention used by CpuSwizzleBlt).
-                __CopyWidthBytes = 
-                    Width * 
-                    (pBlt->Sys.PixelPitch ? 
-                        pBlt->Sys.PixelPitch : 
-                        ResPixelPitch);
+                GetOffset.Slice = (pTexInfo->Flags.Info.TiledYs || pTexInfo->Flags.Info.TiledYf) ? 
+                                    (pBlt->Gpu.Slice / pPlatform->TileInfo[pTexInfo->TileMode].LogicalTileDepth) : 
+                                    pBlt->Gpu.Slice;
+                break;
             }
+            default: 
+                __GMM_ASSERT(0);
         }
 
-        { // __CopyHeight...
-            if(!pBlt->Blt.Height) // i.e. "Full Height"
+        if( pOffsetCache && 
+            (pOffsetCache->ReqLock == GetOffset.ReqLock) && 
+            (pOffsetCache->ReqRender == GetOffset.ReqRender) && 
+            (pOffsetCache->ReqStdLayout == GetOffset.ReqStdLayout) && 
+            (pOffsetCache->MipLevel == GetOffset.MipLevel) && 
+            (pOffsetCache->ArrayIndex == GetOffset.ArrayIndex) && 
+            (pOffsetCache->CubeFace == GetOffset.CubeFace) && 
+            (pOffsetCache->Slice == GetOffset.Slice)) 
+        {
+            GetOffset = *pOffsetCache; // Same subresource as previous BLT of batch.
+        } 
+        else 
+        {
+            REQUIRE(this->GetOffset(GetOffset) == GMM_SUCCESS);
+            if(pOffsetCache) 
             {
-                __GMM_ASSERT(!GmmIsPlanar(pTexInfo->Format)); // Caller must set Blt.Height--GMM "auto-size on zero" not supported with planars since multiple interpretations would confuse more than help.
+                *pOffsetCache = GetOffset;
+            }
+        }
+    }
 
-                __CopyHeight = __GmmTexGetMipHeight(pTexInfo, pBlt->Gpu.MipLevel);
-                __GMM_ASSERT(__CopyHeight >= pBlt->Gpu.OffsetY);
-                __CopyHeight -= pBlt->Gpu.OffsetY;
-                __GMM_ASSERT(__CopyHeight);
-            } 
-            else 
+    if(pTexInfo->Flags.Info.Linear) 
+    {
+        CPU_SWIZZLE_BLT_SURFACE GpuSurface = {0}, SysSurface = {0};
+
+        __GMM_ASSERT( // Linear-to-linear subpixel BLT unexpected--Not implemented.
+            (!pBlt->Sys.PixelPitch || (pBlt->Sys.PixelPitch == ResPixelPitch)) && 
+            (!pBlt->Blt.BytesPerPixel || (pBlt->Blt.BytesPerPixel == ResPixelPitch)));
+        REQUIRE(!pBlt->Blt.pConvert); // Linear-to-linear conversion not implemented.
+
+        __GMM_ASSERT(GetOffset.Lock.Offset < pTexInfo->Size);
+
+        GpuSurface.pBase = (char *) pBlt->Gpu.pData + GetOffset.Lock.Offset;
+        GpuSurface.Pitch = GFX_ULONG_CAST(pTexInfo->Pitch);
+        GpuSurface.Height = GFX_ULONG_CAST((pTexInfo->Size - GetOffset.Lock.Offset) / pTexInfo->Pitch);
+        GpuSurface.OffsetX = __OffsetXBytes;
+        GpuSurface.OffsetY = __OffsetY;
+        GpuSurface.Element.Pitch = GpuSurface.Element.Size = ResPixelPitch;
+
+        SysSurface.pBase = pBlt->Sys.pData;
+        SysSurface.Pitch = pBlt->Sys.RowPitch;
+        SysSurface.Height = 
+            pBlt->Sys.BufferSize / 
+            (pBlt->Sys.RowPitch ? 
+                pBlt->Sys.RowPitch : 
+                pBlt->Sys.BufferSize);
+        SysSurface.Element.Pitch = SysSurface.Element.Size = ResPixelPitch;
+
+        pOp->Dest = pBlt->Blt.Upload ? GpuSurface : SysSurface;
+        pOp->Src = pBlt->Blt.Upload ? SysSurface : GpuSurface;
+        pOp->CopyWidthBytes = __CopyWidthBytes;
+        pOp->CopyHeight = __CopyHeight;
+    } 
+    else // Swizzled BLT...
+    {
+        CPU_SWIZZLE_BLT_SURFACE LinearSurface = {0}, SwizzledSurface;
+       uint32_t ZOffset = 0;
+
+        __GMM_ASSERT(GetOffset.Render.Offset64 < pTexInfo->Size);
+        
+        // CpuSwizzleBlt OffsetZ is slice within 3D tile for Yf/Ys volumes, or 
+        // sample index for Yf/Ys MSAA (zero if N/A)...
+        ZOffset = (pTexInfo->Type == RESOURCE_3D &&
+                    (pTexInfo->Flags.Info.TiledYs || pTexInfo->Flags.Info.TiledYf)) ?
+                  (pBlt->Gpu.Slice % pPlatform->TileInfo[pTexInfo->TileMode].LogicalTileDepth) : 
+                  pBlt->Msaa.Sample;
+        
+        if( pTexInfo->Flags.Info.StdSwizzle == TRUE )
+        {
+            SwizzledSurface.pBase = (char *)pBlt->Gpu.pData + GFX_ULONG_CAST( GetOffset.StdLayout.Offset );
+            SwizzledSurface.OffsetX = __OffsetXBytes;
+            SwizzledSurface.OffsetY = __OffsetY;
+            SwizzledSurface.OffsetZ = ZOffset;
+
+            uint32_t MipWidth = GFX_ULONG_CAST( __GmmTexGetMipWidth( pTexInfo, pBlt->Gpu.MipLevel ) );
+            uint32_t MipHeight = __GmmTexGetMipHeight( pTexInfo, pBlt->Gpu.MipLevel );
+
+            pTextureCalc->AlignTexHeightWidth(pTexInfo, &MipHeight, &MipWidth);
+            SwizzledSurface.Height = MipHeight;
+            SwizzledSurface.Pitch = MipWidth * ResPixelPitch;
+        }
+        else
+        {
+            SwizzledSurface.pBase = (char *)pBlt->Gpu.pData + GFX_ULONG_CAST( GetOffset.Render.Offset64 );
+            SwizzledSurface.Pitch = GFX_ULONG_CAST( pTexInfo->Pitch );
+            SwizzledSurface.OffsetX = GetOffset.Render.XOffset + __OffsetXBytes;
+            SwizzledSurface.OffsetY = GetOffset.Render.YOffset + __OffsetY;
+            SwizzledSurface.OffsetZ = GetOffset.Render.ZOffset + ZOffset;
+            SwizzledSurface.Height = GFX_ULONG_CAST( pTexInfo->Size / pTexInfo->Pitch ) / GFX_MAX( pTexInfo->MSAA.NumSamples, 1 ); // Yf/Ys samples share tiles, so Pitch covers single sample's rows.
+        }
+
+        if(pTexInfo == &PlaneSurf[GMM_PLANE_U])
+        {
+            // Redescribed UV plane's rows are addressed from top of Y plane...
+            SwizzledSurface.Height += GFX_ULONG_CAST(Surf.OffsetInfo.Plane.Y[GMM_PLANE_U]);
+        }
+
+        SwizzledSurface.Element.Pitch = ResPixelPitch;
+
+        LinearSurface.pBase = pBlt->Sys.pData;
+        LinearSurface.Pitch = pBlt->Sys.RowPitch;
+        LinearSurface.Height = 
+            pBlt->Sys.BufferSize / 
+            (pBlt->Sys.RowPitch ? 
+                pBlt->Sys.RowPitch : 
+                pBlt->Sys.BufferSize);
+        LinearSurface.Element.Pitch = 
+            pBlt->Sys.PixelPitch ? 
+                pBlt->Sys.PixelPitch : 
+                ResPixelPitch;
+        LinearSurface.Element.Size = 
+            SwizzledSurface.Element.Size = 
+                pBlt->Blt.BytesPerPixel ? 
+                    pBlt->Blt.BytesPerPixel : 
+                    ResPixelPitch;
+
+        LinearSurface.Element.pConvert = SwizzledSurface.Element.pConvert = NULL;
+        if(pBlt->Blt.pConvert) // Whole pixels converted between Sys and resource formats...
+        {
+            __GMM_ASSERT(!pBlt->Blt.BytesPerPixel);
+
+            LinearSurface.Element.Size = LinearSurface.Element.Pitch;
+            SwizzledSurface.Element.Size = ResPixelPitch;
+            if(pBlt->Blt.Upload)
             {
-                __CopyHeight = pBlt->Blt.Height;
+                SwizzledSurface.Element.pConvert = pBlt->Blt.pConvert;
+            }
+            else
+            {
+                LinearSurface.Element.pConvert = pBlt->Blt.pConvert;
             }
-
-            __CopyHeight = GFX_CEIL_DIV(__CopyHeight, BlockHeight);
         }
 
-        __GMM_ASSERT((pBlt->Gpu.OffsetX % BlockWidth) == 0);
-        __OffsetXBytes = (pBlt->Gpu.OffsetX / BlockWidth) * ResPixelPitch + pBlt->Gpu.OffsetSubpixel;
+        SwizzledSurface.pSwizzle = NULL;
 
-        __GMM_ASSERT((pBlt->Gpu.OffsetY % BlockHeight) == 0);
-        __OffsetY = (pBlt->Gpu.OffsetY / BlockHeight);
+        if(     pTexInfo->Flags.Info.TiledW )
+        {
+            SwizzledSurface.pSwizzle = &INTEL_TILE_W;
+
+            // Correct for GMM's 2x Pitch handling of stencil...
+            // (Unlike the HW, CpuSwizzleBlt handles TileW as a natural, 
+            // 64x64=4KB tile, so the pre-Gen10 "double-pitch/half-height" 
+            // kludging to TileY shape must be reversed.)
+            __GMM_ASSERT((SwizzledSurface.Pitch % 2) == 0);
+            SwizzledSurface.Pitch /= 2;
+            SwizzledSurface.Height *= 2;
+
+            __GMM_ASSERT((GetOffset.Render.XOffset % 2) == 0);
+            SwizzledSurface.OffsetX = GetOffset.Render.XOffset / 2 + __OffsetXBytes;
+            SwizzledSurface.OffsetY = GetOffset.Render.YOffset * 2 + __OffsetY;
+        } 
+        else if( pTexInfo->Flags.Info.TiledY && 
+                 !(pTexInfo->Flags.Info.TiledYs ||
+                   pTexInfo->Flags.Info.TiledYf ))
+        {
+            SwizzledSurface.pSwizzle = &INTEL_TILE_Y;
+        } 
+        else if(pTexInfo->Flags.Info.TiledX) 
+        {
+            SwizzledSurface.pSwizzle = &INTEL_TILE_X;
+        } 
+        else // Yf/s...
+        {
+            #define NA
+
+            #define CASE(xD, msaa, kb, bpe)                         \
+                case bpe: SwizzledSurface.pSwizzle = &ST_##xD##_##msaa##kb##_##bpe##bpp; break
+
+            #define SWITCH_BPP(xD, msaa, kb)                        \
+                switch(pTexInfo->BitsPerPixel)             \
+                {                                                   \
+                    CASE(xD, msaa, kb, 8);                          \
+                    CASE(xD, msaa, kb, 16);                         \
+                    CASE(xD, msaa, kb, 32);                         \
+                    CASE(xD, msaa, kb, 64);                         \
+                    CASE(xD, msaa, kb, 128);                        \
+                }
 
-        { // Get pResData Offsets to this subresource...
-            GetOffset.ReqLock = pTexInfo->Flags.Info.Linear;
-            GetOffset.ReqStdLayout = !GetOffset.ReqLock && pTexInfo->Flags.Info.StdSwizzle;
-            GetOffset.ReqRender = !GetOffset.ReqLock && !GetOffset.ReqStdLayout;
-            GetOffset.MipLevel = pBlt->Gpu.MipLevel;
-            switch(pTexInfo->Type) 
+            #define SWITCH_MSAA(xD, kb)                             \
+                switch(pTexInfo->MSAA.NumSamples)          \
+                {                                                   \
+                    case 0:  SWITCH_BPP(xD,        , kb); break;    \
+                    case 1:  SWITCH_BPP(xD,        , kb); break;    \
+                    case 2:  SWITCH_BPP(xD, MSAA2_ , kb); break;    \
+                    case 4:  SWITCH_BPP(xD, MSAA4_ , kb); break;    \
+                    case 8:  SWITCH_BPP(xD, MSAA8_ , kb); break;    \
+                    case 16: SWITCH_BPP(xD, MSAA16_, kb); break;    \
+                }
+
+            if(pTexInfo->Type == RESOURCE_3D) 
             {
-                case RESOURCE_1D:
-                case RESOURCE_2D:
-                case RESOURCE_PRIMARY:
+                if(pTexInfo->Flags.Info.TiledYf) 
                 {
-                    GetOffset.ArrayIndex = pBlt->Gpu.Slice;
-                    break;
-                }
-                case RESOURCE_CUBE:
+                    SWITCH_BPP(3D, , 4KB);
+                } 
+                else if(pTexInfo->Flags.Info.TiledYs) 
                 {
-                    GetOffset.ArrayIndex = pBlt->Gpu.Slice / 6;
-                    GetOffset.CubeFace = (GMM_CUBE_FACE_ENUM)(pBlt->Gpu.Slice % 6);
-                    break;
-                }
-                case RESOURCE_3D:
+                    SWITCH_BPP(3D, , 64KB);
+                } 
+            } 
+            else // 2D/Cube...
+            {
+                if(pTexInfo->Flags.Info.TiledYf) 
                 {
-                    GetOffset.Slice = (pTexInfo->Flags.Info.TiledYs || pTexInfo->Flags.Info.TiledYf) ? 
-                                        (pBlt->Gpu.Slice / pPlatform->TileInfo[pTexInfo->TileMode].LogicalTileDepth) : 
-                                        pBlt->Gpu.Slice;
-                    break;
-                }
-                default: 
-                    __GMM_ASSERT(0);
+                    SWITCH_MSAA(2D, 4KB);
+                } 
+                else if(pTexInfo->Flags.Info.TiledYs) 
+                {
+                    SWITCH_MSAA(2D, 64KB);
+                } 
             }
-
-            REQUIRE(this->GetOffset(GetOffset) == GMM_SUCCESS);
+        }
+        __GMM_ASSERT(SwizzledSurface.pSwizzle);
+
+        { // Cache policy...
+            uint32_t PrefetchBytes;
+
+            CpuBltGetCachePolicy(
+                (uint64_t) __CopyWidthBytes * __CopyHeight, 
+                pBlt->Blt.Upload, 
+                pBlt->Blt.CacheHint, 
+                &SwizzledSurface.Temporal, 
+                &PrefetchBytes);
+
+            LinearSurface.PrefetchRows = // Only the source is prefetched.
+                (pBlt->Blt.Upload && PrefetchBytes && __CopyWidthBytes) ? 
+                    (int) ((PrefetchBytes + __CopyWidthBytes - 1) / __CopyWidthBytes) : 
+                    0;
+            SwizzledSurface.PrefetchRows = 0;
         }
 
-        if(pTexInfo->Flags.Info.Linear) 
-        {
-            char *pDest, *pSrc;
-            uint32_t DestPitch, SrcPitch;
-            uint32_t y;
+        pOp->Dest = pBlt->Blt.Upload ? SwizzledSurface : LinearSurface;
+        pOp->Src = pBlt->Blt.Upload ? LinearSurface : SwizzledSurface;
+        pOp->CopyWidthBytes = __CopyWidthBytes;
+        pOp->CopyHeight = __CopyHeight;
+    }
 
-            __GMM_ASSERT( // Linear-to-linear subpixel BLT unexpected--Not implemented.
-                (!pBlt->Sys.PixelPitch || (pBlt->Sys.PixelPitch == ResPixelPitch)) && 
-                (!pBlt->Blt.BytesPerPixel || (pBlt->Blt.BytesPerPixel == ResPixelPitch)));
+EXIT:
 
-            if(pBlt->Blt.Upload) 
-            {
-                pDest = (char *) pBlt->Gpu.pData;
-                DestPitch = GFX_ULONG_CAST(pTexInfo->Pitch);
+    return Success;
+}
 
-                pSrc = (char *) pBlt->Sys.pData;
-                SrcPitch = pBlt->Sys.RowPitch;
-            } 
-            else 
-            {
-                pDest = (char *) pBlt->Sys.pData;
-                DestPitch = pBlt->Sys.RowPitch;
+/////////////////////////////////////////////////////////////////////////////////////
+/// Performs a copy resolved by CpuBltResolve.
+///
+/// @param[in]  pOp: Resolved copy.
+/// @param[in]  pWorkers: Workers to split swizzled transfers across, or NULL to 
+///                       perform the entire copy on the calling thread.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltExecute(const CPU_BLT_OP *pOp, const GMM_RES_CPU_BLT_WORKERS *pWorkers)
+{
+    CPU_SWIZZLE_BLT_SURFACE Dest, Src;
 
-                pSrc = (char *) pBlt->Gpu.pData;
-                SrcPitch = GFX_ULONG_CAST(pTexInfo->Pitch);
-            }
+    __GMM_ASSERTPTR(pOp, VOIDRETURN);
 
-            __GMM_ASSERT(GetOffset.Lock.Offset < pTexInfo->Size);
-            pDest += GetOffset.Lock.Offset + (__OffsetY * DestPitch + __OffsetXBytes);
+    Dest = pOp->Dest;
+    Src = pOp->Src;
 
-            for(y = 0; y < __CopyHeight; y++) 
-            {
-                // Memcpy per row isn't optimal, but doubt this linear-to-linear path matters.
-
-                #if _WIN32
-                    #ifdef __GMM_KMD__
-                        GFX_MEMCPY_S
-                    #else
-                        memcpy_s
-                    #endif
-                        (pDest, __CopyWidthBytes, pSrc, __CopyWidthBytes);
+    if(!Dest.pSwizzle && !Src.pSwizzle) // Linear-to-linear...
+    {
+        char *pDest = (char *) Dest.pBase + Dest.OffsetY * Dest.Pitch + Dest.OffsetX;
+        char *pSrc = (char *) Src.pBase + Src.OffsetY * Src.Pitch + Src.OffsetX;
+        uint32_t y;
+
+        for(y = 0; y < pOp->CopyHeight; y++) 
+        {
+            // Memcpy per row isn't optimal, but doubt this linear-to-linear path matters.
+
+            #if _WIN32
+                #ifdef __GMM_KMD__
+                    GFX_MEMCPY_S
                 #else
-                    memcpy(pDest, pSrc, __CopyWidthBytes);
+                    memcpy_s
                 #endif
-                pDest += DestPitch;
-                pSrc += SrcPitch;
+                    (pDest, pOp->CopyWidthBytes, pSrc, pOp->CopyWidthBytes);
+            #else
+                memcpy(pDest, pSrc, pOp->CopyWidthBytes);
+            #endif
+            pDest += Dest.Pitch;
+            pSrc += Src.Pitch;
+        }
+    }
+    else // Swizzled...
+    {
+        CPU_BLT_BAND_TASK BandTask;
+
+        BandTask.pDest = &Dest;
+        BandTask.pSrc = &Src;
+        BandTask.CopyWidthBytes = pOp->CopyWidthBytes;
+        BandTask.CopyHeight = pOp->CopyHeight;
+        BandTask.CopyDepth = 0;
+        BandTask.LinearSlicePitch = 0;
+        BandTask.pfnBlt = CpuSwizzleBltSelectKernel(&Dest, &Src); // Specialized kernel, if one covers these surfaces.
+        BandTask.NumBands = CpuBltNumBands(pWorkers, Dest.pSwizzle ? &Dest : &Src, pOp->CopyHeight);
+
+        if(BandTask.NumBands == 1)
+        {
+            BandTask.pfnBlt(&Dest, &Src, pOp->CopyWidthBytes, pOp->CopyHeight);
+        }
+        else
+        {
+            RunCpuBltTasks(pWorkers, BandTask.NumBands, CpuBltBandTask, &BandTask);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Merges a resolved copy into the preceding one when the two rectangles continue 
+/// each other--horizontally (same rows) or vertically (same columns)--in both the 
+/// destination and source surfaces.
+///
+/// @param[in,out] pOp: Preceding copy, extended on success.
+/// @param[in]  pNext: Following copy.
+/// @return     TRUE if pNext was merged into pOp, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltCoalesce(CPU_BLT_OP *pOp, const CPU_BLT_OP *pNext)
+{
+    enum { HORIZONTAL, VERTICAL, NUM_DIRECTIONS };
+    const CPU_SWIZZLE_BLT_SURFACE *pSurf[2][2] = 
+    {
+        { &pOp->Dest, &pNext->Dest },
+        { &pOp->Src,  &pNext->Src  },
+    };
+    BOOLEAN Continues[NUM_DIRECTIONS] = { TRUE, TRUE };
+    int Direction, s;
+
+    Continues[HORIZONTAL] = (pOp->CopyHeight == pNext->CopyHeight);
+    Continues[VERTICAL] = (pOp->CopyWidthBytes == pNext->CopyWidthBytes);
+
+    for(s = 0; s < 2; s++)
+    {
+        const CPU_SWIZZLE_BLT_SURFACE *pA = pSurf[s][0], *pB = pSurf[s][1];
+
+        if( (pA->pSwizzle != pB->pSwizzle) || 
+            (pA->Pitch != pB->Pitch) || 
+            (pA->Element.Pitch != pB->Element.Pitch) || 
+            (pA->Element.Size != pB->Element.Size) || 
+            (pA->Element.Size != pA->Element.Pitch) || // Merging sub-element copies not worth the bookkeeping.
+            (pA->Element.pConvert != pB->Element.pConvert) || 
+            (pA->Temporal != pB->Temporal) || 
+            (pA->PrefetchRows != pB->PrefetchRows))
+        {
+            return FALSE;
+        }
+
+        if(pA->pSwizzle) // Swizzled surface must be same subresource mapping...
+        {
+            if( (pA->pBase != pB->pBase) || 
+                (pA->Height != pB->Height) || 
+                (pA->OffsetZ != pB->OffsetZ))
+            {
+                return FALSE;
             }
-        } 
-        else // Swizzled BLT...
+
+            Continues[HORIZONTAL] = Continues[HORIZONTAL] && 
+                (pB->OffsetY == pA->OffsetY) && 
+                (pB->OffsetX == pA->OffsetX + pOp->CopyWidthBytes);
+            Continues[VERTICAL] = Continues[VERTICAL] && 
+                (pB->OffsetX == pA->OffsetX) && 
+                (pB->OffsetY == pA->OffsetY + pOp->CopyHeight);
+        }
+        else // Linear surfaces may be separately based, so compare addresses...
         {
-            CPU_SWIZZLE_BLT_SURFACE LinearSurface = {0}, SwizzledSurface;
-           uint32_t ZOffset = 0;
+            const char *pStartA = (const char *) pA->pBase + (size_t) pA->OffsetY * pA->Pitch + pA->OffsetX;
+            const char *pStartB = (const char *) pB->pBase + (size_t) pB->OffsetY * pB->Pitch + pB->OffsetX;
 
-            __GMM_ASSERT(GetOffset.Render.Offset64 < pTexInfo->Size);
-            
-            ZOffset = (pTexInfo->Type == RESOURCE_3D &&
-                        (pTexInfo->Flags.Info.TiledYs || pTexInfo->Flags.Info.TiledYf)) ?
-                      (pBlt->Gpu.Slice % pPlatform->TileInfo[pTexInfo->TileMode].LogicalTileDepth) : 0;
-            
-            if( pTexInfo->Flags.Info.StdSwizzle == TRUE )
+            if((const char *) pB->pBase < (const char *) pA->pBase)
+            {
+                return FALSE;
+            }
+
+            Continues[HORIZONTAL] = Continues[HORIZONTAL] && 
+                (pStartB == pStartA + pOp->CopyWidthBytes);
+            Continues[VERTICAL] = Continues[VERTICAL] && 
+                (pStartB == pStartA + (size_t) pOp->CopyHeight * pA->Pitch);
+        }
+    }
+
+    for(Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+    {
+        if(Continues[Direction])
+        {
+            for(s = 0; s < 2; s++)
             {
-                SwizzledSurface.pBase = (char *)pBlt->Gpu.pData + GFX_ULONG_CAST( GetOffset.StdLayout.Offset );
-                SwizzledSurface.OffsetX = __OffsetXBytes;
-                SwizzledSurface.OffsetY = __OffsetY;
-                SwizzledSurface.OffsetZ = ZOffset;
+                CPU_SWIZZLE_BLT_SURFACE *pA = (s == 0) ? &pOp->Dest : &pOp->Src;
+                const CPU_SWIZZLE_BLT_SURFACE *pB = pSurf[s][1];
 
-                uint32_t MipWidth = GFX_ULONG_CAST( __GmmTexGetMipWidth( pTexInfo, pBlt->Gpu.MipLevel ) );
-                uint32_t MipHeight = __GmmTexGetMipHeight( pTexInfo, pBlt->Gpu.MipLevel );
+                if(!pA->pSwizzle) // Extend linear extent to cover pNext's.
+                {
+                    uint32_t BaseRows = GFX_ULONG_CAST(((const char *) pB->pBase - (const char *) pA->pBase) / pA->Pitch);
+
+                    pA->Height = GFX_MAX(pA->Height, BaseRows + pB->Height);
+                }
+            }
 
-                pTextureCalc->AlignTexHeightWidth(pTexInfo, &MipHeight, &MipWidth);
-                SwizzledSurface.Height = MipHeight;
-                SwizzledSurface.Pitch = MipWidth * ResPixelPitch;
+            if(Direction == HORIZONTAL)
+            {
+                pOp->CopyWidthBytes += pNext->CopyWidthBytes;
             }
             else
             {
-                SwizzledSurface.pBase = (char *)pBlt->Gpu.pData + GFX_ULONG_CAST( GetOffset.Render.Offset64 );
-                SwizzledSurface.Pitch = GFX_ULONG_CAST( pTexInfo->Pitch );
-                SwizzledSurface.OffsetX = GetOffset.Render.XOffset + __OffsetXBytes;
-                SwizzledSurface.OffsetY = GetOffset.Render.YOffset + __OffsetY;
-                SwizzledSurface.OffsetZ = GetOffset.Render.ZOffset + ZOffset;
-                SwizzledSurface.Height = GFX_ULONG_CAST( pTexInfo->Size / pTexInfo->Pitch );
+                pOp->CopyHeight += pNext->CopyHeight;
             }
 
-            SwizzledSurface.Element.Pitch = ResPixelPitch;
-
-            LinearSurface.pBase = pBlt->Sys.pData;
-            LinearSurface.Pitch = pBlt->Sys.RowPitch;
-            LinearSurface.Height = 
-                pBlt->Sys.BufferSize / 
-                (pBlt->Sys.RowPitch ? 
-                    pBlt->Sys.RowPitch : 
-                    pBlt->Sys.BufferSize);
-            LinearSurface.Element.Pitch = 
-                pBlt->Sys.PixelPitch ? 
-                    pBlt->Sys.PixelPitch : 
-                    ResPixelPitch;
-            LinearSurface.Element.Size = 
-                SwizzledSurface.Element.Size = 
-                    pBlt->Blt.BytesPerPixel ? 
-                        pBlt->Blt.BytesPerPixel : 
-                        ResPixelPitch;
+            return TRUE;
+        }
+    }
 
-            SwizzledSurface.pSwizzle = NULL;
+    return FALSE;
+}
 
-            if(     pTexInfo->Flags.Info.TiledW )
-            {
-                SwizzledSurface.pSwizzle = &INTEL_TILE_W;
-
-                // Correct for GMM's 2x Pitch handling of stencil...
-                // (Unlike the HW, CpuSwizzleBlt handles TileW as a natural, 
-                // 64x64=4KB tile, so the pre-Gen10 "double-pitch/half-height" 
-                // kludging to TileY shape must be reversed.)
-                __GMM_ASSERT((SwizzledSurface.Pitch % 2) == 0);
-                SwizzledSurface.Pitch /= 2;
-                SwizzledSurface.Height *= 2;
-
-                __GMM_ASSERT((GetOffset.Render.XOffset % 2) == 0);
-                SwizzledSurface.OffsetX = GetOffset.Render.XOffset / 2 + __OffsetXBytes;
-                SwizzledSurface.OffsetY = GetOffset.Render.YOffset * 2 + __OffsetY;
-            } 
-            else if( pTexInfo->Flags.Info.TiledY && 
-                     !(pTexInfo->Flags.Info.TiledYs ||
-                       pTexInfo->Flags.Info.TiledYf ))
+/////////////////////////////////////////////////////////////////////////////////////
+/// Chooses how a CpuBlt accesses the swizzled surface, from the copy's footprint
+/// relative to the CPU cache sizes reported by GmmGetCacheSizes. An upload whose
+/// source and destination together fit in half the LLC uses regular loads/stores,
+/// leaving the result cache-resident for CPU reads that often follow small BLTs.
+/// Downloads always stream: the swizzled source is commonly WC-mapped, where only
+/// MOVNTDQA reads at full speed. Larger uploads stream (MOVNTDQ) too, so as not to
+/// evict the working set, and prefetch their linear source ahead of the transfer--
+/// farther when the source can't even be held by LLC + eDRAM, and so comes from
+/// memory. (The GT L3 isn't a CPU cache, so plays no part.)
+///
+/// @param[in]  FootprintBytes: Bytes copied.
+/// @param[in]  Upload: Nonzero if the swizzled surface is the destination.
+/// @param[in]  Hint: Client override, or GMM_RES_CPU_BLT_CACHE_AUTO.
+/// @param[out] pTemporal: Nonzero for regular loads/stores.
+/// @param[out] pPrefetchBytes: Distance ahead of transfer to prefetch linear source; 0 = None.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltGetCachePolicy(uint64_t FootprintBytes, BOOLEAN Upload, GMM_RES_CPU_BLT_CACHE_HINT Hint, int *pTemporal, uint32_t *pPrefetchBytes)
+{
+    const GMM_CACHE_SIZES &CacheSizes = pGmmGlobalContext->GetCacheSizes();
+    uint64_t LLC;
+
+    __GMM_ASSERTPTR(pTemporal, VOIDRETURN);
+    __GMM_ASSERTPTR(pPrefetchBytes, VOIDRETURN);
+
+    LLC = CacheSizes.TotalLLCCache ? CacheSizes.TotalLLCCache : GMM_CPU_BLT_DEFAULT_LLC;
+
+    if(Hint == GMM_RES_CPU_BLT_CACHE_AUTO)
+    {
+        Hint = 
+            (Upload && (2 * FootprintBytes <= LLC / 2)) ? 
+                GMM_RES_CPU_BLT_CACHE_TEMPORAL : 
+                GMM_RES_CPU_BLT_CACHE_STREAMING;
+    }
+
+    *pTemporal = (Hint == GMM_RES_CPU_BLT_CACHE_TEMPORAL);
+    *pPrefetchBytes = 
+        *pTemporal ? 0 : 
+        (FootprintBytes <= LLC + CacheSizes.TotalEDRAM) ? GMM_CPU_BLT_PREFETCH_BYTES / 2 : 
+        GMM_CPU_BLT_PREFETCH_BYTES;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Prefetches the leading span (up to GMM_CPU_BLT_PREFETCH_BYTES) of a resolved 
+/// copy's linear source, so its cold misses overlap whatever transfer precedes it.
+///
+/// @param[in]  pOp: Resolved copy. (Swizzled sources are left alone--CpuSwizzleBlt 
+///                  already reads those whole tiles sequentially.)
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltPrefetchSource(const CPU_BLT_OP *pOp)
+{
+    __GMM_ASSERTPTR(pOp, VOIDRETURN);
+
+    if(!pOp->Src.pSwizzle)
+    {
+        const char *pRow = 
+            (const char *) pOp->Src.pBase + 
+            (size_t) pOp->Src.OffsetY * pOp->Src.Pitch + 
+            pOp->Src.OffsetX;
+        uint32_t Budget = GMM_CPU_BLT_PREFETCH_BYTES;
+        uint32_t x, y;
+
+        for(y = 0; (y < pOp->CopyHeight) && Budget; y++, pRow += pOp->Src.Pitch)
+        {
+            for(x = 0; (x < pOp->CopyWidthBytes) && Budget; x += 64, Budget -= 64)
             {
-                SwizzledSurface.pSwizzle = &INTEL_TILE_Y;
-            } 
-            else if(pTexInfo->Flags.Info.TiledX) 
+                _mm_prefetch(pRow + x, _MM_HINT_T0);
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Performs and empties the pending copies of a CpuBltBatch. Before each copy, the 
+/// leading span of the next copy's linear source is prefetched, so its cold misses 
+/// (e.g. next subresource of a packed upload) overlap the current transfer.
+///
+/// @param[in,out] pBatch: Batch state.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltFlushBatch(CPU_BLT_BATCH *pBatch)
+{
+    uint32_t i;
+
+    __GMM_ASSERTPTR(pBatch, VOIDRETURN);
+
+    for(i = 0; i < pBatch->NumOps; i++)
+    {
+        if(i + 1 < pBatch->NumOps)
+        {
+            CpuBltPrefetchSource(&pBatch->Op[i + 1]);
+        }
+
+        CpuBltExecute(&pBatch->Op[i], NULL);
+    }
+
+    pBatch->NumOps = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Context and task function for one step of a CpuBltStream pipeline: Task 0 
+/// transfers one band between staging and resource, while task 1 runs the band 
+/// callback of its neighbor.
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct CPU_BLT_STREAM_TASK_REC
+{
+    GmmLib::GmmResourceInfoCommon   *pResource;
+    const GMM_RES_COPY_BLT_STREAM   *pStream;
+    GMM_RES_COPY_BLT                Blt;            // Band transfer, if DoBlt.
+    GMM_RES_COPY_BLT_BAND           Band;           // Band callback, if DoBand.
+    BOOLEAN                         DoBlt, DoBand;
+    BOOLEAN                         BltResult, BandResult;
+} CPU_BLT_STREAM_TASK;
+
+static void GMM_STDCALL CpuBltStreamTask(void *pTaskContext, uint32_t TaskIndex)
+{
+    CPU_BLT_STREAM_TASK *pTask = (CPU_BLT_STREAM_TASK *) pTaskContext;
+
+    if((TaskIndex == 0) && pTask->DoBlt)
+    {
+        pTask->BltResult = pTask->pResource->CpuBlt(&pTask->Blt);
+    }
+    else if((TaskIndex == 1) && pTask->DoBand)
+    {
+        pTask->BandResult = pTask->pStream->pfnBand(pTask->pStream->pContext, &pTask->Band);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Performs a CPU BLT like CpuBlt, but with linear data produced (upload) or 
+/// consumed (download) band-by-band via callback, through fixed-size staging 
+/// memory--so working set is independent of surface size. With two bands of 
+/// staging and pWorkers specified, each band's callback overlaps transfer of 
+/// the neighboring band.
+///
+/// @param[in]  pStream: Describes the streaming blit. See ::GMM_RES_COPY_BLT_STREAM.
+/// @return     TRUE if succeeded, FALSE otherwise (including callback abort)
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltStream(GMM_RES_COPY_BLT_STREAM *pStream)
+{
+    const GMM_PLATFORM_INFO *pPlatform;
+    GMM_TEXTURE_CALC *pTextureCalc;
+    uint32_t BlockWidth, BlockHeight, BlockDepth;
+    uint32_t RowPitch, TileRows, BandRows, NumBuffers, BufferSize;
+    uint32_t Y0, Y1, FirstBand, BandsPerSlice, NumSlices, NumBands;
+    CPU_BLT_STREAM_TASK Task;
+    BOOLEAN Success = TRUE;
+
+    __GMM_ASSERTPTR(pStream, FALSE);
+    __GMM_ASSERTPTR(pStream->pfnBand, FALSE);
+    __GMM_ASSERTPTR(pStream->pStaging, FALSE);
+    __GMM_ASSERT(pStream->Blt.Msaa.Samples <= 1);
+
+    pPlatform = GMM_OVERRIDE_PLATFORM_INFO(&Surf);
+    pTextureCalc = GMM_OVERRIDE_TEXTURE_CALC(&Surf);
+
+    pTextureCalc->GetCompressionBlockDimensions(Surf.Format, &BlockWidth, &BlockHeight, &BlockDepth);
+
+    { // Rows to stream...
+        Y0 = pStream->Blt.Gpu.OffsetY;
+        if(pStream->Blt.Blt.Height)
+        {
+            Y1 = Y0 + pStream->Blt.Blt.Height;
+        }
+        else // i.e. "Full Height"
+        {
+            __GMM_ASSERT(!GmmIsPlanar(Surf.Format)); // As with CpuBlt, planars must specify Blt.Height.
+            Y1 = __GmmTexGetMipHeight(&Surf, pStream->Blt.Gpu.MipLevel);
+            __GMM_ASSERT(Y1 > Y0);
+        }
+    }
+
+    { // Band size: Fit one or two bands in staging, in whole tile rows where possible...
+        RowPitch = pStream->Blt.Sys.RowPitch;
+        __GMM_ASSERT(RowPitch);
+
+        TileRows = Surf.Flags.Info.Linear ? 
+            BlockHeight : 
+            GFX_MAX(pPlatform->TileInfo[Surf.TileMode].LogicalTileHeight, 1) * BlockHeight;
+
+        for(NumBuffers = pStream->pWorkers ? 2 : 1; NumBuffers >= 1; NumBuffers--)
+        {
+            BandRows = (pStream->StagingSize / NumBuffers / GFX_MAX(RowPitch, 1)) * BlockHeight;
+            if(pStream->BandHeight)
             {
-                SwizzledSurface.pSwizzle = &INTEL_TILE_X;
-            } 
-            else // Yf/s...
+                BandRows = GFX_MIN(BandRows, pStream->BandHeight);
+            }
+            if((BandRows >= TileRows) || (NumBuffers == 1))
             {
-                #define NA
-
-                #define CASE(xD, msaa, kb, bpe)                         \
-                    case bpe: SwizzledSurface.pSwizzle = &ST_##xD##_##msaa##kb##_##bpe##bpp; break
-
-                #define SWITCH_BPP(xD, msaa, kb)                        \
-                    switch(pTexInfo->BitsPerPixel)             \
-                    {                                                   \
-                        CASE(xD, msaa, kb, 8);                          \
-                        CASE(xD, msaa, kb, 16);                         \
-                        CASE(xD, msaa, kb, 32);                         \
-                        CASE(xD, msaa, kb, 64);                         \
-                        CASE(xD, msaa, kb, 128);                        \
-                    }
+                break;
+            }
+        }
 
-                #define SWITCH_MSAA(xD, kb)                             \
-                    switch(pTexInfo->MSAA.NumSamples)          \
-                    {                                                   \
-                        case 0:  SWITCH_BPP(xD,        , kb); break;    \
-                        case 1:  SWITCH_BPP(xD,        , kb); break;    \
-                        case 2:  SWITCH_BPP(xD, MSAA2_ , kb); break;    \
-                        case 4:  SWITCH_BPP(xD, MSAA4_ , kb); break;    \
-                        case 8:  SWITCH_BPP(xD, MSAA8_ , kb); break;    \
-                        case 16: SWITCH_BPP(xD, MSAA16_, kb); break;    \
-                    }
+        BandRows = (BandRows >= TileRows) ? 
+            (BandRows - (BandRows % TileRows)) : 
+            (BandRows - (BandRows % BlockHeight));
+        if(!BandRows)
+        {
+            __GMM_ASSERT(0); // Staging can't hold a single row.
+            return FALSE;
+        }
 
-                if(pTexInfo->Type == RESOURCE_3D) 
-                {
-                    if(pTexInfo->Flags.Info.TiledYf) 
-                    {
-                        SWITCH_BPP(3D, , 4KB);
-                    } 
-                    else if(pTexInfo->Flags.Info.TiledYs) 
-                    {
-                        SWITCH_BPP(3D, , 64KB);
-                    } 
-                } 
-                else // 2D/Cube...
-                {
-                    if(pTexInfo->Flags.Info.TiledYf) 
-                    {
-                        SWITCH_MSAA(2D, 4KB);
-                    } 
-                    else if(pTexInfo->Flags.Info.TiledYs) 
-                    {
-                        SWITCH_MSAA(2D, 64KB);
-                    } 
-                }
-            }
-            __GMM_ASSERT(SwizzledSurface.pSwizzle);
+        BufferSize = (BandRows / BlockHeight) * RowPitch;
+    }
+
+    { // Bands are aligned to multiples of BandRows, so (unless staging too small) each covers whole tile rows...
+        FirstBand = Y0 / BandRows;
+        BandsPerSlice = GFX_CEIL_DIV(Y1, BandRows) - FirstBand;
+        NumSlices = GFX_MAX(pStream->Blt.Blt.Slices, 1);
+        NumBands = BandsPerSlice * NumSlices;
+    }
 
-            if(pBlt->Blt.Upload) 
+    Task.pResource = this;
+    Task.pStream = pStream;
+
+    /* Pipeline step s transfers band s and runs callback of band s - 1 (upload: 
+    callback of band s precedes its transfer, so runs at step s with transfer 
+    of band s - 1). With two buffers, both halves of a step run concurrently. */
+
+    for(uint32_t Step = 0; Success && (Step <= NumBands); Step++)
+    {
+        uint32_t BltBand = pStream->Blt.Blt.Upload ? (Step - 1) : Step;
+        uint32_t CallbackBand = pStream->Blt.Blt.Upload ? Step : (Step - 1);
+
+        Task.DoBlt = (BltBand < NumBands);   // (Unsigned, so also excludes "-1".)
+        Task.DoBand = (CallbackBand < NumBands);
+        Task.BltResult = Task.BandResult = TRUE;
+
+        if(Task.DoBlt)
+        {
+            uint32_t Band = (BltBand % BandsPerSlice) + FirstBand;
+            uint32_t BandY0 = GFX_MAX(Y0, Band * BandRows);
+            uint32_t BandY1 = GFX_MIN(Y1, (Band + 1) * BandRows);
+
+            Task.Blt = pStream->Blt;
+            Task.Blt.Gpu.Slice = pStream->Blt.Gpu.Slice + BltBand / BandsPerSlice;
+            Task.Blt.Gpu.OffsetY = BandY0;
+            Task.Blt.Blt.Height = BandY1 - BandY0;
+            Task.Blt.Blt.Slices = 1;
+            Task.Blt.Sys.pData = (char *) pStream->pStaging + (BltBand % NumBuffers) * BufferSize;
+            Task.Blt.Sys.SlicePitch = 0;
+            Task.Blt.Sys.BufferSize = BufferSize;
+        }
+
+        if(Task.DoBand)
+        {
+            uint32_t Band = (CallbackBand % BandsPerSlice) + FirstBand;
+            uint32_t BandY0 = GFX_MAX(Y0, Band * BandRows);
+            uint32_t BandY1 = GFX_MIN(Y1, (Band + 1) * BandRows);
+
+            Task.Band.pData = (char *) pStream->pStaging + (CallbackBand % NumBuffers) * BufferSize;
+            Task.Band.Size = GFX_CEIL_DIV(BandY1 - BandY0, BlockHeight) * RowPitch;
+            Task.Band.Index = CallbackBand;
+            Task.Band.Slice = pStream->Blt.Gpu.Slice + CallbackBand / BandsPerSlice;
+            Task.Band.OffsetY = BandY0;
+            Task.Band.Height = BandY1 - BandY0;
+        }
+
+        if(Task.DoBlt && Task.DoBand && (NumBuffers == 2))
+        {
+            RunCpuBltTasks(pStream->pWorkers, 2, CpuBltStreamTask, &Task);
+        }
+        else // Single buffer (or pipeline fill/drain): Older band first...
+        {
+            if(pStream->Blt.Blt.Upload)
             {
-                CpuSwizzleBlt(&SwizzledSurface, &LinearSurface, __CopyWidthBytes, __CopyHeight);
-            } 
-            else 
+                CpuBltStreamTask(&Task, 0);
+                CpuBltStreamTask(&Task, 1);
+            }
+            else
             {
-                CpuSwizzleBlt(&LinearSurface, &SwizzledSurface, __CopyWidthBytes, __CopyHeight);
+                CpuBltStreamTask(&Task, 1);
+                CpuBltStreamTask(&Task, 0);
             }
         }
+
+        Success = Task.BltResult && Task.BandResult;
     }
 
-EXIT:
+    return Success;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Fills a rectangle of the resource with a repeating byte pattern (e.g. a clear 
+/// color), writing the pattern straight into the tiled layout with non-temporal 
+/// stores--i.e. without reading a source buffer of the pattern.
+///
+/// @param[in]  pFill: Describes the fill operation. See ::GMM_RES_FILL for more info.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuFill(GMM_RES_FILL *pFill)
+{
+    GMM_RES_COPY_BLT Blt = {0};
+    BOOLEAN Success = TRUE;
+    uint32_t Slice, Sample;
+
+    __GMM_ASSERTPTR(pFill, FALSE);
+    __GMM_ASSERTPTR(pFill->Pattern.pData, FALSE);
+
+    if((pFill->Pattern.Size < 1) || (pFill->Pattern.Size > 16))
+    {
+        __GMM_ASSERT(0);
+        return FALSE;
+    }
+
+    // Subresource rectangles resolved as upload BLT's, with no Sys surface...
+    Blt.Gpu.pData = pFill->Gpu.pData;
+    Blt.Gpu.MipLevel = pFill->Gpu.MipLevel;
+    Blt.Gpu.OffsetX = pFill->Gpu.OffsetX;
+    Blt.Gpu.OffsetY = pFill->Gpu.OffsetY;
+    Blt.Sys.RowPitch = 1;
+    Blt.Blt.Width = pFill->Fill.Width;
+    Blt.Blt.Height = pFill->Fill.Height;
+    Blt.Blt.Upload = TRUE;
+
+    for(Slice = pFill->Gpu.Slice; 
+        Slice < (pFill->Gpu.Slice + GFX_MAX(pFill->Fill.Slices, 1)); 
+        Slice++)
+    {
+        for(Sample = pFill->Gpu.MsaaSample; 
+            Sample < (pFill->Gpu.MsaaSample + GFX_MAX(pFill->Fill.MsaaSamples, 1)); 
+            Sample++)
+        {
+            CPU_BLT_OP Op;
+
+            Blt.Gpu.Slice = Slice;
+            Blt.Msaa.Sample = Sample;
+
+            if(CpuBltResolve(&Blt, &Op, NULL))
+            {
+                CpuSwizzleFill(&Op.Dest, pFill->Pattern.pData, pFill->Pattern.Size, Op.CopyWidthBytes, Op.CopyHeight);
+            }
+            else
+            {
+                Success = FALSE;
+            }
+        }
+    }
 
     return Success;
 }
@@ -0,0 +1,328 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#include "Internal/Common/GmmLibInc.h"
+
+typedef enum
+{
+    DIRTY_TILES_MARK,
+    DIRTY_TILES_FLUSH,
+    DIRTY_TILES_CLEAR,
+} DIRTY_TILES_ACTION;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns log2 of the number of set bits of a swizzle mask--i.e. log2 of the tile 
+/// dimension the mask describes.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t SwizzleMaskBits(int Mask)
+{
+    uint32_t Bits = 0;
+
+    for(; Mask; Mask &= Mask - 1)
+    {
+        Bits++;
+    }
+
+    return Bits;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Sets or clears a tile's dirty bit, maintaining the dirty count.
+/////////////////////////////////////////////////////////////////////////////////////
+static void SetDirtyBit(GMM_RES_DIRTY_TILES *pDirty, GMM_GFX_SIZE_T Tile, BOOLEAN Dirty)
+{
+    uint32_t *pWord = &pDirty->pBits[Tile / 32];
+    uint32_t Bit = 1u << (Tile % 32);
+
+    __GMM_ASSERT(Tile < pDirty->NumTiles);
+
+    if(Dirty && !(*pWord & Bit))
+    {
+        *pWord |= Bit;
+        pDirty->NumDirty++;
+    }
+    else if(!Dirty && (*pWord & Bit))
+    {
+        *pWord &= ~Bit;
+        pDirty->NumDirty--;
+    }
+}
+
+#define IS_DIRTY(pDirty, Tile) ((pDirty)->pBits[(Tile) / 32] & (1u << ((Tile) % 32)))
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Visits the tiles touched by one resolved single-subresource upload rectangle: 
+/// Marks or clears their dirty bits, or transfers the portions of the rectangle 
+/// lying in dirty tiles (merging horizontal runs of dirty tiles into one transfer).
+///
+/// @param[in,out] pDirty: Dirty-tile tracker.
+/// @param[in]  Action: Operation to perform on touched tiles.
+/// @param[in]  pResBase: Resource base address the resolved surfaces are relative to.
+/// @param[in]  pDest: Resolved resource surface.
+/// @param[in]  pSrc: Resolved linear surface (DIRTY_TILES_FLUSH only).
+/// @param[in]  WidthBytes: Width of rectangle in bytes.
+/// @param[in]  Height: Height of rectangle in rows.
+/////////////////////////////////////////////////////////////////////////////////////
+static void WalkDirtyTiles(GMM_RES_DIRTY_TILES *pDirty, DIRTY_TILES_ACTION Action, const void *pResBase, 
+                           const CPU_SWIZZLE_BLT_SURFACE *pDest, const CPU_SWIZZLE_BLT_SURFACE *pSrc, 
+                           uint32_t WidthBytes, uint32_t Height)
+{
+    GMM_GFX_SIZE_T Base = (GMM_GFX_SIZE_T)((const char *) pDest->pBase - (const char *) pResBase);
+
+    if(!WidthBytes || !Height)
+    {
+        return;
+    }
+
+    if(pDest->pSwizzle) // Tiles...
+    {
+        uint32_t WidthBits = SwizzleMaskBits(pDest->pSwizzle->Mask.x);
+        uint32_t HeightBits = SwizzleMaskBits(pDest->pSwizzle->Mask.y);
+        uint32_t SizeBits = WidthBits + HeightBits + SwizzleMaskBits(pDest->pSwizzle->Mask.z);
+        uint32_t TilesPerRow = pDest->Pitch >> WidthBits;
+        uint32_t x0 = pDest->OffsetX >> WidthBits, x1 = (pDest->OffsetX + WidthBytes - 1) >> WidthBits;
+        uint32_t y0 = pDest->OffsetY >> HeightBits, y1 = (pDest->OffsetY + Height - 1) >> HeightBits;
+        uint32_t tx, ty;
+
+        __GMM_ASSERT((1u << SizeBits) == pDirty->TileSize);
+
+        #define TILE_INDEX(tx, ty) ((Base + ((GMM_GFX_SIZE_T)((ty) * TilesPerRow + (tx)) << SizeBits)) >> SizeBits)
+
+        for(ty = y0; ty <= y1; ty++)
+        {
+            for(tx = x0; tx <= x1; )
+            {
+                if(Action != DIRTY_TILES_FLUSH)
+                {
+                    SetDirtyBit(pDirty, TILE_INDEX(tx, ty), Action == DIRTY_TILES_MARK);
+                    tx++;
+                }
+                else if(!IS_DIRTY(pDirty, TILE_INDEX(tx, ty)))
+                {
+                    tx++;
+                }
+                else // Transfer run of dirty tiles, clipped to rectangle...
+                {
+                    CPU_SWIZZLE_BLT_SURFACE RunDest = *pDest, RunSrc = *pSrc;
+                    uint32_t RunX0, RunX1, RunY0, RunY1, txEnd = tx;
+
+                    while((txEnd < x1) && IS_DIRTY(pDirty, TILE_INDEX(txEnd + 1, ty))) txEnd++;
+
+                    RunX0 = GFX_MAX(tx << WidthBits, (uint32_t) pDest->OffsetX);
+                    RunX1 = GFX_MIN((txEnd + 1) << WidthBits, pDest->OffsetX + WidthBytes);
+                    RunY0 = GFX_MAX(ty << HeightBits, (uint32_t) pDest->OffsetY);
+                    RunY1 = GFX_MIN((ty + 1) << HeightBits, pDest->OffsetY + Height);
+
+                    RunDest.OffsetX = RunX0;
+                    RunDest.OffsetY = RunY0;
+                    RunSrc.OffsetX += RunX0 - pDest->OffsetX;
+                    RunSrc.OffsetY += RunY0 - pDest->OffsetY;
+
+                    CpuSwizzleBlt(&RunDest, &RunSrc, RunX1 - RunX0, RunY1 - RunY0);
+
+                    tx = txEnd + 1;
+                }
+            }
+        }
+
+        #undef TILE_INDEX
+    }
+    else // Linear: 4KB pages...
+    {
+        uint32_t y;
+
+        for(y = 0; y < Height; y++)
+        {
+            GMM_GFX_SIZE_T Row = Base + (GMM_GFX_SIZE_T)(pDest->OffsetY + y) * pDest->Pitch;
+            GMM_GFX_SIZE_T Start = Row + pDest->OffsetX, End = Start + WidthBytes;
+            GMM_GFX_SIZE_T Page;
+
+            for(Page = Start / pDirty->TileSize; Page <= (End - 1) / pDirty->TileSize; Page++)
+            {
+                if(Action != DIRTY_TILES_FLUSH)
+                {
+                    SetDirtyBit(pDirty, Page, Action == DIRTY_TILES_MARK);
+                }
+                else if(IS_DIRTY(pDirty, Page))
+                {
+                    GMM_GFX_SIZE_T From = GFX_MAX(Start, Page * pDirty->TileSize);
+                    GMM_GFX_SIZE_T To = GFX_MIN(End, (Page + 1) * pDirty->TileSize);
+
+                    memcpy(
+                        (char *) pResBase + From, 
+                        (const char *) pSrc->pBase + (pSrc->OffsetY + y) * pSrc->Pitch + pSrc->OffsetX + (From - Start), 
+                        GFX_ULONG_CAST(To - From));
+                }
+            }
+        }
+    }
+}
+
+#undef IS_DIRTY
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Initializes a dirty-tile tracker for the resource, with no tiles dirty. Tiles 
+/// are numbered in memory order, as by GetTileHashes.
+///
+/// @param[in,out] pDirty: On input, pBits and NumTiles describe the bitmap--or pBits 
+///                     NULL to only query NumTiles and TileSize. On output, 
+///                     NumTiles and TileSize describe the resource's tiles. See 
+///                     ::GMM_RES_DIRTY_TILES.
+/// @return     TRUE if succeeded, FALSE otherwise (including bitmap too small)
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::InitDirtyTiles(GMM_RES_DIRTY_TILES *pDirty)
+{
+    uint32_t TileSize, NumTiles;
+
+    __GMM_ASSERTPTR(pDirty, FALSE);
+
+    TileSize = Surf.Flags.Info.TiledYs ? GMM_KBYTE(64) : GMM_KBYTE(4);
+    NumTiles = GFX_ULONG_CAST(GFX_CEIL_DIV(Surf.Size, TileSize));
+
+    if(pDirty->pBits)
+    {
+        if(pDirty->NumTiles < NumTiles)
+        {
+            __GMM_ASSERT(0);
+            return FALSE;
+        }
+        memset(pDirty->pBits, 0, GFX_CEIL_DIV(NumTiles, 32) * sizeof(uint32_t));
+    }
+
+    pDirty->NumTiles = NumTiles;
+    pDirty->TileSize = TileSize;
+    pDirty->NumDirty = 0;
+
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Marks the tiles touched by a rectangle of the resource as dirty.
+///
+/// @param[in,out] pDirty: Tracker initialized by InitDirtyTiles.
+/// @param[in]  pRect: Rectangle, as the Gpu, Blt (Width, Height, Slices) and
+///                    Msaa members of an upload. Sys members are ignored.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::MarkDirtyTiles(GMM_RES_DIRTY_TILES *pDirty, const GMM_RES_COPY_BLT *pRect)
+{
+    GMM_RES_COPY_BLT Blt;
+
+    __GMM_ASSERTPTR(pRect, FALSE);
+
+    Blt = *pRect;
+    Blt.Sys.pData = NULL;
+    Blt.Sys.RowPitch = 1; // No Sys surface--resolving resource side only.
+    Blt.Sys.SlicePitch = Blt.Msaa.SamplePitch = Blt.Sys.BufferSize = 0;
+    Blt.Blt.Upload = TRUE;
+
+    return DirtyTilesOp(pDirty, &Blt, DIRTY_TILES_MARK);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Uploads only the dirty-tile portions of full-image upload BLTs, then marks the 
+/// tiles touched by the BLTs clean. So e.g. a client keeping a linear copy of a 
+/// streaming texture marks each frame's updated rectangles, then flushes with 
+/// whole-subresource BLTs from its copy--paying only for the tiles that changed.
+///
+/// @param[in,out] pDirty: Tracker initialized by InitDirtyTiles.
+/// @param[in]  pBlts: Array of upload BLTs. See ::GMM_RES_COPY_BLT for more info. 
+///                    Pixel-pitch, partial-pixel, and conversion BLTs not supported.
+/// @param[in]  NumBlts: Number of elements in pBlts.
+/// @return     TRUE if all succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::FlushDirtyTiles(GMM_RES_DIRTY_TILES *pDirty, GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts)
+{
+    BOOLEAN Success = TRUE;
+    uint32_t i;
+
+    __GMM_ASSERTPTR((pBlts || !NumBlts), FALSE);
+
+    for(i = 0; i < NumBlts; i++)
+    {
+        if( !pBlts[i].Blt.Upload || 
+            (pBlts[i].Sys.PixelPitch && (pBlts[i].Sys.PixelPitch != Surf.BitsPerPixel / CHAR_BIT)) || 
+            pBlts[i].Blt.BytesPerPixel || 
+            pBlts[i].Blt.pConvert)
+        {
+            __GMM_ASSERT(0);
+            Success = FALSE;
+            continue;
+        }
+
+        Success = DirtyTilesOp(pDirty, &pBlts[i], DIRTY_TILES_FLUSH) && Success;
+    }
+
+    // Clean only after all transfers, since tiles may be shared (e.g. mip tail)...
+    for(i = 0; i < NumBlts; i++)
+    {
+        DirtyTilesOp(pDirty, &pBlts[i], DIRTY_TILES_CLEAR);
+    }
+
+    return Success;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Implements MarkDirtyTiles and FlushDirtyTiles: Resolves each subresource of 
+/// an upload BLT and visits its tiles.
+///
+/// @param[in,out] pDirty: Dirty-tile tracker.
+/// @param[in]  pBlt: Upload BLT, or rectangle to mark.
+/// @param[in]  Action: DIRTY_TILES_ACTION to perform on touched tiles.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::DirtyTilesOp(GMM_RES_DIRTY_TILES *pDirty, const GMM_RES_COPY_BLT *pBlt, uint32_t Action)
+{
+    GMM_RES_COPY_BLT SubBlt = *pBlt;
+    BOOLEAN Success = TRUE;
+    uint32_t Slice, Sample;
+
+    __GMM_ASSERTPTR((pDirty && pDirty->pBits), FALSE);
+
+    SubBlt.Blt.Slices = SubBlt.Msaa.Samples = 1;
+
+    for(Slice = 0; Slice < GFX_MAX(pBlt->Blt.Slices, 1); Slice++)
+    {
+        for(Sample = 0; Sample < GFX_MAX(pBlt->Msaa.Samples, 1); Sample++)
+        {
+            uint32_t SysOffset = Slice * pBlt->Sys.SlicePitch + Sample * pBlt->Msaa.SamplePitch;
+            CPU_BLT_OP Op;
+
+            SubBlt.Gpu.Slice = pBlt->Gpu.Slice + Slice;
+            SubBlt.Msaa.Sample = pBlt->Msaa.Sample + Sample;
+            SubBlt.Sys.pData = pBlt->Sys.pData ? (char *) pBlt->Sys.pData + SysOffset : NULL;
+            SubBlt.Sys.BufferSize = pBlt->Sys.BufferSize ? pBlt->Sys.BufferSize - SysOffset : 0;
+
+            if(CpuBltResolve(&SubBlt, &Op, NULL))
+            {
+                WalkDirtyTiles(pDirty, (DIRTY_TILES_ACTION) Action, pBlt->Gpu.pData, &Op.Dest, &Op.Src, Op.CopyWidthBytes, Op.CopyHeight);
+            }
+            else
+            {
+                Success = FALSE;
+            }
+        }
+    }
+
+    return Success;
+}
@@ -0,0 +1,161 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#include "Internal/Common/GmmLibInc.h"
+
+#if(!defined(_WIN32) && !defined(__GMM_KMD__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define GMM_FILE_BLT_BATCH_SIZE 64
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Uploads all subresources of the resource from a file holding their linear 
+/// images back-to-back. The file is memory-mapped and swizzled straight from the 
+/// page cache into the resource (no read() into staging), with subresources 
+/// visited in file order and the mapping advised as sequential, so readahead 
+/// stays ahead of the swizzle.
+///
+/// @param[in]  pFileBlt: Describes the file and its layout. See ::GMM_RES_FILE_BLT.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltFromFile(const GMM_RES_FILE_BLT *pFileBlt)
+{
+#if(!defined(_WIN32) && !defined(__GMM_KMD__))
+    // I/O failures (missing or truncated file, etc.) are runtime conditions the
+    // caller must handle, so fail without asserting...
+    #define REQUIRE(e)          \
+        if(!(e))                \
+        {                       \
+            Success = FALSE;    \
+            goto EXIT;          \
+        }
+
+    GMM_RES_COPY_BLT Blts[GMM_FILE_BLT_BATCH_SIZE];
+    CPU_BLT_PACKED_LAYOUT Layout;
+    uint32_t NumBlts = 0;
+    uint64_t PayloadSize = 0, Offset = 0;
+    uint64_t MapOffset = 0, MapLength = 0;
+    char *pMap = (char *) MAP_FAILED;
+    int Fd = -1;
+    BOOLEAN Success = TRUE;
+
+    __GMM_ASSERTPTR(pFileBlt, FALSE);
+    __GMM_ASSERTPTR(pFileBlt->pGpuData, FALSE);
+    __GMM_ASSERT(!GmmIsPlanar(Surf.Format)); // Planar subresources have no single linear image.
+
+    REQUIRE(CpuBltGetPackedLayout(pFileBlt->Layout, pFileBlt->RowAlignment, pFileBlt->MipLevels, pFileBlt->ArraySize, &Layout)); // (Asserts on bad layout itself.)
+    PayloadSize = Layout.PayloadSize;
+
+    { // Map payload...
+        struct stat Stat;
+        uint64_t PageSize = (uint64_t) sysconf(_SC_PAGESIZE);
+
+        Fd = pFileBlt->pFileName ? open(pFileBlt->pFileName, O_RDONLY | O_CLOEXEC) : pFileBlt->FileDescriptor;
+        REQUIRE(Fd >= 0);
+        REQUIRE(fstat(Fd, &Stat) == 0);
+        REQUIRE( // Payload within file (without overflowing FileOffset + PayloadSize)...
+            (pFileBlt->FileOffset <= (uint64_t) Stat.st_size) && 
+            (PayloadSize <= (uint64_t) Stat.st_size - pFileBlt->FileOffset));
+
+        MapOffset = pFileBlt->FileOffset & ~(PageSize - 1);
+        MapLength = pFileBlt->FileOffset - MapOffset + PayloadSize;
+        pMap = (char *) mmap(NULL, MapLength, PROT_READ, MAP_PRIVATE, Fd, (off_t) MapOffset);
+        REQUIRE(pMap != (char *) MAP_FAILED);
+
+        madvise(pMap, MapLength, MADV_SEQUENTIAL); // Advisory--failure harmless.
+    }
+
+    { // Upload subresources in file order...
+        const char *pPayload = pMap + (pFileBlt->FileOffset - MapOffset);
+        uint32_t Outer, Inner;
+        uint32_t NumOuter = (pFileBlt->Layout == GMM_RES_FILE_LAYOUT_MIP_MAJOR) ? Layout.MipLevels : Layout.ArraySize;
+        uint32_t NumInner = (pFileBlt->Layout == GMM_RES_FILE_LAYOUT_MIP_MAJOR) ? Layout.ArraySize : Layout.MipLevels;
+
+        for(Outer = 0; Outer < NumOuter; Outer++)
+        {
+            for(Inner = 0; Inner < NumInner; Inner++)
+            {
+                uint32_t Mip = (pFileBlt->Layout == GMM_RES_FILE_LAYOUT_MIP_MAJOR) ? Outer : Inner;
+                uint32_t Slice = (pFileBlt->Layout == GMM_RES_FILE_LAYOUT_MIP_MAJOR) ? Inner : Outer;
+                GMM_RES_COPY_BLT *pBlt = &Blts[NumBlts++];
+
+                memset(pBlt, 0, sizeof(*pBlt));
+                pBlt->Gpu.pData = pFileBlt->pGpuData;
+                pBlt->Gpu.MipLevel = Mip;
+                pBlt->Gpu.Slice = Slice;
+                pBlt->Sys.pData = (void *)(pPayload + Offset);
+                pBlt->Sys.RowPitch = Layout.RowPitch[Mip];
+                pBlt->Sys.BufferSize = GFX_ULONG_CAST(GFX_MIN(PayloadSize - Offset, (uint64_t) 0xffffffff));
+                pBlt->Blt.Upload = TRUE;
+                if(Surf.Type == RESOURCE_3D) // Depth slices of mip contiguous in file...
+                {
+                    pBlt->Blt.Slices = __GmmTexGetMipDepth(&Surf, Mip);
+                    pBlt->Sys.SlicePitch = GFX_ULONG_CAST(Layout.MipSize[Mip] / pBlt->Blt.Slices);
+                }
+
+                Offset += Layout.MipSize[Mip];
+
+                if(NumBlts == GMM_FILE_BLT_BATCH_SIZE)
+                {
+                    Success = CpuBltBatch(Blts, NumBlts) && Success;
+                    NumBlts = 0;
+                }
+            }
+
+            if(pFileBlt->Layout == GMM_RES_FILE_LAYOUT_SLICE_MAJOR) // Done with slice's pages...
+            {
+                uint64_t Done = (pFileBlt->FileOffset - MapOffset + Offset) & ~((uint64_t) sysconf(_SC_PAGESIZE) - 1);
+
+                Success = CpuBltBatch(Blts, NumBlts) && Success;
+                NumBlts = 0;
+                madvise(pMap, Done, MADV_DONTNEED);
+            }
+        }
+
+        Success = CpuBltBatch(Blts, NumBlts) && Success;
+    }
+
+EXIT:
+
+    if(pMap != (char *) MAP_FAILED)
+    {
+        munmap(pMap, MapLength);
+    }
+    if(pFileBlt->pFileName && (Fd >= 0))
+    {
+        close(Fd);
+    }
+
+    return Success;
+
+    #undef REQUIRE
+#else
+    GMM_UNREFERENCED_PARAMETER(pFileBlt);
+    __GMM_ASSERT(0); // Not yet implemented for this platform.
+    return FALSE;
+#endif
+}
@@ -0,0 +1,245 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#include "Internal/Common/GmmLibInc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Computes the linear layout of the resource's subresources (or a leading subset 
+/// of its mips/slices) packed back-to-back in the given order.
+///
+/// @param[in]  Order: Order of subresources. See ::GMM_RES_FILE_LAYOUT.
+/// @param[in]  RowAlignment: Alignment, in bytes, of each row's start; 0 = 1 = "Tightly packed".
+/// @param[in]  MipLevels: Number of mips packed; 0 = "All mips of resource".
+/// @param[in]  ArraySize: Number of array slices (or cube faces) packed; 0 = "All of resource".
+/// @param[out] pLayout: Receives the layout.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltGetPackedLayout(GMM_RES_FILE_LAYOUT Order, uint32_t RowAlignment, uint32_t MipLevels, uint32_t ArraySize, CPU_BLT_PACKED_LAYOUT *pLayout)
+{
+    GMM_TEXTURE_CALC *pTextureCalc;
+    uint32_t BlockWidth, BlockHeight, BlockDepth;
+    uint32_t ResArraySize = 
+        (Surf.Type == RESOURCE_3D) ? 1 : 
+        (Surf.Type == RESOURCE_CUBE) ? GFX_MAX(Surf.ArraySize, 1) * 6 : 
+        GFX_MAX(Surf.ArraySize, 1);
+
+    __GMM_ASSERTPTR(pLayout, FALSE);
+
+    pTextureCalc = GMM_OVERRIDE_TEXTURE_CALC(&Surf);
+    pTextureCalc->GetCompressionBlockDimensions(Surf.Format, &BlockWidth, &BlockHeight, &BlockDepth);
+
+    memset(pLayout, 0, sizeof(*pLayout));
+    pLayout->Order = Order;
+    pLayout->MipLevels = MipLevels ? MipLevels : (Surf.MaxLod + 1);
+    pLayout->ArraySize = ArraySize ? ArraySize : ResArraySize;
+
+    if((pLayout->MipLevels > Surf.MaxLod + 1) || 
+       (pLayout->MipLevels > GMM_MAX_MIPMAP) || 
+       (pLayout->ArraySize > ResArraySize))
+    {
+        __GMM_ASSERT(0);
+        return FALSE;
+    }
+
+    for(uint32_t Mip = 0; Mip < pLayout->MipLevels; Mip++)
+    {
+        uint32_t Width = GFX_ULONG_CAST(__GmmTexGetMipWidth(&Surf, Mip));
+        uint32_t Height = __GmmTexGetMipHeight(&Surf, Mip);
+        uint32_t Depth = (Surf.Type == RESOURCE_3D) ? __GmmTexGetMipDepth(&Surf, Mip) : 1;
+
+        pLayout->RowPitch[Mip] = GFX_CEIL_DIV(Width, BlockWidth) * (Surf.BitsPerPixel / CHAR_BIT);
+        if(RowAlignment > 1)
+        {
+            pLayout->RowPitch[Mip] = GFX_CEIL_DIV(pLayout->RowPitch[Mip], RowAlignment) * RowAlignment;
+        }
+        pLayout->MipSize[Mip] = (uint64_t) pLayout->RowPitch[Mip] * GFX_CEIL_DIV(Height, BlockHeight) * Depth;
+        pLayout->MipOffset[Mip] = pLayout->SliceSize;
+        pLayout->SliceSize += pLayout->MipSize[Mip];
+    }
+
+    pLayout->PayloadSize = pLayout->SliceSize * pLayout->ArraySize;
+
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Transfers all subresources of the resource to/from a buffer holding their 
+/// linear images back-to-back (slice-major or mip-major), in one call.
+///
+/// Where array slices of a mip differ only by a whole number of rows (i.e. 
+/// non-3D, non-MSAA resources whose ArrayQPitch is a multiple of the pitch), each 
+/// mip is resolved (GetOffset, etc.) once, and its other slices derived by QPitch 
+/// rather than re-resolved. Mips packed into a Yf/Ys mip tail share a tile per 
+/// slice, so in mip-major buffers the tail LODs are visited slice by slice--each 
+/// slice's tail tile filled in one visit--rather than strided across all slices.
+/// Copies are batched, and each copy's source span prefetched while the preceding 
+/// one transfers (see CpuBltFlushBatch).
+///
+/// @param[in]  pSubresourcesBlt: Describes the buffer and its layout. See ::GMM_RES_SUBRESOURCES_BLT.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltAllSubresources(const GMM_RES_SUBRESOURCES_BLT *pSubresourcesBlt)
+{
+    #define REQUIRE(e)          \
+        if(!(e))                \
+        {                       \
+            __GMM_ASSERT(0);    \
+            Success = FALSE;    \
+            goto EXIT;          \
+        }
+
+    CPU_BLT_PACKED_LAYOUT Layout;
+    CPU_BLT_BATCH Batch;
+    CPU_BLT_OP MipOp[GMM_MAX_MIPMAP];  // Resolved slice-0 copy of each mip (when deriving slices).
+    uint32_t ResolvedMips = 0;
+    uint32_t TailLod, NumSubresources, i;
+    uint32_t QPitchRows = 0;
+    BOOLEAN DeriveSlices;
+    BOOLEAN Success = TRUE;
+
+    __GMM_ASSERTPTR(pSubresourcesBlt, FALSE);
+    __GMM_ASSERTPTR(pSubresourcesBlt->pGpuData, FALSE);
+    __GMM_ASSERTPTR(pSubresourcesBlt->pSysData, FALSE);
+    __GMM_ASSERT(!GmmIsPlanar(Surf.Format)); // Planar subresources have no single linear image.
+
+    Batch.NumOps = 0;
+    Batch.Success = TRUE;
+    memset(&Batch.OffsetCache, 0, sizeof(Batch.OffsetCache));
+
+    REQUIRE(CpuBltGetPackedLayout(
+        pSubresourcesBlt->Layout, 
+        pSubresourcesBlt->RowAlignment, 
+        pSubresourcesBlt->MipLevels, 
+        pSubresourcesBlt->ArraySize, 
+        &Layout));
+    REQUIRE(Layout.PayloadSize <= pSubresourcesBlt->SysBufferSize);
+
+    { // Can slices be derived from slice 0 of their mip?
+        GMM_GFX_SIZE_T QPitch = 
+            Surf.Flags.Info.Linear ? 
+                Surf.OffsetInfo.Texture2DOffsetInfo.ArrayQPitchLock : 
+                Surf.OffsetInfo.Texture2DOffsetInfo.ArrayQPitchRender;
+
+        DeriveSlices = 
+            (Layout.ArraySize > 1) && 
+            (Surf.Type != RESOURCE_3D) && 
+            (Surf.MSAA.NumSamples <= 1) && 
+            !Surf.Flags.Info.StdSwizzle && 
+            !Surf.Flags.Info.TiledW && // Halved QPitch, and CpuBltResolve's W-as-Y row doubling, don't match QPitch / Pitch.
+            !Surf.Flags.Gpu.S3d && 
+            Surf.Pitch && 
+            !(QPitch % Surf.Pitch);
+
+        QPitchRows = DeriveSlices ? GFX_ULONG_CAST(QPitch / Surf.Pitch) : 0;
+    }
+
+    TailLod = 
+        (Surf.Flags.Info.TiledYf || Surf.Flags.Info.TiledYs) ? 
+            GFX_MIN(Surf.Alignment.MipTailStartLod, Layout.MipLevels) : 
+            Layout.MipLevels;
+
+    NumSubresources = Layout.MipLevels * Layout.ArraySize;
+    for(i = 0; i < NumSubresources; i++)
+    {
+        GMM_RES_COPY_BLT Blt;
+        uint32_t Mip, Slice;
+        uint64_t SysOffset;
+
+        // Visit order...
+        if(Layout.Order == GMM_RES_FILE_LAYOUT_SLICE_MAJOR)
+        {
+            Slice = i / Layout.MipLevels;
+            Mip = i % Layout.MipLevels;
+        }
+        else if(i < TailLod * Layout.ArraySize) // Mip-major, above tail...
+        {
+            Mip = i / Layout.ArraySize;
+            Slice = i % Layout.ArraySize;
+        }
+        else // Mip-major, tail LODs grouped per slice...
+        {
+            uint32_t TailIndex = i - TailLod * Layout.ArraySize;
+            uint32_t TailLods = Layout.MipLevels - TailLod;
+
+            Slice = TailIndex / TailLods;
+            Mip = TailLod + TailIndex % TailLods;
+        }
+
+        SysOffset = 
+            (Layout.Order == GMM_RES_FILE_LAYOUT_SLICE_MAJOR) ? 
+                Slice * Layout.SliceSize + Layout.MipOffset[Mip] : 
+                Layout.MipOffset[Mip] * Layout.ArraySize + Slice * Layout.MipSize[Mip];
+
+        memset(&Blt, 0, sizeof(Blt));
+        Blt.Gpu.pData = pSubresourcesBlt->pGpuData;
+        Blt.Gpu.MipLevel = Mip;
+        Blt.Gpu.Slice = DeriveSlices ? 0 : Slice;
+        Blt.Sys.pData = (char *) pSubresourcesBlt->pSysData + SysOffset;
+        Blt.Sys.RowPitch = Layout.RowPitch[Mip];
+        Blt.Sys.BufferSize = GFX_ULONG_CAST(GFX_MIN(pSubresourcesBlt->SysBufferSize - SysOffset, (uint64_t) 0xffffffff));
+        Blt.Blt.Upload = pSubresourcesBlt->Upload;
+        if(Surf.Type == RESOURCE_3D) // Depth slices of mip contiguous in buffer...
+        {
+            Blt.Blt.Slices = __GmmTexGetMipDepth(&Surf, Mip);
+            Blt.Sys.SlicePitch = GFX_ULONG_CAST(Layout.MipSize[Mip] / Blt.Blt.Slices);
+        }
+
+        if(!DeriveSlices)
+        {
+            CpuBltOnWorkers(&Blt, NULL, &Batch);
+        }
+        else
+        {
+            CPU_BLT_OP Op;
+            CPU_SWIZZLE_BLT_SURFACE *pGpuSurface = Blt.Blt.Upload ? &Op.Dest : &Op.Src;
+            CPU_SWIZZLE_BLT_SURFACE *pSysSurface = Blt.Blt.Upload ? &Op.Src : &Op.Dest;
+
+            if(!(ResolvedMips & (1 << Mip)))
+            {
+                REQUIRE(CpuBltResolve(&Blt, &MipOp[Mip], &Batch.OffsetCache));
+                ResolvedMips |= (1 << Mip);
+            }
+
+            Op = MipOp[Mip];
+            pGpuSurface->OffsetY += Slice * QPitchRows;
+            pSysSurface->pBase = Blt.Sys.pData;
+            pSysSurface->Height = Blt.Sys.BufferSize / Blt.Sys.RowPitch;
+
+            if(!Batch.NumOps || 
+               !CpuBltCoalesce(&Batch.Op[Batch.NumOps - 1], &Op))
+            {
+                if(Batch.NumOps == GMM_CPU_BLT_BATCH_MAX_OPS)
+                {
+                    CpuBltFlushBatch(&Batch);
+                }
+                Batch.Op[Batch.NumOps++] = Op;
+            }
+        }
+    }
+
+EXIT:
+
+    CpuBltFlushBatch(&Batch);
+
+    return Success && Batch.Success;
+
+    #undef REQUIRE
+}
@@ -0,0 +1,248 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#include "Internal/Common/GmmLibInc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Transfers a whole planar YUV frame to/from separate linear images of its planes 
+/// in one call--e.g. an NV12/P010 decode target's Y and interleaved UV planes.
+///
+/// Each plane is resolved against its own surface description (for redescribed 
+/// UV-packed planes, the PlaneSurf[] of that plane, so callers need not split the 
+/// frame at the U-plane boundary) and gets its own swizzle kernel. Swizzled planes 
+/// are then transferred in tile-row bands, interleaved plane by plane, with the 
+/// linear source of each band prefetched before the preceding band is stored--so 
+/// the streaming stores to one plane overlap the loads for the next.
+///
+/// YV12/I420 chroma planes are linear arrays without respect to the resource's 
+/// pitch (see FillPlanarOffsetAddress), so those formats are only supported on 
+/// linear resources.
+///
+/// @param[in]  pPlanarBlt: Describes the frame and its plane images. See ::GMM_RES_PLANAR_BLT.
+/// @return     TRUE if succeeded, FALSE otherwise
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::CpuBltPlanar(const GMM_RES_PLANAR_BLT *pPlanarBlt)
+{
+    #define REQUIRE(e)          \
+        if(!(e))                \
+        {                       \
+            __GMM_ASSERT(0);    \
+            Success = FALSE;    \
+            goto EXIT;          \
+        }
+
+    typedef struct CPU_BLT_PLANE_OP_REC
+    {
+        CPU_BLT_OP          Op;
+        PFN_CPU_SWIZZLE_BLT pfnBlt;     // NULL for linear-to-linear copies.
+    } CPU_BLT_PLANE_OP;
+
+    CPU_BLT_PLANE_OP PlaneOp[GMM_MAX_PLANE], Pending, Band;
+    uint32_t NumPlaneOps = 0, NumBands = 1;
+    uint32_t Width, Height, ChromaWidth, ChromaHeight, BytesPerSample;
+    uint32_t LastPlane, Plane, b, i;
+    BOOLEAN UVPacked, LinearChroma = FALSE;
+    BOOLEAN HavePending = FALSE;
+    BOOLEAN Success = TRUE;
+
+    __GMM_ASSERTPTR(pPlanarBlt, FALSE);
+    __GMM_ASSERTPTR(pPlanarBlt->pGpuData, FALSE);
+
+    Width = pPlanarBlt->Width ? pPlanarBlt->Width : GFX_ULONG_CAST(Surf.BaseWidth);
+    Height = pPlanarBlt->Height ? pPlanarBlt->Height : Surf.BaseHeight;
+    BytesPerSample = Surf.BitsPerPixel / CHAR_BIT;
+
+    REQUIRE((Width <= Surf.BaseWidth) && (Height <= Surf.BaseHeight));
+
+    switch(Surf.Format)
+    {
+        case GMM_FORMAT_NV12:
+        case GMM_FORMAT_NV21:
+        case GMM_FORMAT_P010:
+        case GMM_FORMAT_P012:
+        case GMM_FORMAT_P016:
+            UVPacked = TRUE;
+            ChromaWidth = GFX_CEIL_DIV(Width, 2);
+            ChromaHeight = GFX_CEIL_DIV(Height, 2);
+            break;
+        case GMM_FORMAT_P208:
+            UVPacked = TRUE;
+            ChromaWidth = GFX_CEIL_DIV(Width, 2);
+            ChromaHeight = Height;
+            break;
+        case GMM_FORMAT_YV12:
+        case GMM_FORMAT_I420:
+        case GMM_FORMAT_IYUV:
+            LinearChroma = TRUE;
+            // Fall through...
+        case GMM_FORMAT_IMC1:
+        case GMM_FORMAT_IMC3:
+            UVPacked = FALSE;
+            ChromaWidth = GFX_CEIL_DIV(Width, 2);
+            ChromaHeight = GFX_CEIL_DIV(Height, 2);
+            break;
+        default:
+            __GMM_ASSERT(0); // Unsupported planar format.
+            return FALSE;
+    }
+
+    REQUIRE(!Surf.Flags.Info.YUVShaderFriendlyLayout);
+    REQUIRE(!LinearChroma || Surf.Flags.Info.Linear);
+
+    LastPlane = UVPacked ? GMM_PLANE_U : GMM_PLANE_V;
+    for(Plane = GMM_PLANE_Y; Plane <= LastPlane; Plane++)
+    {
+        CPU_BLT_PLANE_OP *pPlaneOp = &PlaneOp[NumPlaneOps];
+        uint32_t PlaneWidthBytes, PlaneHeight;
+
+        if(!pPlanarBlt->Sys[Plane].pData)
+        {
+            continue;
+        }
+
+        PlaneWidthBytes = 
+            (Plane == GMM_PLANE_Y) ? Width * BytesPerSample : 
+            UVPacked ? ChromaWidth * 2 * BytesPerSample : 
+            ChromaWidth * BytesPerSample;
+        PlaneHeight = (Plane == GMM_PLANE_Y) ? Height : ChromaHeight;
+
+        REQUIRE(pPlanarBlt->Sys[Plane].RowPitch >= PlaneWidthBytes);
+
+        if(LinearChroma && (Plane != GMM_PLANE_Y))
+        {
+            // Chroma rows are packed at half the resource pitch, starting at the 
+            // plane's (X, Y) in the resource's pitch...
+            CPU_SWIZZLE_BLT_SURFACE Gpu = {0}, Sys = {0};
+
+            Gpu.pBase = 
+                (char *) pPlanarBlt->pGpuData + 
+                GFX_ULONG_CAST(Surf.OffsetInfo.Plane.Y[Plane]) * GFX_ULONG_CAST(Surf.Pitch) + 
+                GFX_ULONG_CAST(Surf.OffsetInfo.Plane.X[Plane]);
+            Gpu.Pitch = GFX_ULONG_CAST(Surf.Pitch) / 2;
+            Gpu.Height = PlaneHeight;
+            Gpu.Element.Pitch = Gpu.Element.Size = 1;
+
+            Sys.pBase = pPlanarBlt->Sys[Plane].pData;
+            Sys.Pitch = pPlanarBlt->Sys[Plane].RowPitch;
+            Sys.Height = PlaneHeight;
+            Sys.Element.Pitch = Sys.Element.Size = 1;
+
+            pPlaneOp->Op.Dest = pPlanarBlt->Upload ? Gpu : Sys;
+            pPlaneOp->Op.Src = pPlanarBlt->Upload ? Sys : Gpu;
+            pPlaneOp->Op.CopyWidthBytes = PlaneWidthBytes;
+            pPlaneOp->Op.CopyHeight = PlaneHeight;
+        }
+        else
+        {
+            GMM_RES_COPY_BLT Blt = {0};
+            const GMM_TEXTURE_INFO *pTexInfo = 
+                (Surf.Flags.Info.RedecribedPlanes && UVPacked) ? &PlaneSurf[Plane] : &Surf;
+            uint32_t PixelPitch = pTexInfo->BitsPerPixel / CHAR_BIT;
+
+            __GMM_ASSERT((PlaneWidthBytes % PixelPitch) == 0);
+
+            Blt.Gpu.pData = pPlanarBlt->pGpuData;
+            Blt.Gpu.OffsetX = GFX_ULONG_CAST(Surf.OffsetInfo.Plane.X[Plane]) / PixelPitch;
+            Blt.Gpu.OffsetY = GFX_ULONG_CAST(Surf.OffsetInfo.Plane.Y[Plane]);
+            Blt.Sys.pData = pPlanarBlt->Sys[Plane].pData;
+            Blt.Sys.RowPitch = pPlanarBlt->Sys[Plane].RowPitch;
+            Blt.Sys.BufferSize = pPlanarBlt->Sys[Plane].RowPitch * PlaneHeight;
+            Blt.Blt.Width = PlaneWidthBytes / PixelPitch;
+            Blt.Blt.Height = PlaneHeight;
+            Blt.Blt.Upload = pPlanarBlt->Upload;
+
+            REQUIRE(CpuBltResolve(&Blt, &pPlaneOp->Op, NULL));
+        }
+
+        pPlaneOp->pfnBlt = NULL;
+        if(pPlaneOp->Op.Dest.pSwizzle || pPlaneOp->Op.Src.pSwizzle)
+        {
+            const CPU_SWIZZLE_BLT_SURFACE *pSwizzled = 
+                pPlaneOp->Op.Dest.pSwizzle ? &pPlaneOp->Op.Dest : &pPlaneOp->Op.Src;
+
+            pPlaneOp->pfnBlt = CpuSwizzleBltSelectKernel(&pPlaneOp->Op.Dest, &pPlaneOp->Op.Src);
+            NumBands = GFX_MAX(NumBands, (uint32_t) CpuSwizzleBltTileRows(pSwizzled, pPlaneOp->Op.CopyHeight));
+        }
+
+        NumPlaneOps++;
+    }
+
+    // Planes not needing a swizzle go first, each prefetching the next plane...
+    for(i = 0; i < NumPlaneOps; i++)
+    {
+        if(!PlaneOp[i].pfnBlt)
+        {
+            if(i + 1 < NumPlaneOps)
+            {
+                CpuBltPrefetchSource(&PlaneOp[i + 1].Op);
+            }
+
+            CpuBltExecute(&PlaneOp[i].Op, NULL);
+        }
+    }
+
+    // ...then swizzled planes, band by band. Each band's source is prefetched 
+    // before the preceding (pending) band is performed.
+    for(b = 0; b < NumBands; b++)
+    {
+        for(i = 0; i < NumPlaneOps; i++)
+        {
+            int FirstRow, Rows;
+
+            if(!PlaneOp[i].pfnBlt)
+            {
+                continue;
+            }
+
+            Band = PlaneOp[i];
+            Rows = CpuSwizzleBltBandRows(
+                Band.Op.Dest.pSwizzle ? &Band.Op.Dest : &Band.Op.Src, 
+                Band.Op.CopyHeight, (int) b, (int) NumBands, &FirstRow);
+            if(!Rows)
+            {
+                continue;
+            }
+
+            Band.Op.Dest.OffsetY += FirstRow;
+            Band.Op.Src.OffsetY += FirstRow;
+            Band.Op.CopyHeight = Rows;
+
+            CpuBltPrefetchSource(&Band.Op);
+
+            if(HavePending)
+            {
+                Pending.pfnBlt(&Pending.Op.Dest, &Pending.Op.Src, Pending.Op.CopyWidthBytes, Pending.Op.CopyHeight);
+            }
+
+            Pending = Band;
+            HavePending = TRUE;
+        }
+    }
+
+    if(HavePending)
+    {
+        Pending.pfnBlt(&Pending.Op.Dest, &Pending.Op.Src, Pending.Op.CopyWidthBytes, Pending.Op.CopyHeight);
+    }
+
+EXIT:
+
+    return Success;
+}
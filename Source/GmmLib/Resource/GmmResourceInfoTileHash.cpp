@@ -0,0 +1,236 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+
+#include "Internal/Common/GmmLibInc.h"
+
+#include <nmmintrin.h> // SSE4.2: CRC32
+
+#if(defined(__GNUC__) || defined(__clang__))
+    #define TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+    #define TARGET_SSE42
+#endif
+
+#if(defined(_M_X64) || defined(__x86_64__))
+    #define CRC32_QWORD(Crc, Qword) _mm_crc32_u64((Crc), (Qword))
+#else // 32-bit: Same CRC, a dword at a time.
+    #define CRC32_QWORD(Crc, Qword) \
+        _mm_crc32_u32(_mm_crc32_u32((uint32_t)(Crc), (uint32_t)(Qword)), (uint32_t)((Qword) >> 32))
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Software CRC32C (bit at a time) of a byte run--for CPUs without SSE4.2.
+///
+/// @param[in]  Crc: Running CRC.
+/// @param[in]  pData: Pointer to data.
+/// @param[in]  Size: Size of data in bytes.
+/// @return     Updated CRC
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t Crc32c(uint32_t Crc, const void *pData, uint32_t Size)
+{
+    const uint8_t *pByte = (const uint8_t *) pData;
+    uint32_t i, Bit;
+
+    for(i = 0; i < Size; i++)
+    {
+        Crc ^= pByte[i];
+        for(Bit = 0; Bit < 8; Bit++)
+        {
+            Crc = (Crc >> 1) ^ (0x82f63b78 & (0 - (Crc & 1)));
+        }
+    }
+
+    return Crc;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Hashes one tile: Four interleaved CRC32C lanes (one per quarter of the tile, 
+/// so the instruction's latency is hidden), folded into a single CRC32C.
+///
+/// @param[in]  pTile: Pointer to tile data.
+/// @param[in]  Size: Size of tile data in bytes.
+/// @return     Hash of tile
+/////////////////////////////////////////////////////////////////////////////////////
+TARGET_SSE42 static uint32_t HashTileSse42(const void *pTile, uint32_t Size)
+{
+    const uint64_t *pQword = (const uint64_t *) pTile;
+    const uint8_t *pByte;
+    uint32_t LaneQwords = Size / (4 * sizeof(uint64_t));
+    uint64_t Crc0 = ~0ull, Crc1 = ~0ull, Crc2 = ~0ull, Crc3 = ~0ull;
+    uint32_t Hash, i;
+
+    for(i = 0; i < LaneQwords; i++)
+    {
+        Crc0 = CRC32_QWORD(Crc0, pQword[i]);
+        Crc1 = CRC32_QWORD(Crc1, pQword[LaneQwords + i]);
+        Crc2 = CRC32_QWORD(Crc2, pQword[2 * LaneQwords + i]);
+        Crc3 = CRC32_QWORD(Crc3, pQword[3 * LaneQwords + i]);
+    }
+
+    // Tail (partial final page of linear resource)...
+    for(pByte = (const uint8_t *) &pQword[4 * LaneQwords]; pByte < (const uint8_t *) pTile + Size; pByte++)
+    {
+        Crc3 = _mm_crc32_u8((uint32_t) Crc3, *pByte);
+    }
+
+    Hash = _mm_crc32_u32((uint32_t) Crc0, (uint32_t) Crc1);
+    Hash = _mm_crc32_u32(Hash, (uint32_t) Crc2);
+    Hash = _mm_crc32_u32(Hash, (uint32_t) Crc3);
+
+    return ~Hash;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Hashes one tile as HashTileSse42 does (same lanes, same hash), using SSE4.2 
+/// CRC32 where the CPU has it and software CRC32C otherwise.
+///
+/// @param[in]  pTile: Pointer to tile data.
+/// @param[in]  Size: Size of tile data in bytes.
+/// @return     Hash of tile
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t HashTile(const void *pTile, uint32_t Size)
+{
+    const char *pLane = (const char *) pTile;
+    uint32_t LaneBytes = (Size / (4 * sizeof(uint64_t))) * sizeof(uint64_t);
+    uint32_t Crc0, Crc1, Crc2, Crc3, Hash;
+
+    if(CpuSwizzleBltCpuFeatures() & CPU_SWIZZLE_BLT_FEATURE_CRC32)
+    {
+        return HashTileSse42(pTile, Size);
+    }
+
+    Crc0 = Crc32c(~0u, pLane, LaneBytes);
+    Crc1 = Crc32c(~0u, pLane + LaneBytes, LaneBytes);
+    Crc2 = Crc32c(~0u, pLane + 2 * LaneBytes, LaneBytes);
+    Crc3 = Crc32c(~0u, pLane + 3 * LaneBytes, Size - 3 * LaneBytes); // Including tail.
+
+    Hash = Crc32c(Crc0, &Crc1, sizeof(Crc1)); // Little-endian, as CRC32 r32.
+    Hash = Crc32c(Hash, &Crc2, sizeof(Crc2));
+    Hash = Crc32c(Hash, &Crc3, sizeof(Crc3));
+
+    return ~Hash;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Computes a hash of each tile of the resource's main surface, directly over its 
+/// tiled memory (i.e. without detiling). Tiles are hashed in memory order, so tile 
+/// i covers surface bytes [i * TileSize, (i + 1) * TileSize). Comparing maps of two 
+/// snapshots with DiffTileHashes then identifies the tiles that need to be checked 
+/// or read back.
+///
+/// @param[in]  pData: Pointer to base of the mapped resource data.
+/// @param[in,out] pTileHashes: On input, pHashes and NumTiles describe the hash 
+///                     array--or pHashes NULL to only query NumTiles and TileSize. 
+///                     On output, NumTiles and TileSize describe the resource's 
+///                     tiles. See ::GMM_RES_TILE_HASHES.
+/// @return     TRUE if succeeded, FALSE otherwise (including array too small)
+/////////////////////////////////////////////////////////////////////////////////////
+BOOLEAN GMM_STDCALL GmmLib::GmmResourceInfoCommon::GetTileHashes(const void *pData, GMM_RES_TILE_HASHES *pTileHashes)
+{
+    GMM_GFX_SIZE_T Offset;
+    uint32_t TileSize, NumTiles, Tile;
+
+    __GMM_ASSERTPTR(pTileHashes, FALSE);
+
+    // Linear resources hashed in 4KB pages...
+    TileSize = Surf.Flags.Info.TiledYs ? GMM_KBYTE(64) : GMM_KBYTE(4);
+    NumTiles = GFX_ULONG_CAST(GFX_CEIL_DIV(Surf.Size, TileSize));
+
+    if(pTileHashes->pHashes)
+    {
+        __GMM_ASSERTPTR(pData, FALSE);
+        if(pTileHashes->NumTiles < NumTiles)
+        {
+            __GMM_ASSERT(0);
+            return FALSE;
+        }
+
+        for(Tile = 0, Offset = 0; Tile < NumTiles; Tile++, Offset += TileSize)
+        {
+            pTileHashes->pHashes[Tile] = 
+                HashTile((const char *) pData + Offset, GFX_ULONG_CAST(GFX_MIN(TileSize, Surf.Size - Offset)));
+        }
+    }
+
+    pTileHashes->NumTiles = NumTiles;
+    pTileHashes->TileSize = TileSize;
+
+    return TRUE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Compares two tile-hash maps (e.g. of successive snapshots of a resource) and 
+/// reports the tiles whose hashes differ. Matching runs are skipped four hashes at 
+/// a time.
+///
+/// @param[in]  pOld: Earlier map.
+/// @param[in]  pNew: Later map, of same resource layout as pOld.
+/// @param[out] pChangedTiles: NULL, or array receiving indices of changed tiles, 
+///                     in increasing order.
+/// @param[in]  MaxChangedTiles: Number of elements at pChangedTiles.
+/// @return     Number of changed tiles (which may exceed MaxChangedTiles)
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::GmmResourceInfoCommon::DiffTileHashes(const GMM_RES_TILE_HASHES *pOld, const GMM_RES_TILE_HASHES *pNew, uint32_t *pChangedTiles, uint32_t MaxChangedTiles)
+{
+    uint32_t NumTiles, NumChanged = 0, Tile = 0;
+
+    __GMM_ASSERTPTR((pOld && pOld->pHashes), 0);
+    __GMM_ASSERTPTR((pNew && pNew->pHashes), 0);
+    __GMM_ASSERT((pOld->NumTiles == pNew->NumTiles) && (pOld->TileSize == pNew->TileSize));
+
+    NumTiles = GFX_MIN(pOld->NumTiles, pNew->NumTiles);
+
+    #define REPORT(Index)                                   \
+        {                                                   \
+            if(pChangedTiles && (NumChanged < MaxChangedTiles)) \
+            {                                               \
+                pChangedTiles[NumChanged] = (Index);        \
+            }                                               \
+            NumChanged++;                                   \
+        }
+
+    for(; Tile + 4 <= NumTiles; Tile += 4)
+    {
+        __m128i Equal = _mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i *) &pOld->pHashes[Tile]), 
+            _mm_loadu_si128((const __m128i *) &pNew->pHashes[Tile]));
+        int Mask = _mm_movemask_ps(_mm_castsi128_ps(Equal));
+
+        if(Mask != 0xf)
+        {
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                if(!(Mask & (1 << i))) REPORT(Tile + i);
+            }
+        }
+    }
+
+    for(; Tile < NumTiles; Tile++)
+    {
+        if(pOld->pHashes[Tile] != pNew->pHashes[Tile]) REPORT(Tile);
+    }
+
+    #undef REPORT
+
+    return NumChanged;
+}
@@ -0,0 +1,959 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#include "GmmHeapULT.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// CTestGmmHeap Constructor
+///
+/////////////////////////////////////////////////////////////////////////////////////
+CTestGmmHeap::CTestGmmHeap()
+{
+
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// CTestGmmHeap Destructor
+///
+/////////////////////////////////////////////////////////////////////////////////////
+CTestGmmHeap::~CTestGmmHeap()
+{
+
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Orders test nodes by Key, as the heap orders its free blocks by address/size.
+/////////////////////////////////////////////////////////////////////////////////////
+int CTestGmmHeap::CompareNodes(const GMM_HEAP_TREE_LINK *pA, const GMM_HEAP_TREE_LINK *pB)
+{
+    uint64_t KeyA = GMM_HEAP_TREE_ENTRY(pA, TEST_HEAP_TREE_NODE, Link)->Key;
+    uint64_t KeyB = GMM_HEAP_TREE_ENTRY(pB, TEST_HEAP_TREE_NODE, Link)->Key;
+
+    return (KeyA < KeyB) ? -1 : (KeyA > KeyB);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Checks parent links, cached heights and AVL balance of a subtree.
+///
+/// @param[in]  pTree: Tree being checked
+/// @param[in]  pLink: Root of subtree
+/// @return     Height of subtree
+/////////////////////////////////////////////////////////////////////////////////////
+int CTestGmmHeap::VerifySubtree(const GMM_HEAP_TREE *pTree, const GMM_HEAP_TREE_LINK *pLink)
+{
+    int LeftHeight, RightHeight;
+
+    if(!pLink)
+    {
+        return 0;
+    }
+
+    if(pLink->pLeft)
+    {
+        EXPECT_EQ(pLink, pLink->pLeft->pParent);
+        EXPECT_LE(pTree->pfnCompare(pLink->pLeft, pLink), 0);
+    }
+    if(pLink->pRight)
+    {
+        EXPECT_EQ(pLink, pLink->pRight->pParent);
+        EXPECT_GE(pTree->pfnCompare(pLink->pRight, pLink), 0);
+    }
+
+    LeftHeight  = VerifySubtree(pTree, pLink->pLeft);
+    RightHeight = VerifySubtree(pTree, pLink->pRight);
+
+    EXPECT_LE(abs(LeftHeight - RightHeight), 1);
+    EXPECT_EQ(1 + max(LeftHeight, RightHeight), pLink->Height);
+
+    return pLink->Height;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Checks tree structure, and that in-order walks both ways visit NumNodes
+/// nodes in sorted order.
+///
+/// @param[in]  pTree: Tree being checked
+/// @param[in]  NumNodes: Expected node count
+/////////////////////////////////////////////////////////////////////////////////////
+void CTestGmmHeap::VerifyTree(const GMM_HEAP_TREE *pTree, size_t NumNodes)
+{
+    const GMM_HEAP_TREE_LINK *pLink, *pPrevLink;
+    size_t                   Count;
+
+    if(pTree->pRoot)
+    {
+        EXPECT_EQ(NULL, pTree->pRoot->pParent);
+    }
+    VerifySubtree(pTree, pTree->pRoot);
+
+    for(Count = 0, pPrevLink = NULL, pLink = __GmmHeapTreeFirst(pTree); pLink; pPrevLink = pLink, pLink = __GmmHeapTreeNext(pLink), Count++)
+    {
+        if(pPrevLink)
+        {
+            EXPECT_LE(pTree->pfnCompare(pPrevLink, pLink), 0);
+        }
+    }
+    EXPECT_EQ(NumNodes, Count);
+
+    for(Count = 0, pLink = __GmmHeapTreeLast(pTree); pLink; pLink = __GmmHeapTreePrev(pLink))
+    {
+        Count++;
+    }
+    EXPECT_EQ(NumNodes, Count);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies heap free-block index stays a sorted, balanced tree through random
+/// inserts (with duplicate keys, as in the by-size index) and removes.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapTreeInsertRemove)
+{
+    const size_t                NumNodes = 2000;
+    vector<TEST_HEAP_TREE_NODE> Nodes(NumNodes);
+    vector<size_t>              Order(NumNodes);
+    GMM_HEAP_TREE               Tree;
+    mt19937                     Rng(0x6d6d47);
+
+    __GmmHeapTreeInit(&Tree, CompareNodes);
+    VerifyTree(&Tree, 0);
+
+    for(size_t i = 0; i < NumNodes; i++)
+    {
+        Nodes[i].Key = Rng() % (NumNodes / 2);
+        Order[i]     = i;
+        __GmmHeapTreeInsert(&Tree, &Nodes[i].Link);
+    }
+    VerifyTree(&Tree, NumNodes);
+
+    // AVL bound: height < 1.44 * log2(n + 2).
+    EXPECT_LT(Tree.pRoot->Height, 1.44 * log2(NumNodes + 2.0));
+
+    shuffle(Order.begin(), Order.end(), Rng);
+    for(size_t i = 0; i < NumNodes; i++)
+    {
+        __GmmHeapTreeRemove(&Tree, &Nodes[Order[i]].Link);
+        if((i % 97) == 0)
+        {
+            VerifyTree(&Tree, NumNodes - i - 1);
+        }
+    }
+    EXPECT_EQ(NULL, Tree.pRoot);
+
+    // Ascending inserts--worst case for an unbalanced tree.
+    for(size_t i = 0; i < NumNodes; i++)
+    {
+        Nodes[i].Key = i;
+        __GmmHeapTreeInsert(&Tree, &Nodes[i].Link);
+    }
+    VerifyTree(&Tree, NumNodes);
+    EXPECT_LT(Tree.pRoot->Height, 1.44 * log2(NumNodes + 2.0));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies LowerBound/Prev lookups used for best-fit and neighbor searches.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapTreeLowerBound)
+{
+    const uint64_t              NumNodes = 64;
+    vector<TEST_HEAP_TREE_NODE> Nodes(NumNodes);
+    TEST_HEAP_TREE_NODE         Key;
+    GMM_HEAP_TREE               Tree;
+    GMM_HEAP_TREE_LINK          *pLink;
+
+    __GmmHeapTreeInit(&Tree, CompareNodes);
+
+    // Keys 10, 20, ... inserted in scrambled order.
+    for(uint64_t i = 0; i < NumNodes; i++)
+    {
+        Nodes[i].Key = ((i * 37) % NumNodes + 1) * 10;
+        __GmmHeapTreeInsert(&Tree, &Nodes[i].Link);
+    }
+    VerifyTree(&Tree, NumNodes);
+
+    for(Key.Key = 0; Key.Key <= (NumNodes + 1) * 10; Key.Key++)
+    {
+        uint64_t Expected = ((Key.Key + 9) / 10) * 10;
+
+        pLink = __GmmHeapTreeLowerBound(&Tree, &Key.Link);
+        if(Expected == 0)
+        {
+            Expected = 10;
+        }
+
+        if(Expected > NumNodes * 10)
+        {
+            EXPECT_EQ(NULL, pLink);
+            EXPECT_EQ(NumNodes * 10, GMM_HEAP_TREE_ENTRY(__GmmHeapTreeLast(&Tree), TEST_HEAP_TREE_NODE, Link)->Key);
+        }
+        else
+        {
+            ASSERT_TRUE(pLink != NULL);
+            EXPECT_EQ(Expected, GMM_HEAP_TREE_ENTRY(pLink, TEST_HEAP_TREE_NODE, Link)->Key);
+
+            pLink = __GmmHeapTreePrev(pLink);
+            if(Expected == 10)
+            {
+                EXPECT_EQ(NULL, pLink);
+            }
+            else
+            {
+                ASSERT_TRUE(pLink != NULL);
+                EXPECT_EQ(Expected - 10, GMM_HEAP_TREE_ENTRY(pLink, TEST_HEAP_TREE_NODE, Link)->Key);
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies buddy allocator: a non-power-of-two range is tiled by the largest
+/// aligned blocks; random allocations are size-aligned and never overlap;
+/// invalid and double frees are rejected; and freeing everything merges the
+/// blocks back.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapBuddyAllocFree)
+{
+    const uint64_t                      MinBlockSize = 4096, NumBlocks = 1000; // 512 + 256 + 128 + 64 + 32 + 8.
+    vector<pair<uint64_t, uint32_t>>    Blocks;
+    vector<bool>                        Used(NumBlocks);
+    mt19937                             Rng(0x4275);
+    GMM_HEAP_BUDDY                      Buddy;
+    uint64_t                            Offset;
+
+    EXPECT_FALSE(__GmmHeapBuddyInit(&Buddy, NumBlocks * MinBlockSize, MinBlockSize + 1));
+    ASSERT_TRUE(__GmmHeapBuddyInit(&Buddy, NumBlocks * MinBlockSize + 123, MinBlockSize));
+    EXPECT_EQ(9u, Buddy.MaxOrder);
+    EXPECT_EQ(0x3e8u, Buddy.OrderMask);
+
+    EXPECT_EQ(0u, __GmmHeapBuddyOrder(&Buddy, 1));
+    EXPECT_EQ(0u, __GmmHeapBuddyOrder(&Buddy, MinBlockSize));
+    EXPECT_EQ(2u, __GmmHeapBuddyOrder(&Buddy, 3 * MinBlockSize));
+    EXPECT_EQ(9u, __GmmHeapBuddyOrder(&Buddy, 512 * MinBlockSize));
+    EXPECT_LT(Buddy.MaxOrder, __GmmHeapBuddyOrder(&Buddy, 0));
+    EXPECT_LT(Buddy.MaxOrder, __GmmHeapBuddyOrder(&Buddy, 512 * MinBlockSize + 1));
+
+    // Smallest free block split: order 3 block at 992 gives order 0 block 992.
+    ASSERT_TRUE(__GmmHeapBuddyAlloc(&Buddy, 0, &Offset));
+    EXPECT_EQ(992 * MinBlockSize, Offset);
+    EXPECT_FALSE(__GmmHeapBuddyFree(&Buddy, Offset + MinBlockSize, 0));   // Not allocated.
+    EXPECT_FALSE(__GmmHeapBuddyFree(&Buddy, Offset, 1));                  // Wrong order.
+    EXPECT_FALSE(__GmmHeapBuddyFree(&Buddy, MinBlockSize / 2, 0));        // Unaligned.
+    EXPECT_FALSE(__GmmHeapBuddyFree(&Buddy, NumBlocks * MinBlockSize, 0));// Out of range.
+    EXPECT_TRUE(__GmmHeapBuddyFree(&Buddy, Offset, 0));
+    EXPECT_FALSE(__GmmHeapBuddyFree(&Buddy, Offset, 0));                  // Double free.
+    EXPECT_EQ(0x3e8u, Buddy.OrderMask);
+
+    for(int i = 0; i < 20000; i++)
+    {
+        if((Rng() % 2) || Blocks.empty())
+        {
+            uint32_t Order = Rng() % 6;
+
+            if(!__GmmHeapBuddyAlloc(&Buddy, Order, &Offset))
+            {
+                continue;
+            }
+            ASSERT_EQ(0u, Offset % (MinBlockSize << Order));
+            ASSERT_LE(Offset / MinBlockSize + (1ull << Order), NumBlocks);
+            for(uint64_t b = Offset / MinBlockSize; b < Offset / MinBlockSize + (1ull << Order); b++)
+            {
+                ASSERT_FALSE(Used[b]);
+                Used[b] = true;
+            }
+            Blocks.push_back(make_pair(Offset, Order));
+        }
+        else
+        {
+            size_t j = Rng() % Blocks.size();
+
+            for(uint64_t b = Blocks[j].first / MinBlockSize; b < Blocks[j].first / MinBlockSize + (1ull << Blocks[j].second); b++)
+            {
+                Used[b] = false;
+            }
+            ASSERT_TRUE(__GmmHeapBuddyFree(&Buddy, Blocks[j].first, Blocks[j].second));
+            Blocks[j] = Blocks.back();
+            Blocks.pop_back();
+        }
+    }
+
+    for(size_t j = 0; j < Blocks.size(); j++)
+    {
+        ASSERT_TRUE(__GmmHeapBuddyFree(&Buddy, Blocks[j].first, Blocks[j].second));
+    }
+    EXPECT_EQ(0x3e8u, Buddy.OrderMask);
+    ASSERT_TRUE(__GmmHeapBuddyAlloc(&Buddy, 9, &Offset));
+    EXPECT_EQ(0u, Offset);
+
+    __GmmHeapBuddyDestroy(&Buddy);
+    EXPECT_EQ(NULL, Buddy.pStorage);
+}
+
+#ifndef _WIN32
+#define TEST_HEAP_BASE  0x100000000ull
+#define TEST_HEAP_PAGE  GMM_KBYTE(4)
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Checks a heap's free list against its free block index, FreeSize and
+/// stats: blocks sorted, non-adjacent (fully coalesced), all indexed, sizes
+/// summing to FreeSize, and counted in the free block stats.
+///
+/// @param[in]  pHeapObj: Heap being checked (not in use by other threads)
+/////////////////////////////////////////////////////////////////////////////////////
+void CTestGmmHeap::VerifyHeap(const GMM_HEAP *pHeapObj)
+{
+    const GMM_HEAPNODE *pNode, *pPrevNode = NULL;
+    GMM_GFX_SIZE_T     FreeSize = 0, LargestFreeBlock = 0;
+    size_t             NumBlocks = 0;
+    GMM_HEAP_STATS     Stats;
+    uint64_t           Histogram[GMM_HEAP_STATS_NUM_BUCKETS] = {};
+
+    for(pNode = pHeapObj->pFreeHeap->pNext; pNode && pNode->pNext; pPrevNode = pNode, pNode = pNode->pNext)
+    {
+        EXPECT_GT(pNode->BlockSize, 0u);
+        EXPECT_GE(pNode->BlockAddr, pHeapObj->BaseAddress);
+        EXPECT_LE(pNode->BlockAddr + pNode->BlockSize, pHeapObj->BaseAddress + pHeapObj->Size);
+        if(pPrevNode)
+        {
+            EXPECT_GT(pNode->BlockAddr, pPrevNode->BlockAddr + pPrevNode->BlockSize);
+        }
+        FreeSize += pNode->BlockSize;
+        LargestFreeBlock = max(LargestFreeBlock, pNode->BlockSize);
+        Histogram[63 - __builtin_clzll(pNode->BlockSize)]++;
+        NumBlocks++;
+    }
+    ASSERT_TRUE(pNode != NULL);
+    EXPECT_EQ(GMM_GFX_ADDRESS_MAX, pNode->BlockAddr); // Tail sentinel.
+
+    EXPECT_EQ(pHeapObj->FreeSize, FreeSize);
+    VerifyTree(&pHeapObj->FreeByAddr, NumBlocks);
+    VerifyTree(&pHeapObj->FreeBySize, NumBlocks);
+
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(const_cast<GMM_HEAP *>(pHeapObj), &Stats));
+    EXPECT_EQ(FreeSize, Stats.FreeSize);
+    EXPECT_EQ(LargestFreeBlock, Stats.LargestFreeBlock);
+    EXPECT_EQ(NumBlocks, Stats.NumFreeBlocks);
+    EXPECT_EQ(0, memcmp(Histogram, Stats.FreeBlockHistogram, sizeof(Histogram)));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies heap sub-allocation without thread cache: random allocations
+/// until exhaustion never overlap, and freeing them in random order coalesces
+/// the heap back into one block.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapAllocFreeCoalesce)
+{
+    const GMM_GFX_SIZE_T                            HeapSize = GMM_MBYTE(16);
+    vector<pair<GMM_GFX_ADDRESS, GMM_GFX_SIZE_T>>   Blocks;
+    mt19937                                         Rng(0x4865);
+    GMM_HEAP                                        *pHeapObj;
+    GMM_GFX_ADDRESS                                 GfxAddress;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, GMM_OTHER_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    VerifyHeap(pHeapObj);
+
+    for(int Iteration = 1;; Iteration++)
+    {
+        GMM_GFX_SIZE_T Size = 1 + Rng() % GMM_KBYTE(96);
+
+        if(!(GfxAddress = GmmAllocateHeapVA(pHeapObj, Size)))
+        {
+            break;
+        }
+        Blocks.push_back(make_pair(GfxAddress, Size));
+
+        // Punch holes now and then, for best-fit reuse.
+        if((Iteration % 3) == 0)
+        {
+            size_t i = Rng() % Blocks.size();
+            EXPECT_EQ(GMM_SUCCESS, GmmFreeHeapVA(pHeapObj, Blocks[i].first, Blocks[i].second));
+            Blocks[i] = Blocks.back();
+            Blocks.pop_back();
+        }
+    }
+    VerifyHeap(pHeapObj);
+
+    sort(Blocks.begin(), Blocks.end());
+    for(size_t i = 0; i < Blocks.size(); i++)
+    {
+        EXPECT_GE(Blocks[i].first, TEST_HEAP_BASE);
+        EXPECT_LE(Blocks[i].first + Blocks[i].second, TEST_HEAP_BASE + HeapSize);
+        if(i)
+        {
+            EXPECT_GE(Blocks[i].first, Blocks[i - 1].first + Blocks[i - 1].second);
+        }
+    }
+
+    shuffle(Blocks.begin(), Blocks.end(), Rng);
+    for(size_t i = 0; i < Blocks.size(); i++)
+    {
+        EXPECT_EQ(GMM_SUCCESS, GmmFreeHeapVA(pHeapObj, Blocks[i].first, Blocks[i].second));
+        if((i % 101) == 0)
+        {
+            VerifyHeap(pHeapObj);
+        }
+    }
+    VerifyHeap(pHeapObj);
+    EXPECT_EQ(HeapSize, pHeapObj->FreeSize);
+    EXPECT_EQ(TEST_HEAP_BASE, GmmAllocateHeapVA(pHeapObj, HeapSize));
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+    EXPECT_EQ(NULL, pHeapObj);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies aligned allocations, and that the best (smallest) fitting hole is
+/// used.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapAlignedBestFit)
+{
+    const GMM_GFX_SIZE_T    HeapSize = GMM_MBYTE(1);
+    GMM_GFX_ADDRESS         Block[6];
+    GMM_HEAP                *pHeapObj;
+
+    // Unaligned heap base, to exercise alignment padding.
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE + 0x100, HeapSize, GMM_FLAT_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+
+    const GMM_GFX_SIZE_T Sizes[6] = { GMM_KBYTE(16), GMM_KBYTE(4), GMM_KBYTE(8), GMM_KBYTE(4), GMM_KBYTE(12), GMM_KBYTE(4) };
+    for(int i = 0; i < 6; i++)
+    {
+        Block[i] = GmmAllocateHeapVA(pHeapObj, Sizes[i]);
+        ASSERT_NE(0u, Block[i]);
+        EXPECT_EQ(0u, Block[i] % GMM_FLAT_HEAP_ALIGN_SIZE);
+        if(i)
+        {
+            EXPECT_EQ(Block[i - 1] + Sizes[i - 1], Block[i]);
+        }
+    }
+    VerifyHeap(pHeapObj);
+
+    // Holes of 16KB, 8KB, 12KB (plus the heap's tail)...
+    GmmFreeHeapVA(pHeapObj, Block[0], Sizes[0]);
+    GmmFreeHeapVA(pHeapObj, Block[2], Sizes[2]);
+    GmmFreeHeapVA(pHeapObj, Block[4], Sizes[4]);
+    VerifyHeap(pHeapObj);
+
+    EXPECT_EQ(Block[2], GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8)));
+    EXPECT_EQ(Block[4], GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(12)));
+    EXPECT_EQ(Block[0], GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(4)));
+    VerifyHeap(pHeapObj);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies a fit search past many holes too small once aligned takes a
+/// bounded number of steps, and still finds a fitting block.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapAlignedFitBounded)
+{
+    const GMM_GFX_SIZE_T    HeapSize = GMM_MBYTE(1);
+    const uint32_t          NumHoles = 40;
+    vector<GMM_GFX_ADDRESS> Holes;
+    GMM_GFX_ADDRESS         GfxAddress = 0;
+    GMM_HEAP_STATS          Before, After;
+    GMM_HEAP                *pHeapObj;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, GMM_OTHER_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+
+    // 8KB holes at 4KB + 16KB * i--none holds a 64KB-aligned 4KB block...
+    ASSERT_NE(0u, GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(4)));
+    for(uint32_t i = 0; i < NumHoles; i++)
+    {
+        Holes.push_back(GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8)));
+        ASSERT_NE(0u, Holes.back());
+        ASSERT_NE(0u, GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8)));
+    }
+    for(uint32_t i = 0; i < NumHoles; i++)
+    {
+        GmmFreeHeapVA(pHeapObj, Holes[i], GMM_KBYTE(8));
+    }
+
+    // ...so it comes from the heap's tail, without visiting every hole.
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Before));
+    EXPECT_TRUE(__GmmAllocAlignHeapBlockGfxAddress(NULL, pHeapObj, GMM_KBYTE(4), GMM_KBYTE(64), &GfxAddress));
+    EXPECT_EQ(TEST_HEAP_BASE + GMM_KBYTE(704), GfxAddress);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &After));
+    EXPECT_LT(After.SearchSteps - Before.SearchSteps, (uint64_t) NumHoles);
+    VerifyHeap(pHeapObj);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies fragmentation stays bounded when aligned searches keep hitting the
+/// step cap (and so aren't best-fit): Churning aligned blocks past many holes
+/// too small for them never spreads them over more than one alignment unit
+/// per live block, and once they are freed the heap is as it was.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapAlignedFitFragmentation)
+{
+    const GMM_GFX_SIZE_T                            HeapSize = GMM_MBYTE(16);
+    const uint32_t                                  NumHoles = 40, MaxLive = 16, Align = GMM_KBYTE(64);
+    vector<GMM_GFX_ADDRESS>                         Holes;
+    vector<pair<GMM_GFX_ADDRESS, GMM_GFX_SIZE_T>>   Live;
+    GMM_GFX_ADDRESS                                 GfxAddress, TailAddress, HighWater;
+    GMM_HEAP_STATS                                  Before, After;
+    mt19937                                         Rng(0x4672);
+    GMM_HEAP                                        *pHeapObj;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, GMM_OTHER_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+
+    // 8KB holes at 4KB + 16KB * i, as in TestHeapAlignedFitBounded, so every
+    // aligned search steps past all of them and hits the cap...
+    ASSERT_NE(0u, GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(4)));
+    for(uint32_t i = 0; i < NumHoles; i++)
+    {
+        Holes.push_back(GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8)));
+        ASSERT_NE(0u, Holes.back());
+        ASSERT_NE(0u, GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8)));
+    }
+    for(uint32_t i = 0; i < NumHoles; i++)
+    {
+        GmmFreeHeapVA(pHeapObj, Holes[i], GMM_KBYTE(8));
+    }
+    TailAddress = HighWater = TEST_HEAP_BASE + GMM_KBYTE(4) + NumHoles * GMM_KBYTE(16);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Before));
+    EXPECT_EQ(NumHoles + 1, Before.NumFreeBlocks);
+
+    // ...while 4-32KB, 64KB-aligned blocks come and go.
+    for(int Iteration = 0; Iteration < 4096; Iteration++)
+    {
+        if((Live.size() < MaxLive) && (Live.empty() || (Rng() & 1)))
+        {
+            GMM_GFX_SIZE_T Size = GMM_KBYTE(4) * (1 + Rng() % 8);
+
+            ASSERT_TRUE(__GmmAllocAlignHeapBlockGfxAddress(NULL, pHeapObj, Size, Align, &GfxAddress));
+            EXPECT_EQ(0u, GfxAddress % Align);
+            EXPECT_GE(GfxAddress, TailAddress); // Never from the holes.
+            Live.push_back(make_pair(GfxAddress, Size));
+            HighWater = max(HighWater, GfxAddress + Size);
+        }
+        else
+        {
+            size_t i = Rng() % Live.size();
+            EXPECT_EQ(GMM_SUCCESS, GmmFreeHeapVA(pHeapObj, Live[i].first, Live[i].second));
+            Live[i] = Live.back();
+            Live.pop_back();
+        }
+    }
+    EXPECT_LE(HighWater - TailAddress, (MaxLive + 1) * (GMM_GFX_SIZE_T) Align);
+    VerifyHeap(pHeapObj);
+
+    for(size_t i = 0; i < Live.size(); i++)
+    {
+        EXPECT_EQ(GMM_SUCCESS, GmmFreeHeapVA(pHeapObj, Live[i].first, Live[i].second));
+    }
+    VerifyHeap(pHeapObj);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &After));
+    EXPECT_EQ(Before.FreeSize, After.FreeSize);
+    EXPECT_EQ(Before.NumFreeBlocks, After.NumFreeBlocks);
+    EXPECT_EQ(Before.LargestFreeBlock, After.LargestFreeBlock);
+    EXPECT_EQ(0, memcmp(Before.FreeBlockHistogram, After.FreeBlockHistogram, sizeof(Before.FreeBlockHistogram)));
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies heap nodes come from few, geometrically growing slabs, that freed
+/// nodes are reused before the pool grows, and that reset releases them all.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapNodePool)
+{
+    const GMM_GFX_SIZE_T    HeapSize = GMM_MBYTE(64);
+    const size_t            NumPages = HeapSize / TEST_HEAP_PAGE;
+    GMM_HEAP                *pHeapObj;
+    uint32_t                NumNodes;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, GMM_FLAT_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    EXPECT_EQ(1u, pHeapObj->NodePool.NumSlabs);
+    EXPECT_EQ(0u, (uintptr_t) pHeapObj->pFreeHeap % __GMM_HEAP_NODE_SLAB_ALIGN);
+
+    for(int Pass = 0; Pass < 2; Pass++)
+    {
+        // Every other page free: a node per free block...
+        for(size_t i = 0; i < NumPages; i++)
+        {
+            ASSERT_EQ(TEST_HEAP_BASE + i * TEST_HEAP_PAGE, GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE));
+        }
+        for(size_t i = 0; i < NumPages; i += 2)
+        {
+            GmmFreeHeapVA(pHeapObj, TEST_HEAP_BASE + i * TEST_HEAP_PAGE, TEST_HEAP_PAGE);
+        }
+        VerifyHeap(pHeapObj);
+        EXPECT_GE(pHeapObj->NodePool.NumNodes, NumPages / 2 + 2);
+        if(Pass == 0)
+        {   // 64 + 128 + ... + 4096, then 4096-node slabs.
+            EXPECT_EQ(7u + (NumPages / 2 + 2 - 8128 + 4095) / 4096, pHeapObj->NodePool.NumSlabs);
+            NumNodes = pHeapObj->NodePool.NumNodes;
+        }
+        else
+        {   // ...reusing the first pass's nodes.
+            EXPECT_EQ(NumNodes, pHeapObj->NodePool.NumNodes);
+        }
+
+        for(size_t i = 1; i < NumPages; i += 2)
+        {
+            GmmFreeHeapVA(pHeapObj, TEST_HEAP_BASE + i * TEST_HEAP_PAGE, TEST_HEAP_PAGE);
+        }
+        VerifyHeap(pHeapObj);
+        EXPECT_EQ(HeapSize, pHeapObj->FreeSize);
+    }
+
+    __GmmUmResetHeap(pHeapObj);
+    EXPECT_EQ(0u, pHeapObj->NodePool.NumSlabs);
+    EXPECT_EQ(NULL, pHeapObj->NodePool.pFreeNodes);
+    EXPECT_EQ(NULL, pHeapObj->pFreeHeap);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies GMM_BUDDY_HEAP's hand out size-aligned power-of-two blocks, with
+/// FreeSize accounting whole blocks.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapBuddyHeap)
+{
+    const GMM_GFX_SIZE_T    HeapSize = GMM_MBYTE(2) + GMM_KBYTE(64) + 100;
+    GMM_GFX_ADDRESS         Tile, Page, Odd, Large;
+    GMM_HEAP                *pHeapObj;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, GMM_BUDDY_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    EXPECT_EQ(GMM_MBYTE(2) + GMM_KBYTE(64), pHeapObj->FreeSize);
+
+    Page = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE);
+    Tile = GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(64));
+    Odd = GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(12));
+    EXPECT_EQ(TEST_HEAP_BASE + GMM_MBYTE(2), Page);  // From the trailing 64KB block...
+    EXPECT_EQ(0u, Tile % GMM_KBYTE(64));             // ...then split from the 2MB one.
+    EXPECT_EQ(0u, Odd % GMM_KBYTE(16));
+    EXPECT_EQ(GMM_MBYTE(2) + GMM_KBYTE(64) - (GMM_KBYTE(4) + GMM_KBYTE(64) + GMM_KBYTE(16)), pHeapObj->FreeSize);
+
+    EXPECT_EQ(0u, GmmAllocateHeapVA(pHeapObj, GMM_MBYTE(2)));
+    GmmFreeHeapVA(pHeapObj, Tile, GMM_KBYTE(64));
+    GmmFreeHeapVA(pHeapObj, Odd, GMM_KBYTE(12));
+    Large = GmmAllocateHeapVA(pHeapObj, GMM_MBYTE(2));
+    EXPECT_EQ(TEST_HEAP_BASE, Large);
+
+    GmmFreeHeapVA(pHeapObj, Page, TEST_HEAP_PAGE);
+    GmmFreeHeapVA(pHeapObj, Large, GMM_MBYTE(2));
+    EXPECT_EQ(GMM_MBYTE(2) + GMM_KBYTE(64), pHeapObj->FreeSize);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies GmmHeapGetStats counters: heap and magazine allocations/frees,
+/// failures, search lengths, and a buddy heap's free blocks.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapStats)
+{
+    GMM_HEAP_STATS  Stats;
+    GMM_GFX_ADDRESS Block[4];
+    GMM_HEAP        *pHeapObj;
+
+    EXPECT_HEAP_ASSERT(EXPECT_EQ(GMM_ERROR, GmmHeapGetStats(NULL, &Stats)));
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, GMM_MBYTE(1), GMM_FLAT_HEAP, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Stats));
+    EXPECT_EQ(GMM_MBYTE(1), Stats.Size);
+    EXPECT_EQ(GMM_MBYTE(1), Stats.LargestFreeBlock);
+    EXPECT_EQ(1u, Stats.NumFreeBlocks);
+    EXPECT_EQ(1u, Stats.FreeBlockHistogram[20]);
+    EXPECT_EQ(0.0, Stats.AverageSearchLength);
+
+    Block[0] = GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8));   // Magazine sizes...
+    Block[1] = GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8));
+    Block[2] = GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(128)); // ...and not.
+    GmmFreeHeapVA(pHeapObj, Block[0], GMM_KBYTE(8));
+    GmmFreeHeapVA(pHeapObj, Block[2], GMM_KBYTE(128));
+    Block[3] = GmmAllocateHeapVA(pHeapObj, GMM_KBYTE(8));
+    EXPECT_EQ(Block[0], Block[3]);
+    EXPECT_EQ(0u, GmmAllocateHeapVA(pHeapObj, GMM_MBYTE(2)));
+
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Stats));
+    EXPECT_EQ(3u, Stats.NumAllocs);
+    EXPECT_EQ(1u, Stats.NumFailedAllocs);
+    EXPECT_EQ(1u, Stats.NumFrees);
+    EXPECT_EQ(1u, Stats.NumCachedAllocs);
+    EXPECT_EQ(1u, Stats.NumCachedFrees);
+    EXPECT_EQ(3u, Stats.NumSearches);     // Oversized request is refused without one.
+    EXPECT_EQ(1.0, Stats.AverageSearchLength);
+    EXPECT_EQ(GMM_MBYTE(1) - GMM_KBYTE(16), Stats.FreeSize);
+    EXPECT_EQ(GMM_MBYTE(1) - GMM_KBYTE(16), Stats.LargestFreeBlock);
+
+    GmmFreeHeapVA(pHeapObj, Block[1], GMM_KBYTE(8));
+    GmmFreeHeapVA(pHeapObj, Block[3], GMM_KBYTE(8));
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+
+    // Buddy heap: 1MB + 64KB + 4KB free; two pages take the 4KB block, then
+    // split the 64KB one.
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, GMM_MBYTE(1) + GMM_KBYTE(68), GMM_BUDDY_HEAP | GMM_HEAP_NO_THREAD_CACHE, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Stats));
+    EXPECT_EQ(3u, Stats.NumFreeBlocks);
+    EXPECT_EQ(GMM_MBYTE(1), Stats.LargestFreeBlock);
+
+    Block[0] = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE);
+    Block[1] = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE);
+    EXPECT_EQ(TEST_HEAP_BASE + GMM_KBYTE(1024 + 64), Block[0]);
+    EXPECT_EQ(TEST_HEAP_BASE + GMM_MBYTE(1), Block[1]);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Stats));
+    EXPECT_EQ(2u, Stats.NumAllocs);
+    EXPECT_EQ(5u, Stats.NumFreeBlocks);   // 4KB, 8KB, 16KB, 32KB and 1MB.
+    EXPECT_EQ(GMM_MBYTE(1), Stats.LargestFreeBlock);
+    EXPECT_EQ(1u, Stats.FreeBlockHistogram[12]);
+    EXPECT_EQ(0u, Stats.FreeBlockHistogram[16]);
+    EXPECT_EQ(1u, Stats.FreeBlockHistogram[20]);
+    EXPECT_EQ(GMM_KBYTE(1024 + 68 - 8), Stats.FreeSize);
+
+    GmmFreeHeapVA(pHeapObj, Block[0], TEST_HEAP_PAGE);
+    GmmFreeHeapVA(pHeapObj, Block[1], TEST_HEAP_PAGE);
+    ASSERT_EQ(GMM_SUCCESS, GmmHeapGetStats(pHeapObj, &Stats));
+    EXPECT_EQ(2u, Stats.NumFrees);
+    EXPECT_EQ(3u, Stats.NumFreeBlocks);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies blocks parked in thread magazines are reclaimed for allocations
+/// the heap otherwise can't satisfy.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapThreadCacheDrain)
+{
+    const GMM_GFX_SIZE_T    HeapSize = GMM_MBYTE(1);
+    vector<GMM_GFX_ADDRESS> Blocks;
+    GMM_GFX_ADDRESS         GfxAddress;
+    GMM_HEAP                *pHeapObj;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, GMM_FLAT_HEAP, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    ASSERT_TRUE(pHeapObj->MagazineKeyValid);
+
+    while((GfxAddress = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE)))
+    {
+        Blocks.push_back(GfxAddress);
+    }
+    EXPECT_EQ(HeapSize / TEST_HEAP_PAGE, Blocks.size());
+
+    for(size_t i = 0; i < Blocks.size(); i++)
+    {
+        GmmFreeHeapVA(pHeapObj, Blocks[i], TEST_HEAP_PAGE);
+    }
+    EXPECT_LT(pHeapObj->FreeSize, HeapSize);     // Some pages still magazined...
+    EXPECT_GE(pHeapObj->FreeSize, HeapSize - GMM_HEAP_MAGAZINE_DEPTH * TEST_HEAP_PAGE);
+
+    // ...most recently freed page comes back first...
+    EXPECT_EQ(Blocks.back(), GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE));
+    GmmFreeHeapVA(pHeapObj, Blocks.back(), TEST_HEAP_PAGE);
+
+    // ...and all are reclaimed for a whole-heap allocation.
+    EXPECT_EQ(TEST_HEAP_BASE, GmmAllocateHeapVA(pHeapObj, HeapSize));
+    EXPECT_EQ(0u, pHeapObj->FreeSize);
+    VerifyHeap(pHeapObj);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies a block freed twice into a thread magazine is cached only once, so
+/// it isn't handed out to two allocations.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapThreadCacheDoubleFree)
+{
+    GMM_GFX_ADDRESS GfxAddress, Realloc[2];
+    GMM_HEAP        *pHeapObj;
+
+    pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, GMM_MBYTE(1), GMM_FLAT_HEAP, NULL);
+    ASSERT_TRUE(pHeapObj != NULL);
+    ASSERT_TRUE(pHeapObj->MagazineKeyValid);
+
+    GfxAddress = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE);
+    ASSERT_NE(0u, GfxAddress);
+
+    GmmFreeHeapVA(pHeapObj, GfxAddress, TEST_HEAP_PAGE);
+    EXPECT_HEAP_ASSERT(GmmFreeHeapVA(pHeapObj, GfxAddress, TEST_HEAP_PAGE)); // Dropped.
+
+    Realloc[0] = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE);
+    Realloc[1] = GmmAllocateHeapVA(pHeapObj, TEST_HEAP_PAGE);
+    EXPECT_EQ(GfxAddress, Realloc[0]);
+    EXPECT_NE(GfxAddress, Realloc[1]);
+    EXPECT_NE(0u, Realloc[1]);
+
+    GmmFreeHeapVA(pHeapObj, Realloc[0], TEST_HEAP_PAGE);
+    GmmFreeHeapVA(pHeapObj, Realloc[1], TEST_HEAP_PAGE);
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies GMM_PROCESS_HEAP's are shared per adapter, until last destroy.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapProcessHeap)
+{
+    int         Adapter[2];
+    GMM_HEAP    *pHeapObj[3];
+
+    pHeapObj[0] = GmmUmSetupHeap(&Adapter[0], NULL, TEST_HEAP_BASE, GMM_MBYTE(1), GMM_PROCESS_HEAP, NULL);
+    pHeapObj[1] = GmmUmSetupHeap(&Adapter[0], NULL, TEST_HEAP_BASE, GMM_MBYTE(1), GMM_PROCESS_HEAP, NULL);
+    pHeapObj[2] = GmmUmSetupHeap(&Adapter[1], NULL, TEST_HEAP_BASE, GMM_MBYTE(1), GMM_PROCESS_HEAP, NULL);
+    ASSERT_TRUE(pHeapObj[0] && pHeapObj[2]);
+    EXPECT_EQ(pHeapObj[0], pHeapObj[1]);
+    EXPECT_NE(pHeapObj[0], pHeapObj[2]);
+    EXPECT_EQ(2u, pHeapObj[0]->NumContexts);
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(&Adapter[0], NULL, &pHeapObj[0], NULL));
+    EXPECT_TRUE(pHeapObj[0] != NULL); // Still in use by other context.
+    EXPECT_EQ(1u, pHeapObj[1]->NumContexts);
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(&Adapter[0], NULL, &pHeapObj[1], NULL));
+    EXPECT_EQ(NULL, pHeapObj[1]);
+    EXPECT_EQ(NULL, GmmGetSharedHeapObject(&Adapter[0], NULL, NULL));
+
+    EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(&Adapter[1], NULL, &pHeapObj[2], NULL));
+    EXPECT_EQ(NULL, GmmGetSharedHeapObject(&Adapter[1], NULL, NULL));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Has threads concurrently allocate/free random mixes of cached and uncached
+/// sizes, claiming each allocated page in a shared ownership map--any overlap
+/// between live allocations fails the claim.
+///
+/// @param[in]  pHeapObj: Heap to use
+/// @param[in]  NumThreads: Thread count
+/// @param[in]  Iterations: Allocations per thread
+/////////////////////////////////////////////////////////////////////////////////////
+void CTestGmmHeap::RunThreads(GMM_HEAP *pHeapObj, int NumThreads, int Iterations)
+{
+    vector<atomic<int>> Owner(pHeapObj->Size / TEST_HEAP_PAGE);
+    atomic<int>         Overlaps(0), Failures(0);
+    vector<thread>      Threads;
+
+    for(size_t i = 0; i < Owner.size(); i++)
+    {
+        Owner[i] = 0;
+    }
+
+    for(int t = 0; t < NumThreads; t++)
+    {
+        Threads.push_back(thread([&, t]() {
+            vector<pair<GMM_GFX_ADDRESS, GMM_GFX_SIZE_T>> Live;
+            mt19937                                       Rng(t + 1);
+
+            for(int i = 0; i < Iterations; i++)
+            {
+                if((Live.size() < 32) && ((Rng() % 3) || Live.empty()))
+                {
+                    GMM_GFX_SIZE_T Size = (1 + Rng() % ((Rng() % 8) ? 16 : 40)) * TEST_HEAP_PAGE; // Mostly cached sizes.
+                    GMM_GFX_ADDRESS GfxAddress = GmmAllocateHeapVA(pHeapObj, Size);
+
+                    if(!GfxAddress)
+                    {
+                        Failures++;
+                        continue;
+                    }
+                    for(GMM_GFX_SIZE_T Page = (GfxAddress - pHeapObj->BaseAddress) / TEST_HEAP_PAGE; Page < (GfxAddress + Size - pHeapObj->BaseAddress) / TEST_HEAP_PAGE; Page++)
+                    {
+                        int Expected = 0;
+                        if(!Owner[Page].compare_exchange_strong(Expected, t + 1))
+                        {
+                            Overlaps++;
+                        }
+                    }
+                    Live.push_back(make_pair(GfxAddress, Size));
+                }
+                else
+                {
+                    size_t j = Rng() % Live.size();
+
+                    for(GMM_GFX_SIZE_T Page = (Live[j].first - pHeapObj->BaseAddress) / TEST_HEAP_PAGE; Page < (Live[j].first + Live[j].second - pHeapObj->BaseAddress) / TEST_HEAP_PAGE; Page++)
+                    {
+                        Owner[Page] = 0;
+                    }
+                    GmmFreeHeapVA(pHeapObj, Live[j].first, Live[j].second);
+                    Live[j] = Live.back();
+                    Live.pop_back();
+                }
+            }
+
+            for(size_t j = 0; j < Live.size(); j++)
+            {
+                for(GMM_GFX_SIZE_T Page = (Live[j].first - pHeapObj->BaseAddress) / TEST_HEAP_PAGE; Page < (Live[j].first + Live[j].second - pHeapObj->BaseAddress) / TEST_HEAP_PAGE; Page++)
+                {
+                    Owner[Page] = 0;
+                }
+                GmmFreeHeapVA(pHeapObj, Live[j].first, Live[j].second);
+            }
+        }));
+    }
+
+    for(size_t t = 0; t < Threads.size(); t++)
+    {
+        Threads[t].join();
+    }
+
+    EXPECT_EQ(0, Overlaps.load());
+    EXPECT_EQ(0, Failures.load());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Verifies heap is thread-safe with and without thread magazines, and that
+/// exiting threads return their magazined blocks.
+/////////////////////////////////////////////////////////////////////////////////////
+TEST_F(CTestGmmHeap, TestHeapMultiThreaded)
+{
+    const GMM_GFX_SIZE_T    HeapSize = GMM_MBYTE(64);
+    const uint32_t          Flags[] = { GMM_FLAT_HEAP, GMM_FLAT_HEAP | GMM_HEAP_NO_THREAD_CACHE, GMM_BUDDY_HEAP };
+
+    for(int f = 0; f < 3; f++)
+    {
+        GMM_HEAP *pHeapObj = GmmUmSetupHeap(NULL, NULL, TEST_HEAP_BASE, HeapSize, Flags[f], NULL);
+        ASSERT_TRUE(pHeapObj != NULL);
+
+        RunThreads(pHeapObj, 8, 20000);
+
+        EXPECT_EQ(NULL, pHeapObj->pMagazines);
+        EXPECT_EQ(HeapSize, pHeapObj->FreeSize);
+        if((Flags[f] & HEAP_TYPE_MASK) == GMM_BUDDY_HEAP)
+        {
+            EXPECT_EQ(TEST_HEAP_BASE, GmmAllocateHeapVA(pHeapObj, HeapSize)); // All merged.
+        }
+        else
+        {
+            VerifyHeap(pHeapObj);
+        }
+
+        EXPECT_EQ(GMM_SUCCESS, GmmUmDestroypHeap(NULL, NULL, &pHeapObj, NULL));
+    }
+}
+#endif
@@ -0,0 +1,61 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#pragma once
+
+#include "stdafx.h"
+
+#include "../inc/External/Common/GmmHeapTree.h"
+#include "../inc/External/Common/GmmHeapBuddy.h"
+#ifndef _WIN32
+#include "../inc/External/Linux/GmmHeapLin.h"
+#endif
+
+// Heap misuse (e.g. a double free) is asserted on, which breaks into the
+// debugger in _DEBUG builds--so there, expect the statement to kill the test.
+#ifdef _DEBUG
+#define EXPECT_HEAP_ASSERT(Statement)   EXPECT_DEATH(Statement, "")
+#else
+#define EXPECT_HEAP_ASSERT(Statement)   Statement
+#endif
+
+class CTestGmmHeap : public testing::Test
+{
+public:
+    CTestGmmHeap();
+    ~CTestGmmHeap();
+
+protected:
+    typedef struct TEST_HEAP_TREE_NODE_REC
+    {
+        uint64_t            Key;
+        GMM_HEAP_TREE_LINK  Link;
+    } TEST_HEAP_TREE_NODE;
+
+    static int  CompareNodes(const GMM_HEAP_TREE_LINK *pA, const GMM_HEAP_TREE_LINK *pB);
+    static int  VerifySubtree(const GMM_HEAP_TREE *pTree, const GMM_HEAP_TREE_LINK *pLink);
+    static void VerifyTree(const GMM_HEAP_TREE *pTree, size_t NumNodes);
+#ifndef _WIN32
+    static void VerifyHeap(const GMM_HEAP *pHeapObj);
+    static void RunThreads(GMM_HEAP *pHeapObj, int NumThreads, int Iterations);
+#endif
+};
@@ -21,6 +21,11 @@ OTHER DEALINGS IN THE SOFTWARE.
 ============================================================================*/
 
 #include "GmmResourceULT.h"
+#include <atomic>
+#include <thread>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -43,14 +48,642 @@ CTestCpuBltResource::~CTestCpuBltResource()
 
 }
     
+/////////////////////////////////////////////////////////////////////////////////////
+/// Sets up common environment for CpuBlt fixture tests. this is called once per
+/// test case before executing all tests under CpuBlt fixture test case.
+/// It also calls SetupTestCase from CommonULT to initialize global context and others.
+/////////////////////////////////////////////////////////////////////////////////////
 void CTestCpuBltResource::SetUpTestCase()
 {
+    GfxPlatform.eProductFamily = IGFX_SKYLAKE;
+    GfxPlatform.eRenderCoreFamily = IGFX_GEN9_CORE;
 
+    CommonULT::SetUpTestCase();
+
+    printf("%s\n", __FUNCTION__);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+/// cleans up once all the tests finish execution.  It also calls TearDownTestCase
+/// from CommonULT to destroy global context and others.
+/////////////////////////////////////////////////////////////////////////////////////
 void CTestCpuBltResource::TearDownTestCase()
 {
+    printf("%s\n", __FUNCTION__);
+
+    CommonULT::TearDownTestCase();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns pointer into Buffer aligned to Alignment (power of two). Buffer is
+/// resized to hold Size bytes past the aligned pointer.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint8_t *AlignedBuffer(vector<uint8_t> &Buffer, size_t Size, size_t Alignment)
+{
+    Buffer.resize(Size + Alignment);
+    return reinterpret_cast<uint8_t *>(
+        (reinterpret_cast<uintptr_t>(Buffer.data()) + Alignment - 1) & ~(uintptr_t)(Alignment - 1));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns tile width (in bytes), height (in rows), and depth (in slices or
+/// samples) of given swizzle descriptor.
+/////////////////////////////////////////////////////////////////////////////////////
+static void GetSwizzleTileDimensions(const SWIZZLE_DESCRIPTOR *pSwizzle, int &TileWidth, int &TileHeight, int &TileDepth)
+{
+    TileWidth = TileHeight = TileDepth = 1;
+    for(int Bit = 0; Bit < 16; Bit++)
+    {
+        TileWidth  <<= (pSwizzle->Mask.x >> Bit) & 1;
+        TileHeight <<= (pSwizzle->Mask.y >> Bit) & 1;
+        TileDepth  <<= (pSwizzle->Mask.z >> Bit) & 1;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Reference (bit-by-bit) swizzled offset computation, independent of the
+/// CpuSwizzleBlt intra-tile offset tables.
+/////////////////////////////////////////////////////////////////////////////////////
+static int ReferenceSwizzleOffset(const SWIZZLE_DESCRIPTOR *pSwizzle, int Pitch, int OffsetX, int OffsetY, int OffsetZ)
+{
+    int TileWidth, TileHeight, TileDepth;
+    GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+    int Offset = ((OffsetY / TileHeight) * (Pitch / TileWidth) + (OffsetX / TileWidth)) * TileWidth * TileHeight * TileDepth;
+    int x = OffsetX % TileWidth, y = OffsetY % TileHeight, z = OffsetZ;
+
+    for(int Bit = 0; Bit < 16; Bit++)
+    {
+        if(pSwizzle->Mask.x & (1 << Bit))
+        {
+            Offset |= (x & 1) << Bit;
+            x >>= 1;
+        }
+        else if(pSwizzle->Mask.y & (1 << Bit))
+        {
+            Offset |= (y & 1) << Bit;
+            y >>= 1;
+        }
+        else if(pSwizzle->Mask.z & (1 << Bit))
+        {
+            Offset |= (z & 1) << Bit;
+            z >>= 1;
+        }
+    }
+
+    return Offset;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Uploads Width x Height rectangle from linear surface into swizzled surface
+/// at (OffsetX, OffsetY) via CpuSwizzleBlt, checks every swizzled byte against
+/// SwizzleOffset reference (and that bytes outside rectangle were untouched),
+/// then downloads rectangle back and checks it matches original.
+///
+/// @param[in]  pSwizzle: Swizzle descriptor of swizzled surface
+/// @param[in]  TilesX/TilesY: Swizzled surface size in tiles
+/// @param[in]  OffsetX/OffsetY/Width/Height: BLT rectangle, in bytes/rows
+/// @param[in]  Specialized: Transfer via CpuSwizzleBltSelectKernel's kernels
+///                          (which must not fall back to CpuSwizzleBlt)
+/////////////////////////////////////////////////////////////////////////////////////
+static void VerifyCpuSwizzleBlt(const SWIZZLE_DESCRIPTOR *pSwizzle, int TilesX, int TilesY,
+                                int OffsetX, int OffsetY, int Width, int Height, bool Specialized = false, bool Temporal = false)
+{
+    int TileWidth, TileHeight, TileDepth;
+    GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+    int Pitch = TileWidth * TilesX;
+    int SurfaceHeight = TileHeight * TilesY;
+    int SurfaceSize = Pitch * SurfaceHeight * TileDepth;
+    int LinearPitch = Width + 3; // Deliberately unaligned.
+
+    vector<uint8_t> SwizzledBuffer, ExpectedBuffer, LinearBuffer, ResultBuffer;
+    uint8_t *pSwizzled = AlignedBuffer(SwizzledBuffer, SurfaceSize, 64);
+    uint8_t *pLinear = AlignedBuffer(LinearBuffer, LinearPitch * Height, 64) + 1;
+    uint8_t *pResult = AlignedBuffer(ResultBuffer, LinearPitch * Height, 64) + 1;
+
+    memset(pSwizzled, 0xcd, SurfaceSize);
+    for(int i = 0; i < LinearPitch * Height; i++)
+    {
+        pLinear[i] = (uint8_t)(i * 7 + i / 251);
+    }
+
+    ExpectedBuffer.assign(pSwizzled, pSwizzled + SurfaceSize);
+    for(int y = 0; y < Height; y++)
+    {
+        for(int x = 0; x < Width; x++)
+        {
+            ExpectedBuffer[SwizzleOffset(pSwizzle, Pitch, OffsetX + x, OffsetY + y, 0)] =
+                pLinear[y * LinearPitch + x];
+        }
+    }
+
+    CPU_SWIZZLE_BLT_SURFACE SwizzledSurface = {}, LinearSurface = {};
+
+    SwizzledSurface.pBase = pSwizzled;
+    SwizzledSurface.Pitch = Pitch;
+    SwizzledSurface.Height = SurfaceHeight;
+    SwizzledSurface.pSwizzle = pSwizzle;
+    SwizzledSurface.OffsetX = OffsetX;
+    SwizzledSurface.OffsetY = OffsetY;
+    SwizzledSurface.Temporal = Temporal;
+
+    LinearSurface.pBase = pLinear;
+    LinearSurface.Pitch = LinearPitch;
+    LinearSurface.Height = Height;
+    LinearSurface.PrefetchRows = Temporal ? 0 : 3;
+
+    PFN_CPU_SWIZZLE_BLT pfnUpload = CpuSwizzleBlt, pfnDownload = CpuSwizzleBlt;
+    if(Specialized)
+    {
+        pfnUpload = CpuSwizzleBltSelectKernel(&SwizzledSurface, &LinearSurface);
+        pfnDownload = CpuSwizzleBltSelectKernel(&LinearSurface, &SwizzledSurface);
+        ASSERT_NE((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, pfnUpload);
+        ASSERT_NE((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, pfnDownload);
+        ASSERT_NE(pfnUpload, pfnDownload);
+    }
+
+    pfnUpload(&SwizzledSurface, &LinearSurface, Width, Height);
+    EXPECT_EQ(0, memcmp(ExpectedBuffer.data(), pSwizzled, SurfaceSize))
+        << "Upload: Pitch=" << Pitch << " Rect=(" << OffsetX << "," << OffsetY << " " << Width << "x" << Height << ")";
+
+    memset(pResult, 0xcd, LinearPitch * Height);
+    LinearSurface.pBase = pResult;
+
+    pfnDownload(&LinearSurface, &SwizzledSurface, Width, Height);
+    for(int y = 0; y < Height; y++)
+    {
+        EXPECT_EQ(0, memcmp(pLinear + y * LinearPitch, pResult + y * LinearPitch, Width))
+            << "Download: Pitch=" << Pitch << " Rect=(" << OffsetX << "," << OffsetY << " " << Width << "x" << Height << ") Row=" << y;
+    }
+}
+
+/// @brief ULT for CpuSwizzleBlt transfer paths
+TEST_F(CTestCpuBltResource, TestCpuSwizzleBlt)
+{
+    const SWIZZLE_DESCRIPTOR *Swizzles[] =
+    {
+        &INTEL_TILE_X,
+        &INTEL_TILE_Y,
+        &ST_2D_4KB_8bpp,
+        &ST_2D_4KB_32bpp,
+        &ST_2D_4KB_128bpp,
+        &ST_2D_64KB_16bpp,
+        &ST_2D_64KB_64bpp,
+        &ST_3D_4KB_32bpp,
+        &INTEL_TILE_W,
+    };
+
+    for(UINT i = 0; i < sizeof(Swizzles) / sizeof(Swizzles[0]); i++)
+    {
+        const SWIZZLE_DESCRIPTOR *pSwizzle = Swizzles[i];
+        int TileWidth, TileHeight, TileDepth;
+        GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+        int Pitch = 3 * TileWidth, Height = 2 * TileHeight;
+
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 0, 0, Pitch, Height);                      // Full surface.
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 5, 1, Pitch - 14, Height - 3);             // Unaligned crust on all sides.
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 48, 4, Pitch - 64, Height / 2);            // Aligned to 16B but not 64B.
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, TileWidth - 8, 2, 20, 3);                  // Narrow, straddling tiles.
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 5, 1, Pitch - 14, Height - 3, false, true); // Temporal access.
+    }
+}
+
+/// @brief ULT for CpuSwizzleBltSelectKernel's specialized kernels
+TEST_F(CTestCpuBltResource, TestCpuSwizzleBltKernels)
+{
+    const SWIZZLE_DESCRIPTOR *Swizzles[] =
+    {
+        &INTEL_TILE_X,
+        &INTEL_TILE_Y,
+        &ST_2D_4KB_8bpp,
+        &ST_2D_4KB_16bpp,
+        &ST_2D_4KB_32bpp,
+        &ST_2D_4KB_64bpp,
+        &ST_2D_4KB_128bpp,
+        &ST_2D_64KB_8bpp,
+        &ST_2D_64KB_16bpp,
+        &ST_2D_64KB_32bpp,
+        &ST_2D_64KB_64bpp,
+        &ST_2D_64KB_128bpp,
+        &INTEL_TILE_W,
+    };
+
+    for(UINT i = 0; i < sizeof(Swizzles) / sizeof(Swizzles[0]); i++)
+    {
+        const SWIZZLE_DESCRIPTOR *pSwizzle = Swizzles[i];
+        int TileWidth, TileHeight, TileDepth;
+        GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+        int Pitch = 3 * TileWidth, Height = 2 * TileHeight;
+
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 0, 0, Pitch, Height, true);
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 5, 1, Pitch - 14, Height - 3, true);
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 48, 4, Pitch - 64, Height / 2, true);
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, TileWidth - 8, 2, 20, 3, true);
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 0, 0, Pitch, Height, true, true);
+        VerifyCpuSwizzleBlt(pSwizzle, 3, 2, 5, 1, Pitch - 14, Height - 3, true, true);
+    }
+
+    { // Surfaces without a specialized kernel fall back to generic path...
+        CPU_SWIZZLE_BLT_SURFACE Swizzled = {}, Linear = {};
+
+        Swizzled.pSwizzle = &ST_3D_4KB_32bpp;
+        EXPECT_EQ((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, CpuSwizzleBltSelectKernel(&Swizzled, &Linear));
+
+        Swizzled.pSwizzle = &INTEL_TILE_Y;
+        Linear.Element.Pitch = 4;
+        Linear.Element.Size = 1;
+        EXPECT_EQ((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, CpuSwizzleBltSelectKernel(&Swizzled, &Linear));
+
+        Swizzled.Element.Pitch = 4; // Sub-element straddling pixels.
+        Swizzled.Element.Size = 3;
+        Swizzled.OffsetX = 2;
+        Linear.Element.Pitch = Linear.Element.Size = 3;
+        EXPECT_EQ((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, CpuSwizzleBltSelectKernel(&Swizzled, &Linear));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Transfers one sub-element of each pixel of a Width x Height rectangle between
+/// swizzled and linear surfaces (both directions) via CpuSwizzleBltSelectKernel's
+/// depth/stencil kernels, and checks results match generic CpuSwizzleBlt's--
+/// including that the rest of each packed pixel was untouched--and uploads
+/// match SwizzleOffset reference.
+///
+/// @param[in]  pSwizzle: Swizzle descriptor of swizzled surface (3x2 tiles)
+/// @param[in]  SwizzledPitch/LinearPitch: Element pitch of each surface, in bytes
+/// @param[in]  Size/SubOffset: Size of transferred sub-element, and its offset within packed pixels
+/// @param[in]  X/Y/Width/Height: BLT rectangle, in pixels/rows
+/// @param[in]  Temporal: Access swizzled surface with regular (not non-temporal) loads/stores
+/////////////////////////////////////////////////////////////////////////////////////
+static void VerifyCpuSwizzleBltSubElement(const SWIZZLE_DESCRIPTOR *pSwizzle, int SwizzledPitch, int LinearPitch,
+                                          int Size, int SubOffset, int X, int Y, int Width, int Height, bool Temporal = false)
+{
+    int TileWidth, TileHeight, TileDepth;
+    GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+    int Pitch = 3 * TileWidth;
+    int SurfaceHeight = 2 * TileHeight;
+    int SurfaceSize = Pitch * SurfaceHeight;
+    int LinearRowPitch = Width * LinearPitch + 5; // Deliberately unaligned.
+    int LinearSize = LinearRowPitch * Height + 8;
 
+    vector<uint8_t> Buffer[4];
+    uint8_t *pSwizzled[2], *pLinear[2];
+
+    for(int i = 0; i < 2; i++)
+    {
+        pSwizzled[i] = AlignedBuffer(Buffer[i], SurfaceSize, 64);
+        pLinear[i] = AlignedBuffer(Buffer[2 + i], LinearSize, 64) + 1;
+        for(int j = 0; j < SurfaceSize; j++) pSwizzled[i][j] = (uint8_t)(j * 5 + j / 241);
+        for(int j = 0; j < LinearSize; j++) pLinear[i][j] = (uint8_t)(j * 7 + j / 251 + 3);
+    }
+
+    CPU_SWIZZLE_BLT_SURFACE SwizzledSurface = {}, LinearSurface = {};
+
+    SwizzledSurface.Pitch = Pitch;
+    SwizzledSurface.Height = SurfaceHeight;
+    SwizzledSurface.pSwizzle = pSwizzle;
+    SwizzledSurface.OffsetX = X * SwizzledPitch + ((SwizzledPitch > Size) ? SubOffset : 0);
+    SwizzledSurface.OffsetY = Y;
+    SwizzledSurface.Element.Pitch = SwizzledPitch;
+    SwizzledSurface.Element.Size = Size;
+    SwizzledSurface.Temporal = Temporal;
+
+    LinearSurface.Pitch = LinearRowPitch;
+    LinearSurface.Height = Height;
+    LinearSurface.OffsetX = (LinearPitch > Size) ? SubOffset : 0;
+    LinearSurface.Element.Pitch = LinearPitch;
+    LinearSurface.Element.Size = Size;
+
+    PFN_CPU_SWIZZLE_BLT pfnUpload = CpuSwizzleBltSelectKernel(&SwizzledSurface, &LinearSurface);
+    PFN_CPU_SWIZZLE_BLT pfnDownload = CpuSwizzleBltSelectKernel(&LinearSurface, &SwizzledSurface);
+    ASSERT_NE((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, pfnUpload);
+    ASSERT_NE((PFN_CPU_SWIZZLE_BLT) CpuSwizzleBlt, pfnDownload);
+
+    for(int i = 0; i < 2; i++) // CpuSwizzleBlt, then kernel...
+    {
+        SwizzledSurface.pBase = pSwizzled[i];
+        LinearSurface.pBase = pLinear[i];
+        (i ? pfnUpload : CpuSwizzleBlt)(&SwizzledSurface, &LinearSurface, Width * LinearPitch, Height);
+    }
+    for(int i = 0; i < 2; i++) // Both against SwizzleOffset reference...
+    {
+        int Mismatches = 0;
+
+        for(int y = 0; y < Height; y++)
+        {
+            for(int x = 0; x < Width * Size; x++)
+            {
+                int Pixel = x / Size, Byte = x % Size;
+
+                Mismatches +=
+                    pSwizzled[i][SwizzleOffset(pSwizzle, Pitch, SwizzledSurface.OffsetX + Pixel * SwizzledPitch + Byte, Y + y, 0)] !=
+                    pLinear[i][y * LinearRowPitch + LinearSurface.OffsetX + Pixel * LinearPitch + Byte];
+            }
+        }
+
+        EXPECT_EQ(0, Mismatches) << (i ? "Kernel" : "CpuSwizzleBlt") << " upload: Pitch=" << SwizzledPitch << "/" << LinearPitch << " Size=" << Size;
+    }
+    EXPECT_EQ(0, memcmp(pSwizzled[0], pSwizzled[1], SurfaceSize))
+        << "Upload: Pitch=" << SwizzledPitch << "/" << LinearPitch << " Size=" << Size << " Rect=(" << X << "," << Y << " " << Width << "x" << Height << ")";
+
+    for(int i = 0; i < 2; i++)
+    {
+        for(int j = 0; j < SurfaceSize; j++) pSwizzled[i][j] = (uint8_t)(j * 3 + j / 257 + 1);
+
+        SwizzledSurface.pBase = pSwizzled[i];
+        LinearSurface.pBase = pLinear[i];
+        (i ? pfnDownload : CpuSwizzleBlt)(&LinearSurface, &SwizzledSurface, Width * LinearPitch, Height);
+    }
+    EXPECT_EQ(0, memcmp(pLinear[0], pLinear[1], LinearSize))
+        << "Download: Pitch=" << SwizzledPitch << "/" << LinearPitch << " Size=" << Size << " Rect=(" << X << "," << Y << " " << Width << "x" << Height << ")";
+}
+
+/// @brief ULT for CpuSwizzleBltVolume (compared against slice-at-a-time CpuSwizzleBlt)
+TEST_F(CTestCpuBltResource, TestCpuSwizzleBltVolume)
+{
+    const SWIZZLE_DESCRIPTOR *Swizzles[] =
+    {
+        &ST_3D_4KB_8bpp,
+        &ST_3D_4KB_32bpp,
+        &ST_3D_4KB_128bpp,
+        &ST_3D_64KB_8bpp,
+        &ST_3D_64KB_64bpp,
+    };
+
+    for(UINT i = 0; i < sizeof(Swizzles) / sizeof(Swizzles[0]); i++)
+    {
+        const SWIZZLE_DESCRIPTOR *pSwizzle = Swizzles[i];
+        int TileWidth, TileHeight, TileDepth;
+        GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+        const int Pitch = 2 * TileWidth, Height = 2 * TileHeight, TileLayerSize = Pitch * Height * TileDepth;
+        const int LinearPitch = Pitch + 24, LinearSlicePitch = LinearPitch * Height + 8;
+        const struct
+        {
+            int OffsetX, OffsetY, OffsetZ, Width, Height, Depth;
+        } Rects[] =
+        {
+            { 0, 0, 0, Pitch, Height, TileDepth },
+            { 5, 3, 1, Pitch - 21, Height - 6, TileDepth - 2 },
+            { TileWidth - 16, 4, TileDepth - 1, 16, 4, 1 },
+            { 7, 1, 2, 6, 2, 2 }, // No aligned interior.
+        };
+        vector<uint8_t> SwizzledBuffer, ExpectedBuffer, Linear(LinearSlicePitch * TileDepth), Result(Linear.size());
+        uint8_t *pSwizzled = AlignedBuffer(SwizzledBuffer, TileLayerSize, 64);
+        uint8_t *pExpected = AlignedBuffer(ExpectedBuffer, TileLayerSize, 64);
+
+        for(UINT j = 0; j < Linear.size(); j++)
+        {
+            Linear[j] = (uint8_t)(j * 5 + j / 331);
+        }
+
+        for(UINT r = 0; r < sizeof(Rects) / sizeof(Rects[0]); r++)
+        {
+            CPU_SWIZZLE_BLT_SURFACE Swizzled = {}, LinearSurface = {};
+
+            Swizzled.pSwizzle = pSwizzle;
+            Swizzled.Pitch = Pitch;
+            Swizzled.Height = Height;
+            Swizzled.OffsetX = Rects[r].OffsetX;
+            Swizzled.OffsetY = Rects[r].OffsetY;
+            LinearSurface.Pitch = LinearPitch;
+            LinearSurface.Height = Height;
+            LinearSurface.OffsetX = Rects[r].OffsetX;
+            LinearSurface.OffsetY = Rects[r].OffsetY;
+            Swizzled.Temporal = r % 2; // Alternate rects between temporal and streaming access.
+            LinearSurface.PrefetchRows = Swizzled.Temporal ? 0 : 2;
+
+            memset(pExpected, 0, TileLayerSize);
+            for(int z = 0; z < Rects[r].Depth; z++)
+            {
+                CPU_SWIZZLE_BLT_SURFACE SliceSwizzled = Swizzled, SliceLinear = LinearSurface;
+
+                SliceSwizzled.pBase = pExpected;
+                SliceSwizzled.OffsetZ = Rects[r].OffsetZ + z;
+                SliceLinear.pBase = &Linear[z * LinearSlicePitch];
+                CpuSwizzleBlt(&SliceSwizzled, &SliceLinear, Rects[r].Width, Rects[r].Height);
+            }
+
+            memset(pSwizzled, 0, TileLayerSize);
+            Swizzled.pBase = pSwizzled;
+            Swizzled.OffsetZ = Rects[r].OffsetZ;
+            LinearSurface.pBase = Linear.data();
+            CpuSwizzleBltVolume(&Swizzled, &LinearSurface, Rects[r].Width, Rects[r].Height, Rects[r].Depth, LinearSlicePitch);
+            EXPECT_EQ(0, memcmp(pExpected, pSwizzled, TileLayerSize)) << "Swizzle=" << i << " Rect=" << r;
+
+            memset(Result.data(), 0xcd, Result.size());
+            LinearSurface.pBase = Result.data();
+            CpuSwizzleBltVolume(&LinearSurface, &Swizzled, Rects[r].Width, Rects[r].Height, Rects[r].Depth, LinearSlicePitch);
+            for(int z = 0; z < Rects[r].Depth; z++)
+            {
+                for(int y = Rects[r].OffsetY; y < Rects[r].OffsetY + Rects[r].Height; y++)
+                {
+                    const int Offset = z * LinearSlicePitch + y * LinearPitch + Rects[r].OffsetX;
+
+                    EXPECT_EQ(0, memcmp(&Linear[Offset], &Result[Offset], Rects[r].Width))
+                        << "Swizzle=" << i << " Rect=" << r << " Slice=" << z << " Row=" << y;
+                }
+            }
+        }
+    }
+}
+
+/// @brief ULT for depth/stencil split/merge kernels
+TEST_F(CTestCpuBltResource, TestCpuSwizzleBltDepthStencilKernels)
+{
+    const struct
+    {
+        const SWIZZLE_DESCRIPTOR    *pSwizzle;
+        int                         SwizzledPitch, LinearPitch, Size, SubOffset;
+    } Cases[] =
+    {
+        { &INTEL_TILE_Y,        4, 1, 1, 3 }, // S8 of D24S8.
+        { &INTEL_TILE_Y,        4, 3, 3, 0 }, // D24 of D24S8.
+        { &INTEL_TILE_Y,        8, 1, 1, 4 }, // S8 of D32S8X24.
+        { &INTEL_TILE_Y,        8, 4, 4, 0 }, // D32 of D32S8X24.
+        { &ST_2D_4KB_32bpp,     4, 1, 1, 3 },
+        { &ST_2D_64KB_32bpp,    4, 3, 3, 0 },
+        { &ST_2D_4KB_64bpp,     8, 4, 4, 0 },
+        { &ST_2D_64KB_64bpp,    8, 1, 1, 4 },
+        { &INTEL_TILE_W,        1, 4, 1, 3 }, // TileW stencil <--> S8 of linear D24S8.
+        { &INTEL_TILE_W,        1, 8, 1, 4 }, // TileW stencil <--> S8 of linear D32S8X24.
+    };
+
+    for(UINT i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        int TileWidth, TileHeight, TileDepth;
+        GetSwizzleTileDimensions(Cases[i].pSwizzle, TileWidth, TileHeight, TileDepth);
+
+        int Width = 3 * TileWidth / Cases[i].SwizzledPitch, Height = 2 * TileHeight;
+
+        VerifyCpuSwizzleBltSubElement(Cases[i].pSwizzle, Cases[i].SwizzledPitch, Cases[i].LinearPitch, Cases[i].Size, Cases[i].SubOffset, 0, 0, Width, Height);
+        VerifyCpuSwizzleBltSubElement(Cases[i].pSwizzle, Cases[i].SwizzledPitch, Cases[i].LinearPitch, Cases[i].Size, Cases[i].SubOffset, 3, 1, Width - 7, Height - 3);
+        VerifyCpuSwizzleBltSubElement(Cases[i].pSwizzle, Cases[i].SwizzledPitch, Cases[i].LinearPitch, Cases[i].Size, Cases[i].SubOffset, 1, 5, 6, 9); // Narrow.
+        VerifyCpuSwizzleBltSubElement(Cases[i].pSwizzle, Cases[i].SwizzledPitch, Cases[i].LinearPitch, Cases[i].Size, Cases[i].SubOffset, 3, 1, Width - 7, Height - 3, true);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Retiles Width x Height rectangle from swizzled source surface at (SrcX, SrcY)
+/// into differently swizzled destination surface at (DestX, DestY) via
+/// CpuSwizzleBlt, and checks every destination byte against SwizzleOffset
+/// reference (including that bytes outside rectangle were untouched).
+///
+/// @param[in]  pDestSwizzle/pSrcSwizzle: Swizzle descriptors of the surfaces
+/// @param[in]  DestX/DestY/SrcX/SrcY: Rectangle position in each surface, in bytes/rows
+/// @param[in]  Width/Height: Rectangle size, in bytes/rows
+/////////////////////////////////////////////////////////////////////////////////////
+static void VerifyCpuRetileBlt(const SWIZZLE_DESCRIPTOR *pDestSwizzle, const SWIZZLE_DESCRIPTOR *pSrcSwizzle,
+                               int DestX, int DestY, int SrcX, int SrcY, int Width, int Height)
+{
+    const SWIZZLE_DESCRIPTOR *pSwizzle[2] = { pDestSwizzle, pSrcSwizzle };
+    int Pitch[2], SurfaceHeight[2], SurfaceSize[2];
+
+    for(int i = 0; i < 2; i++)
+    {
+        int TileWidth, TileHeight, TileDepth;
+        GetSwizzleTileDimensions(pSwizzle[i], TileWidth, TileHeight, TileDepth);
+
+        Pitch[i] = GFX_ALIGN(GFX_MAX(DestX, SrcX) + Width, TileWidth);
+        SurfaceHeight[i] = GFX_ALIGN(GFX_MAX(DestY, SrcY) + Height, TileHeight);
+        SurfaceSize[i] = Pitch[i] * SurfaceHeight[i];
+    }
+
+    vector<uint8_t> DestBuffer, SrcBuffer, ExpectedBuffer;
+    uint8_t *pDest = AlignedBuffer(DestBuffer, SurfaceSize[0], 64);
+    uint8_t *pSrc = AlignedBuffer(SrcBuffer, SurfaceSize[1], 64);
+
+    memset(pDest, 0xcd, SurfaceSize[0]);
+    for(int i = 0; i < SurfaceSize[1]; i++)
+    {
+        pSrc[i] = (uint8_t)(i * 13 + i / 509);
+    }
+
+    ExpectedBuffer.assign(pDest, pDest + SurfaceSize[0]);
+    for(int y = 0; y < Height; y++)
+    {
+        for(int x = 0; x < Width; x++)
+        {
+            ExpectedBuffer[SwizzleOffset(pDestSwizzle, Pitch[0], DestX + x, DestY + y, 0)] =
+                pSrc[SwizzleOffset(pSrcSwizzle, Pitch[1], SrcX + x, SrcY + y, 0)];
+        }
+    }
+
+    CPU_SWIZZLE_BLT_SURFACE DestSurface = {}, SrcSurface = {};
+
+    DestSurface.pBase = pDest;
+    DestSurface.Pitch = Pitch[0];
+    DestSurface.Height = SurfaceHeight[0];
+    DestSurface.pSwizzle = pDestSwizzle;
+    DestSurface.OffsetX = DestX;
+    DestSurface.OffsetY = DestY;
+
+    SrcSurface.pBase = pSrc;
+    SrcSurface.Pitch = Pitch[1];
+    SrcSurface.Height = SurfaceHeight[1];
+    SrcSurface.pSwizzle = pSrcSwizzle;
+    SrcSurface.OffsetX = SrcX;
+    SrcSurface.OffsetY = SrcY;
+
+    CpuSwizzleBlt(&DestSurface, &SrcSurface, Width, Height);
+    EXPECT_EQ(0, memcmp(ExpectedBuffer.data(), pDest, SurfaceSize[0]))
+        << "Dest=(" << DestX << "," << DestY << ") Src=(" << SrcX << "," << SrcY << ") " << Width << "x" << Height;
+}
+
+/// @brief ULT for SwizzleOffset and intra-tile offset tables
+TEST_F(CTestCpuBltResource, TestSwizzleOffsetTables)
+{
+    const SWIZZLE_DESCRIPTOR *Swizzles[] =
+    {
+        &INTEL_TILE_X,
+        &INTEL_TILE_Y,
+        &INTEL_TILE_W,
+        &ST_2D_4KB_8bpp,
+        &ST_2D_4KB_128bpp,
+        &ST_2D_64KB_8bpp,
+        &ST_2D_64KB_32bpp,
+        &ST_2D_MSAA4_64KB_32bpp,
+        &ST_2D_MSAA16_4KB_16bpp,
+        &ST_3D_4KB_32bpp,
+        &ST_3D_64KB_8bpp,
+    };
+
+    for(UINT i = 0; i < sizeof(Swizzles) / sizeof(Swizzles[0]); i++)
+    {
+        const SWIZZLE_DESCRIPTOR *pSwizzle = Swizzles[i];
+        int TileWidth, TileHeight, TileDepth;
+        GetSwizzleTileDimensions(pSwizzle, TileWidth, TileHeight, TileDepth);
+
+        const SWIZZLE_OFFSET_TABLE *pTable = SwizzleOffsetTable(pSwizzle);
+        ASSERT_TRUE(pTable != NULL) << "Swizzle=" << i;
+        EXPECT_EQ(pTable, SwizzleOffsetTable(pSwizzle)); // Cached.
+
+        SWIZZLE_DESCRIPTOR Copy = *pSwizzle;
+        EXPECT_EQ(pTable, SwizzleOffsetTable(&Copy)); // Matched on content.
+
+        const int Pitch = 3 * TileWidth, Height = 2 * TileHeight;
+        const int Count = Pitch * Height;
+        vector<int> OffsetX(Count), OffsetY(Count), OffsetZ(Count), Result(Count);
+
+        for(int z = 0; z < TileDepth; z++)
+        {
+            for(int j = 0; j < Count; j++)
+            {
+                OffsetX[j] = j % Pitch;
+                OffsetY[j] = j / Pitch;
+                OffsetZ[j] = (j + z) % TileDepth;
+            }
+
+            SwizzleOffsets(pSwizzle, Pitch, Count, OffsetX.data(), OffsetY.data(), OffsetZ.data(), Result.data());
+
+            for(int j = 0; j < Count; j++)
+            {
+                int Expected = ReferenceSwizzleOffset(pSwizzle, Pitch, OffsetX[j], OffsetY[j], OffsetZ[j]);
+
+                if( (Result[j] != Expected) || 
+                    (SwizzleOffset(pSwizzle, Pitch, OffsetX[j], OffsetY[j], OffsetZ[j]) != Expected) || 
+                    (SWIZZLE_TABLE_OFFSET(pTable, Pitch, OffsetX[j], OffsetY[j], OffsetZ[j]) != Expected))
+                {
+                    ADD_FAILURE() << "Swizzle=" << i << " (" << OffsetX[j] << "," << OffsetY[j] << "," << OffsetZ[j] << ")";
+                    break;
+                }
+            }
+        }
+
+        SwizzleOffsets(pSwizzle, Pitch, Count, OffsetX.data(), OffsetY.data(), NULL, Result.data());
+        EXPECT_EQ(ReferenceSwizzleOffset(pSwizzle, Pitch, OffsetX[Count - 1], OffsetY[Count - 1], 0), Result[Count - 1]);
+    }
+}
+
+/// @brief ULT for CpuSwizzleBlt swizzled-to-swizzled (retiling) path
+TEST_F(CTestCpuBltResource, TestCpuRetileBlt)
+{
+    const struct
+    {
+        const SWIZZLE_DESCRIPTOR *pDest, *pSrc;
+    } Pairs[] =
+    {
+        { &INTEL_TILE_Y,        &INTEL_TILE_X },
+        { &INTEL_TILE_X,        &INTEL_TILE_Y },
+        { &INTEL_TILE_X,        &INTEL_TILE_X },
+        { &ST_2D_64KB_32bpp,    &INTEL_TILE_Y },
+        { &INTEL_TILE_Y,        &ST_2D_4KB_32bpp },
+        { &ST_2D_4KB_8bpp,      &ST_2D_64KB_128bpp },
+        { &INTEL_TILE_Y,        &INTEL_TILE_W },
+        { &INTEL_TILE_W,        &INTEL_TILE_X },
+    };
+
+    for(UINT i = 0; i < sizeof(Pairs) / sizeof(Pairs[0]); i++)
+    {
+        VerifyCpuRetileBlt(Pairs[i].pDest, Pairs[i].pSrc, 0, 0, 0, 0, 1024, 64);         // Aligned, multi-tile.
+        VerifyCpuRetileBlt(Pairs[i].pDest, Pairs[i].pSrc, 32, 3, 32, 5, 700, 37);        // Same X phase, unaligned rows.
+        VerifyCpuRetileBlt(Pairs[i].pDest, Pairs[i].pSrc, 5, 1, 19, 2, 300, 21);         // Different X phase.
+        VerifyCpuRetileBlt(Pairs[i].pDest, Pairs[i].pSrc, 120, 30, 8, 0, 20, 3);         // Narrow, straddling tiles.
+    }
 }
 
 /// @brief ULT for 1D Resource
@@ -62,13 +695,1748 @@ TEST_F(CTestCpuBltResource, TestCpuBlt1D)
 /// @brief ULT for 2D Resource
 TEST_F(CTestCpuBltResource, TestCpuBlt2D)
 {
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYF, TEST_TILEYS };
+    const UINT Width = 300, Height = 70, Bpp = 4, SysPitch = Width * Bpp + 12;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        vector<uint8_t> GpuBuffer, SysBuffer(SysPitch * Height), ResultBuffer(SysPitch * Height);
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, (size_t)ResourceInfo.GetSizeSurface(), GMM_KBYTE(64));
+
+        for(UINT j = 0; j < SysBuffer.size(); j++)
+        {
+            SysBuffer[j] = (uint8_t)(j * 5 + j / 509);
+        }
+
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Gpu.pData = pGpu;
+        Blt.Sys.pData = SysBuffer.data();
+        Blt.Sys.RowPitch = SysPitch;
+        Blt.Sys.BufferSize = (uint32_t)SysBuffer.size();
+        Blt.Sys.PixelPitch = Bpp;
+        Blt.Blt.Upload = TRUE;
+
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        // Full-surface download...
+        Blt.Sys.pData = ResultBuffer.data();
+        Blt.Blt.Upload = FALSE;
+
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        for(UINT y = 0; y < Height; y++)
+        {
+            EXPECT_EQ(0, memcmp(&SysBuffer[y * SysPitch], &ResultBuffer[y * SysPitch], Width * Bpp))
+                << "TileType=" << (int)TileTypes[i] << " Row=" << y;
+        }
+
+        // Sub-rectangle download...
+        const UINT OffsetX = 13, OffsetY = 7;
+
+        memset(ResultBuffer.data(), 0, ResultBuffer.size());
+        Blt.Gpu.OffsetX = OffsetX;
+        Blt.Gpu.OffsetY = OffsetY;
+        Blt.Blt.Width = Width - OffsetX - 29;
+        Blt.Blt.Height = Height - OffsetY - 5;
+
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        for(UINT y = 0; y < Blt.Blt.Height; y++)
+        {
+            EXPECT_EQ(0, memcmp(&SysBuffer[(y + OffsetY) * SysPitch + OffsetX * Bpp], &ResultBuffer[y * SysPitch], Blt.Blt.Width * Bpp))
+                << "TileType=" << (int)TileTypes[i] << " Row=" << y;
+        }
+    }
+}
+
+/// @brief ULT for GMM_RES_COPY_BLT::Blt.CacheHint (all hints must produce identical results)
+TEST_F(CTestCpuBltResource, TestCpuBltCacheHint)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_TILEX, TEST_TILEY, TEST_TILEYF, TEST_TILEYS };
+    const GMM_RES_CPU_BLT_CACHE_HINT Hints[] = { GMM_RES_CPU_BLT_CACHE_AUTO, GMM_RES_CPU_BLT_CACHE_TEMPORAL, GMM_RES_CPU_BLT_CACHE_STREAMING };
+    const UINT Width = 300, Height = 70, Bpp = 4, SysPitch = Width * Bpp + 12;
+    const UINT NumHints = sizeof(Hints) / sizeof(Hints[0]);
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ASSERT_EQ(GMM_SUCCESS, ResourceInfo.Create(*pGmmGlobalContext, gmmParams));
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> GpuBuffer[NumHints], SysBuffer(SysPitch * Height), ResultBuffer(SysPitch * Height);
+        uint8_t *pGpu[NumHints];
+
+        for(UINT j = 0; j < SysBuffer.size(); j++)
+        {
+            SysBuffer[j] = (uint8_t)(j * 7 + j / 499);
+        }
+
+        for(UINT h = 0; h < NumHints; h++)
+        {
+            pGpu[h] = AlignedBuffer(GpuBuffer[h], GpuSize, GMM_KBYTE(64));
+            memset(pGpu[h], 0xcd, GpuSize);
+
+            GMM_RES_COPY_BLT Blt = {};
+            Blt.Gpu.pData = pGpu[h];
+            Blt.Gpu.OffsetX = 3;
+            Blt.Gpu.OffsetY = 5;
+            Blt.Sys.pData = SysBuffer.data();
+            Blt.Sys.RowPitch = SysPitch;
+            Blt.Sys.BufferSize = (uint32_t)SysBuffer.size();
+            Blt.Sys.PixelPitch = Bpp;
+            Blt.Blt.Width = Width - 3 - 17;
+            Blt.Blt.Height = Height - 5 - 2;
+            Blt.Blt.Upload = TRUE;
+            Blt.Blt.CacheHint = Hints[h];
+
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+            if(h)
+            {
+                EXPECT_EQ(0, memcmp(pGpu[0], pGpu[h], GpuSize))
+                    << "TileType=" << (int)TileTypes[i] << " Hint=" << (int)Hints[h];
+            }
+
+            memset(ResultBuffer.data(), 0, ResultBuffer.size());
+            Blt.Sys.pData = ResultBuffer.data();
+            Blt.Blt.Upload = FALSE;
+
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+            for(UINT y = 0; y < Blt.Blt.Height; y++)
+            {
+                EXPECT_EQ(0, memcmp(&SysBuffer[y * SysPitch], &ResultBuffer[y * SysPitch], Blt.Blt.Width * Bpp))
+                    << "TileType=" << (int)TileTypes[i] << " Hint=" << (int)Hints[h] << " Row=" << y;
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Client-supplied GMM_RES_CPU_BLT_WORKERS::pfnRunTasks used by TestCpuBltParallel--
+/// runs each task on its own std::thread and counts batch sizes it was handed.
+/////////////////////////////////////////////////////////////////////////////////////
+static void GMM_STDCALL RunTasksOnThreads(void *pPoolContext, uint32_t NumTasks, PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext)
+{
+    vector<thread> Threads;
+
+    *(uint32_t *)pPoolContext += NumTasks;
+
+    for(uint32_t i = 0; i < NumTasks; i++)
+    {
+        Threads.emplace_back(pfnTask, pTaskContext, i);
+    }
+    for(auto &Thread : Threads)
+    {
+        Thread.join();
+    }
+}
+
+/// @brief ULT for tile-row parallel CpuBlt
+TEST_F(CTestCpuBltResource, TestCpuBltParallel)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYF, TEST_TILEYS };
+    const UINT Width = 300, Height = 333, Bpp = 4, SysPitch = Width * Bpp + 12;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, SysBuffer(SysPitch * Height), ResultBuffer(SysPitch * Height);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < SysBuffer.size(); j++)
+        {
+            SysBuffer[j] = (uint8_t)(j * 7 + j / 1021);
+        }
+
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Sys.pData = SysBuffer.data();
+        Blt.Sys.RowPitch = SysPitch;
+        Blt.Sys.BufferSize = (uint32_t)SysBuffer.size();
+        Blt.Sys.PixelPitch = Bpp;
+        Blt.Gpu.OffsetX = 5;
+        Blt.Gpu.OffsetY = 3;
+        Blt.Blt.Width = Width - 11;
+        Blt.Blt.Height = Height - 4;
+
+        // Serial reference...
+        Blt.Gpu.pData = pExpectedGpu;
+        Blt.Blt.Upload = TRUE;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        uint32_t NumTasksRun = 0, NumDefaultTasksRun = 0;
+        const GMM_RES_CPU_BLT_WORKERS ClientWorkers = { 3, RunTasksOnThreads, &NumTasksRun };
+        const GMM_RES_CPU_BLT_WORKERS ClientDefaultWorkers = { 0, RunTasksOnThreads, &NumDefaultTasksRun };
+        const GMM_RES_CPU_BLT_WORKERS PoolWorkers = { 4, NULL, NULL };
+        const GMM_RES_CPU_BLT_WORKERS *pWorkersList[] = { &ClientWorkers, &ClientDefaultWorkers, &PoolWorkers, NULL };
+
+        for(UINT w = 0; w < sizeof(pWorkersList) / sizeof(pWorkersList[0]); w++)
+        {
+            memset(pGpu, 0, GpuSize);
+            Blt.Gpu.pData = pGpu;
+            Blt.Sys.pData = SysBuffer.data();
+            Blt.Blt.Upload = TRUE;
+
+            EXPECT_TRUE(GmmResCpuBltParallel(&ResourceInfo, &Blt, pWorkersList[w]));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize))
+                << "TileType=" << (int)TileTypes[i] << " Workers=" << w;
+
+            memset(ResultBuffer.data(), 0, ResultBuffer.size());
+            Blt.Sys.pData = ResultBuffer.data();
+            Blt.Blt.Upload = FALSE;
+
+            EXPECT_TRUE(GmmResCpuBltParallel(&ResourceInfo, &Blt, pWorkersList[w]));
+            for(UINT y = 0; y < Blt.Blt.Height; y++)
+            {
+                EXPECT_EQ(0, memcmp(&SysBuffer[y * SysPitch], &ResultBuffer[y * SysPitch], Blt.Blt.Width * Bpp))
+                    << "TileType=" << (int)TileTypes[i] << " Workers=" << w << " Row=" << y;
+            }
+        }
+
+        // Swizzled BLT's should have been split into multiple bands (linear BLT's are not split)...
+        if(TileTypes[i] == TEST_LINEAR)
+        {
+            EXPECT_EQ(0u, NumTasksRun);
+        }
+        else
+        {
+            EXPECT_EQ(2u * ClientWorkers.NumWorkers, NumTasksRun) << "TileType=" << (int)TileTypes[i];
+
+            // ...one per CPU, at most, when client didn't say how many...
+            EXPECT_LE(NumDefaultTasksRun, 2u * GFX_MAX(thread::hardware_concurrency(), 1u)) << "TileType=" << (int)TileTypes[i];
+            if(thread::hardware_concurrency() > 1)
+            {
+                EXPECT_NE(0u, NumDefaultTasksRun) << "TileType=" << (int)TileTypes[i];
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Completion callback state used by TestCpuBltAsync--an upload whose callback 
+/// chains the download of the same rectangle.
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct CPU_BLT_ASYNC_CHAIN_REC
+{
+    GMM_RESOURCE_INFO       *pResourceInfo;
+    GMM_RES_COPY_BLT        DownloadBlt;
+    GMM_RES_CPU_BLT_ASYNC   *pDownload;
+    atomic<uint32_t>        NumUploadCallbacks;
+    atomic<uint32_t>        NumDownloadCallbacks;
+    BOOLEAN                 UploadSuccess;
+} CPU_BLT_ASYNC_CHAIN;
+
+static void GMM_STDCALL OnAsyncDownloadComplete(void *pCallbackContext, BOOLEAN Success)
+{
+    CPU_BLT_ASYNC_CHAIN *pChain = (CPU_BLT_ASYNC_CHAIN *)pCallbackContext;
+
+    EXPECT_TRUE(Success);
+    pChain->NumDownloadCallbacks++;
+}
+
+static void GMM_STDCALL OnAsyncUploadComplete(void *pCallbackContext, BOOLEAN Success)
+{
+    CPU_BLT_ASYNC_CHAIN *pChain = (CPU_BLT_ASYNC_CHAIN *)pCallbackContext;
+
+    pChain->UploadSuccess = Success;
+    pChain->NumUploadCallbacks++;
+    pChain->pDownload = GmmResCpuBltAsync(pChain->pResourceInfo, &pChain->DownloadBlt, NULL, OnAsyncDownloadComplete, pChain);
+}
+
+/// @brief ULT for asynchronous CpuBlt
+TEST_F(CTestCpuBltResource, TestCpuBltAsync)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS };
+    const UINT NumTileTypes = sizeof(TileTypes) / sizeof(TileTypes[0]);
+    const UINT Width = 500, Height = 300, Bpp = 4, SysPitch = Width * Bpp + 12;
+    GMM_RESOURCE_INFO ResourceInfo[NumTileTypes];
+    vector<uint8_t> ExpectedGpuBuffer[NumTileTypes], GpuBuffer[NumTileTypes];
+    vector<uint8_t> SysBuffer(SysPitch * Height), ResultBuffer[NumTileTypes];
+    uint8_t *pExpectedGpu[NumTileTypes], *pGpu[NumTileTypes];
+    GMM_RES_COPY_BLT Blt = {};
+
+    for(UINT j = 0; j < SysBuffer.size(); j++)
+    {
+        SysBuffer[j] = (uint8_t)(j * 13 + j / 883);
+    }
+
+    Blt.Sys.RowPitch = SysPitch;
+    Blt.Sys.BufferSize = (uint32_t)SysBuffer.size();
+    Blt.Sys.PixelPitch = Bpp;
+    Blt.Gpu.OffsetX = 7;
+    Blt.Gpu.OffsetY = 2;
+    Blt.Blt.Width = Width - 20;
+    Blt.Blt.Height = Height - 9;
+
+    // Several uploads in flight at once, checked against synchronous CpuBlt...
+    GMM_RES_CPU_BLT_ASYNC *pAsync[NumTileTypes];
+
+    for(UINT i = 0; i < NumTileTypes; i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        ASSERT_EQ(GMM_SUCCESS, ResourceInfo[i].Create(*pGmmGlobalContext, gmmParams));
+
+        const size_t GpuSize = (size_t)ResourceInfo[i].GetSizeSurface();
+        pExpectedGpu[i] = AlignedBuffer(ExpectedGpuBuffer[i], GpuSize, GMM_KBYTE(64));
+        pGpu[i] = AlignedBuffer(GpuBuffer[i], GpuSize, GMM_KBYTE(64));
+        memset(pExpectedGpu[i], 0, GpuSize);
+        memset(pGpu[i], 0, GpuSize);
+
+        Blt.Gpu.pData = pExpectedGpu[i];
+        Blt.Sys.pData = SysBuffer.data();
+        Blt.Blt.Upload = TRUE;
+        EXPECT_TRUE(ResourceInfo[i].CpuBlt(&Blt));
+
+        Blt.Gpu.pData = pGpu[i];
+        pAsync[i] = GmmResCpuBltAsync(&ResourceInfo[i], &Blt, NULL, NULL, NULL);
+        ASSERT_TRUE(pAsync[i] != NULL);
+    }
+
+    for(UINT i = 0; i < NumTileTypes; i++)
+    {
+        EXPECT_TRUE(GmmResCpuBltAsyncWait(pAsync[i]));
+        EXPECT_TRUE(GmmResCpuBltAsyncIsComplete(pAsync[i]));
+        EXPECT_EQ(0, memcmp(pExpectedGpu[i], pGpu[i], (size_t)ResourceInfo[i].GetSizeSurface()))
+            << "TileType=" << (int)TileTypes[i];
+        GmmResCpuBltAsyncRelease(pAsync[i]);
+    }
+
+    // Upload chaining download via completion callback...
+    for(UINT i = 0; i < NumTileTypes; i++)
+    {
+        CPU_BLT_ASYNC_CHAIN Chain;
+        const GMM_RES_CPU_BLT_WORKERS Workers = { 2, NULL, NULL };
+
+        memset(pGpu[i], 0, (size_t)ResourceInfo[i].GetSizeSurface());
+        ResultBuffer[i].assign(SysBuffer.size(), 0);
+
+        Chain.pResourceInfo = &ResourceInfo[i];
+        Chain.DownloadBlt = Blt;
+        Chain.DownloadBlt.Gpu.pData = pGpu[i];
+        Chain.DownloadBlt.Sys.pData = ResultBuffer[i].data();
+        Chain.DownloadBlt.Blt.Upload = FALSE;
+        Chain.pDownload = NULL;
+        Chain.NumUploadCallbacks = 0;
+        Chain.NumDownloadCallbacks = 0;
+        Chain.UploadSuccess = FALSE;
+
+        Blt.Gpu.pData = pGpu[i];
+        Blt.Sys.pData = SysBuffer.data();
+        Blt.Blt.Upload = TRUE;
+
+        GMM_RES_CPU_BLT_ASYNC *pUpload = GmmResCpuBltAsync(&ResourceInfo[i], &Blt, &Workers, OnAsyncUploadComplete, &Chain);
+        ASSERT_TRUE(pUpload != NULL);
+
+        GmmResCpuBltAsyncRelease(pUpload); // Callback runs before handle is signaled, so download now queued.
+        EXPECT_EQ(1u, Chain.NumUploadCallbacks.load());
+        EXPECT_TRUE(Chain.UploadSuccess);
+        ASSERT_TRUE(Chain.pDownload != NULL);
+
+        EXPECT_TRUE(GmmResCpuBltAsyncWait(Chain.pDownload));
+        EXPECT_EQ(1u, Chain.NumDownloadCallbacks.load());
+        GmmResCpuBltAsyncRelease(Chain.pDownload);
+
+        for(UINT y = 0; y < Blt.Blt.Height; y++)
+        {
+            EXPECT_EQ(0, memcmp(&SysBuffer[y * SysPitch], &ResultBuffer[i][y * SysPitch], Blt.Blt.Width * Bpp))
+                << "TileType=" << (int)TileTypes[i] << " Row=" << y;
+        }
+    }
+}
+
+/// @brief ULT for batched CpuBlt of mipped texture array
+TEST_F(CTestCpuBltResource, TestCpuBltBatch)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYF, TEST_TILEYS };
+    const UINT Width = 256, Height = 64, ArraySize = 3, MaxLod = 2, Bpp = 4, Strips = 4;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.ArraySize = ArraySize;
+        gmmParams.MaxLod = MaxLod;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer;
+        vector<uint8_t> SysBuffer[MaxLod + 1], ResultBuffer[MaxLod + 1];
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+        vector<GMM_RES_COPY_BLT> Blts;
+
+        memset(pExpectedGpu, 0, GpuSize);
+        memset(pGpu, 0, GpuSize);
+
+        for(UINT Mip = 0; Mip <= MaxLod; Mip++)
+        {
+            const UINT MipWidth = Width >> Mip, MipHeight = Height >> Mip;
+            const UINT SysPitch = MipWidth * Bpp, SysSlicePitch = SysPitch * MipHeight;
+
+            SysBuffer[Mip].resize(SysSlicePitch * ArraySize);
+            ResultBuffer[Mip].resize(SysSlicePitch * ArraySize);
+            for(UINT j = 0; j < SysBuffer[Mip].size(); j++)
+            {
+                SysBuffer[Mip][j] = (uint8_t)(j * 3 + j / 251 + Mip);
+            }
+
+            GMM_RES_COPY_BLT Blt = {};
+            Blt.Gpu.pData = pExpectedGpu;
+            Blt.Gpu.MipLevel = Mip;
+            Blt.Sys.pData = SysBuffer[Mip].data();
+            Blt.Sys.RowPitch = SysPitch;
+            Blt.Sys.SlicePitch = SysSlicePitch;
+            Blt.Sys.BufferSize = (uint32_t)SysBuffer[Mip].size();
+            Blt.Sys.PixelPitch = Bpp;
+            Blt.Blt.Slices = ArraySize;
+            Blt.Blt.Upload = TRUE;
+
+            // Reference: one CpuBlt per mip...
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+            // Batch: mip 0 as column strips (coalescing horizontally), mip 1 as 
+            // row strips (coalescing vertically), rest as whole multi-slice BLT's...
+            Blt.Gpu.pData = pGpu;
+            if(Mip < 2)
+            {
+                for(UINT Slice = 0; Slice < ArraySize; Slice++)
+                {
+                    for(UINT Strip = 0; Strip < Strips; Strip++)
+                    {
+                        GMM_RES_COPY_BLT StripBlt = Blt;
+                        UINT SysOffset = Slice * SysSlicePitch;
+
+                        StripBlt.Gpu.Slice = Slice;
+                        StripBlt.Blt.Slices = 1;
+                        if(Mip == 0)
+                        {
+                            StripBlt.Gpu.OffsetX = Strip * (MipWidth / Strips);
+                            StripBlt.Blt.Width = MipWidth / Strips;
+                            StripBlt.Blt.Height = MipHeight;
+                            SysOffset += StripBlt.Gpu.OffsetX * Bpp;
+                        }
+                        else
+                        {
+                            StripBlt.Gpu.OffsetY = Strip * (MipHeight / Strips);
+                            StripBlt.Blt.Width = MipWidth;
+                            StripBlt.Blt.Height = MipHeight / Strips;
+                            SysOffset += StripBlt.Gpu.OffsetY * SysPitch;
+                        }
+                        StripBlt.Sys.pData = &SysBuffer[Mip][SysOffset];
+                        StripBlt.Sys.BufferSize = Blt.Sys.BufferSize - SysOffset;
+                        Blts.push_back(StripBlt);
+                    }
+                }
+            }
+            else
+            {
+                Blts.push_back(Blt);
+            }
+        }
+
+        EXPECT_TRUE(GmmResCpuBltBatch(&ResourceInfo, Blts.data(), (uint32_t)Blts.size()));
+        EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "TileType=" << (int)TileTypes[i];
+
+        // Download same batch...
+        for(auto &Blt : Blts)
+        {
+            UINT Mip = Blt.Gpu.MipLevel;
+
+            Blt.Sys.pData = &ResultBuffer[Mip][(uint8_t *)Blt.Sys.pData - SysBuffer[Mip].data()];
+            Blt.Blt.Upload = FALSE;
+        }
+
+        EXPECT_TRUE(ResourceInfo.CpuBltBatch(Blts.data(), (uint32_t)Blts.size()));
+        for(UINT Mip = 0; Mip <= MaxLod; Mip++)
+        {
+            EXPECT_EQ(0, memcmp(SysBuffer[Mip].data(), ResultBuffer[Mip].data(), SysBuffer[Mip].size()))
+                << "TileType=" << (int)TileTypes[i] << " Mip=" << Mip;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Band callback state for TestCpuBltStream--copies bands to/from a full-size 
+/// linear image, checking bands arrive in order and within staging limits.
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct STREAM_TEST_CONTEXT_REC
+{
+    uint8_t     *pImage;
+    uint32_t    RowPitch, SlicePitch, MaxBandHeight, NextIndex, NumBands, NumRows;
+    BOOLEAN     Upload, InOrder;
+} STREAM_TEST_CONTEXT;
+
+static BOOLEAN GMM_STDCALL StreamTestBand(void *pContext, const GMM_RES_COPY_BLT_BAND *pBand)
+{
+    STREAM_TEST_CONTEXT *pTest = (STREAM_TEST_CONTEXT *)pContext;
+    uint8_t *pImage = pTest->pImage + pBand->Slice * pTest->SlicePitch + pBand->OffsetY * pTest->RowPitch;
+
+    pTest->InOrder = pTest->InOrder && (pBand->Index == pTest->NextIndex) && (pBand->Height <= pTest->MaxBandHeight);
+    pTest->NextIndex++;
+    pTest->NumBands++;
+    pTest->NumRows += pBand->Height;
+
+    if(pTest->Upload)
+    {
+        memcpy(pBand->pData, pImage, pBand->Size);
+    }
+    else
+    {
+        memcpy(pImage, pBand->pData, pBand->Size);
+    }
+    return TRUE;
+}
+
+/// @brief ULT for band-streamed CpuBlt
+TEST_F(CTestCpuBltResource, TestCpuBltStream)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS };
+    const UINT Width = 200, Height = 150, ArraySize = 3, Bpp = 4, RowPitch = Width * Bpp;
+    const UINT StartY = 5, StreamHeight = Height - StartY - 3;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.ArraySize = ArraySize;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Image(RowPitch * Height * ArraySize), ResultImage(Image.size());
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < Image.size(); j++)
+        {
+            Image[j] = (uint8_t)(j * 11 + j / 773);
+        }
+        memset(pExpectedGpu, 0, GpuSize);
+
+        // Reference: whole-image CpuBlt...
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Gpu.pData = pExpectedGpu;
+        Blt.Gpu.OffsetY = StartY;
+        Blt.Sys.pData = &Image[StartY * RowPitch];
+        Blt.Sys.RowPitch = RowPitch;
+        Blt.Sys.SlicePitch = RowPitch * Height;
+        Blt.Sys.BufferSize = (uint32_t)(Image.size() - StartY * RowPitch);
+        Blt.Blt.Height = StreamHeight;
+        Blt.Blt.Slices = ArraySize;
+        Blt.Blt.Upload = TRUE;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        // Staging for two 32-row bands (streamed serially, then with overlap)...
+        const UINT BandHeight = 32;
+        const GMM_RES_CPU_BLT_WORKERS PoolWorkers = { 0, NULL, NULL };
+        const GMM_RES_CPU_BLT_WORKERS *pWorkersList[] = { NULL, &PoolWorkers };
+        vector<uint8_t> Staging(2 * BandHeight * RowPitch);
+
+        for(UINT w = 0; w < sizeof(pWorkersList) / sizeof(pWorkersList[0]); w++)
+        {
+            STREAM_TEST_CONTEXT Test = {};
+            GMM_RES_COPY_BLT_STREAM Stream = {};
+
+            Stream.Blt = Blt;
+            Stream.Blt.Gpu.pData = pGpu;
+            Stream.Blt.Sys.pData = NULL;
+            Stream.pStaging = Staging.data();
+            Stream.StagingSize = (uint32_t)Staging.size();
+            Stream.pWorkers = pWorkersList[w];
+            Stream.pfnBand = StreamTestBand;
+            Stream.pContext = &Test;
+
+            Test.pImage = Image.data();
+            Test.RowPitch = RowPitch;
+            Test.SlicePitch = RowPitch * Height;
+            Test.MaxBandHeight = 2 * BandHeight; // i.e. Whatever fits staging.
+            Test.Upload = TRUE;
+            Test.InOrder = TRUE;
+
+            memset(pGpu, 0, GpuSize);
+            EXPECT_TRUE(GmmResCpuBltStream(&ResourceInfo, &Stream));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "TileType=" << (int)TileTypes[i] << " Workers=" << w;
+            EXPECT_TRUE(Test.InOrder);
+            EXPECT_GT(Test.NumBands, ArraySize);
+            EXPECT_EQ(StreamHeight * ArraySize, Test.NumRows);
+
+            // Download...
+            memset(&Test, 0, sizeof(Test));
+            Test.pImage = ResultImage.data();
+            Test.RowPitch = RowPitch;
+            Test.SlicePitch = RowPitch * Height;
+            Test.MaxBandHeight = 2 * BandHeight; // i.e. Whatever fits staging.
+            Test.InOrder = TRUE;
+
+            memset(ResultImage.data(), 0, ResultImage.size());
+            Stream.Blt.Blt.Upload = FALSE;
+            EXPECT_TRUE(ResourceInfo.CpuBltStream(&Stream));
+            EXPECT_TRUE(Test.InOrder);
+            for(UINT Slice = 0; Slice < ArraySize; Slice++)
+            {
+                const size_t Offset = Slice * Test.SlicePitch + StartY * RowPitch;
+
+                EXPECT_EQ(0, memcmp(&Image[Offset], &ResultImage[Offset], StreamHeight * RowPitch))
+                    << "TileType=" << (int)TileTypes[i] << " Workers=" << w << " Slice=" << Slice;
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Scalar reference IEEE half-to-single conversion for TestCpuBltConvert.
+/////////////////////////////////////////////////////////////////////////////////////
+static uint32_t ReferenceHalfToFloat(uint16_t Half)
+{
+    uint32_t Sign = (uint32_t)(Half & 0x8000) << 16;
+    uint32_t Exp = (Half >> 10) & 0x1f;
+    uint32_t Mant = Half & 0x3ff;
+
+    if(Exp == 0x1f) // Inf/NaN
+    {
+        return Sign | 0x7f800000 | (Mant << 13);
+    }
+    if(Exp == 0)
+    {
+        if(!Mant)
+        {
+            return Sign;
+        }
+        while(!(Mant & 0x400)) // Normalize denormal...
+        {
+            Mant <<= 1;
+            Exp--;
+        }
+        Exp++;
+        Mant &= 0x3ff;
+    }
+    return Sign | ((Exp + 127 - 15) << 23) | (Mant << 13);
+}
+
+/// @brief ULT for CpuBlt with fused format conversion
+TEST_F(CTestCpuBltResource, TestCpuBltConvert)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_TILEX, TEST_TILEY, TEST_TILEYF, TEST_TILEYS };
+    const UINT Width = 100, Height = 40, Bpp = 4;
+    const CPU_SWIZZLE_BLT_CONVERT BgraToRgba = { CPU_SWIZZLE_BLT_CONVERT_NONE, 1, 4, { 2, 1, 0, 3 } };
+    const CPU_SWIZZLE_BLT_CONVERT RgbToRgbx = { CPU_SWIZZLE_BLT_CONVERT_NONE, 1, 4, { 0, 1, 2, CPU_SWIZZLE_BLT_CONVERT_CONSTANT }, 0xff };
+    const CPU_SWIZZLE_BLT_CONVERT HalfToFloat = { CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT, 2, 1, { 0 } };
+    const CPU_SWIZZLE_BLT_CONVERT FloatToHalf = { CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF, 4, 1, { 0 } };
 
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        vector<uint8_t> GpuBuffer;
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, (size_t)ResourceInfo.GetSizeSurface(), GMM_KBYTE(64));
+        vector<uint8_t> SysBuffer(Width * Height * Bpp), ResultBuffer(Width * Height * Bpp);
+
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Gpu.pData = pGpu;
+        Blt.Sys.BufferSize = (uint32_t)SysBuffer.size();
+
+        // Plain (unconverted) download of resource into ResultBuffer...
+        auto Download = [&]()
+        {
+            GMM_RES_COPY_BLT Plain = {};
+            Plain.Gpu.pData = pGpu;
+            Plain.Sys.pData = ResultBuffer.data();
+            Plain.Sys.RowPitch = Width * Bpp;
+            Plain.Sys.BufferSize = (uint32_t)ResultBuffer.size();
+            Plain.Blt.Width = Width;
+            Plain.Blt.Height = Height;
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Plain));
+        };
+
+        for(UINT j = 0; j < SysBuffer.size(); j++)
+        {
+            SysBuffer[j] = (uint8_t)(j * 13 + j / 397);
+        }
+
+        // BGRA8 --> RGBA8...
+        Blt.Sys.pData = SysBuffer.data();
+        Blt.Sys.RowPitch = Width * Bpp;
+        Blt.Sys.PixelPitch = Bpp;
+        Blt.Blt.Width = Width;
+        Blt.Blt.Height = Height;
+        Blt.Blt.Upload = TRUE;
+        Blt.Blt.pConvert = &BgraToRgba;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        Download();
+        for(UINT p = 0; p < Width * Height; p++)
+        {
+            const uint8_t *pSys = &SysBuffer[p * Bpp], *pResult = &ResultBuffer[p * Bpp];
+            ASSERT_TRUE(pResult[0] == pSys[2] && pResult[1] == pSys[1] && pResult[2] == pSys[0] && pResult[3] == pSys[3])
+                << "BGRA TileType=" << (int)TileTypes[i] << " Pixel=" << p;
+        }
+
+        // RGB24 --> RGBX8 (sub-rectangle)...
+        const UINT OffsetX = 7, OffsetY = 3, RectWidth = Width - 20, RectHeight = Height - 9;
+
+        memset(pGpu, 0, (size_t)ResourceInfo.GetSizeSurface());
+        Blt.Gpu.OffsetX = OffsetX;
+        Blt.Gpu.OffsetY = OffsetY;
+        Blt.Sys.RowPitch = RectWidth * 3;
+        Blt.Sys.PixelPitch = 3;
+        Blt.Blt.Width = RectWidth;
+        Blt.Blt.Height = RectHeight;
+        Blt.Blt.pConvert = &RgbToRgbx;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        Download();
+        for(UINT y = 0; y < Height; y++)
+        {
+            for(UINT x = 0; x < Width; x++)
+            {
+                const uint8_t *pResult = &ResultBuffer[(y * Width + x) * Bpp];
+                uint8_t Expected[4] = {};
+
+                if(x >= OffsetX && x < OffsetX + RectWidth && y >= OffsetY && y < OffsetY + RectHeight)
+                {
+                    memcpy(Expected, &SysBuffer[(y - OffsetY) * Blt.Sys.RowPitch + (x - OffsetX) * 3], 3);
+                    Expected[3] = 0xff;
+                }
+                ASSERT_EQ(0, memcmp(Expected, pResult, 4))
+                    << "RGB TileType=" << (int)TileTypes[i] << " x=" << x << " y=" << y;
+            }
+        }
+
+        // R16F --> R32F, then R32F --> R16F download...
+        vector<uint16_t> Halves(Width * Height), ResultHalves(Width * Height);
+
+        for(UINT p = 0; p < Halves.size(); p++)
+        {
+            Halves[p] = (uint16_t)(p * 7919 + (p >> 4));
+            if(((Halves[p] & 0x7c00) == 0x7c00) && (Halves[p] & 0x3ff)) // Only canonical NaN survives round trip.
+            {
+                Halves[p] = (Halves[p] & 0x8000) | 0x7e00;
+            }
+        }
+        Halves[0] = 0x0001;  // Smallest denormal
+        Halves[1] = 0x7c00;  // +Inf
+        Halves[2] = 0x8000;  // -0
+
+        Blt.Gpu.OffsetX = Blt.Gpu.OffsetY = 0;
+        Blt.Sys.pData = Halves.data();
+        Blt.Sys.RowPitch = Width * 2;
+        Blt.Sys.PixelPitch = 2;
+        Blt.Sys.BufferSize = (uint32_t)(Halves.size() * 2);
+        Blt.Blt.Width = Width;
+        Blt.Blt.Height = Height;
+        Blt.Blt.pConvert = &HalfToFloat;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        Download();
+        for(UINT p = 0; p < Halves.size(); p++)
+        {
+            uint32_t Result;
+
+            memcpy(&Result, &ResultBuffer[p * Bpp], sizeof(Result));
+            ASSERT_EQ(ReferenceHalfToFloat(Halves[p]), Result)
+                << "Half=" << Halves[p] << " TileType=" << (int)TileTypes[i] << " Pixel=" << p;
+        }
+
+        Blt.Sys.pData = ResultHalves.data();
+        Blt.Blt.Upload = FALSE;
+        Blt.Blt.pConvert = &FloatToHalf;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        EXPECT_EQ(0, memcmp(Halves.data(), ResultHalves.data(), Halves.size() * 2)) << "TileType=" << (int)TileTypes[i];
+    }
+}
+
+/// @brief ULT for pattern fill of resource rectangles
+TEST_F(CTestCpuBltResource, TestCpuFill)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS };
+    const uint8_t Pattern[16] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xf0, 0x0f };
+    const UINT PatternSizes[] = { 1, 4, 12, 16 };
+    const UINT Width = 200, Height = 150, ArraySize = 3, Bpp = 4;
+    const UINT OffsetX = 3, OffsetY = 5, FillWidth = 150, FillHeight = 70;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.ArraySize = ArraySize;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Image(FillWidth * Bpp * FillHeight * 2);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT p = 0; p < sizeof(PatternSizes) / sizeof(PatternSizes[0]); p++)
+        {
+            // Reference: CpuBlt of linear image of pattern...
+            for(UINT j = 0; j < Image.size(); j++)
+            {
+                Image[j] = Pattern[(j % (FillWidth * Bpp)) % PatternSizes[p]];
+            }
+            memset(pExpectedGpu, 0xcd, GpuSize);
+
+            GMM_RES_COPY_BLT Blt = {};
+            Blt.Gpu.pData = pExpectedGpu;
+            Blt.Gpu.Slice = 1;
+            Blt.Gpu.OffsetX = OffsetX;
+            Blt.Gpu.OffsetY = OffsetY;
+            Blt.Sys.pData = Image.data();
+            Blt.Sys.RowPitch = FillWidth * Bpp;
+            Blt.Sys.SlicePitch = FillWidth * Bpp * FillHeight;
+            Blt.Sys.BufferSize = (uint32_t)Image.size();
+            Blt.Blt.Width = FillWidth;
+            Blt.Blt.Height = FillHeight;
+            Blt.Blt.Slices = 2;
+            Blt.Blt.Upload = TRUE;
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+            GMM_RES_FILL Fill = {};
+            Fill.Gpu.pData = pGpu;
+            Fill.Gpu.Slice = 1;
+            Fill.Gpu.OffsetX = OffsetX;
+            Fill.Gpu.OffsetY = OffsetY;
+            Fill.Pattern.pData = Pattern;
+            Fill.Pattern.Size = PatternSizes[p];
+            Fill.Fill.Width = FillWidth;
+            Fill.Fill.Height = FillHeight;
+            Fill.Fill.Slices = 2;
+
+            memset(pGpu, 0xcd, GpuSize);
+            EXPECT_TRUE(GmmResCpuFill(&ResourceInfo, &Fill));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "TileType=" << (int)TileTypes[i] << " PatternSize=" << PatternSizes[p];
+        }
+    }
+}
+
+/// @brief ULT for per-tile hashing and diff of resource snapshots
+TEST_F(CTestCpuBltResource, TestTileHashes)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS };
+    const UINT Width = 300, Height = 200, ArraySize = 2, Bpp = 4;
+    const UINT RectWidth = 5, RectHeight = 3, RectX = 37, RectY = 41;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.ArraySize = ArraySize;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeMainSurface();
+        vector<uint8_t> OldGpuBuffer, GpuBuffer, Rect(RectWidth * RectHeight * Bpp, 0x5a);
+        uint8_t *pOldGpu = AlignedBuffer(OldGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        // Query...
+        GMM_RES_TILE_HASHES Old = {}, New = {};
+        EXPECT_TRUE(GmmResGetTileHashes(&ResourceInfo, NULL, &Old));
+        EXPECT_EQ((TileTypes[i] == TEST_TILEYS) ? GMM_KBYTE(64) : GMM_KBYTE(4), Old.TileSize);
+        EXPECT_EQ((GpuSize + Old.TileSize - 1) / Old.TileSize, Old.NumTiles);
+
+        vector<uint32_t> OldHashes(Old.NumTiles), NewHashes(Old.NumTiles), Changed(Old.NumTiles);
+        Old.pHashes = OldHashes.data();
+        New.pHashes = NewHashes.data();
+        New.NumTiles = Old.NumTiles;
+
+        for(UINT j = 0; j < GpuSize; j++)
+        {
+            pOldGpu[j] = (uint8_t)(j * 7 + j / 4099);
+        }
+        EXPECT_TRUE(GmmResGetTileHashes(&ResourceInfo, pOldGpu, &Old));
+
+        // Unchanged snapshot...
+        memcpy(pGpu, pOldGpu, GpuSize);
+        EXPECT_TRUE(GmmResGetTileHashes(&ResourceInfo, pGpu, &New));
+        EXPECT_EQ(0u, GmmResDiffTileHashes(&Old, &New, Changed.data(), (uint32_t)Changed.size()));
+
+        // Small rectangle changed...
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Gpu.pData = pGpu;
+        Blt.Gpu.Slice = 1;
+        Blt.Gpu.OffsetX = RectX;
+        Blt.Gpu.OffsetY = RectY;
+        Blt.Sys.pData = Rect.data();
+        Blt.Sys.RowPitch = RectWidth * Bpp;
+        Blt.Sys.BufferSize = (uint32_t)Rect.size();
+        Blt.Blt.Width = RectWidth;
+        Blt.Blt.Height = RectHeight;
+        Blt.Blt.Upload = TRUE;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        EXPECT_TRUE(GmmResGetTileHashes(&ResourceInfo, pGpu, &New));
+
+        vector<uint32_t> Expected;
+        for(UINT Tile = 0; Tile < Old.NumTiles; Tile++)
+        {
+            size_t Offset = (size_t)Tile * Old.TileSize;
+            if(memcmp(pOldGpu + Offset, pGpu + Offset, min((size_t)Old.TileSize, GpuSize - Offset)))
+            {
+                Expected.push_back(Tile);
+            }
+        }
+        ASSERT_FALSE(Expected.empty());
+
+        uint32_t NumChanged = GmmResDiffTileHashes(&Old, &New, Changed.data(), (uint32_t)Changed.size());
+        ASSERT_EQ(Expected.size(), NumChanged) << "TileType=" << (int)TileTypes[i];
+        EXPECT_EQ(0, memcmp(Expected.data(), Changed.data(), NumChanged * sizeof(uint32_t))) << "TileType=" << (int)TileTypes[i];
+
+        // Truncated list still counts all...
+        EXPECT_EQ(NumChanged, GmmResDiffTileHashes(&Old, &New, NULL, 0));
+    }
+}
+
+/// @brief ULT for dirty-tile tracking and incremental upload
+TEST_F(CTestCpuBltResource, TestDirtyTiles)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEX, TEST_TILEY, TEST_TILEYS };
+    const UINT Width = 300, Height = 200, ArraySize = 2, Bpp = 4, RowPitch = Width * Bpp, SlicePitch = RowPitch * Height;
+    const struct { UINT Slice, X, Y, Width, Height; } Rects[] = { { 0, 37, 41, 5, 3 }, { 1, 150, 10, 100, 40 } };
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.ArraySize = ArraySize;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeMainSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Image(SlicePitch * ArraySize);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < Image.size(); j++)
+        {
+            Image[j] = (uint8_t)(j * 5 + j / 1021);
+        }
+
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Sys.pData = Image.data();
+        Blt.Sys.RowPitch = RowPitch;
+        Blt.Sys.SlicePitch = SlicePitch;
+        Blt.Sys.BufferSize = (uint32_t)Image.size();
+        Blt.Blt.Slices = ArraySize;
+        Blt.Blt.Upload = TRUE;
+
+        memset(pGpu, 0, GpuSize);
+        Blt.Gpu.pData = pGpu;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        GMM_RES_DIRTY_TILES Dirty = {};
+        EXPECT_TRUE(GmmResInitDirtyTiles(&ResourceInfo, &Dirty));
+        vector<uint32_t> Bits((Dirty.NumTiles + 31) / 32, 0xffffffff);
+        Dirty.pBits = Bits.data();
+        EXPECT_TRUE(GmmResInitDirtyTiles(&ResourceInfo, &Dirty));
+        EXPECT_EQ(0u, Dirty.NumDirty);
+
+        // Update rectangles of linear image, and mark them...
+        for(UINT r = 0; r < sizeof(Rects) / sizeof(Rects[0]); r++)
+        {
+            GMM_RES_COPY_BLT Rect = {};
+
+            for(UINT y = 0; y < Rects[r].Height; y++)
+            {
+                memset(&Image[Rects[r].Slice * SlicePitch + (Rects[r].Y + y) * RowPitch + Rects[r].X * Bpp], 0x80 + r, Rects[r].Width * Bpp);
+            }
+
+            Rect.Gpu.Slice = Rects[r].Slice;
+            Rect.Gpu.OffsetX = Rects[r].X;
+            Rect.Gpu.OffsetY = Rects[r].Y;
+            Rect.Blt.Width = Rects[r].Width;
+            Rect.Blt.Height = Rects[r].Height;
+            EXPECT_TRUE(GmmResMarkDirtyTiles(&ResourceInfo, &Dirty, &Rect));
+        }
+        EXPECT_GT(Dirty.NumDirty, 0u);
+        EXPECT_LT(Dirty.NumDirty, Dirty.NumTiles / 2);
+
+        // Reference: full re-upload...
+        memset(pExpectedGpu, 0, GpuSize);
+        Blt.Gpu.pData = pExpectedGpu;
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+
+        // Canary in a clean tile must survive flush (i.e. clean tiles not rewritten)...
+        UINT CleanTile = 0;
+        while(Bits[CleanTile / 32] & (1u << (CleanTile % 32))) CleanTile++;
+        pGpu[CleanTile * Dirty.TileSize] ^= 0xff;
+
+        Blt.Gpu.pData = pGpu;
+        EXPECT_TRUE(GmmResFlushDirtyTiles(&ResourceInfo, &Dirty, &Blt, 1));
+        EXPECT_EQ(0u, Dirty.NumDirty);
+
+        EXPECT_EQ(pExpectedGpu[CleanTile * Dirty.TileSize] ^ 0xff, pGpu[CleanTile * Dirty.TileSize]) << "TileType=" << (int)TileTypes[i];
+        pGpu[CleanTile * Dirty.TileSize] ^= 0xff;
+        EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "TileType=" << (int)TileTypes[i];
+    }
+}
+
+/// @brief ULT for whole-resource transfer to/from packed linear subresources
+TEST_F(CTestCpuBltResource, TestCpuBltAllSubresources)
+{
+    const struct
+    {
+        GMM_RESOURCE_TYPE   Type;
+        TEST_TILE_TYPE      TileType;
+        UINT                Depth, ArraySize;
+    } Cases[] =
+    {
+        { RESOURCE_2D, TEST_LINEAR, 1, 3 },
+        { RESOURCE_2D, TEST_TILEX,  1, 3 },
+        { RESOURCE_2D, TEST_TILEY,  1, 3 },
+        { RESOURCE_2D, TEST_TILEYF, 1, 3 }, // Mip tail.
+        { RESOURCE_2D, TEST_TILEYS, 1, 3 }, // Mip tail.
+        { RESOURCE_3D, TEST_TILEY,  4, 1 },
+    };
+    const GMM_RES_FILE_LAYOUT Layouts[] = { GMM_RES_FILE_LAYOUT_SLICE_MAJOR, GMM_RES_FILE_LAYOUT_MIP_MAJOR };
+    const UINT Width = 100, Height = 60, MaxLod = 5, Bpp = 4;
+
+    for(UINT i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = Cases[i].Type;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = Cases[i].Depth;
+        gmmParams.ArraySize = Cases[i].ArraySize;
+        gmmParams.MaxLod = MaxLod;
+        SetTileFlag(gmmParams, Cases[i].TileType);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        UINT RowPitch[MaxLod + 1], MipSize[MaxLod + 1], MipDepth[MaxLod + 1], SliceSize = 0;
+        for(UINT Mip = 0; Mip <= MaxLod; Mip++)
+        {
+            RowPitch[Mip] = GFX_MAX(Width >> Mip, 1u) * Bpp;
+            MipDepth[Mip] = (Cases[i].Type == RESOURCE_3D) ? GFX_MAX(Cases[i].Depth >> Mip, 1u) : 1;
+            MipSize[Mip] = RowPitch[Mip] * GFX_MAX(Height >> Mip, 1u) * MipDepth[Mip];
+            SliceSize += MipSize[Mip];
+        }
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        const UINT SysSize = SliceSize * Cases[i].ArraySize;
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Sys(SysSize), Result(SysSize);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < SysSize; j++)
+        {
+            Sys[j] = (uint8_t)(j * 11 + j / 509);
+        }
+
+        for(UINT l = 0; l < sizeof(Layouts) / sizeof(Layouts[0]); l++)
+        {
+            // Reference: per-subresource CpuBlt's...
+            memset(pExpectedGpu, 0, GpuSize);
+            for(UINT Slice = 0; Slice < Cases[i].ArraySize; Slice++)
+            {
+                for(UINT Mip = 0; Mip <= MaxLod; Mip++)
+                {
+                    GMM_RES_COPY_BLT Blt = {};
+                    UINT Offset = 0;
+
+                    for(UINT m = 0; m < Mip; m++)
+                    {
+                        Offset += (Layouts[l] == GMM_RES_FILE_LAYOUT_SLICE_MAJOR) ? MipSize[m] : MipSize[m] * Cases[i].ArraySize;
+                    }
+                    Offset += (Layouts[l] == GMM_RES_FILE_LAYOUT_SLICE_MAJOR) ? Slice * SliceSize : Slice * MipSize[Mip];
+
+                    Blt.Gpu.pData = pExpectedGpu;
+                    Blt.Gpu.MipLevel = Mip;
+                    Blt.Gpu.Slice = Slice;
+                    Blt.Sys.pData = &Sys[Offset];
+                    Blt.Sys.RowPitch = RowPitch[Mip];
+                    Blt.Sys.SlicePitch = MipSize[Mip] / MipDepth[Mip];
+                    Blt.Sys.BufferSize = MipSize[Mip];
+                    Blt.Blt.Slices = MipDepth[Mip];
+                    Blt.Blt.Upload = TRUE;
+                    EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+                }
+            }
+
+            GMM_RES_SUBRESOURCES_BLT SubresourcesBlt = {};
+            SubresourcesBlt.pGpuData = pGpu;
+            SubresourcesBlt.pSysData = Sys.data();
+            SubresourcesBlt.SysBufferSize = SysSize;
+            SubresourcesBlt.Layout = Layouts[l];
+            SubresourcesBlt.Upload = TRUE;
+
+            memset(pGpu, 0, GpuSize);
+            EXPECT_TRUE(GmmResCpuBltAllSubresources(&ResourceInfo, &SubresourcesBlt));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "Case=" << i << " Layout=" << l;
+
+            // Round trip...
+            memset(Result.data(), 0xcd, SysSize);
+            SubresourcesBlt.pSysData = Result.data();
+            SubresourcesBlt.Upload = FALSE;
+            EXPECT_TRUE(GmmResCpuBltAllSubresources(&ResourceInfo, &SubresourcesBlt));
+            EXPECT_EQ(0, memcmp(Sys.data(), Result.data(), SysSize)) << "Case=" << i << " Layout=" << l;
+        }
+    }
+}
+
+/// @brief ULT for whole-resource transfer of TileW (separate stencil) arrays, 
+/// whose slices sit at the halved array QPitch
+TEST_F(CTestCpuBltResource, TestCpuBltAllSubresourcesTileW)
+{
+    const UINT Width = 100, Height = 60, ArraySize = 4, MaxLod = 2;
+
+    GMM_RESCREATE_PARAMS gmmParams = {};
+    gmmParams.Type = RESOURCE_2D;
+    gmmParams.NoGfxMemory = 1;
+    gmmParams.Flags.Gpu.SeparateStencil = 1;
+    gmmParams.Format = SetResourceFormat(TEST_BPP_8);
+    gmmParams.BaseWidth64 = Width;
+    gmmParams.BaseHeight = Height;
+    gmmParams.Depth = 1;
+    gmmParams.ArraySize = ArraySize;
+    gmmParams.MaxLod = MaxLod;
+
+    GMM_RESOURCE_INFO ResourceInfo;
+    ASSERT_EQ(GMM_SUCCESS, ResourceInfo.Create(*pGmmGlobalContext, gmmParams));
+    ASSERT_TRUE(ResourceInfo.GetResFlags().Info.TiledW);
+
+    UINT RowPitch[MaxLod + 1], MipSize[MaxLod + 1], SliceSize = 0;
+    for(UINT Mip = 0; Mip <= MaxLod; Mip++)
+    {
+        RowPitch[Mip] = GFX_MAX(Width >> Mip, 1u);
+        MipSize[Mip] = RowPitch[Mip] * GFX_MAX(Height >> Mip, 1u);
+        SliceSize += MipSize[Mip];
+    }
+
+    const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+    const UINT SysSize = SliceSize * ArraySize;
+    vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Sys(SysSize), Result(SysSize);
+    uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+    uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+    for(UINT j = 0; j < SysSize; j++)
+    {
+        Sys[j] = (uint8_t)(j * 11 + j / 509);
+    }
+
+    // Reference: per-subresource CpuBlt's (slice-major)...
+    memset(pExpectedGpu, 0, GpuSize);
+    for(UINT Slice = 0, Offset = 0; Slice < ArraySize; Slice++)
+    {
+        for(UINT Mip = 0; Mip <= MaxLod; Offset += MipSize[Mip++])
+        {
+            GMM_RES_COPY_BLT Blt = {};
+            Blt.Gpu.pData = pExpectedGpu;
+            Blt.Gpu.MipLevel = Mip;
+            Blt.Gpu.Slice = Slice;
+            Blt.Sys.pData = &Sys[Offset];
+            Blt.Sys.RowPitch = RowPitch[Mip];
+            Blt.Sys.BufferSize = MipSize[Mip];
+            Blt.Blt.Upload = TRUE;
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        }
+    }
+
+    GMM_RES_SUBRESOURCES_BLT SubresourcesBlt = {};
+    SubresourcesBlt.pGpuData = pGpu;
+    SubresourcesBlt.pSysData = Sys.data();
+    SubresourcesBlt.SysBufferSize = SysSize;
+    SubresourcesBlt.Layout = GMM_RES_FILE_LAYOUT_SLICE_MAJOR;
+    SubresourcesBlt.Upload = TRUE;
+
+    memset(pGpu, 0, GpuSize);
+    EXPECT_TRUE(GmmResCpuBltAllSubresources(&ResourceInfo, &SubresourcesBlt));
+    EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize));
+
+    // Round trip (slices 1+ included)...
+    memset(Result.data(), 0xcd, SysSize);
+    SubresourcesBlt.pSysData = Result.data();
+    SubresourcesBlt.Upload = FALSE;
+    EXPECT_TRUE(GmmResCpuBltAllSubresources(&ResourceInfo, &SubresourcesBlt));
+    for(UINT Slice = 0; Slice < ArraySize; Slice++)
+    {
+        EXPECT_EQ(0, memcmp(&Sys[Slice * SliceSize], &Result[Slice * SliceSize], SliceSize)) << "Slice=" << Slice;
+    }
+}
+
+/// @brief ULT for whole-frame planar YUV transfers
+TEST_F(CTestCpuBltResource, TestCpuBltPlanar)
+{
+    const struct
+    {
+        GMM_RESOURCE_FORMAT Format;
+        TEST_TILE_TYPE      TileType;
+    } Cases[] =
+    {
+        { GMM_FORMAT_NV12, TEST_LINEAR },
+        { GMM_FORMAT_NV12, TEST_TILEY },
+        { GMM_FORMAT_NV12, TEST_TILEYS }, // Redescribed planes.
+        { GMM_FORMAT_P010, TEST_LINEAR },
+        { GMM_FORMAT_P010, TEST_TILEY },
+        { GMM_FORMAT_P010, TEST_TILEYF }, // Redescribed planes.
+        { GMM_FORMAT_YV12, TEST_LINEAR },
+    };
+    const UINT Width = 98, Height = 62;
+
+    for(UINT i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = Cases[i].Format;
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 1;
+        gmmParams.ArraySize = 1;
+        SetTileFlag(gmmParams, Cases[i].TileType);
+        gmmParams.Flags.Info.Linear = 1; // Planar clients always allow linear fallback.
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        const BOOLEAN UVPacked = (Cases[i].Format != GMM_FORMAT_YV12);
+        const UINT Bps = (Cases[i].Format == GMM_FORMAT_P010) ? 2 : 1;
+        const UINT NumPlanes = UVPacked ? 2 : 3;
+        const UINT PlaneWidthBytes[GMM_MAX_PLANE] = { 0, Width * Bps, (Width / 2) * (UVPacked ? 2 : 1) * Bps, (Width / 2) * Bps };
+        const UINT PlaneHeight[GMM_MAX_PLANE] = { 0, Height, Height / 2, Height / 2 };
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Sys[GMM_MAX_PLANE], Result[GMM_MAX_PLANE];
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+        GMM_RES_PLANAR_BLT PlanarBlt = {};
+
+        memset(pExpectedGpu, 0, GpuSize);
+        for(UINT Plane = GMM_PLANE_Y; Plane < GMM_PLANE_Y + NumPlanes; Plane++)
+        {
+            const UINT RowPitch = PlaneWidthBytes[Plane] + 3;
+
+            Sys[Plane].resize(RowPitch * PlaneHeight[Plane]);
+            Result[Plane].resize(RowPitch * PlaneHeight[Plane]);
+            for(UINT j = 0; j < Sys[Plane].size(); j++)
+            {
+                Sys[Plane][j] = (uint8_t)(j * 7 + j / 251 + Plane * 61);
+            }
+
+            PlanarBlt.Sys[Plane].pData = Sys[Plane].data();
+            PlanarBlt.Sys[Plane].RowPitch = RowPitch;
+
+            // Reference: per-plane CpuBlt's (or, for YV12 chroma, the half-pitch linear array)...
+            if(UVPacked || (Plane == GMM_PLANE_Y))
+            {
+                GMM_RES_COPY_BLT Blt = {};
+                UINT PixelPitch = Bps;
+
+                if(ResourceInfo.GetResFlags().Info.RedecribedPlanes && (Plane == GMM_PLANE_U))
+                {
+                    PixelPitch = 2 * Bps; // Redescribed UV plane is one two-sample pixel per U/V pair.
+                }
+
+                Blt.Gpu.pData = pExpectedGpu;
+                Blt.Gpu.OffsetX = (UINT)ResourceInfo.GetPlanarXOffset((GMM_YUV_PLANE)Plane) / PixelPitch;
+                Blt.Gpu.OffsetY = (UINT)ResourceInfo.GetPlanarYOffset((GMM_YUV_PLANE)Plane);
+                Blt.Sys.pData = Sys[Plane].data();
+                Blt.Sys.RowPitch = RowPitch;
+                Blt.Sys.BufferSize = (UINT)Sys[Plane].size();
+                Blt.Blt.Width = PlaneWidthBytes[Plane] / PixelPitch;
+                Blt.Blt.Height = PlaneHeight[Plane];
+                Blt.Blt.Upload = TRUE;
+                EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+            }
+            else
+            {
+                const UINT ChromaPitch = (UINT)ResourceInfo.GetRenderPitch() / 2;
+                uint8_t *pPlane = 
+                    pExpectedGpu + 
+                    ResourceInfo.GetPlanarYOffset((GMM_YUV_PLANE)Plane) * ResourceInfo.GetRenderPitch() + 
+                    ResourceInfo.GetPlanarXOffset((GMM_YUV_PLANE)Plane);
+
+                for(UINT y = 0; y < PlaneHeight[Plane]; y++)
+                {
+                    memcpy(pPlane + y * ChromaPitch, &Sys[Plane][y * RowPitch], PlaneWidthBytes[Plane]);
+                }
+            }
+        }
+
+        PlanarBlt.pGpuData = pGpu;
+        PlanarBlt.Upload = TRUE;
+
+        memset(pGpu, 0, GpuSize);
+        EXPECT_TRUE(GmmResCpuBltPlanar(&ResourceInfo, &PlanarBlt));
+        EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "Case=" << i;
+
+        // Round trip...
+        for(UINT Plane = GMM_PLANE_Y; Plane < GMM_PLANE_Y + NumPlanes; Plane++)
+        {
+            memset(Result[Plane].data(), 0xcd, Result[Plane].size());
+            PlanarBlt.Sys[Plane].pData = Result[Plane].data();
+        }
+        PlanarBlt.Upload = FALSE;
+        EXPECT_TRUE(GmmResCpuBltPlanar(&ResourceInfo, &PlanarBlt));
+        for(UINT Plane = GMM_PLANE_Y; Plane < GMM_PLANE_Y + NumPlanes; Plane++)
+        {
+            const UINT RowPitch = PlanarBlt.Sys[Plane].RowPitch;
+
+            for(UINT y = 0; y < PlaneHeight[Plane]; y++)
+            {
+                EXPECT_EQ(0, memcmp(&Sys[Plane][y * RowPitch], &Result[Plane][y * RowPitch], PlaneWidthBytes[Plane])) << "Case=" << i << " Plane=" << Plane << " Row=" << y;
+            }
+        }
+    }
+}
+
+#ifndef _WIN32
+/// @brief ULT for mmap-based whole-resource upload from file
+TEST_F(CTestCpuBltResource, TestCpuBltFromFile)
+{
+    const TEST_TILE_TYPE TileTypes[] = { TEST_LINEAR, TEST_TILEY, TEST_TILEYS };
+    const GMM_RES_FILE_LAYOUT Layouts[] = { GMM_RES_FILE_LAYOUT_SLICE_MAJOR, GMM_RES_FILE_LAYOUT_MIP_MAJOR };
+    const UINT Width = 100, Height = 60, ArraySize = 3, MaxLod = 3, Bpp = 4, RowAlignment = 16, HeaderSize = 100;
+
+    for(UINT i = 0; i < sizeof(TileTypes) / sizeof(TileTypes[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.ArraySize = ArraySize;
+        gmmParams.MaxLod = MaxLod;
+        SetTileFlag(gmmParams, TileTypes[i]);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ResourceInfo.Create(*pGmmGlobalContext, gmmParams);
+
+        UINT RowPitch[MaxLod + 1], MipSize[MaxLod + 1], SliceSize = 0;
+        for(UINT Mip = 0; Mip <= MaxLod; Mip++)
+        {
+            RowPitch[Mip] = GFX_ALIGN(GFX_MAX(Width >> Mip, 1u) * Bpp, RowAlignment);
+            MipSize[Mip] = RowPitch[Mip] * GFX_MAX(Height >> Mip, 1u);
+            SliceSize += MipSize[Mip];
+        }
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, File(HeaderSize + SliceSize * ArraySize);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < File.size(); j++)
+        {
+            File[j] = (uint8_t)(j * 13 + j / 511);
+        }
+
+        char FileName[] = "/tmp/GmmCpuBltFromFileXXXXXX";
+        int Fd = mkstemp(FileName);
+        ASSERT_GE(Fd, 0);
+        ASSERT_EQ((ssize_t)File.size(), write(Fd, File.data(), File.size()));
+
+        for(UINT l = 0; l < sizeof(Layouts) / sizeof(Layouts[0]); l++)
+        {
+            // Reference: per-subresource CpuBlt's from in-memory copy of file...
+            memset(pExpectedGpu, 0, GpuSize);
+            for(UINT Slice = 0; Slice < ArraySize; Slice++)
+            {
+                for(UINT Mip = 0, Offset = 0; Mip <= MaxLod; Mip++)
+                {
+                    GMM_RES_COPY_BLT Blt = {};
+
+                    Offset = HeaderSize;
+                    for(UINT m = 0; m < Mip; m++)
+                    {
+                        Offset += (Layouts[l] == GMM_RES_FILE_LAYOUT_SLICE_MAJOR) ? MipSize[m] : MipSize[m] * ArraySize;
+                    }
+                    Offset += (Layouts[l] == GMM_RES_FILE_LAYOUT_SLICE_MAJOR) ? Slice * SliceSize : Slice * MipSize[Mip];
+
+                    Blt.Gpu.pData = pExpectedGpu;
+                    Blt.Gpu.MipLevel = Mip;
+                    Blt.Gpu.Slice = Slice;
+                    Blt.Sys.pData = &File[Offset];
+                    Blt.Sys.RowPitch = RowPitch[Mip];
+                    Blt.Sys.BufferSize = MipSize[Mip];
+                    Blt.Blt.Upload = TRUE;
+                    EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+                }
+            }
+
+            GMM_RES_FILE_BLT FileBlt = {};
+            FileBlt.pGpuData = pGpu;
+            FileBlt.FileOffset = HeaderSize;
+            FileBlt.Layout = Layouts[l];
+            FileBlt.RowAlignment = RowAlignment;
+
+            // By name...
+            FileBlt.pFileName = FileName;
+            memset(pGpu, 0, GpuSize);
+            EXPECT_TRUE(GmmResCpuBltFromFile(&ResourceInfo, &FileBlt));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "TileType=" << (int)TileTypes[i] << " Layout=" << l;
+
+            // By descriptor...
+            FileBlt.pFileName = NULL;
+            FileBlt.FileDescriptor = Fd;
+            memset(pGpu, 0, GpuSize);
+            EXPECT_TRUE(GmmResCpuBltFromFile(&ResourceInfo, &FileBlt));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "TileType=" << (int)TileTypes[i] << " Layout=" << l;
+        }
+
+        { // I/O failures fail the BLT (without asserting)...
+            GMM_RES_FILE_BLT FileBlt = {};
+            FileBlt.pGpuData = pGpu;
+            FileBlt.RowAlignment = RowAlignment;
+            FileBlt.FileDescriptor = Fd;
+
+            FileBlt.FileOffset = HeaderSize + 1; // Truncated.
+            EXPECT_FALSE(GmmResCpuBltFromFile(&ResourceInfo, &FileBlt));
+
+            FileBlt.FileOffset = ~0ull - HeaderSize; // FileOffset + PayloadSize overflows.
+            EXPECT_FALSE(GmmResCpuBltFromFile(&ResourceInfo, &FileBlt));
+
+            FileBlt.FileOffset = HeaderSize;
+            FileBlt.FileDescriptor = -1; // Bad descriptor.
+            EXPECT_FALSE(GmmResCpuBltFromFile(&ResourceInfo, &FileBlt));
+
+            FileBlt.pFileName = "/nonexistent/GmmCpuBltFromFile"; // Missing file.
+            EXPECT_FALSE(GmmResCpuBltFromFile(&ResourceInfo, &FileBlt));
+        }
+
+        close(Fd);
+        unlink(FileName);
+    }
+}
+#endif
+
+/// @brief ULT for MSAA (TileYs) Resource
+TEST_F(CTestCpuBltResource, TestCpuBltMsaa)
+{
+    const struct
+    {
+        uint32_t                    NumSamples;
+        const SWIZZLE_DESCRIPTOR    *pSwizzle;
+    } Cases[] = {
+        { 2,  &ST_2D_MSAA2_64KB_32bpp },
+        { 4,  &ST_2D_MSAA4_64KB_32bpp },
+        { 8,  &ST_2D_MSAA8_64KB_32bpp },
+        { 16, &ST_2D_MSAA16_64KB_32bpp },
+    };
+    const UINT Width = 300, Height = 70, Bpp = 4, SysPitch = Width * Bpp + 12, SamplePitch = SysPitch * Height;
+
+    for(UINT i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        const uint32_t NumSamples = Cases[i].NumSamples;
+
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_2D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.RenderTarget = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(TEST_BPP_32);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = 0x1;
+        gmmParams.MSAA.NumSamples = NumSamples;
+        SetTileFlag(gmmParams, TEST_TILEYS);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ASSERT_EQ(GMM_SUCCESS, ResourceInfo.Create(*pGmmGlobalContext, gmmParams));
+
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        const int GpuPitch = (int)ResourceInfo.GetRenderPitch();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, SysBuffer(SamplePitch * NumSamples), ResultBuffer(SamplePitch * NumSamples);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < SysBuffer.size(); j++)
+        {
+            SysBuffer[j] = (uint8_t)(j * 3 + j / 757);
+        }
+
+        for(UINT Sample = 0; Sample < NumSamples; Sample++)
+        {
+            for(UINT y = 0; y < Height; y++)
+            {
+                for(UINT x = 0; x < Width * Bpp; x++)
+                {
+                    pExpectedGpu[SwizzleOffset(Cases[i].pSwizzle, GpuPitch, x, y, Sample)] = 
+                        SysBuffer[Sample * SamplePitch + y * SysPitch + x];
+                }
+            }
+        }
+
+        // Upload all samples...
+        GMM_RES_COPY_BLT Blt = {};
+        Blt.Gpu.pData = pGpu;
+        Blt.Sys.pData = SysBuffer.data();
+        Blt.Sys.RowPitch = SysPitch;
+        Blt.Msaa.SamplePitch = SamplePitch;
+        Blt.Sys.BufferSize = (uint32_t)SysBuffer.size();
+        Blt.Sys.PixelPitch = Bpp;
+        Blt.Msaa.Samples = NumSamples;
+        Blt.Blt.Upload = TRUE;
+
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "NumSamples=" << NumSamples;
+
+        // Download all samples...
+        Blt.Sys.pData = ResultBuffer.data();
+        Blt.Blt.Upload = FALSE;
+
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        for(UINT Sample = 0; Sample < NumSamples; Sample++)
+        {
+            for(UINT y = 0; y < Height; y++)
+            {
+                const UINT Offset = Sample * SamplePitch + y * SysPitch;
+
+                EXPECT_EQ(0, memcmp(&SysBuffer[Offset], &ResultBuffer[Offset], Width * Bpp))
+                    << "NumSamples=" << NumSamples << " Sample=" << Sample << " Row=" << y;
+            }
+        }
+
+        // Download single (last) sample...
+        const UINT Sample = NumSamples - 1;
+
+        memset(ResultBuffer.data(), 0, ResultBuffer.size());
+        Blt.Msaa.Sample = Sample;
+        Blt.Msaa.Samples = 1;
+
+        EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+        for(UINT y = 0; y < Height; y++)
+        {
+            EXPECT_EQ(0, memcmp(&SysBuffer[Sample * SamplePitch + y * SysPitch], &ResultBuffer[y * SysPitch], Width * Bpp))
+                << "NumSamples=" << NumSamples << " Sample=" << Sample << " Row=" << y;
+        }
+    }
 }
 
 /// @brief ULT for 3D Resource
 TEST_F(CTestCpuBltResource, TestCpuBlt3D)
 {
+    const struct
+    {
+        TEST_TILE_TYPE  TileType;
+        TEST_BPP        Bpp;
+    } Cases[] =
+    {
+        { TEST_TILEY,  TEST_BPP_32 },
+        { TEST_TILEYF, TEST_BPP_8 },
+        { TEST_TILEYF, TEST_BPP_32 },
+        { TEST_TILEYF, TEST_BPP_128 },
+        { TEST_TILEYS, TEST_BPP_8 },
+        { TEST_TILEYS, TEST_BPP_32 },
+    };
+    const UINT Width = 70, Height = 37, Depth = 21;
+
+    for(UINT i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        GMM_RESCREATE_PARAMS gmmParams = {};
+        gmmParams.Type = RESOURCE_3D;
+        gmmParams.NoGfxMemory = 1;
+        gmmParams.Flags.Gpu.Texture = 1;
+        gmmParams.Format = SetResourceFormat(Cases[i].Bpp);
+        gmmParams.BaseWidth64 = Width;
+        gmmParams.BaseHeight = Height;
+        gmmParams.Depth = Depth;
+        SetTileFlag(gmmParams, Cases[i].TileType);
+
+        GMM_RESOURCE_INFO ResourceInfo;
+        ASSERT_EQ(GMM_SUCCESS, ResourceInfo.Create(*pGmmGlobalContext, gmmParams));
+
+        const UINT Bpp = ResourceInfo.GetBitsPerPixel() / CHAR_BIT;
+        const UINT SysPitch = Width * Bpp + 16, SlicePitch = SysPitch * Height + 48;
+        const size_t GpuSize = (size_t)ResourceInfo.GetSizeSurface();
+        vector<uint8_t> ExpectedGpuBuffer, GpuBuffer, Sys(SlicePitch * Depth), Result(SlicePitch * Depth);
+        uint8_t *pExpectedGpu = AlignedBuffer(ExpectedGpuBuffer, GpuSize, GMM_KBYTE(64));
+        uint8_t *pGpu = AlignedBuffer(GpuBuffer, GpuSize, GMM_KBYTE(64));
+
+        for(UINT j = 0; j < Sys.size(); j++)
+        {
+            Sys[j] = (uint8_t)(j * 7 + j / 641);
+        }
+
+        const struct
+        {
+            UINT X, Y, Width, Height, Slice, Slices;
+        } Rects[] =
+        {
+            { 0, 0, Width,      Height,      0, Depth },  // Whole volume.
+            { 3, 5, Width - 9,  Height - 11, 3, 15 },     // Unaligned, spanning tile layers.
+            { 17, 1, 9,         4,           6, 2 },      // Smaller than a tile chunk.
+        };
+
+        for(UINT r = 0; r < sizeof(Rects) / sizeof(Rects[0]); r++)
+        {
+            GMM_RES_COPY_BLT Blt = {};
+            Blt.Gpu.OffsetX = Rects[r].X;
+            Blt.Gpu.OffsetY = Rects[r].Y;
+            Blt.Sys.RowPitch = SysPitch;
+            Blt.Sys.SlicePitch = SlicePitch;
+            Blt.Blt.Width = Rects[r].Width;
+            Blt.Blt.Height = Rects[r].Height;
+            Blt.Blt.Upload = TRUE;
+
+            // Reference: slice-at-a-time CpuBlt's...
+            memset(pExpectedGpu, 0, GpuSize);
+            for(UINT Slice = Rects[r].Slice; Slice < Rects[r].Slice + Rects[r].Slices; Slice++)
+            {
+                Blt.Gpu.pData = pExpectedGpu;
+                Blt.Gpu.Slice = Slice;
+                Blt.Sys.pData = &Sys[Slice * SlicePitch];
+                Blt.Sys.BufferSize = (uint32_t)(Sys.size() - Slice * SlicePitch);
+                Blt.Blt.Slices = 1;
+                EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+            }
+
+            // Multi-slice upload...
+            memset(pGpu, 0, GpuSize);
+            Blt.Gpu.pData = pGpu;
+            Blt.Gpu.Slice = Rects[r].Slice;
+            Blt.Sys.pData = &Sys[Rects[r].Slice * SlicePitch];
+            Blt.Sys.BufferSize = (uint32_t)(Sys.size() - Rects[r].Slice * SlicePitch);
+            Blt.Blt.Slices = Rects[r].Slices;
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "Case=" << i << " Rect=" << r;
+
+            // Multi-slice download...
+            memset(Result.data(), 0xcd, Result.size());
+            Blt.Sys.pData = &Result[Rects[r].Slice * SlicePitch];
+            Blt.Blt.Upload = FALSE;
+            EXPECT_TRUE(ResourceInfo.CpuBlt(&Blt));
+            for(UINT Slice = Rects[r].Slice; Slice < Rects[r].Slice + Rects[r].Slices; Slice++)
+            {
+                for(UINT y = 0; y < Rects[r].Height; y++)
+                {
+                    const UINT Offset = Slice * SlicePitch + y * SysPitch;
+
+                    EXPECT_EQ(0, memcmp(&Sys[Offset], &Result[Offset], Rects[r].Width * Bpp))
+                        << "Case=" << i << " Rect=" << r << " Slice=" << Slice << " Row=" << y;
+                }
+            }
+
+            // Multi-slice upload/download on workers (Yf/Ys volumes banded a tile layer at a time)...
+            uint32_t NumTasksRun = 0;
+            const GMM_RES_CPU_BLT_WORKERS Workers = { 3, RunTasksOnThreads, &NumTasksRun };
+
+            memset(pGpu, 0, GpuSize);
+            Blt.Sys.pData = &Sys[Rects[r].Slice * SlicePitch];
+            Blt.Blt.Upload = TRUE;
+            EXPECT_TRUE(GmmResCpuBltParallel(&ResourceInfo, &Blt, &Workers));
+            EXPECT_EQ(0, memcmp(pExpectedGpu, pGpu, GpuSize)) << "Case=" << i << " Rect=" << r << " (Workers)";
+
+            memset(Result.data(), 0xcd, Result.size());
+            Blt.Sys.pData = &Result[Rects[r].Slice * SlicePitch];
+            Blt.Blt.Upload = FALSE;
+            EXPECT_TRUE(GmmResCpuBltParallel(&ResourceInfo, &Blt, &Workers));
+            for(UINT Slice = Rects[r].Slice; Slice < Rects[r].Slice + Rects[r].Slices; Slice++)
+            {
+                for(UINT y = 0; y < Rects[r].Height; y++)
+                {
+                    const UINT Offset = Slice * SlicePitch + y * SysPitch;
 
+                    EXPECT_EQ(0, memcmp(&Sys[Offset], &Result[Offset], Rects[r].Width * Bpp))
+                        << "Case=" << i << " Rect=" << r << " Slice=" << Slice << " Row=" << y << " (Workers)";
+                }
+            }
+            if(r == 0) // Whole volume spans several tile rows.
+            {
+                EXPECT_NE(0u, NumTasksRun) << "Case=" << i;
+            }
+        }
+    }
 }
 
 /// @brief ULT for Cube Resource
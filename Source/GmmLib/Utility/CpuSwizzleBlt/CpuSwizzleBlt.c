@@ -291,11 +291,43 @@ trivial when high throughput is goal.
 
 This file implements (1) SwizzleOffset function to compute swizzled offset of 
 dimensionally-specified surface byte, and (2) CpuSwizzleBlt function to BLT 
-between linear ("y * pitch + x") and swizzled surfaces--with goal of providing 
+between linear ("y * pitch + x") and swizzled surfaces, or directly between two 
+differently swizzled surfaces (retiling), and (3) CpuSwizzleFill function to 
+fill swizzled surface with repeating pattern--with goal of providing 
 high-performance, swizzling BLT implementation to be used both in production 
 and as a guide for those seeking to understand swizzled access or implement 
 functionality beyond the simple BLT. */
 
+#ifdef SUB_ELEMENT_SUPPORT
+
+// Element Conversion Descriptor for CpuSwizzleBlt function...
+typedef struct _CPU_SWIZZLE_BLT_CONVERT 
+{
+    int                         Numeric;        // CPU_SWIZZLE_BLT_CONVERT_* numeric conversion applied to each source channel.
+    int                         ChannelSize;    // Size, in bytes, of source element channels (1, 2, or 4).
+    int                         NumChannels;    // Number of destination element channels (1..4).
+    int                         Channel[4];     // Per destination channel: index of source channel, or CPU_SWIZZLE_BLT_CONVERT_CONSTANT.
+    unsigned int                Constant;       // Value, in destination channel format, of CONSTANT channels.
+} CPU_SWIZZLE_BLT_CONVERT;
+
+#define CPU_SWIZZLE_BLT_CONVERT_NONE            0 // Channels moved as-is.
+#define CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT   1 // 16-bit float channels widened to 32-bit float.
+#define CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF   2 // 32-bit float channels narrowed to 16-bit float (round-to-nearest-even).
+
+#define CPU_SWIZZLE_BLT_CONVERT_CONSTANT        (-1)
+
+/* Conversion performed in transfer loop, as elements move between surfaces--
+e.g. ("Dest.Element.pConvert = &Convert")...
+
+    BGRA8 --> RGBA8:    { CPU_SWIZZLE_BLT_CONVERT_NONE, 1, 4, {2, 1, 0, 3} }
+    RGB8 --> RGBX8:     { CPU_SWIZZLE_BLT_CONVERT_NONE, 1, 4, {0, 1, 2, CPU_SWIZZLE_BLT_CONVERT_CONSTANT}, 0xff }
+    R16F --> R32F:      { CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT, 2, 1, {0} }
+
+Source and destination Element.Size's are then those of the source and 
+destination formats. */
+
+#endif
+
 // Surface Descriptor for CpuSwizzleBlt function...
 typedef struct _CPU_SWIZZLE_BLT_SURFACE 
 {
@@ -310,6 +342,7 @@ typedef struct _CPU_SWIZZLE_BLT_SURFACE
         struct _CPU_SWIZZLE_BLT_SURFACE_ELEMENT 
         {
             int                     Pitch, Size; // Zero if full-pixel BLT, or pitch and size, in bytes, of pixel element being BLT'ed.
+            const CPU_SWIZZLE_BLT_CONVERT *pConvert; // NULL, or (destination surface only) conversion of source elements to this surface's.
         }                       Element;
 
         /* e.g. to BLT only stencil data from S8D24 surface to S8 surface...
@@ -318,10 +351,57 @@ typedef struct _CPU_SWIZZLE_BLT_SURFACE
             Src.Element.Pitch = sizeof(S8D24) = 4;
             Src.OffsetX += BYTE_OFFSET_OF_S8_WITHIN_S8D24; */
     #endif
+
+    int                         Temporal;       // Swizzled surfaces: Nonzero to access with regular (cache-allocating) loads/stores, else non-temporal ones (MOVNTDQ/MOVNTDQA).
+    int                         PrefetchRows;   // Linear source surfaces: Zero, or number of rows ahead of transfer to software-prefetch.
+
+    /* Non-temporal access (the default) suits BLTs larger than the CPU
+    caches, or write-combined mappings; BLTs small enough to stay cached
+    (e.g. whose result the CPU will soon read) are better off Temporal. */
 } CPU_SWIZZLE_BLT_SURFACE;
 
+// Intra-Tile Offset Table for Swizzle Descriptor...
+typedef struct _SWIZZLE_OFFSET_TABLE 
+{
+    SWIZZLE_DESCRIPTOR          Swizzle;        // Descriptor table was built for.
+    int                         TileWidthBits, TileHeightBits, TileDepthBits, TileSizeBits; // Log2 of tile dimensions and size.
+    const unsigned short        *pX, *pY, *pZ;  // Intra-tile offset contribution of each x (byte), y (row), and z (slice or sample) within tile.
+} SWIZZLE_OFFSET_TABLE;
+
+/* Since dimension masks are mutually exclusive, per-dimension contributions 
+combine with simple OR to form intra-tile offset--e.g. for per-texel random 
+access into swizzled surface...
+
+    const SWIZZLE_OFFSET_TABLE *pTable = SwizzleOffsetTable(&INTEL_TILE_Y); // Once.
+    ...
+    pTexel = pBase + SWIZZLE_TABLE_OFFSET(pTable, Pitch, x * Bpp, y, 0);
+
+As with SwizzleOffset, CSX XOR's (if any) not applied. */
+#define SWIZZLE_TABLE_OFFSET(pTable, Pitch, OffsetX, OffsetY, OffsetZ) (                    \
+    ((((OffsetY) >> (pTable)->TileHeightBits) * ((Pitch) >> (pTable)->TileWidthBits) +      \
+      ((OffsetX) >> (pTable)->TileWidthBits)) << (pTable)->TileSizeBits) +                  \
+    ((pTable)->pX[(OffsetX) & ((1 << (pTable)->TileWidthBits) - 1)] |                       \
+     (pTable)->pY[(OffsetY) & ((1 << (pTable)->TileHeightBits) - 1)] |                      \
+     (pTable)->pZ[(OffsetZ)]))
+
 extern int SwizzleOffset(const SWIZZLE_DESCRIPTOR *pSwizzle, int Pitch, int OffsetX, int OffsetY, int OffsetZ);
+extern const SWIZZLE_OFFSET_TABLE *SwizzleOffsetTable(const SWIZZLE_DESCRIPTOR *pSwizzle);
+extern void SwizzleOffsets(const SWIZZLE_DESCRIPTOR *pSwizzle, int Pitch, int Count, const int *pOffsetX, const int *pOffsetY, const int *pOffsetZ, int *pSwizzledOffset);
 extern void CpuSwizzleBlt(CPU_SWIZZLE_BLT_SURFACE *pDest, CPU_SWIZZLE_BLT_SURFACE *pSrc, int CopyWidthBytes, int CopyHeight);
+extern int CpuSwizzleBltTileRows(const CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface, int CopyHeight);
+extern void CpuSwizzleBltBand(CPU_SWIZZLE_BLT_SURFACE *pDest, CPU_SWIZZLE_BLT_SURFACE *pSrc, int CopyWidthBytes, int CopyHeight, int Band, int NumBands);
+extern int CpuSwizzleBltBandRows(const CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface, int CopyHeight, int Band, int NumBands, int *pFirstRow);
+extern void CpuSwizzleFill(CPU_SWIZZLE_BLT_SURFACE *pDest, const void *pPattern, int PatternSize, int FillWidthBytes, int FillHeight);
+
+// Probed CPU Features (for callers selecting code paths of their own)...
+#define CPU_SWIZZLE_BLT_FEATURE_STREAMING_LOAD  0x1 // SSE4.1: MOVNTDQA
+#define CPU_SWIZZLE_BLT_FEATURE_CRC32           0x2 // SSE4.2: CRC32
+extern int CpuSwizzleBltCpuFeatures(void);
+
+// Specialized Kernels (CpuSwizzleBltKernels.cpp)...
+typedef void (*PFN_CPU_SWIZZLE_BLT)(CPU_SWIZZLE_BLT_SURFACE *pDest, CPU_SWIZZLE_BLT_SURFACE *pSrc, int CopyWidthBytes, int CopyHeight);
+extern PFN_CPU_SWIZZLE_BLT CpuSwizzleBltSelectKernel(const CPU_SWIZZLE_BLT_SURFACE *pDest, const CPU_SWIZZLE_BLT_SURFACE *pSrc);
+extern void CpuSwizzleBltVolume(CPU_SWIZZLE_BLT_SURFACE *pDest, CPU_SWIZZLE_BLT_SURFACE *pSrc, int CopyWidthBytes, int CopyHeight, int CopyDepth, int LinearSlicePitch);
 
 #ifdef __cplusplus
 }
@@ -357,7 +437,123 @@ static unsigned char PopCnt4[16] =          {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
 #define POPCNT16(x) (POPCNT4((x) >> 12) + POPCNT4((x) >> 8) + POPCNT4((x) >> 4) + POPCNT4(x))
 
 
-int SwizzleOffset( // ##########################################################
+// CPU Feature Detection #######################################################
+
+/* Transfer instructions beyond the compile-time baseline are selected at
+runtime. All functions in this file share one CPUID probe, performed on first
+use. (Racing first uses are benign--each would store the same results.) */
+
+#if(_MSC_VER >= 1500)
+    #define CPUID(Leaf, Subleaf, Regs)  __cpuidex((int *)(Regs), (Leaf), (Subleaf))
+    #define MOVNTDQA_R(Reg, Src)        ((Reg) = _mm_stream_load_si128((__m128i *)(Src)))
+    #if(_MSC_VER >= 1700)
+        #define PDEP(Src, Mask)         _pdep_u32((Src), (Mask))
+        #define XGETBV0()               _xgetbv(0)
+        #define CPU_SWIZZLE_BLT_AVX2_SUPPORT
+        #if(_MSC_VER >= 1910)
+            #define CPU_SWIZZLE_BLT_AVX512_SUPPORT
+        #endif
+        #define TARGET_AVX2
+        #define TARGET_AVX512
+    #endif
+#elif((defined __clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 5)))
+    #define CPUID(Leaf, Subleaf, Regs)  __cpuid_count((Leaf), (Subleaf), (Regs)[0], (Regs)[1], (Regs)[2], (Regs)[3])
+    #define MOVNTDQA_R(Reg, Src)        ((Reg) = _mm_stream_load_si128((__m128i *)(Src)))
+    #if(defined(__BMI2__))
+        #define PDEP(Src, Mask)         _pdep_u32((Src), (Mask))
+    #endif
+    #if((defined __clang__) || (__GNUC__ >= 5))
+        static unsigned long long XGETBV0(void)
+        {
+            unsigned int eax, edx;
+            __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return(((unsigned long long) edx << 32) | eax);
+        }
+        #define CPU_SWIZZLE_BLT_AVX2_SUPPORT
+        #define CPU_SWIZZLE_BLT_AVX512_SUPPORT
+        #define TARGET_AVX2             __attribute__((target("avx2")))
+        #define TARGET_AVX512           __attribute__((target("avx512f")))
+    #endif
+#elif defined(__ghs__)
+    #define MOVNTDQA_R(Reg, Src)        ((Reg) = _mm_stream_load_si128((__m128i *)(Src)))
+#else
+    #define MOVNTDQA_R(Reg, Src)        ((Reg) = (Reg))
+#endif
+
+static struct
+{
+    char    Probed;
+    char    StreamingLoad;  // SSE4.1: MOVNTDQA
+    char    Crc32;          // SSE4.2: CRC32
+    char    PDep;           // BMI2: PDEP (Parallel Deposit)
+    char    Avx2;           // AVX2, with OS-enabled YMM state.
+    char    Avx512;         // AVX-512F, with OS-enabled ZMM state.
+}   CpuFeatures;
+
+static void ProbeCpuFeatures(void) // ###########################################
+{
+    unsigned int Leaf0[4] = {0}, Leaf1[4] = {0}, Leaf7[4] = {0};
+
+    #if(defined(CPUID))
+    {
+        CPUID(0, 0, Leaf0);
+        CPUID(1, 0, Leaf1);
+        if(Leaf0[0] >= 7) CPUID(7, 0, Leaf7);
+    }
+    #elif defined(__ghs__)
+    {
+        __CPUID(1, Leaf1);
+    }
+    #endif
+
+    #if(defined(CPUID) || defined(__ghs__))
+        CpuFeatures.StreamingLoad = ((Leaf1[2] & (1 << 19)) != 0); // ECX[19] = SSE4.1
+        CpuFeatures.Crc32 = ((Leaf1[2] & (1 << 20)) != 0); // ECX[20] = SSE4.2
+    #endif
+
+    #ifdef PDEP
+        CpuFeatures.PDep = ((Leaf7[1] & (1 << 8)) != 0); // EBX[8] = BMI2
+    #endif
+
+    #ifdef CPU_SWIZZLE_BLT_AVX2_SUPPORT
+    {
+        int OsXSave = ((Leaf1[2] & (1 << 27)) != 0); // ECX[27] = OSXSAVE
+        unsigned long long XCR0 = OsXSave ? XGETBV0() : 0;
+
+        CpuFeatures.Avx2 = // XMM + YMM State, EBX[5] = AVX2
+            ((XCR0 & 0x06) == 0x06) && ((Leaf7[1] & (1 << 5)) != 0);
+
+        #ifdef CPU_SWIZZLE_BLT_AVX512_SUPPORT
+            CpuFeatures.Avx512 = // XMM + YMM + Opmask/ZMM State, EBX[16] = AVX-512F
+                ((XCR0 & 0xe6) == 0xe6) && ((Leaf7[1] & (1 << 16)) != 0);
+        #endif
+    }
+    #endif
+
+    CpuFeatures.Probed = 1;
+}
+
+int CpuSwizzleBltCpuFeatures( // ###############################################
+
+    /* Return CPU_SWIZZLE_BLT_FEATURE_* flags of the running CPU's features. */
+
+    void)
+
+{ // ###########################################################################
+
+    if(!CpuFeatures.Probed) ProbeCpuFeatures();
+
+    return(
+        (CpuFeatures.StreamingLoad ? CPU_SWIZZLE_BLT_FEATURE_STREAMING_LOAD : 0) |
+        (CpuFeatures.Crc32 ? CPU_SWIZZLE_BLT_FEATURE_CRC32 : 0));
+}
+
+#ifndef PDEP
+    #define PDEP(Src, Mask) 0 // Not reached: CpuFeatures.PDep stays clear.
+#endif
+
+
+static int SwizzleOffsetUncached( // ###########################################
 
     /* Return swizzled offset of dimensionally-specified surface byte. */
 
@@ -371,17 +567,12 @@ int SwizzleOffset( // ##########################################################
     function returns byte's linear/memory offset from surface's base--i.e. it 
     performs the swizzled, spatial-to-linear mapping.
     
-    Function makes no real effort to perform optimally, since should only used 
-    outside loops in CpuSwizzleBlt and similar functions. If any of this 
-    functionality was needed in performance path, a custom implementation 
-    should be used that limits itself to functionality specifically needed 
-    (probably single-dimension, intra-tile offsets) and uses a fast computation 
-    (e.g. LUT's, hard-codings, PDEP). */
+    Function makes no real effort to perform optimally, since only used to 
+    build intra-tile offset tables (see SwizzleOffsetTable) and where no table 
+    is available. */
 
 { // ###########################################################################
 
-    static char PDepSupported = -1; // AVX2/BMI2 PDEP (Parallel Deposit) Instruction
-
     int SwizzledOffset; // Return value being computed.
 
     int TileWidthBits =  POPCNT16(pSwizzle->Mask.x); // Log2(Tile Width in Bytes)
@@ -393,23 +584,7 @@ int SwizzleOffset( // ##########################################################
     int Row, Col;   // Tile grid position on surface, of tile containing specified byte. 
     int x, y, z;    // Position of specified byte within tile that contains it.
 
-    if(PDepSupported == -1) 
-    {
-        #if(_MSC_VER >= 1700)
-            #define PDEP(Src, Mask) _pdep_u32((Src), (Mask))
-            int CpuInfo[4];
-            __cpuidex(CpuInfo, 7, 0);
-            PDepSupported = ((CpuInfo[1] & (1 << 8)) != 0); // EBX[8] = BMI2
-        #elif ( defined (__BMI2__ ))
-            #define PDEP(Src, Mask) _pdep_u32((Src), (Mask))
-            unsigned int eax, ebx, ecx, edx;
-            __cpuid_count(7, 0, eax, ebx, ecx, edx);
-            PDepSupported = ((ebx & (1 << 8)) != 0); // EBX[8] = BMI2
-        #else
-            #define PDEP(Src, Mask) 0
-            PDepSupported = 0;
-        #endif
-    }
+    if(!CpuFeatures.Probed) ProbeCpuFeatures();
 
     assert( // Mutually Exclusive Swizzle Positions...
         (pSwizzle->Mask.x | pSwizzle->Mask.y | pSwizzle->Mask.z) == 
@@ -436,7 +611,7 @@ int SwizzleOffset( // ##########################################################
         (Row * TilesPerRow + Col) << TileSizeBits; // <-- Tiles laid across surface in row-major order.
 
     // ...then OR swizzled offset of byte within tile...
-    if(PDepSupported) 
+    if(CpuFeatures.PDep) 
     {
         SwizzledOffset += 
             PDEP(x, pSwizzle->Mask.x) + 
@@ -455,19 +630,802 @@ int SwizzleOffset( // ##########################################################
                 SwizzledOffset += Q & MaskQ;        \
                 Q <<= 1 ^ (MaskQ >> bitIndex);      \
             }
-            PROCESS(x);
-            PROCESS(y);
-            PROCESS(z);
+            PROCESS(x);
+            PROCESS(y);
+            PROCESS(z);
+
+            bitIndex++;
+            bitMask <<= 1;
+
+            #undef PROCESS
+        }
+    }
+
+    return(SwizzledOffset);
+}
+
+
+// Intra-Tile Offset Tables ####################################################
+
+/* Tables built lazily on first use of each descriptor, in small fixed-size 
+cache (no dynamic allocation, so usable in any environment). Slots are claimed 
+atomically, so racing first uses of different descriptors don't collide; 
+racing first uses of same descriptor wait for slot's builder. Once built, 
+tables are never modified or evicted. */
+
+#define SWIZZLE_OFFSET_TABLE_SLOTS      16
+#define SWIZZLE_OFFSET_TABLE_ENTRIES    1024 // Tile Width + Height + Depth; enough for all descriptors above (max: TileX 512 + 8 + 1).
+
+#define SWIZZLE_OFFSET_TABLE_FREE       0
+#define SWIZZLE_OFFSET_TABLE_BUILDING   1
+#define SWIZZLE_OFFSET_TABLE_READY      2
+
+#if(_MSC_VER >= 1500)
+    #define CAS_LONG(pDest, Comparand, Exchange)    _InterlockedCompareExchange((pDest), (Exchange), (Comparand))
+    #define COMPILER_BARRIER()                      _ReadWriteBarrier()
+#elif((defined __clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 5)))
+    #define CAS_LONG(pDest, Comparand, Exchange)    __sync_val_compare_and_swap((pDest), (Comparand), (Exchange))
+    #define COMPILER_BARRIER()                      __asm__ __volatile__("" ::: "memory")
+#else // No atomics: First uses must not race (e.g. prime tables during single-threaded init).
+    static long CasLong(volatile long *pDest, long Comparand, long Exchange)
+    {
+        long Initial = *pDest;
+        if(Initial == Comparand) *pDest = Exchange;
+        return(Initial);
+    }
+    #define CAS_LONG(pDest, Comparand, Exchange)    CasLong((pDest), (Comparand), (Exchange))
+    #define COMPILER_BARRIER()
+#endif
+
+static struct 
+{
+    volatile long           State;
+    SWIZZLE_OFFSET_TABLE    Table;
+    unsigned short          Offset[SWIZZLE_OFFSET_TABLE_ENTRIES];
+}   SwizzleOffsetTables[SWIZZLE_OFFSET_TABLE_SLOTS];
+
+
+const SWIZZLE_OFFSET_TABLE *SwizzleOffsetTable( // ############################
+
+    /* Return intra-tile offset table for given swizzle descriptor. */
+
+    const SWIZZLE_DESCRIPTOR    *pSwizzle)  // Pointer to applicable swizzle descriptor.
+
+    /* Returns NULL if table cache is full (or descriptor's tile dimensions 
+    exceed table capacity), in which case callers should fall back to 
+    SwizzleOffset. Tables matched on descriptor content, so copies of a 
+    descriptor share a table. */
+
+{ // ###########################################################################
+
+    int TileWidthBits =  POPCNT16(pSwizzle->Mask.x);
+    int TileHeightBits = POPCNT16(pSwizzle->Mask.y);
+    int TileDepthBits =  POPCNT16(pSwizzle->Mask.z);
+    int Slot;
+
+    if(((1 << TileWidthBits) + (1 << TileHeightBits) + (1 << TileDepthBits)) > SWIZZLE_OFFSET_TABLE_ENTRIES) 
+    {
+        return(NULL);
+    }
+
+    for(Slot = 0; Slot < SWIZZLE_OFFSET_TABLE_SLOTS; Slot++) 
+    {
+        SWIZZLE_OFFSET_TABLE *pTable = &SwizzleOffsetTables[Slot].Table;
+        volatile long *pState = &SwizzleOffsetTables[Slot].State;
+        long State = *pState;
+
+        if(State == SWIZZLE_OFFSET_TABLE_FREE) 
+        {
+            State = CAS_LONG(pState, SWIZZLE_OFFSET_TABLE_FREE, SWIZZLE_OFFSET_TABLE_BUILDING);
+            if(State == SWIZZLE_OFFSET_TABLE_FREE) // Claimed slot--build table...
+            {
+                unsigned short *pOffset = SwizzleOffsetTables[Slot].Offset;
+                int TileWidth = 1 << TileWidthBits, i;
+
+                pTable->Swizzle = *pSwizzle;
+                pTable->TileWidthBits = TileWidthBits;
+                pTable->TileHeightBits = TileHeightBits;
+                pTable->TileDepthBits = TileDepthBits;
+                pTable->TileSizeBits = TileWidthBits + TileHeightBits + TileDepthBits;
+
+                pTable->pX = pOffset;
+                for(i = 0; i < (1 << TileWidthBits); i++)
+                {
+                    *pOffset++ = (unsigned short) SwizzleOffsetUncached(pSwizzle, TileWidth, i, 0, 0);
+                }
+
+                pTable->pY = pOffset;
+                for(i = 0; i < (1 << TileHeightBits); i++)
+                {
+                    *pOffset++ = (unsigned short) SwizzleOffsetUncached(pSwizzle, TileWidth, 0, i, 0);
+                }
+
+                pTable->pZ = pOffset;
+                for(i = 0; i < (1 << TileDepthBits); i++)
+                {
+                    *pOffset++ = (unsigned short) SwizzleOffsetUncached(pSwizzle, TileWidth, 0, 0, i);
+                }
+
+                COMPILER_BARRIER(); // Publish table before READY (x86 stores otherwise ordered).
+                *pState = SWIZZLE_OFFSET_TABLE_READY;
+
+                return(pTable);
+            }
+        }
+
+        while(State == SWIZZLE_OFFSET_TABLE_BUILDING) // Another thread building slot...
+        {
+            State = *pState;
+        }
+
+        COMPILER_BARRIER(); // Read table only after READY.
+
+        if( (pTable->Swizzle.Mask.x == pSwizzle->Mask.x) && 
+            (pTable->Swizzle.Mask.y == pSwizzle->Mask.y) && 
+            (pTable->Swizzle.Mask.z == pSwizzle->Mask.z)) 
+        {
+            return(pTable);
+        }
+    }
+
+    return(NULL);
+} // SwizzleOffsetTable
+
+
+int SwizzleOffset( // ##########################################################
+
+    /* Return swizzled offset of dimensionally-specified surface byte. */
+
+    const SWIZZLE_DESCRIPTOR    *pSwizzle,  // Pointer to applicable swizzle descriptor.
+    int                         Pitch,      // Pointer to applicable surface row-pitch.
+    int                         OffsetX,    // Horizontal offset into surface of the target byte, in bytes.
+    int                         OffsetY,    // Vertical offset into surface of the target byte, in physical/pitch rows.
+    int                         OffsetZ)    // Zero if N/A, or 3D offset into surface of the target byte, in 3D slices or MSAA samples as appropriate.
+
+    /* Given logically-specified (x, y, z) byte within swizzled surface, 
+    function returns byte's linear/memory offset from surface's base--i.e. it 
+    performs the swizzled, spatial-to-linear mapping.
+
+    Function looks up descriptor's intra-tile offset table on each call; for 
+    many offsets in same surface, use SwizzleOffsets or SWIZZLE_TABLE_OFFSET. */
+
+{ // ###########################################################################
+
+    const SWIZZLE_OFFSET_TABLE *pTable;
+
+    if(!CpuFeatures.Probed) ProbeCpuFeatures();
+
+    if((pTable = SwizzleOffsetTable(pSwizzle)) != NULL) 
+    {
+        assert( // Pitch is Multiple of Tile Width...
+            Pitch == ((Pitch >> pTable->TileWidthBits) << pTable->TileWidthBits));
+
+        assert((OffsetZ >> pTable->TileDepthBits) == 0); // When dealing with 3D tiling, treat as separate single-tile-deep planes.
+
+        return(SWIZZLE_TABLE_OFFSET(pTable, Pitch, OffsetX, OffsetY, OffsetZ));
+    }
+
+    return(SwizzleOffsetUncached(pSwizzle, Pitch, OffsetX, OffsetY, OffsetZ));
+} // SwizzleOffset
+
+
+void SwizzleOffsets( // ########################################################
+
+    /* Compute swizzled offsets of multiple dimensionally-specified bytes. */
+
+    const SWIZZLE_DESCRIPTOR    *pSwizzle,          // Pointer to applicable swizzle descriptor.
+    int                         Pitch,              // Pointer to applicable surface row-pitch.
+    int                         Count,              // Number of offsets to compute.
+    const int                   *pOffsetX,          // Horizontal offsets into surface of the target bytes, in bytes.
+    const int                   *pOffsetY,          // Vertical offsets into surface of the target bytes, in physical/pitch rows.
+    const int                   *pOffsetZ,          // NULL if N/A, or 3D offsets into surface of the target bytes, in 3D slices or MSAA samples as appropriate.
+    int                         *pSwizzledOffset)   // Out: Swizzled offsets of the target bytes.
+
+    /* Bulk form of SwizzleOffset--e.g. for gathering texels by coordinates. */
+
+{ // ###########################################################################
+
+    const SWIZZLE_OFFSET_TABLE *pTable;
+    int i;
+
+    if(!CpuFeatures.Probed) ProbeCpuFeatures();
+
+    if((pTable = SwizzleOffsetTable(pSwizzle)) != NULL) 
+    {
+        assert(Pitch == ((Pitch >> pTable->TileWidthBits) << pTable->TileWidthBits));
+
+        if(pOffsetZ) 
+        {
+            for(i = 0; i < Count; i++) 
+            {
+                assert((pOffsetZ[i] >> pTable->TileDepthBits) == 0);
+                pSwizzledOffset[i] = SWIZZLE_TABLE_OFFSET(pTable, Pitch, pOffsetX[i], pOffsetY[i], pOffsetZ[i]);
+            }
+        } 
+        else 
+        {
+            for(i = 0; i < Count; i++) 
+            {
+                pSwizzledOffset[i] = SWIZZLE_TABLE_OFFSET(pTable, Pitch, pOffsetX[i], pOffsetY[i], 0);
+            }
+        }
+    } 
+    else 
+    {
+        for(i = 0; i < Count; i++) 
+        {
+            pSwizzledOffset[i] = SwizzleOffsetUncached(pSwizzle, Pitch, pOffsetX[i], pOffsetY[i], pOffsetZ ? pOffsetZ[i] : 0);
+        }
+    }
+} // SwizzleOffsets
+
+
+typedef void (*WIDE_XFER)(
+    char    *pSwizzledAddressLine,  // Swizzled address of current row of transfer chunks.
+    int     *pSwizzledOffsetX,      // In/Out: Swizzled X offset of next chunk.
+    int     MaskX,                  // Swizzled increment mask for Width.
+    char    *pLinearAddress,        // Linear address of run.
+    int     LinearPitch,            // Linear surface pitch.
+    int     RunBytes,               // Run length in bytes--multiple of Width.
+    int     Width);                 // Chunk width in bytes: 16 or 64.
+
+#if(!defined(MINIMALIST) && defined(CPU_SWIZZLE_BLT_AVX2_SUPPORT))
+
+/* Wide Transfer Kernels: Where CPU supports AVX2/AVX-512, MainRun of BLT can be
+transferred a full swizzled cache line at a time--i.e. instead of as four 16B
+SSE transfers, as one 64B ZMM or two 32B YMM transfers.
+
+Each kernel call transfers a horizontal run of 64B swizzled lines, each line
+holding a Width x (64 / Width) chunk (i.e. 16x4 for Y-family tiling, 64x1 for
+TileX). Swizzled offset of each line is maintained using same swizzled
+incrementing as XFER_SPAN (see "Compute Mask[IncSize]..."), and final value is
+returned so caller's X-loop can continue where kernel left off. Kernels have
+external dependencies on caller for...
+    (1) 64B alignment of swizzled lines and chunk alignment of the run.
+    (2) Flushing of non-temporal stores (i.e. SFENCE). */
+
+#define WIDE_XFER_QUARTER_OFFSETS(Offsets, Width, LinearPitch)         \
+{   /* Linear offsets of the four 16B quarters of a swizzled line... */ \
+    int q;                                                              \
+    for(q = 0; q < 4; q++)                                              \
+    {                                                                   \
+        (Offsets)[q] =                                                  \
+            ((q * 16) / (Width)) * (LinearPitch) + ((q * 16) % (Width));\
+    }                                                                   \
+}
+
+TARGET_AVX2 static void WideXferToSwizzledAvx2( // ############################
+    char *pSwizzledAddressLine, int *pSwizzledOffsetX, int MaskX, char *pLinearAddress, int LinearPitch, int RunBytes, int Width)
+{
+    char *pLinearAddressEnd = pLinearAddress + RunBytes;
+    int SwizzledOffsetX = *pSwizzledOffsetX;
+    int Offset[4];
+
+    WIDE_XFER_QUARTER_OFFSETS(Offset, Width, LinearPitch);
+
+    while(pLinearAddress < pLinearAddressEnd)
+    {
+        __m256i *pSwizzledAddress = (__m256i *)(pSwizzledAddressLine + SwizzledOffsetX);
+
+        __m256i ymm0 = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(pLinearAddress + Offset[0]))),
+            _mm_loadu_si128((__m128i *)(pLinearAddress + Offset[1])), 1);
+        __m256i ymm1 = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(pLinearAddress + Offset[2]))),
+            _mm_loadu_si128((__m128i *)(pLinearAddress + Offset[3])), 1);
+
+        _mm256_stream_si256(pSwizzledAddress + 0, ymm0);
+        _mm256_stream_si256(pSwizzledAddress + 1, ymm1);
+
+        SwizzledOffsetX = (SwizzledOffsetX - MaskX) & MaskX;
+        pLinearAddress += Width;
+    }
+
+    *pSwizzledOffsetX = SwizzledOffsetX;
+}
+
+TARGET_AVX2 static void WideXferFromSwizzledAvx2( // ##########################
+    char *pSwizzledAddressLine, int *pSwizzledOffsetX, int MaskX, char *pLinearAddress, int LinearPitch, int RunBytes, int Width)
+{
+    char *pLinearAddressEnd = pLinearAddress + RunBytes;
+    int SwizzledOffsetX = *pSwizzledOffsetX;
+    int Offset[4];
+
+    WIDE_XFER_QUARTER_OFFSETS(Offset, Width, LinearPitch);
+
+    while(pLinearAddress < pLinearAddressEnd)
+    {
+        __m256i *pSwizzledAddress = (__m256i *)(pSwizzledAddressLine + SwizzledOffsetX);
+
+        __m256i ymm0 = _mm256_stream_load_si256(pSwizzledAddress + 0);
+        __m256i ymm1 = _mm256_stream_load_si256(pSwizzledAddress + 1);
+
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[0]), _mm256_castsi256_si128(ymm0));
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[1]), _mm256_extracti128_si256(ymm0, 1));
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[2]), _mm256_castsi256_si128(ymm1));
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[3]), _mm256_extracti128_si256(ymm1, 1));
+
+        SwizzledOffsetX = (SwizzledOffsetX - MaskX) & MaskX;
+        pLinearAddress += Width;
+    }
+
+    *pSwizzledOffsetX = SwizzledOffsetX;
+}
+
+#ifdef CPU_SWIZZLE_BLT_AVX512_SUPPORT
+
+#if(defined(__GNUC__) && !defined(__clang__))
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // False positives on _mm*_undefined_* within AVX-512 intrinsic headers.
+#endif
+
+TARGET_AVX512 static void WideXferToSwizzledAvx512( // #########################
+    char *pSwizzledAddressLine, int *pSwizzledOffsetX, int MaskX, char *pLinearAddress, int LinearPitch, int RunBytes, int Width)
+{
+    char *pLinearAddressEnd = pLinearAddress + RunBytes;
+    int SwizzledOffsetX = *pSwizzledOffsetX;
+    int Offset[4];
+
+    WIDE_XFER_QUARTER_OFFSETS(Offset, Width, LinearPitch);
+
+    while(pLinearAddress < pLinearAddressEnd)
+    {
+        __m256i ymm0 = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(pLinearAddress + Offset[0]))),
+            _mm_loadu_si128((__m128i *)(pLinearAddress + Offset[1])), 1);
+        __m256i ymm1 = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(pLinearAddress + Offset[2]))),
+            _mm_loadu_si128((__m128i *)(pLinearAddress + Offset[3])), 1);
+        __m512i zmm = _mm512_inserti64x4(_mm512_castsi256_si512(ymm0), ymm1, 1);
+
+        _mm512_stream_si512((void *)(pSwizzledAddressLine + SwizzledOffsetX), zmm);
+
+        SwizzledOffsetX = (SwizzledOffsetX - MaskX) & MaskX;
+        pLinearAddress += Width;
+    }
+
+    *pSwizzledOffsetX = SwizzledOffsetX;
+}
+
+TARGET_AVX512 static void WideXferFromSwizzledAvx512( // #######################
+    char *pSwizzledAddressLine, int *pSwizzledOffsetX, int MaskX, char *pLinearAddress, int LinearPitch, int RunBytes, int Width)
+{
+    char *pLinearAddressEnd = pLinearAddress + RunBytes;
+    int SwizzledOffsetX = *pSwizzledOffsetX;
+    int Offset[4];
+
+    WIDE_XFER_QUARTER_OFFSETS(Offset, Width, LinearPitch);
+
+    while(pLinearAddress < pLinearAddressEnd)
+    {
+        __m512i zmm = _mm512_stream_load_si512((void *)(pSwizzledAddressLine + SwizzledOffsetX));
+        __m256i ymm0 = _mm512_castsi512_si256(zmm);
+        __m256i ymm1 = _mm512_extracti64x4_epi64(zmm, 1);
+
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[0]), _mm256_castsi256_si128(ymm0));
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[1]), _mm256_extracti128_si256(ymm0, 1));
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[2]), _mm256_castsi256_si128(ymm1));
+        _mm_storeu_si128((__m128i *)(pLinearAddress + Offset[3]), _mm256_extracti128_si256(ymm1, 1));
+
+        SwizzledOffsetX = (SwizzledOffsetX - MaskX) & MaskX;
+        pLinearAddress += Width;
+    }
+
+    *pSwizzledOffsetX = SwizzledOffsetX;
+}
+
+#if(defined(__GNUC__) && !defined(__clang__))
+    #pragma GCC diagnostic pop
+#endif
+
+#endif // CPU_SWIZZLE_BLT_AVX512_SUPPORT
+
+#endif // Wide Transfer Kernels
+
+
+// Element Conversion ##########################################################
+
+/* Converting transfers (i.e. Dest.Element.pConvert) load each source element 
+into an XMM register, convert it there, and store destination element--so 
+format conversion costs no additional pass over memory. Conversion is optional 
+numeric conversion of source channels (e.g. half-to-float), followed by PSHUFB 
+channel arrangement, with constant channels OR'ed in. */
+
+#if(!defined(MINIMALIST) && defined(SUB_ELEMENT_SUPPORT))
+
+typedef struct _ELEMENT_CONVERT
+{
+    __m128i     Shuffle;    // PSHUFB control arranging (numerically converted) source bytes into destination element.
+    __m128i     Fill;       // Constant-channel bytes.
+    int         Numeric;
+} ELEMENT_CONVERT;
+
+static void PrepareElementConvert( // ##########################################
+
+    /* Expands conversion descriptor into per-BLT register constants. */
+
+    ELEMENT_CONVERT                 *pPrepared, // Pointer to prepared conversion.
+    const CPU_SWIZZLE_BLT_CONVERT   *pConvert)  // Pointer to conversion descriptor, or NULL if none.
+
+{ // ###########################################################################
+
+    union { __m128i x; unsigned char b[16]; } Shuffle, Fill;
+    int DestChannelSize, c, i;
+
+    if(!pConvert) 
+    {
+        pPrepared->Shuffle = pPrepared->Fill = _mm_setzero_si128();
+        pPrepared->Numeric = CPU_SWIZZLE_BLT_CONVERT_NONE;
+        return;
+    }
+
+    DestChannelSize = 
+        (pConvert->Numeric == CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT) ? pConvert->ChannelSize * 2 : 
+        (pConvert->Numeric == CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF) ? pConvert->ChannelSize / 2 : 
+        pConvert->ChannelSize;
+
+    assert( // Legit conversion...
+        ((pConvert->Numeric == CPU_SWIZZLE_BLT_CONVERT_NONE) || 
+         ((pConvert->Numeric == CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT) && (pConvert->ChannelSize == 2)) || 
+         ((pConvert->Numeric == CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF) && (pConvert->ChannelSize == 4))) && 
+        (pConvert->NumChannels >= 1) && (pConvert->NumChannels <= 4) && 
+        (DestChannelSize * pConvert->NumChannels <= 16));
+
+    for(i = 0; i < 16; i++) 
+    {
+        Shuffle.b[i] = 0x80; // PSHUFB: Zero
+        Fill.b[i] = 0;
+    }
+
+    for(c = 0; c < pConvert->NumChannels; c++) 
+    {
+        for(i = 0; i < DestChannelSize; i++) 
+        {
+            if(pConvert->Channel[c] == CPU_SWIZZLE_BLT_CONVERT_CONSTANT) 
+            {
+                Fill.b[c * DestChannelSize + i] = (unsigned char)(pConvert->Constant >> (i * 8));
+            } 
+            else 
+            {
+                assert((pConvert->Channel[c] >= 0) && (pConvert->Channel[c] < 16 / DestChannelSize));
+                Shuffle.b[c * DestChannelSize + i] = (unsigned char)(pConvert->Channel[c] * DestChannelSize + i);
+            }
+        }
+    }
+
+    pPrepared->Shuffle = Shuffle.x;
+    pPrepared->Fill = Fill.x;
+    pPrepared->Numeric = pConvert->Numeric;
+
+} // PrepareElementConvert
+
+
+static __m128i HalfToFloat4(__m128i Half) // ###################################
+{
+    /* Widens four IEEE half-precision values (low 64 bits) to single-precision. 
+    Exponent is rebiased with float multiply, which also normalizes denormals; 
+    Inf/NaN exponents are then forced to all-ones. */
+
+    const __m128i MaskNoSign =  _mm_set1_epi32(0x7fff);
+    const __m128 Magic =        _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+    const __m128i WasInfNan =   _mm_set1_epi32(0x7bff);
+    const __m128i ExpInfNan =   _mm_set1_epi32(255 << 23);
+
+    __m128i h =         _mm_unpacklo_epi16(Half, _mm_setzero_si128());
+    __m128i ExpMant =   _mm_and_si128(MaskNoSign, h);
+    __m128i JustSign =  _mm_xor_si128(h, ExpMant);
+    __m128 Scaled =     _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(ExpMant, 13)), Magic);
+    __m128i InfNanExp = _mm_and_si128(_mm_cmpgt_epi32(ExpMant, WasInfNan), ExpInfNan);
+    __m128i SignInf =   _mm_or_si128(_mm_slli_epi32(JustSign, 16), InfNanExp);
+
+    return _mm_or_si128(_mm_castps_si128(Scaled), SignInf);
+
+} // HalfToFloat4
+
+
+static __m128i FloatToHalf4(__m128i Float) // ##################################
+{
+    /* Narrows four single-precision values to IEEE half-precision (packed into 
+    low 64 bits), rounding to nearest-even, with overflow to Inf and NaN's 
+    kept NaN. */
+
+    const __m128i SignMask =        _mm_set1_epi32(0x80000000);
+    const __m128i F16Max =          _mm_set1_epi32((127 + 16) << 23);       // Floats >= this round to Inf.
+    const __m128i MinNormal =       _mm_set1_epi32((127 - 14) << 23);       // Smallest float yielding normal half.
+    const __m128i SubnormMagic =    _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i NormalBias =      _mm_set1_epi32(0xfff - ((127 - 15) << 23)); // Rebias exponent and add rounding.
+
+    __m128i JustSign =  _mm_and_si128(Float, SignMask);
+    __m128i Abs =       _mm_xor_si128(Float, JustSign);
+    __m128i IsNan =     _mm_castps_si128(_mm_cmpunord_ps(_mm_castsi128_ps(Abs), _mm_castsi128_ps(Abs)));
+    __m128i IsRegular = _mm_cmpgt_epi32(F16Max, Abs);
+    __m128i InfOrNan =  _mm_or_si128(_mm_and_si128(IsNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+    __m128i IsSubnorm = _mm_cmpgt_epi32(MinNormal, Abs);
+
+    __m128i Subnorm =   _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Abs), _mm_castsi128_ps(SubnormMagic))), SubnormMagic);
+    __m128i MantOdd =   _mm_srai_epi32(_mm_slli_epi32(Abs, 31 - 13), 31); // -1 if half mantissa LSB odd (for round-to-even).
+    __m128i Normal =    _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(Abs, NormalBias), MantOdd), 13);
+
+    __m128i NonSpecial = _mm_or_si128(_mm_and_si128(Subnorm, IsSubnorm), _mm_andnot_si128(IsSubnorm, Normal));
+    __m128i Joined =    _mm_or_si128(_mm_and_si128(NonSpecial, IsRegular), _mm_andnot_si128(IsRegular, InfOrNan));
+    __m128i h =         _mm_or_si128(Joined, _mm_srli_epi32(JustSign, 16));
+
+    // Pack low words of each dword into low 64 bits...
+    h = _mm_shufflelo_epi16(h, _MM_SHUFFLE(3, 3, 2, 0));
+    h = _mm_shufflehi_epi16(h, _MM_SHUFFLE(3, 3, 2, 0));
+    return _mm_shuffle_epi32(h, _MM_SHUFFLE(3, 3, 2, 0));
+
+} // FloatToHalf4
+
+
+static __m128i ConvertElement(__m128i Element, const ELEMENT_CONVERT *pConvert, int Numeric) // ##
+{
+    /* Numeric is passed as constant by each XFER instantiation, so compiler 
+    keeps conditionals out of the transfer loops. */
+
+    if(Numeric == CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT) Element = HalfToFloat4(Element);
+    if(Numeric == CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF) Element = FloatToHalf4(Element);
+
+    return _mm_or_si128(_mm_shuffle_epi8(Element, pConvert->Shuffle), pConvert->Fill);
+
+} // ConvertElement
+
+
+static __m128i LoadElement(const void *pSrc, int Size) // #####################
+{
+    union { __m128i x; unsigned char b[16]; } Element;
+    int i;
+
+    switch(Size) 
+    {
+        case 16: return _mm_loadu_si128((const __m128i *) pSrc);
+        case  8: return _mm_loadl_epi64((const __m128i *) pSrc);
+        case  4: return _mm_cvtsi32_si128(*(const int *) pSrc);
+        case  2: return _mm_cvtsi32_si128(*(const unsigned short *) pSrc);
+        case  1: return _mm_cvtsi32_si128(*(const unsigned char *) pSrc);
+        default: 
+        {
+            Element.x = _mm_setzero_si128();
+            for(i = 0; i < Size; i++) Element.b[i] = ((const unsigned char *) pSrc)[i];
+            return Element.x;
+        }
+    }
+
+} // LoadElement
+
+
+static void StoreElement(void *pDest, __m128i Value, int Size) // #############
+{
+    union { __m128i x; unsigned char b[16]; } Element;
+    int i;
+
+    switch(Size) 
+    {
+        case 16: _mm_storeu_si128((__m128i *) pDest, Value); break;
+        case  8: _mm_storel_epi64((__m128i *) pDest, Value); break;
+        case  4: *(int *) pDest = _mm_cvtsi128_si32(Value); break;
+        case  2: *(unsigned short *) pDest = (unsigned short) _mm_cvtsi128_si32(Value); break;
+        case  1: *(unsigned char *) pDest = (unsigned char) _mm_cvtsi128_si32(Value); break;
+        default: 
+        {
+            Element.x = Value;
+            for(i = 0; i < Size; i++) ((unsigned char *) pDest)[i] = Element.b[i];
+        }
+    }
+
+} // StoreElement
+
+#endif // Element Conversion
+
+
+static void CpuRetileBlt( // ###################################################
+
+    /* Performs BLT between two swizzled surfaces. */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    CPU_SWIZZLE_BLT_SURFACE *pSrc,          // Pointer to source surface descriptor.
+    int                     CopyWidthBytes, // Width of BLT rectangle, in bytes.
+    int                     CopyHeight)     // Height of BLT rectangle, in physical/pitch rows.
+
+    /* Retiling (e.g. TileX-to-TileY, or TileY-to-TileYs) maps tiles straight 
+    between the two swizzle descriptors--i.e. without staging through a linear 
+    intermediate, which would double memory traffic.
+
+    Any two swizzles share a "common run" granularity--the number of low-order 
+    offset bits that are X bits in both descriptors (e.g. 16 bytes for TileX 
+    and TileY, 512 bytes for TileX and TileX). Within such run, bytes are 
+    contiguous in both surfaces, so BLT is performed as series of run copies, 
+    with run offsets within tiles taken from small per-surface tables built up 
+    front (one entry per run of tile width), and tile-granular offsets computed 
+    arithmetically.
+    
+    Rows are traversed in bands matching the height of a destination cache 
+    line (e.g. four 16-byte runs of TileY), so non-temporal writes to the 
+    destination fill complete lines. */
+
+{ // ###########################################################################
+
+    #define MAX_RETILE_RUNS_PER_TILE    512 // Max Tile Width (TileX) at 1-Byte Run Granularity
+    #define MAX_RETILE_BAND_HEIGHT      16
+
+    struct RETILE_SURFACE_REC 
+    {
+        CPU_SWIZZLE_BLT_SURFACE *pSurface;
+        int TileWidthBits, TileSizeBits, TilesPerRow;
+        int RunOffset[MAX_RETILE_RUNS_PER_TILE];    // Intra-tile swizzled offset of each run in tile's top row.
+        char *pRow[MAX_RETILE_BAND_HEIGHT];         // Address of (x = 0) for each row of current band.
+    } Surface[2], *pD = &Surface[0], *pS = &Surface[1];
+
+    int RunBits, RunBytes, BandHeight;
+    int i, x, y, y0;
+
+    assert( // No surface overrun...
+        ((pDest->OffsetX + CopyWidthBytes) <= pDest->Pitch) && 
+        ((pDest->OffsetY + CopyHeight) <= pDest->Height) && 
+        ((pSrc->OffsetX + CopyWidthBytes) <= pSrc->Pitch) && 
+        ((pSrc->OffsetY + CopyHeight) <= pSrc->Height));
+
+    #ifdef SUB_ELEMENT_SUPPORT
+        assert( // No Sub-Element Transfer or Conversion...
+            (pDest->Element.Size == pDest->Element.Pitch) && 
+            (pSrc->Element.Size == pSrc->Element.Pitch) && 
+            !pDest->Element.pConvert && !pSrc->Element.pConvert);
+    #endif
+
+    #ifdef INTEL_CSX_SWIZZLE_SUPPORT
+        assert(
+            (pDest->pSwizzle->XOR == SWIZZLE_DESCRIPTOR_XOR_NONE) && 
+            (pSrc->pSwizzle->XOR == SWIZZLE_DESCRIPTOR_XOR_NONE));
+    #endif
+
+    { // Compute Common Run Granularity...
+        int CommonLowX = // Low-order X bits shared by both swizzles, plus first non-X bit.
+            ~(pDest->pSwizzle->Mask.x & pSrc->pSwizzle->Mask.x);
+
+        RunBits = 0;
+        while(!(CommonLowX & (1 << RunBits))) RunBits++;
+
+        // Runs can only be shared where surfaces agree on X alignment...
+        while((RunBits > 0) && ((pDest->OffsetX - pSrc->OffsetX) & ((1 << RunBits) - 1))) RunBits--;
+
+        RunBytes = 1 << RunBits;
+    }
+
+    { // Compute Band Height...
+        int DestLowXBits = 0, DestTileHeight = 1 << POPCNT16(pDest->pSwizzle->Mask.y);
+
+        while(pDest->pSwizzle->Mask.x & (1 << DestLowXBits)) DestLowXBits++;
+
+        BandHeight = 64 >> ((DestLowXBits < 6) ? DestLowXBits : 6);
+        if(BandHeight > DestTileHeight) BandHeight = DestTileHeight;
+        if(BandHeight > MAX_RETILE_BAND_HEIGHT) BandHeight = MAX_RETILE_BAND_HEIGHT;
+    }
+
+    pD->pSurface = pDest;
+    pS->pSurface = pSrc;
+
+    for(i = 0; i < 2; i++) // Per-Surface Run Tables...
+    {
+        struct RETILE_SURFACE_REC *pSurface = &Surface[i];
+        int Run, RunsPerTile;
+
+        pSurface->TileWidthBits = POPCNT16(pSurface->pSurface->pSwizzle->Mask.x);
+        pSurface->TileSizeBits = 
+            pSurface->TileWidthBits + 
+            POPCNT16(pSurface->pSurface->pSwizzle->Mask.y) + 
+            POPCNT16(pSurface->pSurface->pSwizzle->Mask.z);
+        pSurface->TilesPerRow = pSurface->pSurface->Pitch >> pSurface->TileWidthBits;
+
+        RunsPerTile = 1 << (pSurface->TileWidthBits - RunBits);
+        assert(RunsPerTile <= MAX_RETILE_RUNS_PER_TILE);
+
+        for(Run = 0; Run < RunsPerTile; Run++)
+        {
+            pSurface->RunOffset[Run] = 
+                SwizzleOffset(pSurface->pSurface->pSwizzle, pSurface->pSurface->Pitch, Run << RunBits, 0, 0);
+        }
+    }
+
+    for(y0 = 0; y0 < CopyHeight; y0 += BandHeight) 
+    {
+        int Rows = ((CopyHeight - y0) < BandHeight) ? (CopyHeight - y0) : BandHeight;
+
+        for(i = 0; i < 2; i++) 
+        {
+            for(y = 0; y < Rows; y++) 
+            {
+                Surface[i].pRow[y] = 
+                    (char *) Surface[i].pSurface->pBase + 
+                    SwizzleOffset(
+                        Surface[i].pSurface->pSwizzle, 
+                        Surface[i].pSurface->Pitch, 
+                        0, 
+                        Surface[i].pSurface->OffsetY + y0 + y, 
+                        Surface[i].pSurface->OffsetZ);
+            }
+        }
 
-            bitIndex++;
-            bitMask <<= 1;
+        for(x = 0; x < CopyWidthBytes; ) 
+        {
+            int xd = pDest->OffsetX + x, xs = pSrc->OffsetX + x;
+            int Run = RunBytes - (xd & (RunBytes - 1));
+            int OffsetD, OffsetS;
 
-            #undef PROCESS
+            if(Run > CopyWidthBytes - x) Run = CopyWidthBytes - x;
+
+            #define RETILE_X_OFFSET(pSurface, x) (                                          \
+                (((x) >> (pSurface)->TileWidthBits) << (pSurface)->TileSizeBits) +          \
+                (pSurface)->RunOffset[((x) & ((1 << (pSurface)->TileWidthBits) - 1)) >> RunBits] + \
+                ((x) & (RunBytes - 1)))
+
+            OffsetD = RETILE_X_OFFSET(pD, xd);
+            OffsetS = RETILE_X_OFFSET(pS, xs);
+
+            #undef RETILE_X_OFFSET
+
+            { // Copy Run in Each Row of Band...
+                uintptr_t Alignment = (uintptr_t)(Run | OffsetD | OffsetS);
+
+                for(y = 0; y < Rows; y++) 
+                {
+                    Alignment |= (uintptr_t) pD->pRow[y] | (uintptr_t) pS->pRow[y];
+                }
+
+                for(y = 0; y < Rows; y++) 
+                {
+                    char *pDestRun = pD->pRow[y] + OffsetD;
+                    char *pSrcRun = pS->pRow[y] + OffsetS;
+                    int Bytes = Run;
+
+                    if(!(Alignment & 0xf)) 
+                    {
+                        // Stream from source (possibly WC-mapped) to non-temporal destination (unless either Temporal)...
+                        for(; Bytes; Bytes -= 16, pDestRun += 16, pSrcRun += 16) 
+                        {
+                            __m128i xmm;
+
+                            if(CpuFeatures.StreamingLoad && !pSrc->Temporal) 
+                            {
+                                MOVNTDQA_R(xmm, pSrcRun);
+                            } 
+                            else 
+                            {
+                                xmm = _mm_load_si128((__m128i *) pSrcRun);
+                            }
+
+                            if(pDest->Temporal) 
+                            {
+                                _mm_store_si128((__m128i *) pDestRun, xmm);
+                            } 
+                            else 
+                            {
+                                _mm_stream_si128((__m128i *) pDestRun, xmm);
+                            }
+                        }
+                    } 
+                    else 
+                    {
+                        for(; Bytes >= 16; Bytes -= 16, pDestRun += 16, pSrcRun += 16) 
+                        {
+                            _mm_storeu_si128((__m128i *) pDestRun, _mm_loadu_si128((__m128i *) pSrcRun));
+                        }
+                        for(; Bytes; Bytes--) 
+                        {
+                            *pDestRun++ = *pSrcRun++;
+                        }
+                    }
+                }
+            }
+
+            x += Run;
         }
     }
 
-    return(SwizzledOffset);
-}
+    _mm_sfence(); // Flush Non-Temporal Writes
+
+    #undef MAX_RETILE_RUNS_PER_TILE
+    #undef MAX_RETILE_BAND_HEIGHT
+} // CpuRetileBlt
 
 
 void CpuSwizzleBlt( // #########################################################
@@ -493,6 +1451,14 @@ void CpuSwizzleBlt( // #########################################################
     CPU_SWIZZLE_BLT_SURFACE *pLinearSurface, *pSwizzledSurface;
     int LinearToSwizzled;
 
+    if(pDest->pSwizzle && pSrc->pSwizzle) // Both surfaces swizzled (i.e. retiling)...
+    {
+        if(!CpuFeatures.Probed) ProbeCpuFeatures();
+
+        CpuRetileBlt(pDest, pSrc, CopyWidthBytes, CopyHeight);
+        return;
+    }
+
     { // One surface swizzled, the other unswizzled (aka "linear")...
         assert((pDest->pSwizzle != NULL) ^ (pSrc->pSwizzle != NULL));
 
@@ -514,8 +1480,14 @@ void CpuSwizzleBlt( // #########################################################
         assert( // Either both or neither specified...
             (pDest->Element.Pitch != 0) == (pSrc->Element.Pitch != 0));
 
-        assert( // Surfaces agree on transfer element size...
-            pDest->Element.Size == pSrc->Element.Size);
+        assert( // Surfaces agree on transfer element size (unless converting)...
+            (pDest->Element.Size == pSrc->Element.Size) || 
+            pDest->Element.pConvert);
+
+        assert( // Conversion specified on destination only, for whole elements...
+            !pSrc->Element.pConvert && 
+            (!pDest->Element.pConvert || 
+             ((pDest->Element.Size <= 16) && (pSrc->Element.Size <= 16))));
 
         assert( // Element pitch not specified without element size...
             !(pDest->Element.Pitch && !pDest->Element.Size));
@@ -536,7 +1508,8 @@ void CpuSwizzleBlt( // #########################################################
             (
                 // Sub-element transfer...
                 ((pLinearSurface->Element.Size != pLinearSurface->Element.Pitch) || 
-                    (pSwizzledSurface->Element.Size != pSwizzledSurface->Element.Pitch)) && 
+                    (pSwizzledSurface->Element.Size != pSwizzledSurface->Element.Pitch) || 
+                    pDest->Element.pConvert) && 
                 // No overrun...
                 ((pLinearSurface->OffsetX + CopyWidthBytes) <= 
                     (pLinearSurface->Pitch + 
@@ -596,9 +1569,10 @@ void CpuSwizzleBlt( // #########################################################
         #ifdef MINIMALIST // Simple implementation for functional understanding/testing/etc.
         {
             #ifdef SUB_ELEMENT_SUPPORT
-                assert( // No Sub-Element Transfer...
+                assert( // No Sub-Element Transfer or Conversion...
                     (pLinearSurface->Element.Size == pLinearSurface->Element.Pitch) && 
-                    (pSwizzledSurface->Element.Size == pSwizzledSurface->Element.Pitch));
+                    (pSwizzledSurface->Element.Size == pSwizzledSurface->Element.Pitch) && 
+                    !pDest->Element.pConvert);
             #endif
 
             #ifdef INTEL_CSX_SWIZZLE_SUPPORT
@@ -721,11 +1695,11 @@ void CpuSwizzleBlt( // #########################################################
             #define SWIZZLE_OFFSET(OffsetX, OffsetY, OffsetZ) \
                 SwizzleOffset(pSwizzledSurface->pSwizzle, pSwizzledSurface->Pitch, OffsetX, OffsetY, OffsetZ)
 
+            #define NO_WIDE_XFER ((WIDE_XFER) 0) // For XFER instantiations without wide-transfer support.
+
             #define MAX_XFER_WIDTH  16  // See "Compute Transfer Dimensions".
             #define MAX_XFER_HEIGHT 4   // "
 
-            static char StreamingLoadSupported = -1; // SSE4.1: MOVNTDQA
-
             int TileWidthBits = POPCNT16(pSwizzledSurface->pSwizzle->Mask.x);   // Log2(Tile Width in Bytes)
             int TileHeightBits = POPCNT16(pSwizzledSurface->pSwizzle->Mask.y);  // Log2(Tile Height)
             int TileDepthBits = POPCNT16(pSwizzledSurface->pSwizzle->Mask.z);   // Log2(Tile Depth or MSAA Samples)
@@ -735,6 +1709,15 @@ void CpuSwizzleBlt( // #########################################################
             int MaskX[MAX_XFER_WIDTH + 1], MaskY[MAX_XFER_HEIGHT + 1];
             int SwizzledOffsetX0, SwizzledOffsetY;
             struct { int Width, Height; } SwizzleMaxXfer;
+            struct { WIDE_XFER pfnXfer; int Width, Height, MaskX, Lead, Run; } WideXfer = {0};
+
+            #ifdef SUB_ELEMENT_SUPPORT
+                int ElementXfer = // i.e. element-by-element transfer...
+                    (pLinearSurface->Element.Size != pLinearSurface->Element.Pitch) || 
+                    (pSwizzledSurface->Element.Size != pSwizzledSurface->Element.Pitch) || 
+                    (pDest->Element.pConvert != NULL);
+                ELEMENT_CONVERT Convert;
+            #endif
 
             char *pSwizzledAddressCopyBase = 
                 (char *) pSwizzledSurface->pBase + 
@@ -742,28 +1725,11 @@ void CpuSwizzleBlt( // #########################################################
 
             assert(sizeof(__m24) == 3);
 
-            if(StreamingLoadSupported == -1) 
-            {
-                #if(_MSC_VER >= 1500)
-                    #define MOVNTDQA_R(Reg, Src) ((Reg) = _mm_stream_load_si128((__m128i *)(Src)))
-                    int CpuInfo[4];
-                    __cpuid(CpuInfo, 1);
-                    StreamingLoadSupported = ((CpuInfo[2] & (1 << 19)) != 0); // ECX[19] = SSE4.1
-                #elif((defined __clang__) || (__GNUC__ > 4) || (__GNUC__ == 4) && (__GNUC_MINOR__ >= 5))
-                    #define MOVNTDQA_R(Reg, Src) ((Reg) = _mm_stream_load_si128((__m128i *)(Src)))
-                    unsigned int eax, ebx, ecx, edx;
-                    __cpuid(1, eax, ebx, ecx, edx);
-                    StreamingLoadSupported = ((ecx & (1 << 19)) != 0); // ECX[19] = SSE4.1
-                #elif defined(__ghs__)
-                    #define MOVNTDQA_R(Reg, Src) ((Reg) = _mm_stream_load_si128((__m128i *)(Src)))
-                    unsigned int CpuInfo[4];
-                    __CPUID(1, CpuInfo);
-                    StreamingLoadSupported = ((CpuInfo[2] & (1 << 19)) != 0); // ECX[19] = SSE4.1
-                #else
-                    #define MOVNTDQA_R(Reg, Src) ((Reg) = (Reg))
-                    StreamingLoadSupported = 0;
-                #endif
-            }
+            if(!CpuFeatures.Probed) ProbeCpuFeatures();
+
+            #ifdef SUB_ELEMENT_SUPPORT
+                PrepareElementConvert(&Convert, pDest->Element.pConvert);
+            #endif
 
             { // Compute Transfer Dimensions...
 
@@ -848,9 +1814,8 @@ void CpuSwizzleBlt( // #########################################################
 
                 #ifdef SUB_ELEMENT_SUPPORT
                 {
-                    // For partial-pixel transfers, there is no crust and MainRun is done pixel-by-pixel...
-                    if( (pLinearSurface->Element.Size != pLinearSurface->Element.Pitch) || 
-                        (pSwizzledSurface->Element.Size != pSwizzledSurface->Element.Pitch)) 
+                    // For partial-pixel (or converting) transfers, there is no crust and MainRun is done pixel-by-pixel...
+                    if(ElementXfer) 
                     {
                         CopyWidth.LeftCrust = CopyWidth.RightCrust = 0;
                         CopyWidth.MainRun = CopyWidthBytes;
@@ -932,17 +1897,93 @@ void CpuSwizzleBlt( // #########################################################
                 {
                     MaskY[y] = SWIZZLE_OFFSET(0, (1 << TileHeightBits) - y, 0);
                 }
+
+                // Wide transfers use 64B-line-sized chunks: Width x (64 / Width)...
+                for(WideXfer.Width = 64; 
+                    (pSwizzledSurface->pSwizzle->Mask.x & (WideXfer.Width - 1)) != (WideXfer.Width - 1); 
+                    WideXfer.Width >>= 1);
+
+                WideXfer.Height = 64 / WideXfer.Width;
+                WideXfer.MaskX = SWIZZLE_OFFSET((1 << TileWidthBits) - WideXfer.Width, 0, 0) | ExtendedMaskX;
+            }
+
+            #ifdef CPU_SWIZZLE_BLT_AVX2_SUPPORT
+            { // Select Wide Transfer Kernel (see "Wide Transfer Kernels")...
+
+                /* Usable only where each swizzled cache line holds row-ordered 
+                chunk our 16x4 (or 16x1) X-loop would otherwise transfer in 
+                pieces--i.e. 16x4 for Y-family tilings, 64x1 for TileX. */
+
+                int Usable = 
+                    (SwizzleMaxXfer.Width == 16) && 
+                    (WideXfer.Width >= 16) && 
+                    (WideXfer.Height == SwizzleMaxXfer.Height) && 
+                    ((uintptr_t) pSwizzledAddressCopyBase % 64 == 0) && 
+                    !pSwizzledSurface->Temporal; // Wide kernels stream--and Temporal BLTs are small anyway.
+
+                #ifdef SUB_ELEMENT_SUPPORT
+                    Usable = Usable && !ElementXfer;
+                #endif
+
+                #ifdef INTEL_CSX_SWIZZLE_SUPPORT
+                    Usable = Usable && (pSwizzledSurface->pSwizzle->XOR == SWIZZLE_DESCRIPTOR_XOR_NONE);
+                #endif
+
+                if(Usable) 
+                {
+                    // Split MainRun into SSE "Lead" to Width-aligned boundary, then wide "Run"...
+                    WideXfer.Lead = (WideXfer.Width - (x0 + CopyWidth.LeftCrust)) & (WideXfer.Width - 1);
+                    if(WideXfer.Lead > CopyWidth.MainRun) WideXfer.Lead = CopyWidth.MainRun;
+                    WideXfer.Run = (CopyWidth.MainRun - WideXfer.Lead) & ~(WideXfer.Width - 1);
+
+                    if(WideXfer.Run) 
+                    {
+                        #ifdef CPU_SWIZZLE_BLT_AVX512_SUPPORT
+                            if(CpuFeatures.Avx512) 
+                            {
+                                WideXfer.pfnXfer = LinearToSwizzled ? WideXferToSwizzledAvx512 : WideXferFromSwizzledAvx512;
+                            } 
+                            else 
+                        #endif
+                        if(CpuFeatures.Avx2) 
+                        {
+                            WideXfer.pfnXfer = LinearToSwizzled ? WideXferToSwizzledAvx2 : WideXferFromSwizzledAvx2;
+                        }
+                    }
+                }
             }
+            #endif
 
             { // Base Dimensional Swizzled Offsets...
                 int IntraTileY = y0 & ((1 << TileHeightBits) - 1);
                 int TileAlignedY = y0 - IntraTileY;
+                int PixelX0 = x0;
+
+                #ifdef SUB_ELEMENT_SUPPORT
+                {
+                    /* Sub-element transfers can start part way into a pixel 
+                    (e.g. S8 of S8D24), but swizzled X incrementing by 
+                    Element.Pitch clears the bits below it--So keep the 
+                    intra-pixel offset out of SwizzledOffsetX and in the base 
+                    address instead (it falls within pixel's linear X run). */
+                    int ElementPitch = pSwizzledSurface->Element.Pitch;
+
+                    if( ElementXfer && 
+                        ElementPitch && 
+                        !(ElementPitch & (ElementPitch - 1)) && 
+                        (ElementPitch <= SwizzleMaxXfer.Width)) 
+                    {
+                        PixelX0 = x0 & ~(ElementPitch - 1);
+                        pSwizzledAddressCopyBase += x0 - PixelX0;
+                    }
+                }
+                #endif
 
                 SwizzledOffsetY = SWIZZLE_OFFSET(0, IntraTileY, 0);
 
                 SwizzledOffsetX0 = 
                     SWIZZLE_OFFSET(
-                        x0, 
+                        PixelX0, 
                         TileAlignedY, // <-- Since SwizzledOffsetX will include "bits beyond the tile".
                         0);
             }
@@ -965,6 +2006,26 @@ void CpuSwizzleBlt( // #########################################################
                 char *pLinearAddressEnd;
                 int _MaskX;
 
+                if(LinearToSwizzled && pLinearSurface->PrefetchRows) 
+                {
+                    // Software-prefetch linear source rows PrefetchRows ahead of those about to be transferred...
+                    int Row = y + pLinearSurface->PrefetchRows;
+                    int RowEnd = Row + xferHeight;
+                    int x;
+
+                    if(RowEnd > y1) RowEnd = y1;
+                    for(; Row < RowEnd; Row++) 
+                    {
+                        const char *pRow = pLinearAddress + (intptr_t) (Row - y) * pLinearSurface->Pitch;
+
+                        for(x = 0; x < CopyWidthBytes; x += 64) 
+                        {
+                            _mm_prefetch(pRow + x, _MM_HINT_T0);
+                        }
+                        _mm_prefetch(pRow + CopyWidthBytes - 1, _MM_HINT_T0); // Line holding run's last byte.
+                    }
+                }
+
                 // XFER Macros /////////////////////////////////////////////////
 
                 /* We'll define "XFER" macro to contain BLT X-loop work.
@@ -995,14 +2056,14 @@ void CpuSwizzleBlt( // #########################################################
                 will simply decide whether given instantiation has that code or 
                 not. */
 
-                #define XFER(XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust) \
+                #define XFER(XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust, XFER_Wide) \
                 {                                                                                                   \
-                         XFER_LINES(4, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust) \
-                    else XFER_LINES(2, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust) \
-                    else XFER_LINES(1, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust);\
+                         XFER_LINES(4, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust, XFER_Wide) \
+                    else XFER_LINES(2, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust, XFER_Wide) \
+                    else XFER_LINES(1, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust, XFER_Wide);\
                 }
 
-                #define XFER_LINES(XFER_LINES_Lines, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust) \
+                #define XFER_LINES(XFER_LINES_Lines, XFER_Store, XFER_Load, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch, XFER_Crust, XFER_Wide) \
                     if(xferHeight == (XFER_LINES_Lines))    \
                     {                                       \
                         if(XFER_Crust)                      \
@@ -1013,7 +2074,17 @@ void CpuSwizzleBlt( // #########################################################
                             XFER_SPAN(MOVQ_M, MOVQ_R, CopyWidth.LeftCrust  & 8, 8, 8, XFER_LINES_Lines, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch); \
                         }                                   \
                                                             \
-                        XFER_SPAN(XFER_Store, XFER_Load, CopyWidth.MainRun, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_LINES_Lines, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch);\
+                        if((XFER_Wide) && ((XFER_LINES_Lines) == WideXfer.Height)) \
+                        {                                   \
+                            XFER_SPAN(XFER_Store, XFER_Load, WideXfer.Lead, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_LINES_Lines, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch); \
+                            (XFER_Wide)(pSwizzledAddressLine, &SwizzledOffsetX, WideXfer.MaskX, pLinearAddress, pLinearSurface->Pitch, WideXfer.Run, WideXfer.Width); \
+                            pLinearAddress += WideXfer.Run; \
+                            XFER_SPAN(XFER_Store, XFER_Load, CopyWidth.MainRun - WideXfer.Lead - WideXfer.Run, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_LINES_Lines, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch); \
+                        }                                   \
+                        else                                \
+                        {                                   \
+                            XFER_SPAN(XFER_Store, XFER_Load, CopyWidth.MainRun, XFER_Pitch_Swizzled, XFER_Pitch_Linear, XFER_LINES_Lines, XFER_pDest, XFER_DestPitch, XFER_pSrc, XFER_SrcPitch); \
+                        }                                   \
                                                             \
                         if(XFER_Crust)                      \
                         {                                   \
@@ -1074,19 +2145,63 @@ void CpuSwizzleBlt( // #########################################################
                     (pSwizzledSurface->Pitch % 16 == 0));
 
                 #ifdef SUB_ELEMENT_SUPPORT
-                    if( (pLinearSurface->Element.Size != pLinearSurface->Element.Pitch) || 
-                        (pSwizzledSurface->Element.Size != pSwizzledSurface->Element.Pitch)) 
+                    if(pDest->Element.pConvert) 
+                    {
+                        /* Converting transfers load/store each side's own 
+                        element size, with conversion in between. (Plain, 
+                        temporal loads/stores, since elements are generally 
+                        smaller than the streaming 16 bytes.) */
+
+                        #define CVT_LOAD(Reg, Src)          ((Reg) = LoadElement((Src), pSrc->Element.Size))
+                        #define CVT_STORE(Dest, Reg, Numeric) StoreElement((Dest), ConvertElement((Reg), &Convert, (Numeric)), pDest->Element.Size)
+                        #define CVT_STORE_NONE(Dest, Reg)   CVT_STORE((Dest), (Reg), CPU_SWIZZLE_BLT_CONVERT_NONE)
+                        #define CVT_STORE_H2F(Dest, Reg)    CVT_STORE((Dest), (Reg), CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT)
+                        #define CVT_STORE_F2H(Dest, Reg)    CVT_STORE((Dest), (Reg), CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF)
+
+                        if(LinearToSwizzled) 
+                        {
+                            switch(Convert.Numeric) 
+                            {
+                                case CPU_SWIZZLE_BLT_CONVERT_NONE:          XFER(CVT_STORE_NONE, CVT_LOAD, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                case CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT: XFER( CVT_STORE_H2F, CVT_LOAD, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                case CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF: XFER( CVT_STORE_F2H, CVT_LOAD, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                default: assert(0);
+                            }
+                        } 
+                        else 
+                        {
+                            switch(Convert.Numeric) 
+                            {
+                                case CPU_SWIZZLE_BLT_CONVERT_NONE:          XFER(CVT_STORE_NONE, CVT_LOAD, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                case CPU_SWIZZLE_BLT_CONVERT_HALF_TO_FLOAT: XFER( CVT_STORE_H2F, CVT_LOAD, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                case CPU_SWIZZLE_BLT_CONVERT_FLOAT_TO_HALF: XFER( CVT_STORE_F2H, CVT_LOAD, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                default: assert(0);
+                            }
+                        }
+                    } 
+                    else if(ElementXfer) 
                     {
                         if(LinearToSwizzled) 
                         {
                             switch(pLinearSurface->Element.Size) 
                             {
-                                case 16: XFER(MOVNTDQ_M, MOVDQU_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0); break;
-                                case  8: XFER(   MOVQ_M,   MOVQ_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0); break;
-                                case  4: XFER(   MOVD_M,   MOVD_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0); break;
-                                case  3: XFER(   MOV3_M,   MOV3_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0); break;
-                                case  2: XFER(   MOVW_M,   MOVW_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0); break;
-                                case  1: XFER(   MOVB_M,   MOVB_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0); break;
+                                case 16: 
+                                {
+                                    if(pSwizzledSurface->Temporal) 
+                                    {
+                                        XFER(  MOVDQ_M, MOVDQU_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER);
+                                    } 
+                                    else 
+                                    {
+                                        XFER(MOVNTDQ_M, MOVDQU_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER);
+                                    }
+                                    break;
+                                }
+                                case  8: XFER(   MOVQ_M,   MOVQ_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                case  4: XFER(   MOVD_M,   MOVD_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                case  3: XFER(   MOV3_M,   MOV3_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                case  2: XFER(   MOVW_M,   MOVW_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
+                                case  1: XFER(   MOVB_M,   MOVB_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, pLinearAddress, pLinearSurface->Pitch, 0, NO_WIDE_XFER); break;
                                 default: assert(0);
                             }
                         } 
@@ -1096,21 +2211,21 @@ void CpuSwizzleBlt( // #########################################################
                             {
                                 case 16: 
                                 {
-                                    if(StreamingLoadSupported) 
+                                    if(CpuFeatures.StreamingLoad && !pSwizzledSurface->Temporal) 
                                     {
-                                        XFER(MOVDQU_M, MOVNTDQA_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0);
+                                        XFER(MOVDQU_M, MOVNTDQA_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER);
                                     } 
                                     else 
                                     {
-                                        XFER(MOVDQU_M,    MOVDQ_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0);
+                                        XFER(MOVDQU_M,    MOVDQ_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER);
                                     }
                                     break;
                                 }
-                                case  8: XFER(   MOVQ_M,   MOVQ_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0); break;
-                                case  4: XFER(   MOVD_M,   MOVD_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0); break;
-                                case  3: XFER(   MOV3_M,   MOV3_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0); break;
-                                case  2: XFER(   MOVW_M,   MOVW_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0); break;
-                                case  1: XFER(   MOVB_M,   MOVB_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0); break;
+                                case  8: XFER(   MOVQ_M,   MOVQ_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                case  4: XFER(   MOVD_M,   MOVD_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                case  3: XFER(   MOV3_M,   MOV3_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                case  2: XFER(   MOVW_M,   MOVW_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
+                                case  1: XFER(   MOVB_M,   MOVB_R, pSwizzledSurface->Element.Pitch, pLinearSurface->Element.Pitch, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, SwizzleMaxXfer.Width, 0, NO_WIDE_XFER); break;
                                 default: assert(0);
                             }
                         }
@@ -1120,9 +2235,20 @@ void CpuSwizzleBlt( // #########################################################
                 {
                     switch(SwizzleMaxXfer.Width) 
                     {
-                        case 16: XFER(MOVNTDQ_M, MOVDQU_R, 16, 16, pSwizzledAddress, 16, pLinearAddress, pLinearSurface->Pitch, 1); break;
+                        case 16: 
+                        {
+                            if(pSwizzledSurface->Temporal) 
+                            {
+                                XFER(  MOVDQ_M, MOVDQU_R, 16, 16, pSwizzledAddress, 16, pLinearAddress, pLinearSurface->Pitch, 1, NO_WIDE_XFER);
+                            } 
+                            else 
+                            {
+                                XFER(MOVNTDQ_M, MOVDQU_R, 16, 16, pSwizzledAddress, 16, pLinearAddress, pLinearSurface->Pitch, 1, WideXfer.pfnXfer);
+                            }
+                            break;
+                        }
                         #ifdef INTEL_TILE_W_SUPPORT
-                            case  2: XFER(MOVW_M,  MOVW_R,  2,  2, pSwizzledAddress,  2, pLinearAddress, pLinearSurface->Pitch, 1); break;
+                            case  2: XFER(MOVW_M,  MOVW_R,  2,  2, pSwizzledAddress,  2, pLinearAddress, pLinearSurface->Pitch, 1, NO_WIDE_XFER); break;
                         #endif
                         default: assert(0); // Unexpected cases excluded to save compile time/size of multiplying instantiations.
                     }
@@ -1133,18 +2259,18 @@ void CpuSwizzleBlt( // #########################################################
                     {
                         case 16: 
                         {
-                            if(StreamingLoadSupported) 
+                            if(CpuFeatures.StreamingLoad && !pSwizzledSurface->Temporal) 
                             {
-                                XFER(MOVDQU_M, MOVNTDQA_R, 16, 16, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, 16, 1);
+                                XFER(MOVDQU_M, MOVNTDQA_R, 16, 16, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, 16, 1, WideXfer.pfnXfer);
                             } 
                             else 
                             {
-                                XFER(MOVDQU_M,    MOVDQ_R, 16, 16, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, 16, 1);
+                                XFER(MOVDQU_M,    MOVDQ_R, 16, 16, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress, 16, 1, WideXfer.pfnXfer);
                             }
                             break;
                         }
                         #ifdef INTEL_TILE_W_SUPPORT
-                            case 2: XFER(MOVW_M,   MOVW_R,  2,  2, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress,  2, 1); break;
+                            case 2: XFER(MOVW_M,   MOVW_R,  2,  2, pLinearAddress, pLinearSurface->Pitch, pSwizzledAddress,  2, 1, NO_WIDE_XFER); break;
                         #endif
                         default: assert(0);
                     }
@@ -1173,4 +2299,274 @@ void CpuSwizzleBlt( // #########################################################
     }
 } // CpuSwizzleBlt
 
+
+int CpuSwizzleBltTileRows( // ##################################################
+
+    /* Return number of swizzled surface tile rows touched by BLT. */
+
+    const CPU_SWIZZLE_BLT_SURFACE   *pSwizzledSurface,  // Pointer to swizzled surface descriptor of BLT.
+    int                             CopyHeight)         // Height of BLT rectangle, in physical/pitch rows.
+
+{ // ###########################################################################
+
+    int TileHeightBits = POPCNT16(pSwizzledSurface->pSwizzle->Mask.y); // Log2(Tile Height)
+
+    if(CopyHeight <= 0) return(0);
+
+    return(
+        ((pSwizzledSurface->OffsetY + CopyHeight - 1) >> TileHeightBits) - 
+        (pSwizzledSurface->OffsetY >> TileHeightBits) + 1);
+}
+
+
+int CpuSwizzleBltBandRows( // ##################################################
+
+    /* Return number of BLT rectangle rows in given band (see CpuSwizzleBltBand), 
+    and (via pFirstRow) band's first row, relative to BLT rectangle. */
+
+    const CPU_SWIZZLE_BLT_SURFACE   *pSwizzledSurface,  // Pointer to swizzled surface descriptor of BLT.
+    int                             CopyHeight,         // Height of BLT rectangle, in physical/pitch rows.
+    int                             Band,               // Index of band, [0, NumBands).
+    int                             NumBands,           // Number of bands BLT is being split into.
+    int                             *pFirstRow)         // Receives band's first row.
+
+{ // ###########################################################################
+
+    int TileHeightBits = POPCNT16(pSwizzledSurface->pSwizzle->Mask.y); // Log2(Tile Height)
+    int TileRows = CpuSwizzleBltTileRows(pSwizzledSurface, CopyHeight);
+    int FirstTileRow = pSwizzledSurface->OffsetY >> TileHeightBits;
+    int y0, y1;
+
+    assert((Band >= 0) && (Band < NumBands));
+
+    y0 = ((FirstTileRow + TileRows * Band / NumBands) << TileHeightBits) - pSwizzledSurface->OffsetY;
+    y1 = ((FirstTileRow + TileRows * (Band + 1) / NumBands) << TileHeightBits) - pSwizzledSurface->OffsetY;
+
+    if(y0 < 0) y0 = 0;
+    if(y1 > CopyHeight) y1 = CopyHeight;
+
+    *pFirstRow = y0;
+
+    return((y1 > y0) ? (y1 - y0) : 0);
+} // CpuSwizzleBltBandRows
+
+
+void CpuSwizzleBltBand( // #####################################################
+
+    /* Performs one band of specified swizzling BLT. */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    CPU_SWIZZLE_BLT_SURFACE *pSrc,          // Pointer to source surface descriptor.
+    int                     CopyWidthBytes, // Width of BLT rectangle, in bytes.
+    int                     CopyHeight,     // Height of BLT rectangle, in physical/pitch rows.
+    int                     Band,           // Index of band to transfer, [0, NumBands).
+    int                     NumBands)       // Number of bands BLT is being split into.
+
+    /* BLT rectangle is split into NumBands horizontal bands along tile-row 
+    boundaries of the swizzled surface--i.e. no two bands touch the same tile, 
+    so bands can be transferred concurrently (e.g. by separate worker threads) 
+    without sharing cache lines or WC buffers. Tile rows are distributed as 
+    evenly as possible; when NumBands exceeds CpuSwizzleBltTileRows, excess 
+    bands are empty.
+
+    Each band is a complete CpuSwizzleBlt--including its closing SFENCE--so 
+    band's non-temporal stores are globally visible once this function 
+    returns on its executing thread. */
+
+{ // ###########################################################################
+
+    CPU_SWIZZLE_BLT_SURFACE BandDest = *pDest, BandSrc = *pSrc;
+    int y0, Rows; // Band's rows, relative to BLT rectangle.
+
+    Rows = CpuSwizzleBltBandRows(pDest->pSwizzle ? pDest : pSrc, CopyHeight, Band, NumBands, &y0);
+
+    if(Rows) 
+    {
+        BandDest.OffsetY += y0;
+        BandSrc.OffsetY += y0;
+
+        CpuSwizzleBlt(&BandDest, &BandSrc, CopyWidthBytes, Rows);
+    }
+} // CpuSwizzleBltBand
+
+
+static void FillRun( // #########################################################
+
+    /* Writes pattern to one run of bytes contiguous in surface. */
+
+    char        *pDest,         // Pointer to start of run.
+    int         Bytes,          // Length of run, in bytes.
+    const char  *pPattern,      // Pointer to pattern, repeated to (PatternSize + 15) bytes.
+    int         PatternSize,    // Size of pattern, in bytes.
+    int         Phase,          // Index into pattern of run's first byte.
+    int         Temporal)       // Nonzero for regular stores, else non-temporal.
+
+{ // ###########################################################################
+
+    int Step = 16 % PatternSize; // Phase advance per 16-byte store.
+
+    for(; Bytes && ((uintptr_t) pDest & 0xf); Bytes--) // Unaligned Head...
+    {
+        *pDest++ = pPattern[Phase];
+        if(++Phase == PatternSize) Phase = 0;
+    }
+
+    for(; Bytes >= 16; Bytes -= 16, pDest += 16) // Aligned Body...
+    {
+        if(Temporal) 
+        {
+            _mm_store_si128((__m128i *) pDest, _mm_loadu_si128((__m128i *) &pPattern[Phase]));
+        } 
+        else 
+        {
+            _mm_stream_si128((__m128i *) pDest, _mm_loadu_si128((__m128i *) &pPattern[Phase]));
+        }
+        Phase += Step;
+        if(Phase >= PatternSize) Phase -= PatternSize;
+    }
+
+    for(; Bytes; Bytes--) // Tail...
+    {
+        *pDest++ = pPattern[Phase];
+        if(++Phase == PatternSize) Phase = 0;
+    }
+} // FillRun
+
+
+void CpuSwizzleFill( // ########################################################
+
+    /* Fills rectangle of surface with repeating byte pattern. */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    const void              *pPattern,      // Pointer to fill pattern.
+    int                     PatternSize,    // Size of fill pattern, in bytes (1..16).
+    int                     FillWidthBytes, // Width of fill rectangle, in bytes.
+    int                     FillHeight)     // Height of fill rectangle, in physical/pitch rows.
+
+    /* Pattern repeats across each row from rectangle's left edge--i.e. byte x 
+    of row takes pattern byte (x % PatternSize)--so a pixel-sized pattern fills 
+    each pixel with it (e.g. clear color), or a block-sized one each 
+    compression block.
+
+    No source surface is read: as in CpuRetileBlt, rectangle is traversed as 
+    runs of bytes contiguous in destination (e.g. 16 bytes for TileY, 512 for 
+    TileX, whole rows when linear), with each run written straight from the 
+    pattern using non-temporal stores, and rows taken in bands matching the 
+    height of a destination cache line. Partial-tile edges need no special 
+    handling, since only runs' bytes inside rectangle are written. */
+
+{ // ###########################################################################
+
+    #define MAX_FILL_RUNS_PER_TILE  512 // Max Tile Width (TileX) at 1-Byte Run Granularity
+    #define MAX_FILL_BAND_HEIGHT    16
+
+    char Pattern[16 + 15]; // Pattern repeated so any phase has 16 bytes following.
+    int RunOffset[MAX_FILL_RUNS_PER_TILE]; // Intra-tile swizzled offset of each run in tile's top row.
+    char *pRow[MAX_FILL_BAND_HEIGHT]; // Address of (x = 0) for each row of current band.
+    int TileWidthBits = 0, TileSizeBits = 0;
+    int RunBits, RunBytes, BandHeight;
+    int i, x, y, y0;
+
+    assert(pPattern && (PatternSize >= 1) && (PatternSize <= 16));
+    assert( // No surface overrun...
+        ((pDest->OffsetX + FillWidthBytes) <= pDest->Pitch) && 
+        ((pDest->OffsetY + FillHeight) <= pDest->Height));
+
+    #ifdef SUB_ELEMENT_SUPPORT
+        assert( // No Sub-Element Fill or Conversion...
+            (pDest->Element.Size == pDest->Element.Pitch) && 
+            !pDest->Element.pConvert);
+    #endif
+
+    #ifdef INTEL_CSX_SWIZZLE_SUPPORT
+        assert(!pDest->pSwizzle || (pDest->pSwizzle->XOR == SWIZZLE_DESCRIPTOR_XOR_NONE));
+    #endif
+
+    for(i = 0; i < (int) sizeof(Pattern); i++) 
+    {
+        Pattern[i] = ((const char *) pPattern)[i % PatternSize];
+    }
+
+    if(!pDest->pSwizzle) // Linear: Each row one run...
+    {
+        for(y = 0; y < FillHeight; y++) 
+        {
+            FillRun(
+                (char *) pDest->pBase + (pDest->OffsetY + y) * pDest->Pitch + pDest->OffsetX, 
+                FillWidthBytes, Pattern, PatternSize, 0, pDest->Temporal);
+        }
+
+        _mm_sfence(); // Flush Non-Temporal Writes
+        return;
+    }
+
+    { // Compute Run Granularity and Band Height...
+        int TileHeight = 1 << POPCNT16(pDest->pSwizzle->Mask.y);
+
+        RunBits = 0;
+        while(pDest->pSwizzle->Mask.x & (1 << RunBits)) RunBits++;
+        RunBytes = 1 << RunBits;
+
+        BandHeight = 64 >> ((RunBits < 6) ? RunBits : 6);
+        if(BandHeight > TileHeight) BandHeight = TileHeight;
+        if(BandHeight > MAX_FILL_BAND_HEIGHT) BandHeight = MAX_FILL_BAND_HEIGHT;
+    }
+
+    { // Run Table...
+        int Run, RunsPerTile;
+
+        TileWidthBits = POPCNT16(pDest->pSwizzle->Mask.x);
+        TileSizeBits = 
+            TileWidthBits + 
+            POPCNT16(pDest->pSwizzle->Mask.y) + 
+            POPCNT16(pDest->pSwizzle->Mask.z);
+
+        RunsPerTile = 1 << (TileWidthBits - RunBits);
+        assert(RunsPerTile <= MAX_FILL_RUNS_PER_TILE);
+
+        for(Run = 0; Run < RunsPerTile; Run++) 
+        {
+            RunOffset[Run] = SwizzleOffset(pDest->pSwizzle, pDest->Pitch, Run << RunBits, 0, 0);
+        }
+    }
+
+    for(y0 = 0; y0 < FillHeight; y0 += BandHeight) 
+    {
+        int Rows = ((FillHeight - y0) < BandHeight) ? (FillHeight - y0) : BandHeight;
+
+        for(y = 0; y < Rows; y++) 
+        {
+            pRow[y] = 
+                (char *) pDest->pBase + 
+                SwizzleOffset(pDest->pSwizzle, pDest->Pitch, 0, pDest->OffsetY + y0 + y, pDest->OffsetZ);
+        }
+
+        for(x = 0; x < FillWidthBytes; ) 
+        {
+            int xd = pDest->OffsetX + x;
+            int Run = RunBytes - (xd & (RunBytes - 1));
+            int Offset, Phase = x % PatternSize;
+
+            if(Run > FillWidthBytes - x) Run = FillWidthBytes - x;
+
+            Offset = 
+                ((xd >> TileWidthBits) << TileSizeBits) + 
+                RunOffset[(xd & ((1 << TileWidthBits) - 1)) >> RunBits] + 
+                (xd & (RunBytes - 1));
+
+            for(y = 0; y < Rows; y++) 
+            {
+                FillRun(pRow[y] + Offset, Run, Pattern, PatternSize, Phase, pDest->Temporal);
+            }
+
+            x += Run;
+        }
+    }
+
+    _mm_sfence(); // Flush Non-Temporal Writes
+
+    #undef MAX_FILL_RUNS_PER_TILE
+    #undef MAX_FILL_BAND_HEIGHT
+} // CpuSwizzleFill
+
 #endif // #ifndef INCLUDE_CpuSwizzleBlt_c_AS_HEADER
@@ -0,0 +1,983 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+// CpuSwizzleBltKernels.cpp - Compile-time specialized CpuSwizzleBlt kernels.
+
+#define INCLUDE_CpuSwizzleBlt_c_AS_HEADER
+#include "CpuSwizzleBlt.c"
+
+#include <stdint.h>
+#include <string.h>
+
+#if(_MSC_VER >= 1400)
+    #include <intrin.h>
+#else
+    #include <x86intrin.h>
+#endif
+
+/* Background:
+
+CpuSwizzleBlt is generic over swizzle masks, element size and transfer
+dimensions, so its tile walk recomputes increment masks and chooses transfer
+widths/heights per line. For the common plain-copy cases--2D TileX/TileY and
+Yf/Ys surfaces of every bpp (bpp being folded into the Yf/Ys masks)--this
+file instantiates kernels with the masks as template arguments, so swizzled
+increments, chunk height and bytes-per-tile-row become constants and the
+inner loop is a fixed run of 16-byte moves.
+
+Depth/stencil BLTs get kernels of their own: Separating/merging the stencil
+or depth of a packed D24S8/D32S8X24 surface moves whole 16-byte chunks of
+pixels, packing/unpacking their sub-elements with one byte shuffle (merges
+store through a byte mask, leaving the other sub-elements untouched); and
+TileW stencil, whose 1-byte X runs leave CpuSwizzleBlt moving byte by byte,
+is transferred a 64-byte 8x8 block at a time, shuffled to/from row order.
+
+Kernels handle only the aligned interior of the BLT rectangle; the ragged
+edges (if any) are passed to CpuSwizzleBlt. Callers pick the kernel once
+per BLT with CpuSwizzleBltSelectKernel, which falls back to CpuSwizzleBlt
+for anything not covered (MSAA, 3D, CSX XOR, or converting BLTs).
+
+Yf/Ys 3D (ST_3D_*) tiles interleave Z within their low bits ("Z Z Y Y X X X
+X"), so a per-slice walk revisits every tile once per slice, writing a
+quarter of each 256-byte block at a time. CpuSwizzleBltVolume instead walks
+the tiles once for a run of slices sharing a tile layer, transferring every
+slice of each chunk (whole 256-byte blocks) before moving on. */
+
+
+// Compile-Time Mask Helpers...
+template<int Mask> struct SWIZZLE_POPCNT { enum { Value = (Mask & 1) + SWIZZLE_POPCNT<((unsigned) Mask >> 1)>::Value }; };
+template<> struct SWIZZLE_POPCNT<0> { enum { Value = 0 }; };
+
+template<int MaskX, int MaskY>
+struct SWIZZLE_KERNEL_TRAITS
+{
+    enum
+    {
+        TileHeightBits = SWIZZLE_POPCNT<MaskY>::Value,
+
+        /* Y bits directly above the 16-byte X run let a chunk cover that
+        many rows at consecutive 16-byte addresses (capped at one 64B line). */
+        ChunkHeight = ((MaskY & 0x30) == 0x30) ? 4 : (MaskY & 0x10) ? 2 : 1,
+
+        /* Swizzled-increment masks (see CpuSwizzleBlt): +16 bytes in X,
+        extended beyond the tile so carries advance to the next tile; and
+        +ChunkHeight rows in Y. */
+        ChunkMaskX = (MaskX & ~0xf) | ~(MaskX | MaskY),
+        ChunkMaskY = MaskY & ~((ChunkHeight - 1) << 4),
+    };
+};
+
+
+// Swizzled Surface Accesses (non-temporal unless CPU_SWIZZLE_BLT_SURFACE.Temporal)...
+#if(((defined __clang__) || (defined __GNUC__)) && !(defined __SSE4_1__))
+    #define TARGET_SSE41 __attribute__((target("sse4.1"))) // MOVNTDQA only used when probed.
+#else
+    #define TARGET_SSE41
+#endif
+
+TARGET_SSE41 static inline __m128i StreamLoadSwizzled(const void *p)
+{
+    return(_mm_stream_load_si128((__m128i *) p));
+}
+
+static inline __m128i LoadSwizzled(const void *p, int StreamingLoad) // Aligned 16 bytes of (likely WC) swizzled memory.
+{
+    if(StreamingLoad) return(StreamLoadSwizzled(p));
+    return(_mm_load_si128((const __m128i *) p));
+}
+
+static inline void StoreSwizzled(void *p, __m128i x, int Temporal)
+{
+    if(Temporal)
+    {
+        _mm_store_si128((__m128i *) p, x);
+    }
+    else
+    {
+        _mm_stream_si128((__m128i *) p, x);
+    }
+}
+
+// Software prefetch of the linear source rows a chunk row ahead (see CPU_SWIZZLE_BLT_SURFACE.PrefetchRows)...
+static inline void PrefetchLinearRows(const char *pLine, int Pitch, int Rows, int WidthBytes)
+{
+    int r, x;
+
+    for(r = 0; r < Rows; r++, pLine += Pitch)
+    {
+        for(x = 0; x < WidthBytes; x += 64)
+        {
+            _mm_prefetch(pLine + x, _MM_HINT_T0);
+        }
+        _mm_prefetch(pLine + WidthBytes - 1, _MM_HINT_T0);
+    }
+}
+
+
+template<int MaskX, int MaskY, bool Upload>
+static void CpuSwizzleBltKernel( // ############################################
+
+    /* Specialized CpuSwizzleBlt for one swizzle and direction. */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    CPU_SWIZZLE_BLT_SURFACE *pSrc,          // Pointer to source surface descriptor.
+    int                     CopyWidthBytes, // Width of BLT rectangle, in bytes.
+    int                     CopyHeight)     // Height of BLT rectangle, in physical/pitch rows.
+
+    /* Only valid for surfaces accepted by CpuSwizzleBltSelectKernel. */
+
+{ // ###########################################################################
+
+    typedef SWIZZLE_KERNEL_TRAITS<MaskX, MaskY> TRAITS;
+
+    const int H = TRAITS::ChunkHeight;
+    CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface = Upload ? pDest : pSrc;
+    CPU_SWIZZLE_BLT_SURFACE *pLinearSurface = Upload ? pSrc : pDest;
+    int x0, x1, y0, y1; // Aligned interior, relative to BLT rectangle.
+
+    x0 = (16 - pSwizzledSurface->OffsetX) & 15;
+    x1 = (pSwizzledSurface->OffsetX + CopyWidthBytes) & ~15;
+    x1 -= pSwizzledSurface->OffsetX;
+    y0 = (H - pSwizzledSurface->OffsetY) & (H - 1);
+    y1 = ((pSwizzledSurface->OffsetY + CopyHeight) & ~(H - 1)) - pSwizzledSurface->OffsetY;
+
+    if((x1 <= x0) || (y1 <= y0)) // No aligned interior--nothing to specialize.
+    {
+        CpuSwizzleBlt(pDest, pSrc, CopyWidthBytes, CopyHeight);
+        return;
+    }
+
+    { // Edges (Top, Bottom, Left, Right) via Generic Path...
+        const struct { int x, y, Width, Height; } Edge[4] =
+        {
+            { 0,  0,  CopyWidthBytes,      y0              },
+            { 0,  y1, CopyWidthBytes,      CopyHeight - y1 },
+            { 0,  y0, x0,                  y1 - y0         },
+            { x1, y0, CopyWidthBytes - x1, y1 - y0         },
+        };
+        int i;
+
+        for(i = 0; i < 4; i++)
+        {
+            if(Edge[i].Width && Edge[i].Height)
+            {
+                CPU_SWIZZLE_BLT_SURFACE EdgeDest = *pDest, EdgeSrc = *pSrc;
+
+                EdgeDest.OffsetX += Edge[i].x;
+                EdgeDest.OffsetY += Edge[i].y;
+                EdgeSrc.OffsetX += Edge[i].x;
+                EdgeSrc.OffsetY += Edge[i].y;
+
+                CpuSwizzleBlt(&EdgeDest, &EdgeSrc, Edge[i].Width, Edge[i].Height);
+            }
+        }
+    }
+
+    { // Interior...
+        const SWIZZLE_DESCRIPTOR *pSwizzle = pSwizzledSurface->pSwizzle;
+        int SwizzledPitch = pSwizzledSurface->Pitch;
+        int LinearPitch = pLinearSurface->Pitch;
+        int BytesPerRowOfTiles = SwizzledPitch << TRAITS::TileHeightBits;
+        int SwizzledY = pSwizzledSurface->OffsetY + y0;
+        int IntraTileY = SwizzledY & ((1 << TRAITS::TileHeightBits) - 1);
+        int SwizzledOffsetY = SwizzleOffset(pSwizzle, SwizzledPitch, 0, IntraTileY, 0);
+        int SwizzledOffsetX0 = SwizzleOffset(pSwizzle, SwizzledPitch, pSwizzledSurface->OffsetX + x0, SwizzledY - IntraTileY, 0);
+        char *pSwizzledBase = (char *) pSwizzledSurface->pBase;
+        char *pLinearLine =
+            (char *) pLinearSurface->pBase +
+            (intptr_t) (pLinearSurface->OffsetY + y0) * LinearPitch +
+            pLinearSurface->OffsetX + x0;
+        const int Temporal = pSwizzledSurface->Temporal;
+        const int StreamingLoad = // MOVNTDQA where CPU has it (SSE4.1, probed at runtime).
+            !Temporal && (CpuSwizzleBltCpuFeatures() & CPU_SWIZZLE_BLT_FEATURE_STREAMING_LOAD);
+        const int PrefetchRows = Upload ? pLinearSurface->PrefetchRows : 0;
+        int x, y, r;
+
+        for(y = y0; y < y1; y += H)
+        {
+            char *pSwizzledLine = pSwizzledBase + SwizzledOffsetY;
+            char *pLinear = pLinearLine;
+            int SwizzledOffsetX = SwizzledOffsetX0;
+
+            if(PrefetchRows && (y + PrefetchRows < y1))
+            {
+                PrefetchLinearRows(pLinearLine + (intptr_t) PrefetchRows * LinearPitch, LinearPitch, (((y1 - y - PrefetchRows) < H) ? (y1 - y - PrefetchRows) : H), x1 - x0);
+            }
+
+            for(x = x0; x < x1; x += 16)
+            {
+                char *pSwizzled = pSwizzledLine + SwizzledOffsetX;
+
+                for(r = 0; r < H; r++) // Constant trip count--unrolled.
+                {
+                    if(Upload)
+                    {
+                        StoreSwizzled(
+                            pSwizzled + 16 * r,
+                            _mm_loadu_si128((const __m128i *) (pLinear + r * LinearPitch)),
+                            Temporal);
+                    }
+                    else
+                    {
+                        _mm_storeu_si128(
+                            (__m128i *) (pLinear + r * LinearPitch),
+                            LoadSwizzled(pSwizzled + 16 * r, StreamingLoad));
+                    }
+                }
+
+                SwizzledOffsetX = (SwizzledOffsetX - TRAITS::ChunkMaskX) & TRAITS::ChunkMaskX;
+                pLinear += 16;
+            }
+
+            SwizzledOffsetY = (SwizzledOffsetY - TRAITS::ChunkMaskY) & TRAITS::ChunkMaskY;
+            if(!SwizzledOffsetY) SwizzledOffsetX0 += BytesPerRowOfTiles;
+
+            pLinearLine += H * LinearPitch;
+        }
+
+        _mm_sfence(); // Flush Non-Temporal Writes
+    }
+} // CpuSwizzleBltKernel
+
+
+// Partial-Register Moves (Size known at compile time, so memcpy's become plain moves)...
+template<int Size> static inline __m128i LoadPartial(const void *p)
+{
+    __m128i x = _mm_setzero_si128();
+    memcpy(&x, p, Size);
+    return(x);
+}
+
+template<int Size> static inline void StorePartial(void *p, __m128i x)
+{
+    memcpy(p, &x, Size);
+}
+
+
+template<int ElementPitch, int ElementSize, bool Upload>
+static void CpuSwizzleBltSubElementKernel( // ##################################
+
+    /* Specialized CpuSwizzleBlt separating (download) or merging (upload)
+    one sub-element of a swizzled, packed depth-stencil surface--e.g. S8 or
+    D24 of D24S8, or S8 or D32 of D32S8X24--to/from a linear surface holding
+    only that sub-element. */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    CPU_SWIZZLE_BLT_SURFACE *pSrc,          // Pointer to source surface descriptor.
+    int                     CopyWidthBytes, // Width of BLT rectangle, in bytes of linear surface.
+    int                     CopyHeight)     // Height of BLT rectangle, in physical/pitch rows.
+
+    /* Only valid for surfaces accepted by CpuSwizzleBltSelectKernel. Each
+    16-byte swizzled chunk holds 16 / ElementPitch whole pixels, so their
+    sub-elements are packed/unpacked with a single byte shuffle; merges use
+    masked (non-temporal) stores, so the rest of each pixel is untouched. */
+
+{ // ###########################################################################
+
+    enum
+    {
+        PixelsPerChunk = 16 / ElementPitch,
+        LinearPerChunk = PixelsPerChunk * ElementSize, // Bytes of linear surface per swizzled chunk.
+    };
+
+    CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface = Upload ? pDest : pSrc;
+    CPU_SWIZZLE_BLT_SURFACE *pLinearSurface = Upload ? pSrc : pDest;
+    const SWIZZLE_DESCRIPTOR *pSwizzle = pSwizzledSurface->pSwizzle;
+    const int MaskY = pSwizzle->Mask.y;
+    const int H = ((MaskY & 0x30) == 0x30) ? 4 : (MaskY & 0x10) ? 2 : 1; // As SWIZZLE_KERNEL_TRAITS::ChunkHeight.
+    const int SubOffset = pSwizzledSurface->OffsetX & (ElementPitch - 1);
+    const int PixelX = pSwizzledSurface->OffsetX - SubOffset; // Swizzled byte offset of first pixel.
+    const int Pixels = CopyWidthBytes / ElementSize;
+    int x0, x1, y0, y1; // Aligned interior, relative to BLT rectangle (x in pixels).
+
+    x0 = ((16 - PixelX) & 15) / ElementPitch;
+    x1 = (((PixelX + Pixels * ElementPitch) & ~15) - PixelX) / ElementPitch;
+    y0 = (H - pSwizzledSurface->OffsetY) & (H - 1);
+    y1 = ((pSwizzledSurface->OffsetY + CopyHeight) & ~(H - 1)) - pSwizzledSurface->OffsetY;
+
+    if((x1 <= x0) || (y1 <= y0)) // No aligned interior--nothing to specialize.
+    {
+        CpuSwizzleBlt(pDest, pSrc, CopyWidthBytes, CopyHeight);
+        return;
+    }
+
+    { // Edges (Top, Bottom, Left, Right) via Generic Path...
+        const struct { int x, y, Width, Height; } Edge[4] = // x/Width in pixels.
+        {
+            { 0,  0,  Pixels,      y0              },
+            { 0,  y1, Pixels,      CopyHeight - y1 },
+            { 0,  y0, x0,          y1 - y0         },
+            { x1, y0, Pixels - x1, y1 - y0         },
+        };
+        int i;
+
+        for(i = 0; i < 4; i++)
+        {
+            if(Edge[i].Width && Edge[i].Height)
+            {
+                CPU_SWIZZLE_BLT_SURFACE EdgeSwizzled = *pSwizzledSurface, EdgeLinear = *pLinearSurface;
+
+                EdgeSwizzled.OffsetX += Edge[i].x * ElementPitch;
+                EdgeSwizzled.OffsetY += Edge[i].y;
+                EdgeLinear.OffsetX += Edge[i].x * ElementSize;
+                EdgeLinear.OffsetY += Edge[i].y;
+
+                CpuSwizzleBlt(
+                    Upload ? &EdgeSwizzled : &EdgeLinear,
+                    Upload ? &EdgeLinear : &EdgeSwizzled,
+                    Edge[i].Width * ElementSize,
+                    Edge[i].Height);
+            }
+        }
+    }
+
+    { // Interior...
+        const int ChunkMaskX = (pSwizzle->Mask.x & ~0xf) | ~(pSwizzle->Mask.x | MaskY);
+        const int ChunkMaskY = MaskY & ~((H - 1) << 4);
+        int TileHeightBits = 0, m;
+        signed char Shuffle[16], WriteMask[16];
+        const int Temporal = pSwizzledSurface->Temporal;
+        const int StreamingLoad = // MOVNTDQA where CPU has it (SSE4.1, probed at runtime).
+            !Temporal && (CpuSwizzleBltCpuFeatures() & CPU_SWIZZLE_BLT_FEATURE_STREAMING_LOAD);
+        __m128i Extract, Expand, Write, WriteBytes;
+
+        for(m = MaskY; m; m &= m - 1) TileHeightBits++;
+
+        { // Shuffles between chunk's pixels and their packed sub-elements...
+            int e, j;
+
+            memset(Shuffle, 0x80, sizeof(Shuffle));
+            memset(WriteMask, 0, sizeof(WriteMask));
+            for(e = 0; e < PixelsPerChunk; e++)
+            {
+                for(j = 0; j < ElementSize; j++)
+                {
+                    int Packed = e * ElementSize + j;
+                    int Unpacked = e * ElementPitch + SubOffset + j;
+
+                    if(Upload)
+                    {
+                        Shuffle[Unpacked] = (signed char) Packed;
+                        WriteMask[Unpacked] = (signed char) 0x80;
+                    }
+                    else
+                    {
+                        Shuffle[Packed] = (signed char) Unpacked;
+                    }
+                }
+            }
+
+            Extract = Expand = _mm_loadu_si128((const __m128i *) Shuffle);
+            Write = _mm_loadu_si128((const __m128i *) WriteMask);
+            WriteBytes = _mm_cmplt_epi8(Write, _mm_setzero_si128()); // 0x80 --> 0xff, for Temporal merges.
+        }
+
+        int SwizzledPitch = pSwizzledSurface->Pitch;
+        int LinearPitch = pLinearSurface->Pitch;
+        int BytesPerRowOfTiles = SwizzledPitch << TileHeightBits;
+        int SwizzledY = pSwizzledSurface->OffsetY + y0;
+        int IntraTileY = SwizzledY & ((1 << TileHeightBits) - 1);
+        int SwizzledOffsetY = SwizzleOffset(pSwizzle, SwizzledPitch, 0, IntraTileY, 0);
+        int SwizzledOffsetX0 = SwizzleOffset(pSwizzle, SwizzledPitch, PixelX + x0 * ElementPitch, SwizzledY - IntraTileY, 0);
+        char *pSwizzledBase = (char *) pSwizzledSurface->pBase;
+        char *pLinearLine =
+            (char *) pLinearSurface->pBase +
+            (intptr_t) (pLinearSurface->OffsetY + y0) * LinearPitch +
+            pLinearSurface->OffsetX + x0 * ElementSize;
+        int x, y, r;
+
+        for(y = y0; y < y1; y += H)
+        {
+            char *pSwizzledLine = pSwizzledBase + SwizzledOffsetY;
+            char *pLinear = pLinearLine;
+            int SwizzledOffsetX = SwizzledOffsetX0;
+
+            for(x = x0; x < x1; x += PixelsPerChunk)
+            {
+                char *pSwizzled = pSwizzledLine + SwizzledOffsetX;
+
+                for(r = 0; r < H; r++)
+                {
+                    if(Upload)
+                    {
+                        __m128i Expanded = _mm_shuffle_epi8(LoadPartial<LinearPerChunk>(pLinear + r * LinearPitch), Expand);
+
+                        if(Temporal)
+                        {
+                            __m128i *pChunk = (__m128i *) (pSwizzled + 16 * r);
+
+                            _mm_store_si128(pChunk, _mm_or_si128(_mm_and_si128(WriteBytes, Expanded), _mm_andnot_si128(WriteBytes, _mm_load_si128(pChunk))));
+                        }
+                        else
+                        {
+                            _mm_maskmoveu_si128(Expanded, Write, pSwizzled + 16 * r);
+                        }
+                    }
+                    else
+                    {
+                        StorePartial<LinearPerChunk>(
+                            pLinear + r * LinearPitch,
+                            _mm_shuffle_epi8(LoadSwizzled(pSwizzled + 16 * r, StreamingLoad), Extract));
+                    }
+                }
+
+                SwizzledOffsetX = (SwizzledOffsetX - ChunkMaskX) & ChunkMaskX;
+                pLinear += LinearPerChunk;
+            }
+
+            SwizzledOffsetY = (SwizzledOffsetY - ChunkMaskY) & ChunkMaskY;
+            if(!SwizzledOffsetY) SwizzledOffsetX0 += BytesPerRowOfTiles;
+
+            pLinearLine += H * LinearPitch;
+        }
+
+        _mm_sfence(); // Flush Non-Temporal Writes
+    }
+} // CpuSwizzleBltSubElementKernel
+
+
+#ifdef INTEL_TILE_W_SUPPORT
+
+// One 8-byte row of an 8x8 TileW block, to/from linear surface (whose stencil bytes are LinearPitch apart)...
+template<int LinearPitch> static inline __m128i TileWLoadRow(const char *pLinear)
+{
+    if(LinearPitch == 1)
+    {
+        return(_mm_loadl_epi64((const __m128i *) pLinear));
+    }
+    else
+    {
+        unsigned char Row[8];
+        int i;
+
+        for(i = 0; i < 8; i++) Row[i] = pLinear[i * LinearPitch];
+        return(_mm_loadl_epi64((const __m128i *) Row));
+    }
+}
+
+template<int LinearPitch> static inline void TileWStoreRow(char *pLinear, __m128i x)
+{
+    if(LinearPitch == 1)
+    {
+        _mm_storel_epi64((__m128i *) pLinear, x);
+    }
+    else
+    {
+        unsigned char Row[8];
+        int i;
+
+        _mm_storel_epi64((__m128i *) Row, x);
+        for(i = 0; i < 8; i++) pLinear[i * LinearPitch] = Row[i];
+    }
+}
+
+
+template<int LinearPitch, bool Upload>
+static void CpuSwizzleBltTileWKernel( // #######################################
+
+    /* Specialized CpuSwizzleBlt for TileW (stencil) surfaces, to/from linear
+    stencil (LinearPitch 1) or the stencil bytes of linear packed
+    depth-stencil (LinearPitch 4 or 8). */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    CPU_SWIZZLE_BLT_SURFACE *pSrc,          // Pointer to source surface descriptor.
+    int                     CopyWidthBytes, // Width of BLT rectangle, in bytes of linear surface.
+    int                     CopyHeight)     // Height of BLT rectangle, in physical/pitch rows.
+
+    /* TileW's low six bits ("Y X Y X Y X") store each 8x8 block of stencil in
+    one 64-byte line, as four 16-byte quarters--each a 4x4 quadrant (left/
+    right, top/bottom) with its x and y bits interleaved. A byte shuffle
+    (swapping offset bits 1 and 2--its own inverse) puts a quadrant in row
+    order; dword unpacks then pair left/right quadrants into 8-byte rows. */
+
+{ // ###########################################################################
+
+    CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface = Upload ? pDest : pSrc;
+    CPU_SWIZZLE_BLT_SURFACE *pLinearSurface = Upload ? pSrc : pDest;
+    const int Pixels = CopyWidthBytes / LinearPitch;
+    int x0, x1, y0, y1; // Aligned interior, relative to BLT rectangle (x in pixels).
+
+    x0 = (8 - pSwizzledSurface->OffsetX) & 7;
+    x1 = ((pSwizzledSurface->OffsetX + Pixels) & ~7) - pSwizzledSurface->OffsetX;
+    y0 = (8 - pSwizzledSurface->OffsetY) & 7;
+    y1 = ((pSwizzledSurface->OffsetY + CopyHeight) & ~7) - pSwizzledSurface->OffsetY;
+
+    if((x1 <= x0) || (y1 <= y0)) // No aligned interior--nothing to specialize.
+    {
+        CpuSwizzleBlt(pDest, pSrc, CopyWidthBytes, CopyHeight);
+        return;
+    }
+
+    { // Edges (Top, Bottom, Left, Right) via Generic Path...
+        const struct { int x, y, Width, Height; } Edge[4] = // x/Width in pixels.
+        {
+            { 0,  0,  Pixels,      y0              },
+            { 0,  y1, Pixels,      CopyHeight - y1 },
+            { 0,  y0, x0,          y1 - y0         },
+            { x1, y0, Pixels - x1, y1 - y0         },
+        };
+        int i;
+
+        for(i = 0; i < 4; i++)
+        {
+            if(Edge[i].Width && Edge[i].Height)
+            {
+                CPU_SWIZZLE_BLT_SURFACE EdgeSwizzled = *pSwizzledSurface, EdgeLinear = *pLinearSurface;
+
+                EdgeSwizzled.OffsetX += Edge[i].x;
+                EdgeSwizzled.OffsetY += Edge[i].y;
+                EdgeLinear.OffsetX += Edge[i].x * LinearPitch;
+                EdgeLinear.OffsetY += Edge[i].y;
+
+                CpuSwizzleBlt(
+                    Upload ? &EdgeSwizzled : &EdgeLinear,
+                    Upload ? &EdgeLinear : &EdgeSwizzled,
+                    Edge[i].Width * LinearPitch,
+                    Edge[i].Height);
+            }
+        }
+    }
+
+    { // Interior...
+        const SWIZZLE_DESCRIPTOR *pSwizzle = pSwizzledSurface->pSwizzle;
+        const int BlockMaskX = (pSwizzle->Mask.x & ~0x3f) | ~(pSwizzle->Mask.x | pSwizzle->Mask.y); // +8 bytes in X.
+        const int BlockMaskY = pSwizzle->Mask.y & ~0x3f; // +8 rows in Y.
+        const __m128i Quadrant = _mm_setr_epi8(0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15);
+        const int TileHeightBits = 6;
+        const int Temporal = pSwizzledSurface->Temporal;
+        const int StreamingLoad = // MOVNTDQA where CPU has it (SSE4.1, probed at runtime).
+            !Temporal && (CpuSwizzleBltCpuFeatures() & CPU_SWIZZLE_BLT_FEATURE_STREAMING_LOAD);
+        int SwizzledPitch = pSwizzledSurface->Pitch;
+        int LinearPitchBytes = pLinearSurface->Pitch;
+        int BytesPerRowOfTiles = SwizzledPitch << TileHeightBits;
+        int SwizzledY = pSwizzledSurface->OffsetY + y0;
+        int IntraTileY = SwizzledY & ((1 << TileHeightBits) - 1);
+        int SwizzledOffsetY = SwizzleOffset(pSwizzle, SwizzledPitch, 0, IntraTileY, 0);
+        int SwizzledOffsetX0 = SwizzleOffset(pSwizzle, SwizzledPitch, pSwizzledSurface->OffsetX + x0, SwizzledY - IntraTileY, 0);
+        char *pSwizzledBase = (char *) pSwizzledSurface->pBase;
+        char *pLinearLine =
+            (char *) pLinearSurface->pBase +
+            (intptr_t) (pLinearSurface->OffsetY + y0) * LinearPitchBytes +
+            pLinearSurface->OffsetX + x0 * LinearPitch;
+        int x, y;
+
+        for(y = y0; y < y1; y += 8)
+        {
+            char *pSwizzledLine = pSwizzledBase + SwizzledOffsetY;
+            char *pLinear = pLinearLine;
+            int SwizzledOffsetX = SwizzledOffsetX0;
+
+            for(x = x0; x < x1; x += 8)
+            {
+                __m128i *pBlock = (__m128i *) (pSwizzledLine + SwizzledOffsetX);
+                __m128i q0, q1, q2, q3; // Quadrants: Top-Left, Top-Right, Bottom-Left, Bottom-Right.
+                #define ROW(n) (pLinear + (n) * LinearPitchBytes)
+
+                if(Upload)
+                {
+                    // Rows pairs, as dwords: { L0, R0, L1, R1 }...
+                    __m128i r01 = _mm_unpacklo_epi64(TileWLoadRow<LinearPitch>(ROW(0)), TileWLoadRow<LinearPitch>(ROW(1)));
+                    __m128i r23 = _mm_unpacklo_epi64(TileWLoadRow<LinearPitch>(ROW(2)), TileWLoadRow<LinearPitch>(ROW(3)));
+                    __m128i r45 = _mm_unpacklo_epi64(TileWLoadRow<LinearPitch>(ROW(4)), TileWLoadRow<LinearPitch>(ROW(5)));
+                    __m128i r67 = _mm_unpacklo_epi64(TileWLoadRow<LinearPitch>(ROW(6)), TileWLoadRow<LinearPitch>(ROW(7)));
+
+                    // ...to { L0, L1, R0, R1 }...
+                    r01 = _mm_shuffle_epi32(r01, _MM_SHUFFLE(3, 1, 2, 0));
+                    r23 = _mm_shuffle_epi32(r23, _MM_SHUFFLE(3, 1, 2, 0));
+                    r45 = _mm_shuffle_epi32(r45, _MM_SHUFFLE(3, 1, 2, 0));
+                    r67 = _mm_shuffle_epi32(r67, _MM_SHUFFLE(3, 1, 2, 0));
+
+                    // ...to row-ordered quadrants...
+                    q0 = _mm_unpacklo_epi64(r01, r23);
+                    q1 = _mm_unpackhi_epi64(r01, r23);
+                    q2 = _mm_unpacklo_epi64(r45, r67);
+                    q3 = _mm_unpackhi_epi64(r45, r67);
+
+                    StoreSwizzled(pBlock + 0, _mm_shuffle_epi8(q0, Quadrant), Temporal);
+                    StoreSwizzled(pBlock + 1, _mm_shuffle_epi8(q1, Quadrant), Temporal);
+                    StoreSwizzled(pBlock + 2, _mm_shuffle_epi8(q2, Quadrant), Temporal);
+                    StoreSwizzled(pBlock + 3, _mm_shuffle_epi8(q3, Quadrant), Temporal);
+                }
+                else
+                {
+                    __m128i r;
+
+                    q0 = _mm_shuffle_epi8(LoadSwizzled(pBlock + 0, StreamingLoad), Quadrant);
+                    q1 = _mm_shuffle_epi8(LoadSwizzled(pBlock + 1, StreamingLoad), Quadrant);
+                    q2 = _mm_shuffle_epi8(LoadSwizzled(pBlock + 2, StreamingLoad), Quadrant);
+                    q3 = _mm_shuffle_epi8(LoadSwizzled(pBlock + 3, StreamingLoad), Quadrant);
+
+                    r = _mm_unpacklo_epi32(q0, q1);
+                    TileWStoreRow<LinearPitch>(ROW(0), r);
+                    TileWStoreRow<LinearPitch>(ROW(1), _mm_srli_si128(r, 8));
+                    r = _mm_unpackhi_epi32(q0, q1);
+                    TileWStoreRow<LinearPitch>(ROW(2), r);
+                    TileWStoreRow<LinearPitch>(ROW(3), _mm_srli_si128(r, 8));
+                    r = _mm_unpacklo_epi32(q2, q3);
+                    TileWStoreRow<LinearPitch>(ROW(4), r);
+                    TileWStoreRow<LinearPitch>(ROW(5), _mm_srli_si128(r, 8));
+                    r = _mm_unpackhi_epi32(q2, q3);
+                    TileWStoreRow<LinearPitch>(ROW(6), r);
+                    TileWStoreRow<LinearPitch>(ROW(7), _mm_srli_si128(r, 8));
+                }
+
+                #undef ROW
+
+                SwizzledOffsetX = (SwizzledOffsetX - BlockMaskX) & BlockMaskX;
+                pLinear += 8 * LinearPitch;
+            }
+
+            SwizzledOffsetY = (SwizzledOffsetY - BlockMaskY) & BlockMaskY;
+            if(!SwizzledOffsetY) SwizzledOffsetX0 += BytesPerRowOfTiles;
+
+            pLinearLine += 8 * LinearPitchBytes;
+        }
+
+        _mm_sfence(); // Flush Non-Temporal Writes
+    }
+} // CpuSwizzleBltTileWKernel
+
+#endif // INTEL_TILE_W_SUPPORT
+
+
+extern "C" void CpuSwizzleBltVolume( // ########################################
+
+    /* Performs BLT of a run of 3D slices between a Yf/Ys 3D swizzled surface
+    and a linear surface holding each slice's rows, all slices of each tile
+    chunk at once. */
+
+    CPU_SWIZZLE_BLT_SURFACE *pDest,         // Pointer to destination surface descriptor.
+    CPU_SWIZZLE_BLT_SURFACE *pSrc,          // Pointer to source surface descriptor.
+    int                     CopyWidthBytes, // Width of BLT rectangle, in bytes.
+    int                     CopyHeight,     // Height of BLT rectangle, in physical/pitch rows.
+    int                     CopyDepth,      // Number of slices, from swizzled OffsetZ (all within one tile layer).
+    int                     LinearSlicePitch) // Bytes from one slice of linear surface to the next.
+
+    /* Swizzled surface's OffsetZ is first slice within tile, and OffsetZ +
+    CopyDepth must not exceed tile depth. Anything besides full-element,
+    unconverted copies with one swizzled surface falls back to a
+    CpuSwizzleBlt per slice. */
+
+{ // ###########################################################################
+
+    const int MAX_TILE_DEPTH = 32; // ST_3D_64KB_8bpp.
+    int Upload = (pDest->pSwizzle != NULL);
+    CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface = Upload ? pDest : pSrc;
+    CPU_SWIZZLE_BLT_SURFACE *pLinearSurface = Upload ? pSrc : pDest;
+    const SWIZZLE_DESCRIPTOR *pSwizzle = pSwizzledSurface->pSwizzle;
+    int TileDepthBits = 0, Vectorizable, m, z;
+
+    if(CopyDepth <= 0) return;
+
+    for(m = pSwizzle->Mask.z; m; m &= m - 1) TileDepthBits++;
+
+    Vectorizable =
+        ((pSwizzle->Mask.x & 0xf) == 0xf) && // 16-byte X runs.
+        (pSwizzledSurface->OffsetZ + CopyDepth <= (1 << TileDepthBits)) &&
+        ((1 << TileDepthBits) <= MAX_TILE_DEPTH) &&
+        !((uintptr_t) pSwizzledSurface->pBase & 15) &&
+        !(pSwizzledSurface->Pitch & 15);
+
+    #ifdef SUB_ELEMENT_SUPPORT
+        Vectorizable = Vectorizable &&
+            !pDest->Element.pConvert &&
+            (pDest->Element.Size == pDest->Element.Pitch) &&
+            (pSrc->Element.Size == pSrc->Element.Pitch);
+    #endif
+
+    #ifdef INTEL_CSX_SWIZZLE_SUPPORT
+        Vectorizable = Vectorizable && (pSwizzle->XOR == SWIZZLE_DESCRIPTOR_XOR_NONE);
+    #endif
+
+    const int MaskY = pSwizzle->Mask.y;
+    const int H = ((MaskY & 0x30) == 0x30) ? 4 : (MaskY & 0x10) ? 2 : 1; // As SWIZZLE_KERNEL_TRAITS::ChunkHeight.
+    int x0 = 0, x1 = 0, y0 = 0, y1 = 0; // Aligned interior, relative to BLT rectangle.
+
+    if(Vectorizable)
+    {
+        x0 = (16 - pSwizzledSurface->OffsetX) & 15;
+        x1 = ((pSwizzledSurface->OffsetX + CopyWidthBytes) & ~15) - pSwizzledSurface->OffsetX;
+        y0 = (H - pSwizzledSurface->OffsetY) & (H - 1);
+        y1 = ((pSwizzledSurface->OffsetY + CopyHeight) & ~(H - 1)) - pSwizzledSurface->OffsetY;
+
+        Vectorizable = (x1 > x0) && (y1 > y0);
+    }
+
+    for(z = 0; z < CopyDepth; z++) // Per-slice fallback, or edges of each slice...
+    {
+        CPU_SWIZZLE_BLT_SURFACE SliceSwizzled = *pSwizzledSurface, SliceLinear = *pLinearSurface;
+
+        SliceSwizzled.OffsetZ += z;
+        SliceLinear.pBase = (char *) pLinearSurface->pBase + (intptr_t) z * LinearSlicePitch;
+
+        if(!Vectorizable)
+        {
+            CpuSwizzleBlt(
+                Upload ? &SliceSwizzled : &SliceLinear,
+                Upload ? &SliceLinear : &SliceSwizzled,
+                CopyWidthBytes, CopyHeight);
+        }
+        else
+        {
+            const struct { int x, y, Width, Height; } Edge[4] =
+            {
+                { 0,  0,  CopyWidthBytes,      y0              },
+                { 0,  y1, CopyWidthBytes,      CopyHeight - y1 },
+                { 0,  y0, x0,                  y1 - y0         },
+                { x1, y0, CopyWidthBytes - x1, y1 - y0         },
+            };
+            int i;
+
+            for(i = 0; i < 4; i++)
+            {
+                if(Edge[i].Width && Edge[i].Height)
+                {
+                    CPU_SWIZZLE_BLT_SURFACE EdgeSwizzled = SliceSwizzled, EdgeLinear = SliceLinear;
+
+                    EdgeSwizzled.OffsetX += Edge[i].x;
+                    EdgeSwizzled.OffsetY += Edge[i].y;
+                    EdgeLinear.OffsetX += Edge[i].x;
+                    EdgeLinear.OffsetY += Edge[i].y;
+
+                    CpuSwizzleBlt(
+                        Upload ? &EdgeSwizzled : &EdgeLinear,
+                        Upload ? &EdgeLinear : &EdgeSwizzled,
+                        Edge[i].Width, Edge[i].Height);
+                }
+            }
+        }
+    }
+
+    if(Vectorizable) // Interior, all slices of each chunk at once...
+    {
+        const int ChunkMaskX = (pSwizzle->Mask.x & ~0xf) | ~(pSwizzle->Mask.x | MaskY | pSwizzle->Mask.z);
+        const int ChunkMaskY = MaskY & ~((H - 1) << 4);
+        int TileHeightBits = 0;
+        int SwizzledOffsetZ[MAX_TILE_DEPTH];
+        int SwizzledPitch = pSwizzledSurface->Pitch;
+        int LinearPitch = pLinearSurface->Pitch;
+        int BytesPerRowOfTiles;
+        int SwizzledY = pSwizzledSurface->OffsetY + y0;
+        int IntraTileY, SwizzledOffsetY, SwizzledOffsetX0;
+        char *pSwizzledBase = (char *) pSwizzledSurface->pBase;
+        char *pLinearLine =
+            (char *) pLinearSurface->pBase +
+            (intptr_t) (pLinearSurface->OffsetY + y0) * LinearPitch +
+            pLinearSurface->OffsetX + x0;
+        const int Temporal = pSwizzledSurface->Temporal;
+        const int StreamingLoad = // MOVNTDQA where CPU has it (SSE4.1, probed at runtime).
+            !Temporal && (CpuSwizzleBltCpuFeatures() & CPU_SWIZZLE_BLT_FEATURE_STREAMING_LOAD);
+        const int PrefetchRows = Upload ? pLinearSurface->PrefetchRows : 0;
+        int x, y, r;
+
+        for(m = MaskY; m; m &= m - 1) TileHeightBits++;
+        BytesPerRowOfTiles = SwizzledPitch << (TileHeightBits + TileDepthBits);
+        IntraTileY = SwizzledY & ((1 << TileHeightBits) - 1);
+        SwizzledOffsetY = SwizzleOffset(pSwizzle, SwizzledPitch, 0, IntraTileY, 0);
+        SwizzledOffsetX0 = SwizzleOffset(pSwizzle, SwizzledPitch, pSwizzledSurface->OffsetX + x0, SwizzledY - IntraTileY, 0);
+
+        for(z = 0; z < CopyDepth; z++)
+        {
+            SwizzledOffsetZ[z] = SwizzleOffset(pSwizzle, SwizzledPitch, 0, 0, pSwizzledSurface->OffsetZ + z);
+        }
+
+        for(y = y0; y < y1; y += H)
+        {
+            char *pSwizzledLine = pSwizzledBase + SwizzledOffsetY;
+            char *pLinear = pLinearLine;
+            int SwizzledOffsetX = SwizzledOffsetX0;
+
+            if(PrefetchRows && (y + PrefetchRows < y1))
+            {
+                for(z = 0; z < CopyDepth; z++)
+                {
+                    PrefetchLinearRows(pLinearLine + (intptr_t) z * LinearSlicePitch + (intptr_t) PrefetchRows * LinearPitch, LinearPitch, (((y1 - y - PrefetchRows) < H) ? (y1 - y - PrefetchRows) : H), x1 - x0);
+                }
+            }
+
+            for(x = x0; x < x1; x += 16)
+            {
+                char *pSwizzledChunk = pSwizzledLine + SwizzledOffsetX;
+                char *pLinearSlice = pLinear;
+
+                for(z = 0; z < CopyDepth; z++, pLinearSlice += LinearSlicePitch)
+                {
+                    char *pSwizzled = pSwizzledChunk + SwizzledOffsetZ[z];
+
+                    for(r = 0; r < H; r++)
+                    {
+                        if(Upload)
+                        {
+                            StoreSwizzled(
+                                pSwizzled + 16 * r,
+                                _mm_loadu_si128((const __m128i *) (pLinearSlice + r * LinearPitch)),
+                                Temporal);
+                        }
+                        else
+                        {
+                            _mm_storeu_si128(
+                                (__m128i *) (pLinearSlice + r * LinearPitch),
+                                LoadSwizzled(pSwizzled + 16 * r, StreamingLoad));
+                        }
+                    }
+                }
+
+                SwizzledOffsetX = (SwizzledOffsetX - ChunkMaskX) & ChunkMaskX;
+                pLinear += 16;
+            }
+
+            SwizzledOffsetY = (SwizzledOffsetY - ChunkMaskY) & ChunkMaskY;
+            if(!SwizzledOffsetY) SwizzledOffsetX0 += BytesPerRowOfTiles;
+
+            pLinearLine += H * LinearPitch;
+        }
+
+        _mm_sfence(); // Flush Non-Temporal Writes
+    }
+} // CpuSwizzleBltVolume
+
+// Kernel Dispatch Table...
+static const struct
+{
+    int                 MaskX, MaskY;
+    PFN_CPU_SWIZZLE_BLT pfnUpload, pfnDownload;
+}   SwizzleBltKernels[] =
+{
+    #define KERNEL(MaskX, MaskY) { MaskX, MaskY, CpuSwizzleBltKernel<MaskX, MaskY, true>, CpuSwizzleBltKernel<MaskX, MaskY, false> }
+
+    KERNEL(0x01ff, 0x0e00), // INTEL_TILE_X
+    KERNEL(0x0e0f, 0x01f0), // INTEL_TILE_Y
+    KERNEL(0x0acf, 0x0530), // ST_2D_4KB_128bpp, ST_2D_4KB_64bpp
+    KERNEL(0x0a8f, 0x0570), // ST_2D_4KB_32bpp, ST_2D_4KB_16bpp
+    KERNEL(0x0a0f, 0x05f0), // ST_2D_4KB_8bpp
+    KERNEL(0xaacf, 0x5530), // ST_2D_64KB_128bpp, ST_2D_64KB_64bpp
+    KERNEL(0xaa8f, 0x5570), // ST_2D_64KB_32bpp, ST_2D_64KB_16bpp
+    KERNEL(0xaa0f, 0x55f0), // ST_2D_64KB_8bpp
+
+    #undef KERNEL
+};
+
+
+extern "C" PFN_CPU_SWIZZLE_BLT CpuSwizzleBltSelectKernel( // ##################
+
+    /* Returns kernel to perform BLT between given surfaces--a specialized
+    kernel where one exists, else CpuSwizzleBlt. */
+
+    const CPU_SWIZZLE_BLT_SURFACE   *pDest, // Pointer to destination surface descriptor.
+    const CPU_SWIZZLE_BLT_SURFACE   *pSrc)  // Pointer to source surface descriptor.
+
+    /* Selection depends only on surface properties (not BLT rectangle--other
+    than the offset of a sub-element within its pixel), so may be done once
+    and reused for every band/rectangle of a BLT. */
+
+{ // ###########################################################################
+
+    const CPU_SWIZZLE_BLT_SURFACE *pSwizzledSurface, *pLinearSurface;
+    const SWIZZLE_DESCRIPTOR *pSwizzle;
+    int Upload = (pDest->pSwizzle != NULL);
+    size_t i;
+
+    if(!pDest->pSwizzle == !pSrc->pSwizzle) return(CpuSwizzleBlt); // Need exactly one swizzled surface.
+
+    pSwizzledSurface = Upload ? pDest : pSrc;
+    pLinearSurface = Upload ? pSrc : pDest;
+    pSwizzle = pSwizzledSurface->pSwizzle;
+
+    #ifdef INTEL_CSX_SWIZZLE_SUPPORT
+        if(pSwizzle->XOR != SWIZZLE_DESCRIPTOR_XOR_NONE) return(CpuSwizzleBlt);
+    #endif
+
+    if( pSwizzle->Mask.z ||
+        pSwizzledSurface->OffsetZ ||
+        ((uintptr_t) pSwizzledSurface->pBase & 15) ||
+        (pSwizzledSurface->Pitch & 15))
+    {
+        return(CpuSwizzleBlt);
+    }
+
+    #ifdef SUB_ELEMENT_SUPPORT
+    {
+        const _CPU_SWIZZLE_BLT_SURFACE::_CPU_SWIZZLE_BLT_SURFACE_ELEMENT *pSwizzledElement = &pSwizzledSurface->Element;
+        const _CPU_SWIZZLE_BLT_SURFACE::_CPU_SWIZZLE_BLT_SURFACE_ELEMENT *pLinearElement = &pLinearSurface->Element;
+
+        if(pDest->Element.pConvert) return(CpuSwizzleBlt);
+
+        #ifdef INTEL_TILE_W_SUPPORT
+            if( (pSwizzle->Mask.x == INTEL_TILE_W.Mask.x) &&
+                (pSwizzle->Mask.y == INTEL_TILE_W.Mask.y) &&
+                (pSwizzledElement->Pitch == 1) &&
+                (pSwizzledElement->Size == 1) &&
+                (pLinearElement->Size == 1))
+            {
+                // Stencil of packed linear depth-stencil <--> TileW...
+                switch(pLinearElement->Pitch)
+                {
+                    case 4: return(Upload ? CpuSwizzleBltTileWKernel<4, true> : CpuSwizzleBltTileWKernel<4, false>);
+                    case 8: return(Upload ? CpuSwizzleBltTileWKernel<8, true> : CpuSwizzleBltTileWKernel<8, false>);
+                }
+            }
+        #endif
+
+        if( (pSwizzledElement->Size != pSwizzledElement->Pitch) &&
+            (pLinearElement->Size == pSwizzledElement->Size) &&
+            (pLinearElement->Pitch == pLinearElement->Size) &&
+            ((pSwizzledSurface->OffsetX & (pSwizzledElement->Pitch - 1)) + pSwizzledElement->Size <= pSwizzledElement->Pitch) &&
+            ((pSwizzle->Mask.x & 0xf) == 0xf)) // 16-byte X runs.
+        {
+            // Sub-element of packed swizzled depth-stencil <--> linear...
+            switch((pSwizzledElement->Pitch << 4) | pSwizzledElement->Size)
+            {
+                case 0x41: return(Upload ? CpuSwizzleBltSubElementKernel<4, 1, true> : CpuSwizzleBltSubElementKernel<4, 1, false>); // S8 of D24S8.
+                case 0x43: return(Upload ? CpuSwizzleBltSubElementKernel<4, 3, true> : CpuSwizzleBltSubElementKernel<4, 3, false>); // D24 of D24S8.
+                case 0x81: return(Upload ? CpuSwizzleBltSubElementKernel<8, 1, true> : CpuSwizzleBltSubElementKernel<8, 1, false>); // S8 of D32S8X24.
+                case 0x84: return(Upload ? CpuSwizzleBltSubElementKernel<8, 4, true> : CpuSwizzleBltSubElementKernel<8, 4, false>); // D32 of D32S8X24.
+            }
+        }
+
+        if( (pDest->Element.Size != pDest->Element.Pitch) ||
+            (pSrc->Element.Size != pSrc->Element.Pitch) ||
+            (pDest->Element.Size != pSrc->Element.Size))
+        {
+            return(CpuSwizzleBlt);
+        }
+    }
+    #endif
+
+    #ifdef INTEL_TILE_W_SUPPORT
+        if( (pSwizzle->Mask.x == INTEL_TILE_W.Mask.x) &&
+            (pSwizzle->Mask.y == INTEL_TILE_W.Mask.y))
+        {
+            return(Upload ? CpuSwizzleBltTileWKernel<1, true> : CpuSwizzleBltTileWKernel<1, false>);
+        }
+    #endif
+
+    for(i = 0; i < sizeof(SwizzleBltKernels) / sizeof(SwizzleBltKernels[0]); i++)
+    {
+        if( (SwizzleBltKernels[i].MaskX == pSwizzle->Mask.x) &&
+            (SwizzleBltKernels[i].MaskY == pSwizzle->Mask.y))
+        {
+            return(Upload ? SwizzleBltKernels[i].pfnUpload : SwizzleBltKernels[i].pfnDownload);
+        }
+    }
+
+    return(CpuSwizzleBlt);
+} // CpuSwizzleBltSelectKernel
@@ -24,14 +24,266 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #if  _WIN32
 #include <stdlib.h>
+#include "External/Common/GmmHeapTree.h"
 #include "External/Windows/GmmHeap.h"
 #include "External/Windows/node.h"
+#else
+#include <stdlib.h>
+#undef __GFX_MACRO_C__ // gfxmacro.h's out-of-line functions are emitted by CpuSwizzleBlt.c; only its macros are needed here.
+#include "Internal/Common/GmmLibInc.h"
+#include "External/Linux/GmmHeapLin.h"
 #endif
 
 #ifdef __GMM_KMD__
 #include "..\..\..\miniport\LHDM\KmGmm\inc\gmminc.h"  
 #endif
 
+#ifndef __GMM_KMD__
+//=============================================================================
+// User-Mode Heap Lock
+//
+// Recursive, as heap operations nest (e.g. magazine flushes freeing blocks).
+//=============================================================================
+#if _WIN32
+#define __GMM_UM_HEAP_LOCK_INIT(pHeapObj)       InitializeCriticalSection(&((pHeapObj)->Lock))
+#define __GMM_UM_HEAP_LOCK_DESTROY(pHeapObj)    DeleteCriticalSection(&((pHeapObj)->Lock))
+#define __GMM_UM_HEAP_LOCK(pHeapObj)            EnterCriticalSection(&((pHeapObj)->Lock))
+#define __GMM_UM_HEAP_UNLOCK(pHeapObj)          LeaveCriticalSection(&((pHeapObj)->Lock))
+#else
+#define __GMM_UM_HEAP_LOCK_INIT(pHeapObj)       __GmmUmInitHeapLock(&((pHeapObj)->Lock))
+#define __GMM_UM_HEAP_LOCK_DESTROY(pHeapObj)    pthread_mutex_destroy(&((pHeapObj)->Lock))
+#define __GMM_UM_HEAP_LOCK(pHeapObj)            pthread_mutex_lock(&((pHeapObj)->Lock))
+#define __GMM_UM_HEAP_UNLOCK(pHeapObj)          pthread_mutex_unlock(&((pHeapObj)->Lock))
+
+static void __GmmUmInitHeapLock(pthread_mutex_t *pLock)
+{
+    pthread_mutexattr_t Attr;
+
+    // glibc mutexes take no syscall uncontended and futex-wait when contended.
+    pthread_mutexattr_init(&Attr);
+    pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(pLock, &Attr);
+    pthread_mutexattr_destroy(&Attr);
+}
+#endif
+#endif
+
+//=============================================================================
+// Free Block Index
+//
+// Each heap's free blocks (excluding the list's head/tail sentinels) are
+// indexed by address and by (size, address), so that best-fit allocation and
+// locating the neighbors of a freed block are O(log n) rather than walks of
+// the address-ordered free list--which is kept, for O(1) neighbor stepping.
+// Indexing also keeps the free block counts of the heap's GMM_HEAP_STATS.
+//=============================================================================
+static int __GmmHeapCompareByAddr(const GMM_HEAP_TREE_LINK *pA, const GMM_HEAP_TREE_LINK *pB)
+{
+    const GMM_HEAPNODE *pNodeA = GMM_HEAP_TREE_ENTRY(pA, GMM_HEAPNODE, ByAddr);
+    const GMM_HEAPNODE *pNodeB = GMM_HEAP_TREE_ENTRY(pB, GMM_HEAPNODE, ByAddr);
+
+    return (pNodeA->BlockAddr < pNodeB->BlockAddr) ? -1 : (pNodeA->BlockAddr > pNodeB->BlockAddr);
+}
+
+static int __GmmHeapCompareBySize(const GMM_HEAP_TREE_LINK *pA, const GMM_HEAP_TREE_LINK *pB)
+{
+    const GMM_HEAPNODE *pNodeA = GMM_HEAP_TREE_ENTRY(pA, GMM_HEAPNODE, BySize);
+    const GMM_HEAPNODE *pNodeB = GMM_HEAP_TREE_ENTRY(pB, GMM_HEAPNODE, BySize);
+
+    if (pNodeA->BlockSize != pNodeB->BlockSize)
+    {
+        return (pNodeA->BlockSize < pNodeB->BlockSize) ? -1 : 1;
+    }
+
+    return (pNodeA->BlockAddr < pNodeB->BlockAddr) ? -1 : (pNodeA->BlockAddr > pNodeB->BlockAddr);
+}
+
+// GMM_HEAP_STATS counters (and heap FreeSize) are updated atomically, so
+// GmmHeapGetStats reads them without taking any lock.
+#if _WIN32
+#define __GMM_HEAP_STAT_ADD(Stat, Delta)    InterlockedExchangeAdd64((volatile LONG64 *) &(Stat), (LONG64) (Delta))
+#define __GMM_HEAP_STAT_SUB(Stat, Delta)    InterlockedExchangeAdd64((volatile LONG64 *) &(Stat), -(LONG64) (Delta))
+#define __GMM_HEAP_STAT_SET(Stat, Value)    InterlockedExchange64((volatile LONG64 *) &(Stat), (LONG64) (Value))
+#define __GMM_HEAP_STAT_GET(Stat)           ((uint64_t) InterlockedCompareExchange64((volatile LONG64 *) &(Stat), 0, 0))
+#else
+#define __GMM_HEAP_STAT_ADD(Stat, Delta)    __atomic_fetch_add(&(Stat), (Delta), __ATOMIC_RELAXED)
+#define __GMM_HEAP_STAT_SUB(Stat, Delta)    __atomic_fetch_sub(&(Stat), (Delta), __ATOMIC_RELAXED)
+#define __GMM_HEAP_STAT_SET(Stat, Value)    __atomic_store_n(&(Stat), (Value), __ATOMIC_RELAXED)
+#define __GMM_HEAP_STAT_GET(Stat)           __atomic_load_n(&(Stat), __ATOMIC_RELAXED)
+#endif
+
+// GMM_HEAP_STATS.FreeBlockHistogram bucket of (non-zero) size: floor(log2(Size)).
+static GMM_INLINE uint32_t __GmmHeapStatsBucket(GMM_GFX_SIZE_T Size)
+{
+    return __GmmHeapBuddyHighBit(Size);
+}
+
+// Counts free block of given size in, or (Delta = -1) out of, the stats.
+static GMM_INLINE void __GmmHeapStatsCount(GMM_HEAP *pHeapObj, GMM_GFX_SIZE_T Size, int Delta)
+{
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFreeBlocks, Delta);
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.FreeBlockHistogram[__GmmHeapStatsBucket(Size)], Delta);
+}
+
+// Re-reads LargestFreeBlock from the size index.
+static GMM_INLINE void __GmmHeapStatsFindLargest(GMM_HEAP *pHeapObj)
+{
+    GMM_HEAP_TREE_LINK *pLink = __GmmHeapTreeLast(&pHeapObj->FreeBySize);
+
+    __GMM_HEAP_STAT_SET(pHeapObj->Stats.LargestFreeBlock, pLink ? GMM_HEAP_TREE_ENTRY(pLink, GMM_HEAPNODE, BySize)->BlockSize : 0);
+}
+
+static GMM_INLINE void __GmmHeapIndexInit(GMM_HEAP *pHeapObj)
+{
+    __GmmHeapTreeInit(&pHeapObj->FreeByAddr, __GmmHeapCompareByAddr);
+    __GmmHeapTreeInit(&pHeapObj->FreeBySize, __GmmHeapCompareBySize);
+
+    pHeapObj->Stats.LargestFreeBlock = 0;
+    pHeapObj->Stats.NumFreeBlocks = 0;
+    GFX_MEMSET(pHeapObj->Stats.FreeBlockHistogram, 0, sizeof(pHeapObj->Stats.FreeBlockHistogram));
+}
+
+static GMM_INLINE void __GmmHeapIndexInsert(GMM_HEAP *pHeapObj, GMM_HEAPNODE *pNode)
+{
+    __GmmHeapTreeInsert(&pHeapObj->FreeByAddr, &pNode->ByAddr);
+    __GmmHeapTreeInsert(&pHeapObj->FreeBySize, &pNode->BySize);
+
+    pNode->IndexedSize = pNode->BlockSize;
+    __GmmHeapStatsCount(pHeapObj, pNode->IndexedSize, 1);
+    if (pNode->IndexedSize > pHeapObj->Stats.LargestFreeBlock)
+    {
+        __GMM_HEAP_STAT_SET(pHeapObj->Stats.LargestFreeBlock, pNode->IndexedSize);
+    }
+}
+
+static GMM_INLINE void __GmmHeapIndexRemove(GMM_HEAP *pHeapObj, GMM_HEAPNODE *pNode)
+{
+    __GmmHeapTreeRemove(&pHeapObj->FreeByAddr, &pNode->ByAddr);
+    __GmmHeapTreeRemove(&pHeapObj->FreeBySize, &pNode->BySize);
+
+    __GmmHeapStatsCount(pHeapObj, pNode->IndexedSize, -1);
+    if (pNode->IndexedSize == pHeapObj->Stats.LargestFreeBlock)
+    {
+        __GmmHeapStatsFindLargest(pHeapObj);
+    }
+}
+
+// Re-sorts an indexed node after its BlockSize (and/or BlockAddr) changed.
+// Callers only ever grow/shrink a block within the gap between its free
+// neighbors, so its address order is unchanged--only the size index moves.
+static GMM_INLINE void __GmmHeapIndexUpdate(GMM_HEAP *pHeapObj, GMM_HEAPNODE *pNode)
+{
+    GMM_GFX_SIZE_T OldSize = pNode->IndexedSize;
+
+    __GmmHeapTreeRemove(&pHeapObj->FreeBySize, &pNode->BySize);
+    __GmmHeapTreeInsert(&pHeapObj->FreeBySize, &pNode->BySize);
+
+    pNode->IndexedSize = pNode->BlockSize;
+    __GmmHeapStatsCount(pHeapObj, OldSize, -1);
+    __GmmHeapStatsCount(pHeapObj, pNode->IndexedSize, 1);
+    if (pNode->IndexedSize > pHeapObj->Stats.LargestFreeBlock)
+    {
+        __GMM_HEAP_STAT_SET(pHeapObj->Stats.LargestFreeBlock, pNode->IndexedSize);
+    }
+    else if (OldSize == pHeapObj->Stats.LargestFreeBlock)
+    {
+        __GmmHeapStatsFindLargest(pHeapObj);
+    }
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapFindPrevFreeBlock
+
+Description:
+    Finds the free block starting closest below a given address.
+
+Arguments:
+    pHeapObj ==> ptr to Heap object
+    Addr ==> Address to search below
+
+Return:
+    Last free block with BlockAddr < Addr, else the free list's head sentinel
+---------------------------------------------------------------------------*/
+static GMM_HEAPNODE *__GmmHeapFindPrevFreeBlock(GMM_HEAP *pHeapObj, GMM_GFX_ADDRESS Addr)
+{
+    GMM_HEAPNODE        Key;
+    GMM_HEAP_TREE_LINK  *pLink;
+
+    Key.BlockAddr = Addr;
+    pLink = __GmmHeapTreeLowerBound(&pHeapObj->FreeByAddr, &Key.ByAddr);
+    pLink = pLink ? __GmmHeapTreePrev(pLink) : __GmmHeapTreeLast(&pHeapObj->FreeByAddr);
+
+    return pLink ? GMM_HEAP_TREE_ENTRY(pLink, GMM_HEAPNODE, ByAddr) : pHeapObj->pFreeHeap;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapFindFit
+
+Description:
+    Finds a free block that can hold an aligned allocation, by bounded
+    first-good-fit: Search starts at the first block of at least Size and
+    steps up (by size, then address) through blocks too small once
+    alignment padding is added. If a fitting block turns up within
+    __GMM_HEAP_FIT_MAX_STEPS steps--always, for unpadded requests--it is
+    the best (smallest, then lowest) fit. Otherwise the search stops there
+    and takes the smallest block of at least Size + AlignValue - 1, which
+    fits at any alignment. That is O(log n), but no longer best-fit: It may
+    pass over a smaller block further along that would have fit once
+    aligned. Such blocks (all smaller than Size + AlignValue - 1) stay free
+    for later requests; the cost is splitting a larger block than best-fit
+    would have.
+
+Arguments:
+    pHeapObj ==> ptr to Heap object
+    Size ==> Size of memory block need to be allocated
+    AlignValue ==> Block start alignement
+
+Return:
+    Fitting free block, or NULL if none
+---------------------------------------------------------------------------*/
+#define __GMM_HEAP_FIT_MAX_STEPS   32
+
+static GMM_HEAPNODE *__GmmHeapFindFit(GMM_HEAP *pHeapObj, GMM_GFX_SIZE_T Size, uint32_t AlignValue)
+{
+    GMM_HEAPNODE        Key, *pNode;
+    GMM_HEAP_TREE_LINK  *pLink;
+    uint32_t            Steps = 0;
+
+    Key.BlockAddr = 0;
+    Key.BlockSize = Size;
+
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumSearches, 1);
+
+    for (pLink = __GmmHeapTreeLowerBound(&pHeapObj->FreeBySize, &Key.BySize);
+         pLink;
+         pLink = __GmmHeapTreeNext(pLink))
+    {
+        pNode = GMM_HEAP_TREE_ENTRY(pLink, GMM_HEAPNODE, BySize);
+
+        if (pNode->BlockSize >= Size + (GFX_ALIGN_NP2(pNode->BlockAddr, AlignValue) - pNode->BlockAddr))
+        {
+            __GMM_HEAP_STAT_ADD(pHeapObj->Stats.SearchSteps, Steps + 1);
+            return pNode;
+        }
+
+        if (++Steps == __GMM_HEAP_FIT_MAX_STEPS)
+        {   // Skip to the blocks that fit at any alignment...
+            Key.BlockSize = Size + AlignValue - 1;
+            pLink = __GmmHeapTreeLowerBound(&pHeapObj->FreeBySize, &Key.BySize);
+            __GMM_HEAP_STAT_ADD(pHeapObj->Stats.SearchSteps, Steps + (pLink ? 1 : 0));
+
+            return pLink ? GMM_HEAP_TREE_ENTRY(pLink, GMM_HEAPNODE, BySize) : NULL;
+        }
+    }
+
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.SearchSteps, Steps);
+    return NULL;
+}
+
 #ifdef __GMM_KMD__
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -351,14 +603,11 @@ BOOLEAN __GmmAllocBlockWithGfxAddress(GMM_CONTEXT *pGmmContext,
         GMM_ENTER_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
     }
 
-    pNode = pHeapObj->pFreeHeap->pNext;       //the first node
+    // Only the free block starting at or below ReqAddr can contain it.
+    pNode = __GmmHeapFindPrevFreeBlock(pHeapObj, ReqAddr + 1);
 
-    while (pNode && !(ReqAddr >= pNode->BlockAddr && EndAddr <= (pNode->BlockAddr + pNode->BlockSize)))
-    {
-        pNode = pNode->pNext;
-    }
-
-    if (!pNode)
+    if ((pNode == pHeapObj->pFreeHeap) ||
+        !(EndAddr <= (pNode->BlockAddr + pNode->BlockSize)))
     {
         GMM_DPF_CRITICAL("Unable to allocate specific heap addr!");
 
@@ -375,12 +624,14 @@ BOOLEAN __GmmAllocBlockWithGfxAddress(GMM_CONTEXT *pGmmContext,
         EndAddr == (pNode->BlockAddr + pNode->BlockSize))
     {
         //whole block out, eliminate this node
+        __GmmHeapIndexRemove(pHeapObj, pNode);
         pNode->pPrev->pNext = pNode->pNext;
         pNode->pNext->pPrev = pNode->pPrev;
 
         __GmmFreeNode(pGmmContext, &pGmmContext->HeapNodeMgmt, pNode);
 
-        pHeapObj->FreeSize -= Size;
+        __GMM_HEAP_STAT_SUB(pHeapObj->FreeSize, Size);
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumAllocs, 1);
 
         if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
         {
@@ -394,8 +645,10 @@ BOOLEAN __GmmAllocBlockWithGfxAddress(GMM_CONTEXT *pGmmContext,
     { /* from start */
         pNode->BlockAddr = pNode->BlockAddr + Size;        //there is space left
         pNode->BlockSize -= Size;
+        __GmmHeapIndexUpdate(pHeapObj, pNode);
 
-        pHeapObj->FreeSize -= Size;
+        __GMM_HEAP_STAT_SUB(pHeapObj->FreeSize, Size);
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumAllocs, 1);
 
         if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
         {
@@ -408,8 +661,10 @@ BOOLEAN __GmmAllocBlockWithGfxAddress(GMM_CONTEXT *pGmmContext,
     if (EndAddr == (pNode->BlockAddr + pNode->BlockSize))
     { /* to end */
         pNode->BlockSize -= Size;
+        __GmmHeapIndexUpdate(pHeapObj, pNode);
 
-        pHeapObj->FreeSize -= Size;
+        __GMM_HEAP_STAT_SUB(pHeapObj->FreeSize, Size);
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumAllocs, 1);
 
         if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
         {
@@ -440,6 +695,7 @@ BOOLEAN __GmmAllocBlockWithGfxAddress(GMM_CONTEXT *pGmmContext,
     pNode1->BlockSize = pNode->BlockSize - (EndAddr - pNode->BlockAddr);
 
     pNode->BlockSize = ReqAddr - pNode->BlockAddr;
+    __GmmHeapIndexUpdate(pHeapObj, pNode);
 
     // Insert new node at end of list.
 
@@ -451,166 +707,913 @@ BOOLEAN __GmmAllocBlockWithGfxAddress(GMM_CONTEXT *pGmmContext,
     pNode->pNext = pNode1;
     pNode1->pPrev = pNode;
 
-    pHeapObj->FreeSize -= Size;
+    __GmmHeapIndexInsert(pHeapObj, pNode1);
+
+    __GMM_HEAP_STAT_SUB(pHeapObj->FreeSize, Size);
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumAllocs, 1);
+
+    __GMM_ASSERT(ReqAddr >= pHeapObj->BaseAddress);
+    __GMM_ASSERT(ReqAddr < (pHeapObj->BaseAddress + pHeapObj->Size));
+
+    if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
+    {
+        GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
+    }
+
+    GMM_DPF_EXIT;
+
+    return(TRUE);
+} // __GmmAllocBlockWithGfxAddress
+
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmResetHeap
+
+Description:
+    The function reset the heap by removing all sentinel nodes
+
+Arguments:
+    PGmmContext ==> ptr to GmmContext
+    pHeapObj ==> ptr to Heap object
+
+Return:
+    N/A
+
+Notes:
+N/A
+---------------------------------------------------------------------------*/
+void __GmmResetHeap(GMM_CONTEXT *pGmmContext,
+    GMM_HEAP    *pHeapObj)
+{
+    GMM_HEAPNODE *pNode, *pNode1;
+    KIRQL        OldIrql;
+    KLOCK_QUEUE_HANDLE LockHandle;
+
+    __GMM_ASSERTPTR(pGmmContext, VOIDRETURN);
+    __GMM_ASSERTPTR(pHeapObj, VOIDRETURN);
+
+    GMM_DPF_ENTER;
+
+    if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
+    {
+        GMM_ENTER_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
+    }
+
+    pNode = pHeapObj->pFreeHeap;       //the first node
+
+    while (pNode)
+    {
+        pNode1 = pNode->pNext;      // save the next pointer
+
+        __GmmFreeNode(pGmmContext, &pGmmContext->HeapNodeMgmt, pNode);
+
+        pHeapObj->pFreeHeap = pNode1;
+        pNode = pNode1;
+    }
+
+    __GmmHeapIndexInit(pHeapObj);
+
+    if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
+    {
+        GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
+    }
+
+    GMM_DPF_EXIT;
+}
+
+#else
+//=============================================================================
+// Heap Node Slabs
+//
+// GMM_HEAPNODE's come from per-heap slabs: a slab's nodes are handed out in
+// address order, then recycled most recently freed first. Slabs double in
+// size, up to __GMM_MAX_NUM_OF_SLAB_HEAP_NODES nodes, and are kept on a list
+// (no fixed slab count).
+//=============================================================================
+struct GMM_HEAP_NODE_SLAB_REC
+{
+    struct GMM_HEAP_NODE_SLAB_REC   *pNext;
+    void                            *pAllocation;   // As malloc'ed (unaligned).
+    uint32_t                        NumNodes;
+    uint32_t                        NumUsed;        // Nodes handed out at least once.
+    GMM_HEAPNODE                    *pNodes;        // Cache line aligned.
+};
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+__GmmUmGrowFreeNode
+
+Description:
+Adds a slab to the node pool
+
+Arguments:
+ pNodePool ==> ptr to node pool
+
+Return:
+GMM_SUCCESS or GMM_OUT_OF_MEMORY
+
+Notes:
+N/A
+---------------------------------------------------------------------------*/
+static GMM_STATUS __GmmUmGrowFreeNode(GMM_HEAP_NODE_POOL *pNodePool)
+{
+    GMM_HEAP_NODE_SLAB  *pSlab;
+    void                *pAllocation;
+    size_t              AllocSize;
+
+    AllocSize = sizeof(GMM_HEAP_NODE_SLAB) + (__GMM_HEAP_NODE_SLAB_ALIGN - 1) +
+                (size_t) pNodePool->SlabNodes * sizeof(GMM_HEAPNODE);
+
+    pAllocation = malloc(AllocSize);
+    if (!pAllocation)
+    {
+        __GMM_ASSERT(0);
+        return GMM_OUT_OF_MEMORY;
+    }
+
+    pSlab = (GMM_HEAP_NODE_SLAB *) pAllocation;
+    pSlab->pAllocation = pAllocation;
+    pSlab->NumNodes = pNodePool->SlabNodes;
+    pSlab->NumUsed = 0;
+    pSlab->pNodes = (GMM_HEAPNODE *) GFX_ALIGN((uintptr_t) (pSlab + 1), __GMM_HEAP_NODE_SLAB_ALIGN);
+
+    pSlab->pNext = pNodePool->pSlabs;
+    pNodePool->pSlabs = pSlab;
+    pNodePool->NumSlabs++;
+    pNodePool->NumNodes += pSlab->NumNodes;
+    pNodePool->SlabNodes = GFX_MIN(pNodePool->SlabNodes * 2, __GMM_MAX_NUM_OF_SLAB_HEAP_NODES);
+
+    return GMM_SUCCESS;
+}
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+__GmmUmAllocNode
+
+Description:
+Allocation of free node: the most recently freed one, else the newest slab's
+next unused one
+
+Arguments:
+ pNodePool ==> ptr to node pool
+
+Return:
+Void * indicating free nodeReturn
+---------------------------------------------------------------------------*/
+static GMM_INLINE void *__GmmUmAllocNode(GMM_HEAP_NODE_POOL *pNodePool)
+{
+    GMM_HEAPNODE *pFreeNode = NULL;
+
+    __GMM_ASSERTPTR(pNodePool, NULL);
+
+    if (pNodePool->pFreeNodes)
+    {
+        pFreeNode = pNodePool->pFreeNodes;
+        pNodePool->pFreeNodes = pFreeNode->pNext;
+    }
+    else if ((pNodePool->pSlabs && (pNodePool->pSlabs->NumUsed < pNodePool->pSlabs->NumNodes)) ||
+             (__GmmUmGrowFreeNode(pNodePool) == GMM_SUCCESS))
+    {
+        pFreeNode = &pNodePool->pSlabs->pNodes[pNodePool->pSlabs->NumUsed++];
+    }
+
+    if (pFreeNode)
+    {
+        GFX_MEMSET(pFreeNode, 0, sizeof(GMM_HEAPNODE));
+    }
+
+    return(pFreeNode);
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmFreeNode
+
+Description:
+    Put the node back into free list
+
+Arguments:
+    pNodePool ==> ptr to node pool
+    pFreeNode ==> ptr to a node to be freed
+
+Return:
+    Void
+---------------------------------------------------------------------------*/
+static GMM_INLINE void __GmmUmFreeNode(GMM_HEAP_NODE_POOL *pNodePool, GMM_HEAPNODE *pFreeNode)
+{
+    __GMM_ASSERTPTR(pFreeNode, VOIDRETURN);
+    __GMM_ASSERTPTR(pNodePool, VOIDRETURN);
+
+#if DBG || defined _DEBUG
+    GFX_MEMSET(pFreeNode, __GMM_NODE_SIGNATURE, sizeof(GMM_HEAPNODE));
+#endif //DBG
+
+    pFreeNode->pNext = pNodePool->pFreeNodes;
+    pNodePool->pFreeNodes = pFreeNode;
+}
+
+//=============================================================================
+// Buddy Heap
+//
+// GMM_BUDDY_HEAP's carve their range into power-of-two blocks (from
+// GMM_BUDDY_HEAP_ALIGN_SIZE up), each aligned--relative to BaseAddress--to its
+// size, managed by a GMM_HEAP_BUDDY instead of the free list. Allocations are
+// rounded up to a block, with no alignment padding; blocks are found, split
+// and merged in constant time.
+//=============================================================================
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmBuddyStats
+
+Description:
+    Copies a buddy heap's free block counts of orders Order and up--those an
+    allocation or free of an order Order block can change--into its stats.
+    Caller holds heap Lock.
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
+    Order ==> Lowest order changed
+
+Return:
+    VOID
+---------------------------------------------------------------------------*/
+static void __GmmUmBuddyStats(GMM_HEAP *pHeapObj, uint32_t Order)
+{
+    GMM_HEAP_BUDDY  *pBuddy = &pHeapObj->Buddy;
+    uint64_t        *pBucket;
+
+    for (; Order <= pBuddy->MaxOrder; Order++)
+    {
+        pBucket = &pHeapObj->Stats.FreeBlockHistogram[Order + pBuddy->MinShift];
+        if (*pBucket != pBuddy->NumFree[Order])
+        {
+            __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFreeBlocks, pBuddy->NumFree[Order] - *pBucket);
+            __GMM_HEAP_STAT_SET(*pBucket, pBuddy->NumFree[Order]);
+        }
+    }
+
+    __GMM_HEAP_STAT_SET(pHeapObj->Stats.LargestFreeBlock,
+        pBuddy->OrderMask ? (1ull << (__GmmHeapBuddyHighBit(pBuddy->OrderMask) + pBuddy->MinShift)) : 0);
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmInitBuddyHeap
+
+Description:
+    Frees a buddy heap's whole range. (Bytes past the last whole
+    GMM_BUDDY_HEAP_ALIGN_SIZE block are unused.)
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
+
+Return:
+    Status ==> GMM_SUCCESS, GMM_INVALIDPARAM or GMM_OUT_OF_MEMORY
+---------------------------------------------------------------------------*/
+static GMM_STATUS __GmmUmInitBuddyHeap(GMM_HEAP *pHeapObj)
+{
+    if (!pHeapObj->Size ||
+        !GFX_IS_ALIGNED(pHeapObj->BaseAddress, GMM_BUDDY_HEAP_ALIGN_SIZE))
+    {
+        __GMM_ASSERT(0);
+        return GMM_INVALIDPARAM;
+    }
+
+    if (!__GmmHeapBuddyInit(&pHeapObj->Buddy, pHeapObj->Size, GMM_BUDDY_HEAP_ALIGN_SIZE))
+    {
+        return GMM_OUT_OF_MEMORY;
+    }
+
+    pHeapObj->FreeSize = pHeapObj->Buddy.NumBlocks << pHeapObj->Buddy.MinShift;
+    __GmmUmBuddyStats(pHeapObj, 0);
+
+    return GMM_SUCCESS;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmAllocBuddyBlock
+
+Description:
+    Allocates the smallest buddy heap block holding the requested size.
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
+    Size ==> Size requested
+    pGfxAddress ==> Returns block address
+
+Return:
+    TRUE on success, FALSE if no large enough block is free
+---------------------------------------------------------------------------*/
+static BOOLEAN __GmmUmAllocBuddyBlock(GMM_HEAP           *pHeapObj,
+                                      GMM_GFX_SIZE_T     Size,
+                                      GMM_GFX_ADDRESS    *pGfxAddress)
+{
+    uint32_t Order = __GmmHeapBuddyOrder(&pHeapObj->Buddy, Size);
+    uint64_t Offset;
+    BOOLEAN Success;
+
+    __GMM_UM_HEAP_LOCK(pHeapObj);
+
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumSearches, 1);
+    Success = __GmmHeapBuddyAlloc(&pHeapObj->Buddy, Order, &Offset) ? TRUE : FALSE;
+    if (Success)
+    {
+        __GMM_HEAP_STAT_SUB(pHeapObj->FreeSize, 1ull << (Order + pHeapObj->Buddy.MinShift));
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumAllocs, 1);
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.SearchSteps, 1);  // The lowest block of the smallest order that has one.
+        __GmmUmBuddyStats(pHeapObj, Order);
+        *pGfxAddress = pHeapObj->BaseAddress + Offset;
+    }
+
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
+
+    return Success;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmFreeBuddyBlock
+
+Description:
+    Frees a buddy heap block, merging it with free buddies.
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
+    GfxAddress ==> Block address
+    Size ==> Size requested when allocated
+
+Return:
+    VOID
+---------------------------------------------------------------------------*/
+static void __GmmUmFreeBuddyBlock(GMM_HEAP           *pHeapObj,
+                                  GMM_GFX_ADDRESS    GfxAddress,
+                                  GMM_GFX_SIZE_T     Size)
+{
+    uint32_t Order = __GmmHeapBuddyOrder(&pHeapObj->Buddy, Size);
+
+    __GMM_UM_HEAP_LOCK(pHeapObj);
+
+    if ((GfxAddress >= pHeapObj->BaseAddress) &&
+        __GmmHeapBuddyFree(&pHeapObj->Buddy, GfxAddress - pHeapObj->BaseAddress, Order))
+    {
+        __GMM_HEAP_STAT_ADD(pHeapObj->FreeSize, 1ull << (Order + pHeapObj->Buddy.MinShift));
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFrees, 1);
+        __GmmUmBuddyStats(pHeapObj, Order);
+    }
+    else
+    {
+        __GMM_ASSERT(0); // Not an allocated block.
+    }
+
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
+}
+
+#ifndef _WIN32
+//=============================================================================
+// Process Heap Registry
+//
+// On Windows each adapter's GMM_PROCESS_HEAP is kept by the KMD (reached via
+// pfnEscape); here it is simply kept per process.
+//=============================================================================
+#define __GMM_MAX_PROCESS_HEAPS     8
+
+static struct
+{
+    GMM_ESCAPE_HANDLE   hAdapter;
+    GMM_HEAP            *pHeapObj;
+} __GmmProcessHeaps[__GMM_MAX_PROCESS_HEAPS];
+
+static pthread_mutex_t __GmmProcessHeapsLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    GmmGetSharedHeapObject
+
+Description:
+    Returns the adapter's process heap, adding a context to it.
+
+Arguments:
+    hAdapter ==> Adapter handle
+    hDevice, pfnEscape ==> Unused
+
+Return:
+    pHeapObj, or NULL if adapter has no process heap
+---------------------------------------------------------------------------*/
+GMM_HEAP* GmmGetSharedHeapObject(GMM_ESCAPE_HANDLE        hAdapter,
+                                 GMM_ESCAPE_HANDLE        hDevice,
+                                 GMM_ESCAPE_FUNC_TYPE     pfnEscape)
+{
+    GMM_HEAP    *pHeapObj = NULL;
+    uint32_t    i;
+
+    GMM_UNREFERENCED_PARAMETER(hDevice);
+    GMM_UNREFERENCED_PARAMETER(pfnEscape);
+
+    pthread_mutex_lock(&__GmmProcessHeapsLock);
+
+    for (i = 0; i < __GMM_MAX_PROCESS_HEAPS; i++)
+    {
+        if (__GmmProcessHeaps[i].pHeapObj && (__GmmProcessHeaps[i].hAdapter == hAdapter))
+        {
+            pHeapObj = __GmmProcessHeaps[i].pHeapObj;
+            pHeapObj->NumContexts++;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&__GmmProcessHeapsLock);
+
+    return pHeapObj;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    GmmSetSharedHeapObject
+
+Description:
+    Registers a process heap for the adapter (unless, having raced with
+    another device, the adapter already has one--pHeapObj then stays
+    private to its creator).
+
+Arguments:
+    hAdapter ==> Adapter handle
+    hDevice, pfnEscape ==> Unused
+    pHeapObj ==> Heap to register, NULL to unregister adapter's heap
+
+Return:
+    VOID
+---------------------------------------------------------------------------*/
+void GmmSetSharedHeapObject(GMM_ESCAPE_HANDLE        hAdapter,
+                            GMM_ESCAPE_HANDLE        hDevice,
+                            GMM_HEAP                 *pHeapObj,
+                            GMM_ESCAPE_FUNC_TYPE     pfnEscape)
+{
+    uint32_t i, Free = __GMM_MAX_PROCESS_HEAPS;
+
+    GMM_UNREFERENCED_PARAMETER(hDevice);
+    GMM_UNREFERENCED_PARAMETER(pfnEscape);
+
+    pthread_mutex_lock(&__GmmProcessHeapsLock);
+
+    for (i = 0; i < __GMM_MAX_PROCESS_HEAPS; i++)
+    {
+        if (__GmmProcessHeaps[i].pHeapObj && (__GmmProcessHeaps[i].hAdapter == hAdapter))
+        {
+            if (!pHeapObj)
+            {
+                __GmmProcessHeaps[i].pHeapObj = NULL;
+            }
+            Free = __GMM_MAX_PROCESS_HEAPS;
+            break;
+        }
+        else if (!__GmmProcessHeaps[i].pHeapObj && (Free == __GMM_MAX_PROCESS_HEAPS))
+        {
+            Free = i;
+        }
+    }
+
+    if (pHeapObj && (Free < __GMM_MAX_PROCESS_HEAPS))
+    {
+        __GmmProcessHeaps[Free].hAdapter = hAdapter;
+        __GmmProcessHeaps[Free].pHeapObj = pHeapObj;
+    }
+
+    pthread_mutex_unlock(&__GmmProcessHeapsLock);
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmReleaseHeapContext
+
+Description:
+    Removes a context from a heap--atomically with respect to
+    GmmGetSharedHeapObject, so a process heap can't be handed out as its
+    last context goes away (it is unregistered then).
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
+
+Return:
+    TRUE if that was the heap's last context
+---------------------------------------------------------------------------*/
+static BOOLEAN __GmmUmReleaseHeapContext(GMM_HEAP *pHeapObj)
+{
+    BOOLEAN     LastContext;
+    uint32_t    i;
+
+    pthread_mutex_lock(&__GmmProcessHeapsLock);
+
+    pHeapObj->NumContexts--;
+    LastContext = (pHeapObj->NumContexts == 0);
+
+    for (i = 0; LastContext && (i < __GMM_MAX_PROCESS_HEAPS); i++)
+    {
+        if (__GmmProcessHeaps[i].pHeapObj == pHeapObj)
+        {
+            __GmmProcessHeaps[i].pHeapObj = NULL;
+        }
+    }
+
+    pthread_mutex_unlock(&__GmmProcessHeapsLock);
+
+    return LastContext;
+}
+#endif
+
+// Block start alignment of heap's type.
+static uint32_t __GmmUmHeapAlignment(GMM_HEAP *pHeapObj)
+{
+    switch (pHeapObj->HeapType & HEAP_TYPE_MASK)
+    {
+    case GMM_TRVA_HEAP:
+        return GMM_TRVA_HEAP_ALIGN_SIZE;
+    case GMM_FLAT_HEAP:
+        return GMM_FLAT_HEAP_ALIGN_SIZE;
+    case GMM_BUDDY_HEAP:
+        return GMM_BUDDY_HEAP_ALIGN_SIZE;    //Blocks are naturally aligned
+    default:
+        return GMM_HEAP_ALIGN_SIZE;    //Align to 1B by default
+    }
+}
+
+#if GMM_HEAP_THREAD_CACHE
+//=============================================================================
+// Thread Magazines
+//
+// Each thread using a heap gets a magazine: per size class, a small stack of
+// blocks that thread freed. Frees of a cached size push to the calling
+// thread's magazine, and allocations pop from it, taking only the magazine's
+// own (practically uncontended) lock. A full class flushes its older half to
+// the heap under one heap Lock acquisition; an allocation the heap can't
+// satisfy first drains all magazines. Magazine blocks are out of the heap,
+// so not counted in FreeSize.
+//
+// Lock order: heap Lock, then magazine Lock.
+//=============================================================================
+struct GMM_HEAP_MAGAZINE_REC
+{
+    GMM_HEAP                        *pHeapObj;
+    struct GMM_HEAP_MAGAZINE_REC    *pNext;     // pHeapObj->pMagazines list (under heap Lock).
+    struct GMM_HEAP_MAGAZINE_REC    *pPrev;
+    pthread_mutex_t                 Lock;
+    uint32_t                        Count[GMM_HEAP_MAGAZINE_NUM_CLASSES];
+    GMM_GFX_ADDRESS                 Block[GMM_HEAP_MAGAZINE_NUM_CLASSES][GMM_HEAP_MAGAZINE_DEPTH];
+};
+
+// Magazine class of allocation size, -1 if not cached.
+static int __GmmUmMagazineClass(GMM_HEAP *pHeapObj, GMM_GFX_SIZE_T Size)
+{
+    if (!pHeapObj->MagazineKeyValid ||
+        !Size ||
+        (Size % GMM_HEAP_MAGAZINE_GRANULE) ||
+        (Size > GMM_HEAP_MAGAZINE_GRANULE * GMM_HEAP_MAGAZINE_NUM_CLASSES))
+    {
+        return -1;
+    }
+
+    return (int) (Size / GMM_HEAP_MAGAZINE_GRANULE) - 1;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmFlushMagazine
+
+Description:
+    Returns all a magazine's blocks to its heap. Caller holds heap Lock.
+
+Arguments:
+    pMagazine ==> Ptr to magazine
+
+Return:
+    Number of blocks returned
+---------------------------------------------------------------------------*/
+static uint32_t __GmmUmFlushMagazine(GMM_HEAP_MAGAZINE *pMagazine)
+{
+    uint32_t Class, i, NumBlocks = 0;
+
+    pthread_mutex_lock(&pMagazine->Lock);
+
+    for (Class = 0; Class < GMM_HEAP_MAGAZINE_NUM_CLASSES; Class++)
+    {
+        for (i = 0; i < pMagazine->Count[Class]; i++)
+        {
+            __GmmFreeHeapBlockGfxAddress(NULL, pMagazine->pHeapObj, pMagazine->Block[Class][i], (Class + 1) * GMM_HEAP_MAGAZINE_GRANULE);
+        }
+        NumBlocks += pMagazine->Count[Class];
+        pMagazine->Count[Class] = 0;
+    }
+
+    pthread_mutex_unlock(&pMagazine->Lock);
+
+    return NumBlocks;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmMagazineThreadExit
+
+Description:
+    Thread exit destructor of a thread's magazine: returns its blocks to the
+    heap and frees it.
+
+Arguments:
+    pData ==> Ptr to magazine
+
+Return:
+    VOID
+---------------------------------------------------------------------------*/
+static void __GmmUmMagazineThreadExit(void *pData)
+{
+    GMM_HEAP_MAGAZINE   *pMagazine = (GMM_HEAP_MAGAZINE *) pData;
+    GMM_HEAP            *pHeapObj = pMagazine->pHeapObj;
+
+    __GMM_UM_HEAP_LOCK(pHeapObj);
+
+    __GmmUmFlushMagazine(pMagazine);
+
+    if (pMagazine->pPrev)
+    {
+        pMagazine->pPrev->pNext = pMagazine->pNext;
+    }
+    else
+    {
+        pHeapObj->pMagazines = pMagazine->pNext;
+    }
+    if (pMagazine->pNext)
+    {
+        pMagazine->pNext->pPrev = pMagazine->pPrev;
+    }
+
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
+
+    pthread_mutex_destroy(&pMagazine->Lock);
+    free(pMagazine);
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmUmGetMagazine
+
+Description:
+    Returns the calling thread's magazine for a heap, creating it if needed.
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
 
-    __GMM_ASSERT(ReqAddr >= pHeapObj->BaseAddress);
-    __GMM_ASSERT(ReqAddr < (pHeapObj->BaseAddress + pHeapObj->Size));
+Return:
+    Ptr to magazine, NULL on failure
+---------------------------------------------------------------------------*/
+static GMM_HEAP_MAGAZINE *__GmmUmGetMagazine(GMM_HEAP *pHeapObj)
+{
+    GMM_HEAP_MAGAZINE *pMagazine = (GMM_HEAP_MAGAZINE *) pthread_getspecific(pHeapObj->MagazineKey);
 
-    if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
+    if (!pMagazine)
     {
-        GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
-    }
+        pMagazine = (GMM_HEAP_MAGAZINE *) calloc(1, sizeof(GMM_HEAP_MAGAZINE));
+        if (!pMagazine)
+        {
+            return NULL;
+        }
 
-    GMM_DPF_EXIT;
+        pMagazine->pHeapObj = pHeapObj;
+        pthread_mutex_init(&pMagazine->Lock, NULL);
 
-    return(TRUE);
-} // __GmmAllocBlockWithGfxAddress
+        if (pthread_setspecific(pHeapObj->MagazineKey, pMagazine))
+        {
+            pthread_mutex_destroy(&pMagazine->Lock);
+            free(pMagazine);
+            return NULL;
+        }
+
+        __GMM_UM_HEAP_LOCK(pHeapObj);
+        pMagazine->pNext = pHeapObj->pMagazines;
+        if (pMagazine->pNext)
+        {
+            pMagazine->pNext->pPrev = pMagazine;
+        }
+        pHeapObj->pMagazines = pMagazine;
+        __GMM_UM_HEAP_UNLOCK(pHeapObj);
+    }
 
+    return pMagazine;
+}
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Function:
-    __GmmResetHeap
+    __GmmUmMagazineAlloc
 
 Description:
-    The function reset the heap by removing all sentinel nodes
+    Allocates a block of a cached size from the calling thread's magazine.
 
 Arguments:
-    PGmmContext ==> ptr to GmmContext
-    pHeapObj ==> ptr to Heap object
+    pHeapObj ==> Ptr to HeapObj
+    Size ==> Allocation size
+    pGfxAddress ==> Returned block address
 
 Return:
-    N/A
-
-Notes:
-N/A
+    TRUE on success
 ---------------------------------------------------------------------------*/
-void __GmmResetHeap(GMM_CONTEXT *pGmmContext,
-    GMM_HEAP    *pHeapObj)
+static BOOLEAN __GmmUmMagazineAlloc(GMM_HEAP         *pHeapObj,
+                                    GMM_GFX_SIZE_T   Size,
+                                    GMM_GFX_ADDRESS  *pGfxAddress)
 {
-    GMM_HEAPNODE *pNode, *pNode1;
-    KIRQL        OldIrql;
-    KLOCK_QUEUE_HANDLE LockHandle;
-
-    __GMM_ASSERTPTR(pGmmContext, VOIDRETURN);
-    __GMM_ASSERTPTR(pHeapObj, VOIDRETURN);
-
-    GMM_DPF_ENTER;
+    GMM_HEAP_MAGAZINE   *pMagazine;
+    int                 Class = __GmmUmMagazineClass(pHeapObj, Size);
+    BOOLEAN             Success = FALSE;
 
-    if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
+    if ((Class < 0) ||
+        !(pMagazine = (GMM_HEAP_MAGAZINE *) pthread_getspecific(pHeapObj->MagazineKey)))
     {
-        GMM_ENTER_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
+        return FALSE;
     }
 
-    pNode = pHeapObj->pFreeHeap;       //the first node
-
-    while (pNode)
+    pthread_mutex_lock(&pMagazine->Lock);
+    if (pMagazine->Count[Class])
     {
-        pNode1 = pNode->pNext;      // save the next pointer
-
-        __GmmFreeNode(pGmmContext, &pGmmContext->HeapNodeMgmt, pNode);
-
-        pHeapObj->pFreeHeap = pNode1;
-        pNode = pNode1;
+        *pGfxAddress = pMagazine->Block[Class][--pMagazine->Count[Class]];
+        Success = TRUE;
     }
+    pthread_mutex_unlock(&pMagazine->Lock);
 
-    if ((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0)
+    if (Success)
     {
-        GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumCachedAllocs, 1);
     }
 
-    GMM_DPF_EXIT;
+    return Success;
 }
 
-#else
-#if _WIN32
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Function:
-__GmmUmGrowFreeNode
+    __GmmUmMagazineFree
 
 Description:
-Grows free node
+    Frees a block of a cached size to the calling thread's magazine, first
+    flushing the older half of its class to the heap if the class is full.
+    A block that couldn't have come from the heap (out of its range or
+    misaligned for its type) is left to the heap's free path to catch--
+    cached, it would be handed out as is. A block already in the thread's
+    magazine (a double free) is asserted on and dropped. (Heaps created
+    with GMM_HEAP_NO_THREAD_CACHE send every free through the heap's own
+    overlap checks.)
 
 Arguments:
+    pHeapObj ==> Ptr to HeapObj
+    GfxAddress ==> Block address
+    Size ==> Block size
 
 Return:
-pHeapNodePool ==> pointer to list of free nodes
-
-Notes:
-N/A
+    TRUE if block was taken (else caller frees it to the heap)
 ---------------------------------------------------------------------------*/
-GMM_INLINE void* __GmmUmGrowFreeNode()
+static BOOLEAN __GmmUmMagazineFree(GMM_HEAP         *pHeapObj,
+                                   GMM_GFX_ADDRESS  GfxAddress,
+                                   GMM_GFX_SIZE_T   Size)
 {
-    GMM_HEAPNODE         *pHeapNodePool = NULL;
+    GMM_GFX_ADDRESS     Flush[GMM_HEAP_MAGAZINE_DEPTH / 2];
+    GMM_HEAP_MAGAZINE   *pMagazine;
+    int                 Class = __GmmUmMagazineClass(pHeapObj, Size);
+    uint32_t            i, NumFlush = 0;
+
+    if ((Class < 0) ||
+        (GfxAddress < pHeapObj->BaseAddress) ||
+        (GfxAddress - pHeapObj->BaseAddress > pHeapObj->Size - Size) ||
+        (GfxAddress % __GmmUmHeapAlignment(pHeapObj)) ||
+        !(pMagazine = __GmmUmGetMagazine(pHeapObj)))
+    {
+        return FALSE;
+    }
 
-    pHeapNodePool = __GmmUmInitHeapNodePool(sizeof(GMM_HEAPNODE), __GMM_MAX_NUM_OF_FREE_HEAP_NODES);
+    pthread_mutex_lock(&pMagazine->Lock);
+    for (i = 0; i < pMagazine->Count[Class]; i++)
+    {
+        if (pMagazine->Block[Class][i] == GfxAddress)
+        {
+            pthread_mutex_unlock(&pMagazine->Lock);
+            __GMM_ASSERT(0); // Double free.
+            return TRUE;
+        }
+    }
+    if (pMagazine->Count[Class] == GMM_HEAP_MAGAZINE_DEPTH)
+    {   // Full--take out older half, to flush outside magazine Lock (per lock order).
+        NumFlush = GMM_HEAP_MAGAZINE_DEPTH / 2;
+        memcpy(Flush, pMagazine->Block[Class], sizeof(Flush));
+        memmove(pMagazine->Block[Class], &pMagazine->Block[Class][NumFlush], (GMM_HEAP_MAGAZINE_DEPTH - NumFlush) * sizeof(GMM_GFX_ADDRESS));
+        pMagazine->Count[Class] -= NumFlush;
+    }
+    pMagazine->Block[Class][pMagazine->Count[Class]++] = GfxAddress;
+    pthread_mutex_unlock(&pMagazine->Lock);
+
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumCachedFrees, 1);
+
+    if (NumFlush)
+    {
+        __GMM_UM_HEAP_LOCK(pHeapObj);
+        for (i = 0; i < NumFlush; i++)
+        {
+            __GmmFreeHeapBlockGfxAddress(NULL, pHeapObj, Flush[i], Size);
+        }
+        __GMM_UM_HEAP_UNLOCK(pHeapObj);
+    }
 
-    return pHeapNodePool;
+    return TRUE;
 }
+
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Function:
-__GmmUmAllocNode
+    __GmmUmDrainMagazines
 
 Description:
-Allocation of free node
+    Returns all threads' magazined blocks to the heap.
 
 Arguments:
- pHeapNodePool ==> ptr to list of free nodes
+    pHeapObj ==> Ptr to HeapObj
 
 Return:
-Void * indicating free nodeReturn
+    TRUE if any blocks were returned
 ---------------------------------------------------------------------------*/
-GMM_INLINE void *__GmmUmAllocNode(GMM_HEAPNODE         **pHeapNodePool)
+static BOOLEAN __GmmUmDrainMagazines(GMM_HEAP *pHeapObj)
 {
-    GMM_HEAPNODE *pFreeNode = NULL;
+    GMM_HEAP_MAGAZINE   *pMagazine;
+    uint32_t            NumBlocks = 0;
 
-    __GMM_ASSERTPTR(pHeapNodePool, NULL);
-
-    if ( !(*pHeapNodePool) )
+    if (!pHeapObj->MagazineKeyValid)
     {
-        (*pHeapNodePool) = __GmmUmGrowFreeNode();
+        return FALSE;
     }
 
-    if (*pHeapNodePool)
+    __GMM_UM_HEAP_LOCK(pHeapObj);
+    for (pMagazine = pHeapObj->pMagazines; pMagazine; pMagazine = pMagazine->pNext)
     {
-        pFreeNode = *pHeapNodePool;
-        *pHeapNodePool = (*pHeapNodePool)->pNext;
+        NumBlocks += __GmmUmFlushMagazine(pMagazine);
     }
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
 
-    return(pFreeNode);
+    return (NumBlocks > 0);
 }
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Function:
-    __GmmUmFreeNode
+    __GmmUmInitMagazines / __GmmUmDestroyMagazines
 
 Description:
-    Put the node back into free list
+    Enables magazines for a heap (unless GMM_HEAP_NO_THREAD_CACHE), or frees
+    them all. Heap must no longer be in use by other threads when destroyed.
 
 Arguments:
-    pHeapNodePool ==> Pool of HeapNodes
-    pFreeNode ==> ptr to a node to be freed
+    pHeapObj ==> Ptr to HeapObj
 
 Return:
-    Void
+    VOID
 ---------------------------------------------------------------------------*/
-GMM_INLINE void __GmmUmFreeNode(GMM_HEAPNODE         **pHeapNodePool, GMM_HEAPNODE *pFreeNode)
+static void __GmmUmInitMagazines(GMM_HEAP *pHeapObj)
 {
-    __GMM_ASSERTPTR(pFreeNode, VOIDRETURN);
-    __GMM_ASSERTPTR(pHeapNodePool, VOIDRETURN);
+    pHeapObj->pMagazines = NULL;
+    pHeapObj->MagazineKeyValid =
+        !(pHeapObj->HeapType & GMM_HEAP_NO_THREAD_CACHE) &&
+        !pthread_key_create(&pHeapObj->MagazineKey, __GmmUmMagazineThreadExit);
+}
 
-#if DBG || defined _DEBUG
-    GFX_MEMSET(pFreeNode, __GMM_NODE_SIGNATURE, sizeof(GMM_HEAPNODE));
-#else //!DBG
-    GFX_MEMSET(pFreeNode, 0, sizeof(GMM_HEAPNODE));
-#endif //DBG
+static void __GmmUmDestroyMagazines(GMM_HEAP *pHeapObj)
+{
+    GMM_HEAP_MAGAZINE *pMagazine;
+
+    if (!pHeapObj->MagazineKeyValid)
+    {
+        return;
+    }
+
+    pthread_key_delete(pHeapObj->MagazineKey); // No more thread exit destructors.
+    pHeapObj->MagazineKeyValid = 0;
 
-    pFreeNode->pNext = *pHeapNodePool;
-    *pHeapNodePool = pFreeNode;
+    __GMM_UM_HEAP_LOCK(pHeapObj);
+    while ((pMagazine = pHeapObj->pMagazines))
+    {
+        pHeapObj->pMagazines = pMagazine->pNext;
+        pthread_mutex_destroy(&pMagazine->Lock);
+        free(pMagazine);
+    }
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
 }
+#endif
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
@@ -651,9 +1654,14 @@ GMM_HEAP* GMM_STDCALL GmmUmSetupHeap(GMM_ESCAPE_HANDLE        hAdapter,
         if(pHeapObj)
         {
             GFX_MEMSET(pHeapObj, 0, sizeof(GMM_HEAP));
-            pHeapObj->pHeapNodePool = __GmmUmInitHeapNodePool(sizeof(GMM_HEAPNODE), __GMM_MAX_NUM_OF_FREE_HEAP_NODES);
-
-            Status = __GmmSetupHeap(NULL, pHeapObj, GfxAddress, Size, 0, Flags);
+            Status = __GmmUmInitHeapNodePool(&pHeapObj->NodePool, __GMM_MAX_NUM_OF_FREE_HEAP_NODES);
+            if (Status == GMM_SUCCESS)
+            {
+                Status = __GmmSetupHeap(NULL, pHeapObj, GfxAddress, Size, 0, Flags);
+            }
+#if GMM_HEAP_THREAD_CACHE
+            __GmmUmInitMagazines(pHeapObj);
+#endif
 
             if ((Flags & GMM_PROCESS_HEAP))
             {
@@ -704,14 +1712,20 @@ GMM_STATUS GMM_STDCALL GmmUmDestroypHeap(GMM_ESCAPE_HANDLE        hAdapter,
         return Status;
     }
     
+#if _WIN32
     (*pHeapObj)->NumContexts--;
 
     if ((*pHeapObj)->NumContexts == 0)
+#else
+    if (__GmmUmReleaseHeapContext(*pHeapObj))
+#endif
     {
+#if GMM_HEAP_THREAD_CACHE
+        __GmmUmDestroyMagazines(*pHeapObj);
+#endif
         __GmmUmResetHeap(*pHeapObj);
-        __GmmUmDestroyHeapNodePool((*pHeapObj)->pHeapNodePool);
-        (*pHeapObj)->pHeapNodePool = NULL;
 
+#if _WIN32
         if (((*pHeapObj)->HeapType & GMM_PROCESS_HEAP))
         {
             GmmSetSharedHeapObject(hAdapter,
@@ -719,8 +1733,9 @@ GMM_STATUS GMM_STDCALL GmmUmDestroypHeap(GMM_ESCAPE_HANDLE        hAdapter,
                                    NULL,
                                    pfnEscape);
         }
+#endif
 
-        DeleteCriticalSection(&((*pHeapObj)->Lock));
+        __GMM_UM_HEAP_LOCK_DESTROY(*pHeapObj);
         free(*pHeapObj);
         *pHeapObj = NULL;
     }
@@ -735,54 +1750,26 @@ Function:
     __GmmUmInitHeapNodePool
 
 Description:
-    This function initializes Heap nodes pool for umd use
+    This function initializes Heap nodes pool for umd use, with its first
+    slab
 
 Arguments:
-    NodeSize ==> Size of each node
-    NumNodes ==> Number of Nodes to be created
+    pNodePool ==> Ptr to HeapNodePool
+    NumNodes ==> Number of Nodes in first slab
 
 Return:
-    Status ==> GMM_SUCCESS or GMM_ERROR
+    Status ==> GMM_SUCCESS or GMM_OUT_OF_MEMORY
 ---------------------------------------------------------------------------*/
-GMM_HEAPNODE* __GmmUmInitHeapNodePool(uint32_t NodeSize,
-                                      uint32_t NumNodes)
+GMM_STATUS __GmmUmInitHeapNodePool(GMM_HEAP_NODE_POOL *pNodePool,
+                                   uint32_t NumNodes)
 {
-    uint32_t AllocSize = 0, SizeLeft = 0;
-    GMM_HEAPNODE* pHeadNode = NULL;
-    GMM_HEAPNODE* pHeapNodePool = NULL;
-
-    __GMM_ASSERT(NodeSize >= sizeof(GMM_HEAPNODE));    // Assert if the size is smaller
+    __GMM_ASSERTPTR(pNodePool, GMM_ERROR);
     __GMM_ASSERT(NumNodes);
 
-    AllocSize = SizeLeft = NodeSize*NumNodes;
-    pHeapNodePool = pHeadNode = (GMM_HEAPNODE *)malloc(sizeof(GMM_HEAPNODE));
-
-    if(pHeapNodePool)
-    {
-        SizeLeft -= NodeSize;
-        pHeapNodePool->pPrev = NULL;
-        GFX_MEMSET(pHeadNode, 0, NodeSize);
-
-        //build the singly linked list
-        while (SizeLeft >= NodeSize)
-        {
-            pHeadNode->pNext = (GMM_HEAPNODE *)malloc(sizeof(GMM_HEAPNODE));
-            if (pHeadNode->pNext)
-            {
-                SizeLeft -= NodeSize;
-                pHeadNode = pHeadNode->pNext;
-                GFX_MEMSET(pHeadNode, 0, NodeSize);
-            }
-            else
-            {
-                __GMM_ASSERT(0);
-                break;
-            }
-        }
-        pHeadNode->pNext = NULL;
-    }
+    GFX_MEMSET(pNodePool, 0, sizeof(GMM_HEAP_NODE_POOL));
+    pNodePool->SlabNodes = GFX_MAX(NumNodes, 1);
 
-    return pHeapNodePool;
+    return __GmmUmGrowFreeNode(pNodePool);
 }
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -791,26 +1778,29 @@ Function:
 __GmmUmDestroyHeapNodePool
     
 Description:
-    This function destroys HeapNodePool
+    This function destroys HeapNodePool: releases all its slabs, whether or
+    not their nodes are in use
 
 Arguments:
-    pHeapNodePool ==> Ptr to HeapHodePool
+    pNodePool ==> Ptr to HeapNodePool
 
 Return:
     VOID
 ---------------------------------------------------------------------------*/
-void __GmmUmDestroyHeapNodePool(GMM_HEAPNODE* pHeapNodePool)
+void __GmmUmDestroyHeapNodePool(GMM_HEAP_NODE_POOL *pNodePool)
 {
-    GMM_HEAPNODE* pNode;
-    __GMM_ASSERTPTR(pHeapNodePool, VOIDRETURN);
+    GMM_HEAP_NODE_SLAB *pSlab;
+    __GMM_ASSERTPTR(pNodePool, VOIDRETURN);
 
-    pNode = pHeapNodePool;
-    while (pNode)
+    while ((pSlab = pNodePool->pSlabs))
     {
-        pHeapNodePool = pHeapNodePool->pNext;
-        free(pNode);
-        pNode = pHeapNodePool;
+        pNodePool->pSlabs = pSlab->pNext;
+        free(pSlab->pAllocation);
     }
+
+    pNodePool->pFreeNodes = NULL;
+    pNodePool->NumSlabs = 0;
+    pNodePool->NumNodes = 0;
 }
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -819,7 +1809,8 @@ Function:
     __GmmUmResetHeap
     
 Description:
-    The function resets the heap by removing all sentinel nodes
+    The function resets the heap, releasing all its nodes (sentinel and free
+    block ones) at once with their slabs
 
 Arguments:
     pHeapObj ==> Ptr to HeapObj
@@ -829,24 +1820,17 @@ Return:
 ---------------------------------------------------------------------------*/
 void __GmmUmResetHeap(GMM_HEAP            *pHeapObj)
 {
-    GMM_HEAPNODE* pNode, *pNode1;
-    
     __GMM_ASSERT(pHeapObj != NULL);
 
-    EnterCriticalSection(&(pHeapObj->Lock));
-
-    pNode = pHeapObj->pFreeHeap;
-    while (pNode)
-    {
-        pNode1 = pNode->pNext;      // save the next pointer
+    __GMM_UM_HEAP_LOCK(pHeapObj);
 
-        __GmmUmFreeNode(&(pHeapObj->pHeapNodePool),pNode);
+    __GmmUmDestroyHeapNodePool(&pHeapObj->NodePool);
+    pHeapObj->pFreeHeap = NULL;
 
-        pHeapObj->pFreeHeap = pNode1;
-        pNode = pNode1;
-    }
+    __GmmHeapIndexInit(pHeapObj);
+    __GmmHeapBuddyDestroy(&pHeapObj->Buddy);
 
-    LeaveCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
 
 }
 
@@ -858,6 +1842,8 @@ Function:
 
 Description:
     The function reserves the VA range for the requested size from the Heap
+    (a recently freed block of the size from the calling thread's magazine, if
+    any--see Thread Magazines)
 
 Arguments:
     pHeapObj ==> Ptr to HeapObj
@@ -869,33 +1855,42 @@ Return:
 GMM_GFX_ADDRESS GMM_STDCALL GmmAllocateHeapVA(GMM_HEAP* pHeapObj,
                                               GMM_GFX_SIZE_T AllocSize)
 {
-    GMM_GFX_ADDRESS GfxAddr;
-    ULONG BaseAlignment = GMM_HEAP_ALIGN_SIZE;
-    ULONG HeapType = GMM_OTHER_HEAP;
+    GMM_GFX_ADDRESS GfxAddr = 0;
+    ULONG BaseAlignment;
+    BOOLEAN Success;
 
-    if( !pHeapObj || (AllocSize > (pHeapObj->FreeSize)))
+    if( !pHeapObj )
     {
         __GMM_ASSERT(0);
         return 0;
     }
 
-    HeapType = pHeapObj->HeapType & HEAP_TYPE_MASK;
+#if GMM_HEAP_THREAD_CACHE
+    if (__GmmUmMagazineAlloc(pHeapObj, AllocSize, &GfxAddr))
+    {
+        return GfxAddr;
+    }
+#endif
+
+    BaseAlignment = __GmmUmHeapAlignment(pHeapObj);
+
+    Success = (AllocSize <= __GMM_HEAP_STAT_GET(pHeapObj->FreeSize)) &&
+              __GmmAllocAlignHeapBlockGfxAddress(NULL, pHeapObj, AllocSize, BaseAlignment, &GfxAddr);
+
+#if GMM_HEAP_THREAD_CACHE
+    if (!Success && __GmmUmDrainMagazines(pHeapObj))
+    {   // Heap was only short of blocks parked in thread magazines--retry.
+        Success = (AllocSize <= __GMM_HEAP_STAT_GET(pHeapObj->FreeSize)) &&
+                  __GmmAllocAlignHeapBlockGfxAddress(NULL, pHeapObj, AllocSize, BaseAlignment, &GfxAddr);
+    }
+#endif
 
-    switch (HeapType)
+    if (!Success)
     {
-    case GMM_TRVA_HEAP:
-        BaseAlignment = GMM_TRVA_HEAP_ALIGN_SIZE;
-        break;
-    case GMM_FLAT_HEAP:
-        BaseAlignment = GMM_FLAT_HEAP_ALIGN_SIZE;
-        break;
-    default:
-        BaseAlignment = GMM_HEAP_ALIGN_SIZE;    //Align to 1B by default
-        break;
+        __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFailedAllocs, 1);
     }
-    __GmmAllocAlignHeapBlockGfxAddress(NULL, pHeapObj, AllocSize, BaseAlignment, &GfxAddr);
 
-    return GfxAddr;
+    return Success ? GfxAddr : 0;
 }
 
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -904,7 +1899,8 @@ Function:
     GmmFreeHeapVA
 
 Description:
-    The function frees the previously reserved VA range from the heap
+    The function frees the previously reserved VA range from the heap (or,
+    for the common small sizes, to the calling thread's magazine)
 
 Arguments:
     pHeapObj ==> Ptr to HeapObj
@@ -926,13 +1922,70 @@ GMM_STATUS GMM_STDCALL GmmFreeHeapVA(GMM_HEAP* pHeapObj,
         return Status;
     }
 
+#if GMM_HEAP_THREAD_CACHE
+    if (__GmmUmMagazineFree(pHeapObj, AllocVA, AllocSize))
+    {
+        return Status;
+    }
+#endif
+
     __GmmFreeHeapBlockGfxAddress(NULL, pHeapObj, AllocVA, AllocSize);
 	return Status;
 }
-#endif
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    GmmHeapGetStats
+
+Description:
+    The function returns the heap's occupancy and fragmentation statistics.
+    These are kept up to date, atomically, as blocks are allocated and
+    freed, so this only reads them--without locking the heap. (Counters
+    are read one at a time, so a snapshot taken during allocs/frees on
+    other threads can be mid-update.)
+
+Arguments:
+    pHeapObj ==> Ptr to HeapObj
+    pStats ==> Returned statistics
+
+Return:
+    Status ==> GMM_SUCCESS or GMM_ERROR
+---------------------------------------------------------------------------*/
+GMM_STATUS GMM_STDCALL GmmHeapGetStats(GMM_HEAP *pHeapObj,
+                                       GMM_HEAP_STATS *pStats)
+{
+    uint32_t Bucket;
+
+    if (!pHeapObj || !pStats)
+    {
+        __GMM_ASSERT(0);
+        return GMM_ERROR;
+    }
+
+    pStats->Size = pHeapObj->Size;
+    pStats->FreeSize = __GMM_HEAP_STAT_GET(pHeapObj->FreeSize);
+    pStats->LargestFreeBlock = __GMM_HEAP_STAT_GET(pHeapObj->Stats.LargestFreeBlock);
+    pStats->NumFreeBlocks = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumFreeBlocks);
+    for (Bucket = 0; Bucket < GMM_HEAP_STATS_NUM_BUCKETS; Bucket++)
+    {
+        pStats->FreeBlockHistogram[Bucket] = __GMM_HEAP_STAT_GET(pHeapObj->Stats.FreeBlockHistogram[Bucket]);
+    }
+
+    pStats->NumAllocs = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumAllocs);
+    pStats->NumFailedAllocs = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumFailedAllocs);
+    pStats->NumFrees = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumFrees);
+    pStats->NumCachedAllocs = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumCachedAllocs);
+    pStats->NumCachedFrees = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumCachedFrees);
+
+    pStats->NumSearches = __GMM_HEAP_STAT_GET(pHeapObj->Stats.NumSearches);
+    pStats->SearchSteps = __GMM_HEAP_STAT_GET(pHeapObj->Stats.SearchSteps);
+    pStats->AverageSearchLength = pStats->NumSearches ? ((double) pStats->SearchSteps / pStats->NumSearches) : 0.0;
+
+    return GMM_SUCCESS;
+}
 #endif
 
-#if _WIN32
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 Function:
@@ -978,12 +2031,22 @@ GMM_STATUS __GmmSetupHeap(GMM_CONTEXT *pGmmContext,
 #else
     pHeapObj->HeapType = Flags;
     pHeapObj->NumContexts = 0;
-    InitializeCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_LOCK_INIT(pHeapObj);
 #endif
 
     // setup the linked list and other init stuff.
-    if (GMM_SUCCESS ==
-        (Status = __GmmInitHeap(pGmmContext, pHeapObj)))
+#if !__GMM_KMD__
+    if ((Flags & HEAP_TYPE_MASK) == GMM_BUDDY_HEAP)
+    {
+        Status = __GmmUmInitBuddyHeap(pHeapObj);
+    }
+    else
+#endif
+    {
+        Status = __GmmInitHeap(pGmmContext, pHeapObj);
+    }
+
+    if (Status == GMM_SUCCESS)
     {
 #if !__GMM_KMD__
         pHeapObj->NumContexts++;
@@ -1040,8 +2103,8 @@ GMM_STATUS __GmmInitHeap(GMM_CONTEXT  *pGmmContext,
         &(pGmmContext->HeapNodeMgmt));
 #else
     GMM_UNREFERENCED_PARAMETER(pGmmContext);
-    EnterCriticalSection(&(pHeapObj->Lock));
-    pNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&(pHeapObj->pHeapNodePool));
+    __GMM_UM_HEAP_LOCK(pHeapObj);
+    pNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&pHeapObj->NodePool);
 #endif
     if (!pNode)
     {
@@ -1049,6 +2112,8 @@ GMM_STATUS __GmmInitHeap(GMM_CONTEXT  *pGmmContext,
         goto GMM_INIT_HEAP_EXIT;
     }
 
+    __GmmHeapIndexInit(pHeapObj);
+
     pHeapObj->pFreeHeap = pNode;
     pNode->BlockAddr = 0;
     pNode->BlockSize = 0;
@@ -1059,7 +2124,7 @@ GMM_STATUS __GmmInitHeap(GMM_CONTEXT  *pGmmContext,
     pNode = (GMM_HEAPNODE*)__GmmAllocNode(pGmmContext,
         &(pGmmContext->HeapNodeMgmt));
 #else
-    pNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&(pHeapObj->pHeapNodePool));
+    pNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&pHeapObj->NodePool);
 #endif
     if (!pNode)
     {
@@ -1072,13 +2137,14 @@ GMM_STATUS __GmmInitHeap(GMM_CONTEXT  *pGmmContext,
     pNode->BlockSize = pHeapObj->Size;
     pNode->pPrev = pHeapObj->pFreeHeap;
     pNode->pNext = NULL;
+    __GmmHeapIndexInsert(pHeapObj, pNode);
 
     // [3] initalize last dummyblock
 #if __GMM_KMD__
     pNode = (GMM_HEAPNODE*)__GmmAllocNode(pGmmContext,
         &(pGmmContext->HeapNodeMgmt));
 #else
-    pNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&(pHeapObj->pHeapNodePool));
+    pNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&pHeapObj->NodePool);
 #endif
     if (!pNode)
     {
@@ -1100,7 +2166,7 @@ GMM_INIT_HEAP_EXIT:
         GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
     }
 #else
-    LeaveCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
 #endif
 
     GMM_DPF_EXIT;
@@ -1137,7 +2203,6 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
     GMM_GFX_ADDRESS     CurrBlockStartAddr;
     GMM_GFX_ADDRESS     CurrBlockEndAddr;
     GMM_GFX_ADDRESS     NextBlockStartAddr;
-    GMM_GFX_ADDRESS     NextBlockEndAddr;
     GMM_HEAPNODE        *pTmpNode;
     GMM_HEAPNODE        *pNewNode;
     GMM_HEAPNODE        *pNextNode;
@@ -1150,6 +2215,14 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
     __GMM_ASSERT(pHeapObj);
     __GMM_ASSERT(Size);
 
+#if !__GMM_KMD__
+    if ((pHeapObj->HeapType & HEAP_TYPE_MASK) == GMM_BUDDY_HEAP)
+    {
+        __GmmUmFreeBuddyBlock(pHeapObj, GfxAddress, Size);
+        return;
+    }
+#endif
+
     GMM_DPF_ENTER;
 
 #if __GMM_KMD__
@@ -1160,7 +2233,7 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
     }
 #else
     GMM_UNREFERENCED_PARAMETER(pGmmContext);
-    EnterCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_LOCK(pHeapObj);
 #endif
 
     __GMM_ASSERT( // GfxAddress belongs to pHeapObj...
@@ -1169,17 +2242,20 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
 
     Addr  = GfxAddress;                  // Free memory block start address
     End   = Addr + Size;                 // Free memory block end addrss
-    pNode = pHeapObj->pFreeHeap;         // The first node (pFreeHeap) is "BlockAddr: 0, BlockSize: 0"
 
-    while (pNode)
+    // Free block immediately below the freed range (or the list head sentinel,
+    // "BlockAddr: 0, BlockSize: 0", if none)--the freed range goes right after it.
+    pNode = __GmmHeapFindPrevFreeBlock(pHeapObj, Addr);
+    pNextNode = pNode->pNext;
+
+    CurrBlockStartAddr = pNode->BlockAddr;
+    CurrBlockEndAddr   = pNode->BlockAddr + pNode->BlockSize;
+    NextBlockStartAddr = pNextNode ? pNextNode->BlockAddr : GMM_GFX_ADDRESS_MAX;
+
+    do
     {
-        CurrBlockStartAddr = pNode->BlockAddr;
-        CurrBlockEndAddr   = pNode->BlockAddr + pNode->BlockSize;
-        NextBlockStartAddr = 0;
-        NextBlockEndAddr   = 0;
-        pTmpNode           = NULL;
-        pNewNode           = NULL;
-        pNextNode          = NULL;
+        pTmpNode = NULL;
+        pNewNode = NULL;
 
         // Validate free memory range
         // -----------------------------------------
@@ -1187,7 +2263,10 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
         // -----------------------------------------
         //            | Free Mem |
         //            ------------
-        if (Addr < CurrBlockEndAddr && Addr >= CurrBlockStartAddr)
+        //                      | Free Mem |
+        //                      ------------
+        if ((pNode != pHeapObj->pFreeHeap && Addr < CurrBlockEndAddr && Addr >= CurrBlockStartAddr) ||
+            (End > NextBlockStartAddr))
         {
 #if __GMM_KMD__
             GMMReleaseMessage(GFXDBG_CRITICAL, "__GmmFreeHeapBlockGfxAddress(): Invalid Free Memory Range.");
@@ -1195,40 +2274,21 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
             __GMM_ASSERT(0);
             break;
         }
-        
-        // -----------------------------------------
-        // | Current Node Mem |    | Next Node Mem |
-        // -----------------------------------------
-        //                      | Free Mem |
-        //                      ------------
-        if (pNode->pNext != NULL)
-        {
-            NextBlockStartAddr = pNode->pNext->BlockAddr;
-            NextBlockEndAddr   = pNode->pNext->BlockAddr + pNode->pNext->BlockSize;
-
-            if (End > NextBlockStartAddr && End <= NextBlockEndAddr)
-            {
-#if __GMM_KMD__
-                GMMReleaseMessage(GFXDBG_CRITICAL, "__GmmFreeHeapBlockGfxAddress(): Invalid Free Memory Range.");
-#endif
-                __GMM_ASSERT(0);
-                break;
-            }
-        }
 
         //    ------------------------------------------------------
         // 1) | Current Node Mem | Free Mem |      | Next Node Mem |
         //    ------------------------------------------------------
-        if (Addr == CurrBlockEndAddr && pNode->BlockAddr != 0 && pNode->BlockSize != 0)
+        if (Addr == CurrBlockEndAddr && pNode != pHeapObj->pFreeHeap)
         {
             pNode->BlockSize += Size;
 
             //    ----------------------------------------------
             //    | Current Node Mem | Free Mem | Next Node Mem|
             //    ----------------------------------------------
-            if (pNode->pNext != NULL && End == NextBlockStartAddr)
+            if (pNextNode != NULL && pNextNode->BlockSize != 0 && End == NextBlockStartAddr)
             {
-                pTmpNode            = pNode->pNext;
+                pTmpNode            = pNextNode;
+                __GmmHeapIndexRemove(pHeapObj, pTmpNode);
                 pNode->BlockSize   += pTmpNode->BlockSize;
                 pNode->pNext        = pTmpNode->pNext;
                 pNode->pNext->pPrev = pNode;
@@ -1236,11 +2296,27 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
 #if __GMM_KMD__
                 __GmmFreeNode(pGmmContext, &pGmmContext->HeapNodeMgmt, pTmpNode);
 #else
-                __GmmUmFreeNode(&(pHeapObj->pHeapNodePool), pTmpNode);
+                __GmmUmFreeNode(&pHeapObj->NodePool, pTmpNode);
 #endif
             }
 
-            pHeapObj->FreeSize += Size;
+            __GmmHeapIndexUpdate(pHeapObj, pNode);
+            __GMM_HEAP_STAT_ADD(pHeapObj->FreeSize, Size);
+            __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFrees, 1);
+            break;
+        }
+
+        //    ----------------------------------------------------
+        // 3) | Current Node Mem |     | Free Mem | Next Node Mem|
+        //    ----------------------------------------------------
+        else if (pNextNode != NULL && pNextNode->BlockSize != 0 && End == NextBlockStartAddr)
+        {
+            pNextNode->BlockAddr  = Addr;
+            pNextNode->BlockSize += Size;
+            __GmmHeapIndexUpdate(pHeapObj, pNextNode);
+
+            __GMM_HEAP_STAT_ADD(pHeapObj->FreeSize, Size);
+            __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFrees, 1);
             break;
         }
 
@@ -1251,13 +2327,13 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
         //    -------------------------------------
         //    | Current Node Mem |     | Free Mem |
         //    -------------------------------------
-        else if (Addr > CurrBlockEndAddr && (End < NextBlockStartAddr || pNode->pNext == NULL))
+        else
         {
 #if __GMM_KMD__
             pNewNode = (GMM_HEAPNODE *)__GmmAllocNode(pGmmContext,
                 &pGmmContext->HeapNodeMgmt);
 #else
-            pNewNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&(pHeapObj->pHeapNodePool));
+            pNewNode = (GMM_HEAPNODE*)__GmmUmAllocNode(&pHeapObj->NodePool);
 #endif
 
             if (pNewNode == NULL)
@@ -1271,7 +2347,7 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
 
             pNewNode->BlockAddr = Addr;
             pNewNode->BlockSize = Size;
-            pNewNode->pNext     = pNode->pNext;
+            pNewNode->pNext     = pNextNode;
 
             if (pNewNode->pNext != NULL)
             {
@@ -1281,25 +2357,12 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
             pNode->pNext    = pNewNode;
             pNewNode->pPrev = pNode;
 
-            pHeapObj->FreeSize += Size;
+            __GmmHeapIndexInsert(pHeapObj, pNewNode);
+            __GMM_HEAP_STAT_ADD(pHeapObj->FreeSize, Size);
+            __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumFrees, 1);
             break;
         }
-
-        //    ----------------------------------------------------
-        // 3) | Current Node Mem |     | Free Mem | Next Node Mem|
-        //    ----------------------------------------------------
-        else if (pNode->pNext != NULL && End == NextBlockStartAddr)
-        {
-            pNextNode             = pNode->pNext;
-            pNextNode->BlockAddr  = Addr;
-            pNextNode->BlockSize += Size;
-
-            pHeapObj->FreeSize += Size;
-            break;
-        }
-
-        pNode = pNode->pNext;
-    }
+    } while (0);
 
 #if __GMM_KMD__
     if((pHeapObj->HeapCaps & GMM_HEAP_EXTERNAL_SYNC) == 0) 
@@ -1307,7 +2370,7 @@ void __GmmFreeHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
         GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
     }
 #else
-    LeaveCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
 #endif
 
     GMM_DPF_EXIT;
@@ -1355,6 +2418,14 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
     __GMM_ASSERT(AlignValue);
     __GMM_ASSERT(pGfxAddress);
 
+#if !__GMM_KMD__
+    if ((pHeapObj->HeapType & HEAP_TYPE_MASK) == GMM_BUDDY_HEAP)
+    {   // Blocks are aligned to their (power-of-two) size.
+        __GMM_ASSERT(AlignValue <= GMM_BUDDY_HEAP_ALIGN_SIZE);
+        return __GmmUmAllocBuddyBlock(pHeapObj, Size, pGfxAddress);
+    }
+#endif
+
     GMM_DPF_ENTER;
 
 #if __GMM_KMD__
@@ -1365,44 +2436,18 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
     }
 #else
     GMM_UNREFERENCED_PARAMETER(pGmmContext);
-    EnterCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_LOCK(pHeapObj);
 #endif
 
-    { // Get Best-Fit Free Node...
-        GMM_HEAPNODE    *pBestNode, *pCurrNode;
-        GMM_GFX_SIZE_T  PaddedSize;
-
-		// Validate pFreeHeap before use
-		if (pHeapObj->pFreeHeap == NULL)
-		{
-			Success = FALSE;
-			goto End;
-		}
-		pCurrNode = pHeapObj->pFreeHeap->pNext;
-        pBestNode = NULL;
-        while (pCurrNode) 
-        {
-            BlockAddr = pCurrNode->BlockAddr;
-            PaddedSize = Size + (GFX_ALIGN_NP2(BlockAddr, AlignValue) - BlockAddr);
-
-            // find node which has size larger than requested
-            if (pCurrNode->BlockSize >= PaddedSize) 
-            {
-                // First: check if this is first node we found if so, then that is best fit for now
-                // Second: If not first time then check if still old node is best fit. if not then 
-                //         replace it with new node
-                if ( (pBestNode == NULL) || 
-                     ( (pBestNode != NULL) && (pBestNode->BlockSize >= pCurrNode->BlockSize))) 
-                {
-                    pBestNode = pCurrNode;  
-                }
-            }
-            pCurrNode = pCurrNode->pNext;
-        }
-
-        pNode = pBestNode;
+    // Validate pFreeHeap before use
+    if (pHeapObj->pFreeHeap == NULL)
+    {
+        Success = FALSE;
+        goto End;
     }
 
+    pNode = __GmmHeapFindFit(pHeapObj, Size, AlignValue);
+
     if (pNode != NULL) 
     {
         BlockAddr = pNode->BlockAddr;
@@ -1423,9 +2468,11 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
         if (pNode->BlockSize > 0)
         {
             pNode->BlockAddr = pNode->BlockAddr + Size;        //there is space left
+            __GmmHeapIndexUpdate(pHeapObj, pNode);
         }
         else
         {   //whole block out, eliminate this node
+            __GmmHeapIndexRemove(pHeapObj, pNode);
 			if (pNode->pPrev != NULL)
 			{
 				pNode->pPrev->pNext = pNode->pNext;
@@ -1439,7 +2486,7 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
 #if __GMM_KMD__
             __GmmFreeNode(pGmmContext, &pGmmContext->HeapNodeMgmt, pNode);
 #else
-            __GmmUmFreeNode(&(pHeapObj->pHeapNodePool), pNode);
+            __GmmUmFreeNode(&pHeapObj->NodePool, pNode);
 #endif
         }
     } //it is some place in middle
@@ -1450,7 +2497,7 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
         pNode1 = (GMM_HEAPNODE *) __GmmAllocNode(pGmmContext, 
                                          &pGmmContext->HeapNodeMgmt);
 #else
-        pNode1 = (GMM_HEAPNODE*)__GmmUmAllocNode(&(pHeapObj->pHeapNodePool));
+        pNode1 = (GMM_HEAPNODE*)__GmmUmAllocNode(&pHeapObj->NodePool);
 #endif
 
         if ( pNode1 == NULL )
@@ -1479,9 +2526,11 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
         if (pNode->BlockSize > 0)
         {
             pNode->BlockAddr = AlignAddr + Size;        //there is space left
+            __GmmHeapIndexUpdate(pHeapObj, pNode);
         }
         else
         {   //whole block out, eliminate this node
+            __GmmHeapIndexRemove(pHeapObj, pNode);
 			if (pNode->pPrev != NULL)
 			{
 				pNode->pPrev->pNext = pNode->pNext;
@@ -1493,12 +2542,15 @@ BOOLEAN __GmmAllocAlignHeapBlockGfxAddress(GMM_CONTEXT *pGmmContext,
 #if __GMM_KMD__
             __GmmFreeNode(pGmmContext, &pGmmContext->HeapNodeMgmt, pNode);
 #else
-            __GmmUmFreeNode(&(pHeapObj->pHeapNodePool), pNode);
+            __GmmUmFreeNode(&pHeapObj->NodePool, pNode);
 #endif
         }
+
+        __GmmHeapIndexInsert(pHeapObj, pNode1);
     }
     
-    pHeapObj->FreeSize -= Size;
+    __GMM_HEAP_STAT_SUB(pHeapObj->FreeSize, Size);
+    __GMM_HEAP_STAT_ADD(pHeapObj->Stats.NumAllocs, 1);
 
     __GMM_ASSERT( // Block belongs to pHeapObj...
         (AlignAddr >= pHeapObj->BaseAddress) && 
@@ -1513,11 +2565,10 @@ End:
         GMM_EXIT_CRITICAL_SECTION(OldIrql, &pHeapObj->Lock, &LockHandle);
     }
 #else
-    LeaveCriticalSection(&(pHeapObj->Lock));
+    __GMM_UM_HEAP_UNLOCK(pHeapObj);
 #endif
 
     GMM_DPF_EXIT;
 
     return(Success);
-} // __GmmAllocAlignHeapBlockGfxAddress
-#endif
\ No newline at end of file
+} // __GmmAllocAlignHeapBlockGfxAddress
\ No newline at end of file
@@ -0,0 +1,380 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "External/Common/GmmHeapBuddy.h"
+
+// Binary buddy allocator, backing GMM_BUDDY_HEAP's: power-of-two, naturally
+// aligned blocks, split and merged in constant time via per-order bitmaps.
+
+#define __GMM_HEAP_BUDDY_WORD(Bit)                      ((Bit) / 64)
+#define __GMM_HEAP_BUDDY_MASK(Bit)                      (1ull << ((Bit) % 64))
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddySetBit
+
+Description:
+    Sets a bitmap bit, and its summary bits in the levels above.
+
+Arguments:
+    pBitmap ==> ptr to bitmap
+    Bit ==> bit to set (must be clear)
+
+Return:
+    Non-zero if bitmap was empty
+---------------------------------------------------------------------------*/
+static int __GmmHeapBuddySetBit(GMM_HEAP_BUDDY_BITMAP *pBitmap, uint64_t Bit)
+{
+    uint32_t Level;
+
+    for (Level = 0; Level < pBitmap->NumLevels; Level++)
+    {
+        uint64_t *pWord = &pBitmap->pLevel[Level][__GMM_HEAP_BUDDY_WORD(Bit)];
+        uint64_t Word = *pWord;
+
+        *pWord = Word | __GMM_HEAP_BUDDY_MASK(Bit);
+        if (Word)
+        {
+            return 0; // Summary bits already set.
+        }
+        Bit = __GMM_HEAP_BUDDY_WORD(Bit);
+    }
+
+    return 1;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddyClearBit
+
+Description:
+    Clears a bitmap bit, and the summary bits of words it leaves empty.
+
+Arguments:
+    pBitmap ==> ptr to bitmap
+    Bit ==> bit to clear (must be set)
+
+Return:
+    Non-zero if bitmap is now empty
+---------------------------------------------------------------------------*/
+static int __GmmHeapBuddyClearBit(GMM_HEAP_BUDDY_BITMAP *pBitmap, uint64_t Bit)
+{
+    uint32_t Level;
+
+    for (Level = 0; Level < pBitmap->NumLevels; Level++)
+    {
+        uint64_t *pWord = &pBitmap->pLevel[Level][__GMM_HEAP_BUDDY_WORD(Bit)];
+
+        *pWord &= ~__GMM_HEAP_BUDDY_MASK(Bit);
+        if (*pWord)
+        {
+            return 0;
+        }
+        Bit = __GMM_HEAP_BUDDY_WORD(Bit);
+    }
+
+    return 1;
+}
+
+static int __GmmHeapBuddyTestBit(const uint64_t *pWords, uint64_t Bit)
+{
+    return (pWords[__GMM_HEAP_BUDDY_WORD(Bit)] & __GMM_HEAP_BUDDY_MASK(Bit)) != 0;
+}
+
+// Lowest set bit of non-empty bitmap, found top level down.
+static uint64_t __GmmHeapBuddyFindFirst(const GMM_HEAP_BUDDY_BITMAP *pBitmap)
+{
+    uint64_t Bit = 0;
+    uint32_t Level = pBitmap->NumLevels;
+
+    while (Level--)
+    {
+        Bit = Bit * 64 + __GmmHeapBuddyLowBit(pBitmap->pLevel[Level][Bit]);
+    }
+
+    return Bit;
+}
+
+// Marks order's block free.
+static void __GmmHeapBuddyPush(GMM_HEAP_BUDDY *pBuddy, uint32_t Order, uint64_t Block)
+{
+    pBuddy->NumFree[Order]++;
+    if (__GmmHeapBuddySetBit(&pBuddy->Free[Order], Block))
+    {
+        pBuddy->OrderMask |= 1ull << Order;
+    }
+}
+
+// Marks order's block not free.
+static void __GmmHeapBuddyPop(GMM_HEAP_BUDDY *pBuddy, uint32_t Order, uint64_t Block)
+{
+    pBuddy->NumFree[Order]--;
+    if (__GmmHeapBuddyClearBit(&pBuddy->Free[Order], Block))
+    {
+        pBuddy->OrderMask &= ~(1ull << Order);
+    }
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddyInit
+
+Description:
+    Initializes a buddy allocator to manage [0, Size), all free--as the
+    largest aligned blocks that tile the range. Tail bytes short of an order
+    0 block are not managed.
+
+Arguments:
+    pBuddy ==> ptr to allocator
+    Size ==> bytes managed
+    MinBlockSize ==> order 0 block size (power of two)
+
+Return:
+    Non-zero on success; zero if out of memory or sizes invalid (Size less
+    than one or at least 2^GMM_HEAP_BUDDY_MAX_ORDERS order 0 blocks).
+---------------------------------------------------------------------------*/
+int __GmmHeapBuddyInit(GMM_HEAP_BUDDY *pBuddy, uint64_t Size, uint64_t MinBlockSize)
+{
+    uint64_t NumWords = 0, Block, *pWords;
+    uint32_t Order, Level;
+
+    memset(pBuddy, 0, sizeof(*pBuddy));
+
+    if (!MinBlockSize || (MinBlockSize & (MinBlockSize - 1)))
+    {
+        return 0;
+    }
+
+    pBuddy->MinShift = __GmmHeapBuddyHighBit(MinBlockSize);
+    pBuddy->NumBlocks = Size >> pBuddy->MinShift;
+    if (!pBuddy->NumBlocks ||
+        (pBuddy->NumBlocks >> GMM_HEAP_BUDDY_MAX_ORDERS))
+    {
+        return 0;
+    }
+    pBuddy->MaxOrder = __GmmHeapBuddyHighBit(pBuddy->NumBlocks);
+
+    // Size the bitmaps and carve them out of one allocation...
+    for (Order = 0; Order <= pBuddy->MaxOrder; Order++)
+    {
+        uint64_t NumBits = pBuddy->NumBlocks >> Order;
+
+        NumWords += (NumBits + 63) / 64; // pAllocated
+        do
+        {
+            NumBits = (NumBits + 63) / 64;
+            NumWords += NumBits;
+        } while (NumBits > 1);
+    }
+
+    pBuddy->pStorage = (uint64_t *) calloc((size_t) NumWords, sizeof(uint64_t));
+    if (!pBuddy->pStorage)
+    {
+        return 0;
+    }
+
+    pWords = pBuddy->pStorage;
+    for (Order = 0; Order <= pBuddy->MaxOrder; Order++)
+    {
+        uint64_t NumBits = pBuddy->NumBlocks >> Order;
+
+        pBuddy->pAllocated[Order] = pWords;
+        pWords += (NumBits + 63) / 64;
+
+        Level = 0;
+        do
+        {
+            NumBits = (NumBits + 63) / 64;
+            pBuddy->Free[Order].pLevel[Level++] = pWords;
+            pWords += NumBits;
+        } while (NumBits > 1);
+        pBuddy->Free[Order].NumLevels = Level;
+    }
+
+    // ...then free the range, largest aligned blocks first.
+    for (Block = 0; Block < pBuddy->NumBlocks; Block += 1ull << Order)
+    {
+        Order = pBuddy->MaxOrder;
+        while ((Block & ((1ull << Order) - 1)) ||
+               (Block + (1ull << Order) > pBuddy->NumBlocks))
+        {
+            Order--;
+        }
+
+        __GmmHeapBuddyPush(pBuddy, Order, Block >> Order);
+    }
+
+    return 1;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddyDestroy
+
+Description:
+    Releases a buddy allocator's bitmaps.
+
+Arguments:
+    pBuddy ==> ptr to allocator
+
+Return:
+    VOID
+---------------------------------------------------------------------------*/
+void __GmmHeapBuddyDestroy(GMM_HEAP_BUDDY *pBuddy)
+{
+    free(pBuddy->pStorage);
+    memset(pBuddy, 0, sizeof(*pBuddy));
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddyOrder
+
+Description:
+    Order of smallest block holding given size.
+
+Arguments:
+    pBuddy ==> ptr to allocator
+    Size ==> bytes
+
+Return:
+    Order; greater than MaxOrder if Size is zero or exceeds largest block.
+---------------------------------------------------------------------------*/
+uint32_t __GmmHeapBuddyOrder(const GMM_HEAP_BUDDY *pBuddy, uint64_t Size)
+{
+    uint64_t NumBlocks;
+
+    if (!Size || !pBuddy->NumBlocks)
+    {
+        return GMM_HEAP_BUDDY_MAX_ORDERS;
+    }
+
+    NumBlocks = (Size >> pBuddy->MinShift) + ((Size & ((1ull << pBuddy->MinShift) - 1)) != 0);
+    if (NumBlocks > (1ull << pBuddy->MaxOrder))
+    {
+        return GMM_HEAP_BUDDY_MAX_ORDERS;
+    }
+
+    return (NumBlocks > 1) ? (__GmmHeapBuddyHighBit(NumBlocks - 1) + 1) : 0;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddyAlloc
+
+Description:
+    Allocates a block of given order: the lowest free block of the smallest
+    order that has one, split down as needed, freeing the upper halves.
+
+Arguments:
+    pBuddy ==> ptr to allocator
+    Order ==> block order
+    pOffset ==> returns block offset (aligned to block size)
+
+Return:
+    Non-zero on success; zero if no block large enough is free.
+---------------------------------------------------------------------------*/
+int __GmmHeapBuddyAlloc(GMM_HEAP_BUDDY *pBuddy, uint32_t Order, uint64_t *pOffset)
+{
+    uint64_t Block;
+    uint32_t FreeOrder;
+
+    if ((Order > pBuddy->MaxOrder) ||
+        !(pBuddy->OrderMask >> Order))
+    {
+        return 0;
+    }
+
+    FreeOrder = Order + __GmmHeapBuddyLowBit(pBuddy->OrderMask >> Order);
+    Block = __GmmHeapBuddyFindFirst(&pBuddy->Free[FreeOrder]);
+    __GmmHeapBuddyPop(pBuddy, FreeOrder, Block);
+
+    while (FreeOrder > Order)
+    {
+        FreeOrder--;
+        Block <<= 1;
+        __GmmHeapBuddyPush(pBuddy, FreeOrder, Block + 1);
+    }
+
+    pBuddy->pAllocated[Order][__GMM_HEAP_BUDDY_WORD(Block)] |= __GMM_HEAP_BUDDY_MASK(Block);
+
+    *pOffset = Block << (Order + pBuddy->MinShift);
+
+    return 1;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapBuddyFree
+
+Description:
+    Frees a block, merging it with its buddy for as long as that is free.
+
+Arguments:
+    pBuddy ==> ptr to allocator
+    Offset ==> block offset
+    Order ==> block order (as allocated)
+
+Return:
+    Non-zero on success; zero if block is not allocated (at that order).
+---------------------------------------------------------------------------*/
+int __GmmHeapBuddyFree(GMM_HEAP_BUDDY *pBuddy, uint64_t Offset, uint32_t Order)
+{
+    uint64_t Block;
+
+    if ((Order > pBuddy->MaxOrder) ||
+        (Offset & ((1ull << (Order + pBuddy->MinShift)) - 1)))
+    {
+        return 0;
+    }
+
+    Block = Offset >> (Order + pBuddy->MinShift);
+    if ((Block >= (pBuddy->NumBlocks >> Order)) ||
+        !__GmmHeapBuddyTestBit(pBuddy->pAllocated[Order], Block))
+    {
+        return 0;
+    }
+
+    pBuddy->pAllocated[Order][__GMM_HEAP_BUDDY_WORD(Block)] &= ~__GMM_HEAP_BUDDY_MASK(Block);
+
+    while ((Order < pBuddy->MaxOrder) &&
+           ((Block ^ 1) < (pBuddy->NumBlocks >> Order)) &&
+           __GmmHeapBuddyTestBit(pBuddy->Free[Order].pLevel[0], Block ^ 1))
+    {
+        __GmmHeapBuddyPop(pBuddy, Order, Block ^ 1);
+        Block >>= 1;
+        Order++;
+    }
+
+    __GmmHeapBuddyPush(pBuddy, Order, Block);
+
+    return 1;
+}
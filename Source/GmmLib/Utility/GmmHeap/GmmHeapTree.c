@@ -0,0 +1,428 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#include "External/Common/GmmHeapTree.h"
+
+// Intrusive AVL tree, indexing GMM_HEAP free blocks by address and by size, so
+// best-fit allocation and free-time coalescing needn't walk the free list.
+
+#define __GMM_HEAP_TREE_HEIGHT(pLink)   ((pLink) ? (pLink)->Height : 0)
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeUpdateHeight
+
+Description:
+    Recomputes a link's subtree height from its children's.
+
+Arguments:
+    pLink ==> ptr to link
+
+Return:
+    Balance factor (left height - right height)
+---------------------------------------------------------------------------*/
+static int __GmmHeapTreeUpdateHeight(GMM_HEAP_TREE_LINK *pLink)
+{
+    int LeftHeight = __GMM_HEAP_TREE_HEIGHT(pLink->pLeft);
+    int RightHeight = __GMM_HEAP_TREE_HEIGHT(pLink->pRight);
+
+    pLink->Height = 1 + ((LeftHeight > RightHeight) ? LeftHeight : RightHeight);
+
+    return LeftHeight - RightHeight;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeReplaceChild
+
+Description:
+    Makes pNew take pOld's place as child of pParent (or as root).
+
+Arguments:
+    pTree   ==> ptr to tree
+    pParent ==> ptr to parent of pOld, NULL if pOld is root
+    pOld    ==> ptr to link being replaced
+    pNew    ==> ptr to replacement link (may be NULL)
+
+Return:
+    N/A
+---------------------------------------------------------------------------*/
+static void __GmmHeapTreeReplaceChild(GMM_HEAP_TREE        *pTree,
+                                      GMM_HEAP_TREE_LINK   *pParent,
+                                      GMM_HEAP_TREE_LINK   *pOld,
+                                      GMM_HEAP_TREE_LINK   *pNew)
+{
+    if (!pParent)
+    {
+        pTree->pRoot = pNew;
+    }
+    else if (pParent->pLeft == pOld)
+    {
+        pParent->pLeft = pNew;
+    }
+    else
+    {
+        pParent->pRight = pNew;
+    }
+
+    if (pNew)
+    {
+        pNew->pParent = pParent;
+    }
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeRotate
+
+Description:
+    Rotates the subtree at pLink left (its right child becomes subtree root)
+    or right (its left child does).
+
+Arguments:
+    pTree ==> ptr to tree
+    pLink ==> ptr to root of subtree to rotate
+    Left  ==> Nonzero to rotate left, else right
+
+Return:
+    New root of subtree
+---------------------------------------------------------------------------*/
+static GMM_HEAP_TREE_LINK *__GmmHeapTreeRotate(GMM_HEAP_TREE       *pTree,
+                                               GMM_HEAP_TREE_LINK  *pLink,
+                                               int                 Left)
+{
+    GMM_HEAP_TREE_LINK *pPivot = Left ? pLink->pRight : pLink->pLeft;
+    GMM_HEAP_TREE_LINK *pInner = Left ? pPivot->pLeft : pPivot->pRight;
+
+    __GmmHeapTreeReplaceChild(pTree, pLink->pParent, pLink, pPivot);
+
+    if (Left)
+    {
+        pLink->pRight = pInner;
+        pPivot->pLeft = pLink;
+    }
+    else
+    {
+        pLink->pLeft = pInner;
+        pPivot->pRight = pLink;
+    }
+
+    if (pInner)
+    {
+        pInner->pParent = pLink;
+    }
+    pLink->pParent = pPivot;
+
+    __GmmHeapTreeUpdateHeight(pLink);
+    __GmmHeapTreeUpdateHeight(pPivot);
+
+    return pPivot;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeRebalance
+
+Description:
+    Restores heights and AVL balance from pLink up to the root, after an
+    insertion or removal below pLink.
+
+Arguments:
+    pTree ==> ptr to tree
+    pLink ==> ptr to lowest link whose subtree changed (NULL = none)
+
+Return:
+    N/A
+---------------------------------------------------------------------------*/
+static void __GmmHeapTreeRebalance(GMM_HEAP_TREE       *pTree,
+                                   GMM_HEAP_TREE_LINK  *pLink)
+{
+    while (pLink)
+    {
+        int Balance = __GmmHeapTreeUpdateHeight(pLink);
+
+        if (Balance > 1)
+        {
+            if (__GMM_HEAP_TREE_HEIGHT(pLink->pLeft->pLeft) < __GMM_HEAP_TREE_HEIGHT(pLink->pLeft->pRight))
+            {
+                __GmmHeapTreeRotate(pTree, pLink->pLeft, 1); // Left-Right case.
+            }
+            pLink = __GmmHeapTreeRotate(pTree, pLink, 0);
+        }
+        else if (Balance < -1)
+        {
+            if (__GMM_HEAP_TREE_HEIGHT(pLink->pRight->pRight) < __GMM_HEAP_TREE_HEIGHT(pLink->pRight->pLeft))
+            {
+                __GmmHeapTreeRotate(pTree, pLink->pRight, 0); // Right-Left case.
+            }
+            pLink = __GmmHeapTreeRotate(pTree, pLink, 1);
+        }
+
+        pLink = pLink->pParent;
+    }
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeInit
+
+Description:
+    Initializes an empty tree.
+
+Arguments:
+    pTree      ==> ptr to tree
+    pfnCompare ==> Ordering of the tree's nodes
+
+Return:
+    N/A
+---------------------------------------------------------------------------*/
+void __GmmHeapTreeInit(GMM_HEAP_TREE              *pTree,
+                       PFN_GMM_HEAP_TREE_COMPARE  pfnCompare)
+{
+    pTree->pRoot = NULL;
+    pTree->pfnCompare = pfnCompare;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeInsert
+
+Description:
+    Inserts a link into the tree (after any links comparing equal to it).
+
+Arguments:
+    pTree ==> ptr to tree
+    pLink ==> ptr to link of node to insert (not currently in tree)
+
+Return:
+    N/A
+---------------------------------------------------------------------------*/
+void __GmmHeapTreeInsert(GMM_HEAP_TREE         *pTree,
+                         GMM_HEAP_TREE_LINK    *pLink)
+{
+    GMM_HEAP_TREE_LINK *pParent = NULL, **ppChild = &pTree->pRoot;
+
+    while (*ppChild)
+    {
+        pParent = *ppChild;
+        ppChild = (pTree->pfnCompare(pLink, pParent) < 0) ? &pParent->pLeft : &pParent->pRight;
+    }
+
+    pLink->pParent = pParent;
+    pLink->pLeft = pLink->pRight = NULL;
+    pLink->Height = 1;
+    *ppChild = pLink;
+
+    __GmmHeapTreeRebalance(pTree, pParent);
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeRemove
+
+Description:
+    Removes a link from the tree.
+
+Arguments:
+    pTree ==> ptr to tree
+    pLink ==> ptr to link of node to remove (currently in tree)
+
+Return:
+    N/A
+---------------------------------------------------------------------------*/
+void __GmmHeapTreeRemove(GMM_HEAP_TREE         *pTree,
+                         GMM_HEAP_TREE_LINK    *pLink)
+{
+    GMM_HEAP_TREE_LINK *pRebalance;
+
+    if (!pLink->pLeft || !pLink->pRight)
+    {
+        pRebalance = pLink->pParent;
+        __GmmHeapTreeReplaceChild(pTree, pLink->pParent, pLink, pLink->pLeft ? pLink->pLeft : pLink->pRight);
+    }
+    else // Two children--swap in-order successor into link's place...
+    {
+        GMM_HEAP_TREE_LINK *pSuccessor = pLink->pRight;
+
+        while (pSuccessor->pLeft)
+        {
+            pSuccessor = pSuccessor->pLeft;
+        }
+
+        if (pSuccessor->pParent != pLink)
+        {
+            pRebalance = pSuccessor->pParent;
+            __GmmHeapTreeReplaceChild(pTree, pSuccessor->pParent, pSuccessor, pSuccessor->pRight);
+            pSuccessor->pRight = pLink->pRight;
+            pSuccessor->pRight->pParent = pSuccessor;
+        }
+        else
+        {
+            pRebalance = pSuccessor;
+        }
+
+        pSuccessor->pLeft = pLink->pLeft;
+        pSuccessor->pLeft->pParent = pSuccessor;
+        pSuccessor->Height = pLink->Height;
+        __GmmHeapTreeReplaceChild(pTree, pLink->pParent, pLink, pSuccessor);
+    }
+
+    pLink->pParent = pLink->pLeft = pLink->pRight = NULL;
+    pLink->Height = 0;
+
+    __GmmHeapTreeRebalance(pTree, pRebalance);
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeLowerBound
+
+Description:
+    Finds the first link not ordered before a key.
+
+Arguments:
+    pTree ==> ptr to tree
+    pKey  ==> ptr to link of key node (need not be in tree)
+
+Return:
+    First link comparing >= pKey, or NULL if none
+---------------------------------------------------------------------------*/
+GMM_HEAP_TREE_LINK *__GmmHeapTreeLowerBound(const GMM_HEAP_TREE       *pTree,
+                                            const GMM_HEAP_TREE_LINK  *pKey)
+{
+    GMM_HEAP_TREE_LINK *pLink = pTree->pRoot, *pFound = NULL;
+
+    while (pLink)
+    {
+        if (pTree->pfnCompare(pLink, pKey) >= 0)
+        {
+            pFound = pLink;
+            pLink = pLink->pLeft;
+        }
+        else
+        {
+            pLink = pLink->pRight;
+        }
+    }
+
+    return pFound;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeFirst / __GmmHeapTreeLast
+
+Description:
+    Finds the first (or last) link of the tree.
+
+Arguments:
+    pTree ==> ptr to tree
+
+Return:
+    Link, or NULL if tree empty
+---------------------------------------------------------------------------*/
+GMM_HEAP_TREE_LINK *__GmmHeapTreeFirst(const GMM_HEAP_TREE *pTree)
+{
+    GMM_HEAP_TREE_LINK *pLink = pTree->pRoot;
+
+    while (pLink && pLink->pLeft)
+    {
+        pLink = pLink->pLeft;
+    }
+
+    return pLink;
+}
+
+GMM_HEAP_TREE_LINK *__GmmHeapTreeLast(const GMM_HEAP_TREE *pTree)
+{
+    GMM_HEAP_TREE_LINK *pLink = pTree->pRoot;
+
+    while (pLink && pLink->pRight)
+    {
+        pLink = pLink->pRight;
+    }
+
+    return pLink;
+}
+
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+Function:
+    __GmmHeapTreeNext / __GmmHeapTreePrev
+
+Description:
+    Steps to the in-order successor (or predecessor) of a link.
+
+Arguments:
+    pLink ==> ptr to link in a tree
+
+Return:
+    Link, or NULL if pLink is last (or first)
+---------------------------------------------------------------------------*/
+GMM_HEAP_TREE_LINK *__GmmHeapTreeNext(const GMM_HEAP_TREE_LINK *pLink)
+{
+    if (pLink->pRight)
+    {
+        pLink = pLink->pRight;
+        while (pLink->pLeft)
+        {
+            pLink = pLink->pLeft;
+        }
+        return (GMM_HEAP_TREE_LINK *) pLink;
+    }
+
+    while (pLink->pParent && (pLink->pParent->pRight == pLink))
+    {
+        pLink = pLink->pParent;
+    }
+
+    return pLink->pParent;
+}
+
+GMM_HEAP_TREE_LINK *__GmmHeapTreePrev(const GMM_HEAP_TREE_LINK *pLink)
+{
+    if (pLink->pLeft)
+    {
+        pLink = pLink->pLeft;
+        while (pLink->pRight)
+        {
+            pLink = pLink->pRight;
+        }
+        return (GMM_HEAP_TREE_LINK *) pLink;
+    }
+
+    while (pLink->pParent && (pLink->pParent->pLeft == pLink))
+    {
+        pLink = pLink->pParent;
+    }
+
+    return pLink->pParent;
+}
@@ -0,0 +1,237 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#include "Internal/Common/GmmLibInc.h"
+
+#if(!defined(__GMM_KMD__))
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Creates the pool and starts its threads.
+///
+/// @param[in]  NumThreads: Number of threads to create. Zero is legal, in which case
+///                         all submitted tasks are run by the submitting thread.
+/////////////////////////////////////////////////////////////////////////////////////
+GmmLib::WorkerPool::WorkerPool(uint32_t NumThreads) :
+    Exiting(false)
+{
+    for(uint32_t i = 0; i < NumThreads; i++)
+    {
+        try
+        {
+            Threads.emplace_back(&WorkerPool::WorkerMain, this);
+        }
+        catch(...)
+        {
+            break; // Run with however many threads we managed to create.
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Stops and joins the pool's threads, once any Submit'ed tasks have run. Caller 
+/// must ensure no RunTasks call is in flight.
+/////////////////////////////////////////////////////////////////////////////////////
+GmmLib::WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> Locked(Lock);
+        Exiting = true;
+    }
+    WorkAvailable.notify_all();
+
+    for(auto &Thread : Threads)
+    {
+        Thread.join();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the thread count used for a default pool--one less than the number of
+/// hardware threads, since the submitting thread also runs tasks.
+/////////////////////////////////////////////////////////////////////////////////////
+uint32_t GMM_STDCALL GmmLib::WorkerPool::GetDefaultNumThreads()
+{
+    uint32_t NumCpus = std::thread::hardware_concurrency();
+
+    return (NumCpus > 1) ? (NumCpus - 1) : 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Hands out and runs the next task of a pending batch. Must be called with Lock
+/// held; Lock is released while the task runs.
+///
+/// @param[in]  Locked: Lock holder for WorkerPool::Lock
+/// @param[in]  pBatch: Batch in PendingBatches
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::WorkerPool::RunNextTask(std::unique_lock<std::mutex> &Locked, TASK_BATCH *pBatch)
+{
+    uint32_t TaskIndex = pBatch->NextTask++;
+
+    if(pBatch->NextTask == pBatch->NumTasks)
+    {
+        PendingBatches.erase(std::find(PendingBatches.begin(), PendingBatches.end(), pBatch));
+    }
+
+    Locked.unlock();
+    pBatch->pfnTask(pBatch->pTaskContext, TaskIndex);
+    Locked.lock();
+
+    if(++pBatch->NumCompleted == pBatch->NumTasks)
+    {
+        if(pBatch->Detached)
+        {
+            delete pBatch;
+        }
+        else
+        {
+            BatchCompleted.notify_all();
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Thread procedure for pool threads.
+/////////////////////////////////////////////////////////////////////////////////////
+void GmmLib::WorkerPool::WorkerMain()
+{
+    std::unique_lock<std::mutex> Locked(Lock);
+
+    for(;;)
+    {
+        WorkAvailable.wait(Locked, [this] { return Exiting || !PendingBatches.empty(); });
+
+        if(PendingBatches.empty())
+        {
+            break; // Exiting
+        }
+
+        RunNextTask(Locked, PendingBatches.front());
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Runs a batch of independent tasks across the pool and the calling thread, and
+/// returns once all of them have completed. May be called concurrently from
+/// multiple threads.
+///
+/// @param[in]  NumTasks: Number of tasks in batch
+/// @param[in]  pfnTask: Task function, called once per TaskIndex in [0, NumTasks)
+/// @param[in]  pTaskContext: Passed to pfnTask
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::WorkerPool::RunTasks(uint32_t NumTasks, PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext)
+{
+    TASK_BATCH Batch = {pfnTask, pTaskContext, NumTasks, 0, 0, false};
+
+    if(!NumTasks)
+    {
+        return;
+    }
+
+    if((NumTasks == 1) || Threads.empty())
+    {
+        for(uint32_t i = 0; i < NumTasks; i++)
+        {
+            pfnTask(pTaskContext, i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> Locked(Lock);
+
+    PendingBatches.push_back(&Batch);
+    WorkAvailable.notify_all();
+
+    // Help out until all of our tasks are handed out--only ours, so a caller
+    // never ends up running unrelated (e.g. Submit'ed, asynchronous) work...
+    while(Batch.NextTask < Batch.NumTasks)
+    {
+        RunNextTask(Locked, &Batch);
+    }
+
+    // ...then wait for the stragglers.
+    BatchCompleted.wait(Locked, [&Batch] { return Batch.NumCompleted == Batch.NumTasks; });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Queues a single task to run on a pool thread and returns without waiting for it.
+/// The task may itself call RunTasks (e.g. to split its work across the pool). If 
+/// the pool has no threads (or the task cannot be queued), the task is run on the 
+/// calling thread before returning.
+///
+/// @param[in]  pfnTask: Task function, called once with TaskIndex zero
+/// @param[in]  pTaskContext: Passed to pfnTask
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::WorkerPool::Submit(PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext)
+{
+    TASK_BATCH *pBatch = NULL;
+
+    if(!Threads.empty())
+    {
+        pBatch = new(std::nothrow) TASK_BATCH{pfnTask, pTaskContext, 1, 0, 0, true};
+    }
+
+    if(!pBatch)
+    {
+        pfnTask(pTaskContext, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Locked(Lock);
+        PendingBatches.push_back(pBatch);
+    }
+    WorkAvailable.notify_one();
+}
+
+// Context's worker pool--kept out of Context, so its layout is unchanged.
+static GmmLib::WorkerPool   *pContextWorkerPool = NULL;
+static std::mutex           ContextWorkerPoolLock;
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Returns the context's worker pool, creating it on first use.
+///
+/// @return     Pointer to WorkerPool, or NULL if it could not be created (callers
+///             then run their tasks serially)
+/////////////////////////////////////////////////////////////////////////////////////
+GmmLib::WorkerPool *GMM_STDCALL GmmLib::Context::GetWorkerPool()
+{
+    std::lock_guard<std::mutex> Locked(ContextWorkerPoolLock);
+
+    if(!pContextWorkerPool)
+    {
+        pContextWorkerPool = new(std::nothrow) WorkerPool(WorkerPool::GetDefaultNumThreads());
+    }
+
+    return pContextWorkerPool;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Destroys the context's worker pool, if created.
+/////////////////////////////////////////////////////////////////////////////////////
+void GMM_STDCALL GmmLib::Context::DestroyWorkerPool()
+{
+    std::lock_guard<std::mutex> Locked(ContextWorkerPoolLock);
+
+    delete pContextWorkerPool;
+    pContextWorkerPool = NULL;
+}
+
+#endif // #if(!defined(__GMM_KMD__))
@@ -0,0 +1,120 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+#define GMM_HEAP_BUDDY_MAX_ORDERS       40      // Order n block = 2^n order 0 blocks.
+#define GMM_HEAP_BUDDY_MAX_LEVELS       7       // Enough for 2^40 bits, 64 per word per level.
+
+// Index of lowest/highest set bit of (non-zero) 64-bit word.
+#if _MSC_VER
+#include <intrin.h>
+static __inline uint32_t __GmmHeapBuddyLowBit(uint64_t Word)
+{
+    unsigned long Index;
+#if _WIN64
+    _BitScanForward64(&Index, Word);
+#else // No 64-bit scans on 32-bit targets.
+    if (!_BitScanForward(&Index, (unsigned long) Word))
+    {
+        _BitScanForward(&Index, (unsigned long) (Word >> 32));
+        Index += 32;
+    }
+#endif
+    return Index;
+}
+static __inline uint32_t __GmmHeapBuddyHighBit(uint64_t Word)
+{
+    unsigned long Index;
+#if _WIN64
+    _BitScanReverse64(&Index, Word);
+#else
+    if (_BitScanReverse(&Index, (unsigned long) (Word >> 32)))
+    {
+        Index += 32;
+    }
+    else
+    {
+        _BitScanReverse(&Index, (unsigned long) Word);
+    }
+#endif
+    return Index;
+}
+#else
+#define __GmmHeapBuddyLowBit(Word)      ((uint32_t) __builtin_ctzll(Word))
+#define __GmmHeapBuddyHighBit(Word)     ((uint32_t) (63 - __builtin_clzll(Word)))
+#endif
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP_BUDDY_BITMAP
+//
+// Description:
+//     Hierarchical bitmap: pLevel[0] has a bit per block, pLevel[n + 1] a bit
+//     per non-zero word of pLevel[n], up to a single top word. Set/Clear/
+//     FindFirst touch one word per level.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_BUDDY_BITMAP_REC
+{
+    uint64_t    *pLevel[GMM_HEAP_BUDDY_MAX_LEVELS];
+    uint32_t    NumLevels;
+} GMM_HEAP_BUDDY_BITMAP;
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP_BUDDY
+//
+// Description:
+//     Binary buddy allocator of offsets in [0, NumBlocks << MinShift): blocks
+//     of order n are 2^(n + MinShift) bytes, aligned to their size. Per order,
+//     a bitmap marks the blocks free at that order, and OrderMask the orders
+//     with any free block, so finding, splitting and merging blocks take
+//     constant time. Another (flat) bitmap per order marks allocated blocks,
+//     to validate frees. Does no locking of its own.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_BUDDY_REC
+{
+    uint32_t                MinShift;       // log2 of order 0 block size.
+    uint32_t                MaxOrder;
+    uint64_t                NumBlocks;      // Order 0 blocks.
+    uint64_t                OrderMask;      // Bit n set if an order n block is free.
+    uint64_t                *pStorage;      // All bitmaps' words.
+    GMM_HEAP_BUDDY_BITMAP   Free[GMM_HEAP_BUDDY_MAX_ORDERS];
+    uint64_t                *pAllocated[GMM_HEAP_BUDDY_MAX_ORDERS];
+    uint64_t                NumFree[GMM_HEAP_BUDDY_MAX_ORDERS];     // Free blocks per order.
+} GMM_HEAP_BUDDY;
+
+int         __GmmHeapBuddyInit(GMM_HEAP_BUDDY *pBuddy, uint64_t Size, uint64_t MinBlockSize);
+void        __GmmHeapBuddyDestroy(GMM_HEAP_BUDDY *pBuddy);
+uint32_t    __GmmHeapBuddyOrder(const GMM_HEAP_BUDDY *pBuddy, uint64_t Size);
+int         __GmmHeapBuddyAlloc(GMM_HEAP_BUDDY *pBuddy, uint32_t Order, uint64_t *pOffset);
+int         __GmmHeapBuddyFree(GMM_HEAP_BUDDY *pBuddy, uint64_t Offset, uint32_t Order);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
@@ -0,0 +1,81 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP_TREE_LINK
+//
+// Description:
+//     Intrusive AVL tree link, embedded in the nodes of a GMM_HEAP_TREE (e.g.
+//     GMM_HEAPNODE's ByAddr/BySize links, indexing a GMM_HEAP's free blocks).
+//     A node can be in several trees at once, via separate links.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_TREE_LINK_REC
+{
+    struct GMM_HEAP_TREE_LINK_REC   *pParent;
+    struct GMM_HEAP_TREE_LINK_REC   *pLeft;
+    struct GMM_HEAP_TREE_LINK_REC   *pRight;
+    int                             Height;     // Of subtree rooted here (leaf = 1).
+} GMM_HEAP_TREE_LINK;
+
+// Strict weak ordering of two links' nodes: <0, 0, >0 as A sorts before, with, or after B.
+typedef int (*PFN_GMM_HEAP_TREE_COMPARE)(const GMM_HEAP_TREE_LINK *pA, const GMM_HEAP_TREE_LINK *pB);
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP_TREE
+//
+// Description:
+//     Balanced (AVL) binary search tree of GMM_HEAP_TREE_LINK's. Insert,
+//     Remove, LowerBound are O(log n); Next/Prev are amortized O(1). Trees do
+//     no allocation or locking of their own.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_TREE_REC
+{
+    GMM_HEAP_TREE_LINK          *pRoot;
+    PFN_GMM_HEAP_TREE_COMPARE   pfnCompare;
+} GMM_HEAP_TREE;
+
+// Node of given Type containing given tree link Member.
+#define GMM_HEAP_TREE_ENTRY(pLink, Type, Member) \
+    ((Type *) ((char *) (pLink) - offsetof(Type, Member)))
+
+void                __GmmHeapTreeInit(GMM_HEAP_TREE *pTree, PFN_GMM_HEAP_TREE_COMPARE pfnCompare);
+void                __GmmHeapTreeInsert(GMM_HEAP_TREE *pTree, GMM_HEAP_TREE_LINK *pLink);
+void                __GmmHeapTreeRemove(GMM_HEAP_TREE *pTree, GMM_HEAP_TREE_LINK *pLink);
+GMM_HEAP_TREE_LINK* __GmmHeapTreeLowerBound(const GMM_HEAP_TREE *pTree, const GMM_HEAP_TREE_LINK *pKey);
+GMM_HEAP_TREE_LINK* __GmmHeapTreeFirst(const GMM_HEAP_TREE *pTree);
+GMM_HEAP_TREE_LINK* __GmmHeapTreeLast(const GMM_HEAP_TREE *pTree);
+GMM_HEAP_TREE_LINK* __GmmHeapTreeNext(const GMM_HEAP_TREE_LINK *pLink);
+GMM_HEAP_TREE_LINK* __GmmHeapTreePrev(const GMM_HEAP_TREE_LINK *pLink);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
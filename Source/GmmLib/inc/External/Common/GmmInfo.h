@@ -66,6 +66,8 @@ typedef struct GMM_UMD_CONTEXT_REC
 
 namespace GmmLib
 {
+    class WorkerPool;
+
     class NON_PAGED_SECTION Context : public GmmMemAllocator
     {
     private:
@@ -291,6 +293,12 @@ namespace GmmLib
             return InternalGpuVaMax;
         }
 
+        /////////////////////////////////////////////////////////////////////////
+        /// Returns the cache sizes (see GmmGetCacheSizes) captured by InitContext,
+        /// for per-operation policy decisions (e.g. CpuBlt's).
+        /////////////////////////////////////////////////////////////////////////
+        const GMM_CACHE_SIZES& GMM_STDCALL GetCacheSizes();
+
     #ifdef _WIN32
        
 
@@ -313,6 +321,19 @@ namespace GmmLib
     #endif
     #endif
 
+    #if(!defined(__GMM_KMD__))
+        /////////////////////////////////////////////////////////////////////////
+        /// Returns the worker pool used by parallel CPU operations (e.g. 
+        /// GmmResCpuBltParallel), creating it on first use.
+        /////////////////////////////////////////////////////////////////////////
+        WorkerPool* GMM_STDCALL GetWorkerPool();
+
+        /////////////////////////////////////////////////////////////////////////
+        /// Destroys the worker pool (if created). Called on context destruction.
+        /////////////////////////////////////////////////////////////////////////
+        void GMM_STDCALL DestroyWorkerPool();
+    #endif
+
         // KMD specific inline functions
     #ifdef __GMM_KMD__
 
@@ -33,6 +33,7 @@ OTHER DEALINGS IN THE SOFTWARE.
     #define GMM_FREE(p)         GmmFreeKmdSystemMem((p), GFX_COMPONENT_GMM_TAG)
 #else
     #include <stdlib.h>
+    #include <new>
 
     #define NON_PAGED_SECTION
 
@@ -57,6 +58,13 @@ class NON_PAGED_SECTION GmmMemAllocator
             GMM_UNREFERENCED_PARAMETER(size);
             return ptr;
         }
+
+    #if !__GMM_KMD__
+        void* operator new(size_t size, const std::nothrow_t&) noexcept
+        {
+            return GMM_MALLOC(size);
+        }
+    #endif
         
         void operator delete(void *ptr) 
         {       
@@ -69,4 +77,11 @@ class NON_PAGED_SECTION GmmMemAllocator
             GMM_UNREFERENCED_PARAMETER(place);
             // placement delete -- nothing to do.
         }
+
+    #if !__GMM_KMD__
+        void operator delete(void *ptr, const std::nothrow_t&) noexcept
+        {
+            GMM_FREE(ptr);
+        }
+    #endif
 };
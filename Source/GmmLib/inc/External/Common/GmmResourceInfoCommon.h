@@ -83,6 +83,39 @@ namespace GmmLib
             GMM_STATUS          ApplyExistingSysMemRestrictions();
 
         protected:
+            /// Single-subresource CpuBlt resolved to a CpuSwizzleBlt surface pair.
+            typedef struct CPU_BLT_OP_REC
+            {
+                CPU_SWIZZLE_BLT_SURFACE Dest;
+                CPU_SWIZZLE_BLT_SURFACE Src;
+                uint32_t                CopyWidthBytes;
+                uint32_t                CopyHeight;
+            } CPU_BLT_OP;
+
+            /// Resolved-but-not-yet-performed copies of a CpuBltBatch.
+            #define GMM_CPU_BLT_BATCH_MAX_OPS 32
+            typedef struct CPU_BLT_BATCH_REC
+            {
+                CPU_BLT_OP              Op[GMM_CPU_BLT_BATCH_MAX_OPS];
+                uint32_t                NumOps;
+                GMM_REQ_OFFSET_INFO     OffsetCache;    ///< GetOffset result of last resolved subresource (zero if none).
+                BOOLEAN                 Success;
+            } CPU_BLT_BATCH;
+
+            /// Linear layout of a resource's subresources packed back-to-back (e.g. 
+            /// GmmResCpuBltFromFile payload or GmmResCpuBltAllSubresources buffer).
+            typedef struct CPU_BLT_PACKED_LAYOUT_REC
+            {
+                GMM_RES_FILE_LAYOUT     Order;
+                uint32_t                MipLevels;
+                uint32_t                ArraySize;
+                uint32_t                RowPitch[GMM_MAX_MIPMAP];
+                uint64_t                MipSize[GMM_MAX_MIPMAP];    ///< Size of one array slice of mip (all of its depth slices for 3D).
+                uint64_t                MipOffset[GMM_MAX_MIPMAP];  ///< Offset of mip within an array slice's mips.
+                uint64_t                SliceSize;                  ///< Size of all mips of one array slice.
+                uint64_t                PayloadSize;
+            } CPU_BLT_PACKED_LAYOUT;
+
             /* Function prototypes */
             BOOLEAN             IsPresentableformat();
             // Move GMM Restrictions to it's own class?
@@ -91,6 +124,16 @@ namespace GmmLib
             virtual BOOLEAN     CopyClientParams(GMM_RESCREATE_PARAMS &CreateParams);
             BOOLEAN             RedescribePlanes();
             BOOLEAN             ReAdjustPlaneProperties(BOOLEAN IsAuxSurf);
+            BOOLEAN GMM_STDCALL CpuBltOnWorkers(GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, CPU_BLT_BATCH *pBatch);
+            BOOLEAN GMM_STDCALL CpuBltResolve(GMM_RES_COPY_BLT *pBlt, CPU_BLT_OP *pOp, GMM_REQ_OFFSET_INFO *pOffsetCache);
+            BOOLEAN GMM_STDCALL CpuBltVolume(GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, CPU_BLT_BATCH *pBatch);
+            static void GMM_STDCALL CpuBltExecute(const CPU_BLT_OP *pOp, const GMM_RES_CPU_BLT_WORKERS *pWorkers);
+            static BOOLEAN GMM_STDCALL CpuBltCoalesce(CPU_BLT_OP *pOp, const CPU_BLT_OP *pNext);
+            static void GMM_STDCALL CpuBltPrefetchSource(const CPU_BLT_OP *pOp);
+            static void GMM_STDCALL CpuBltFlushBatch(CPU_BLT_BATCH *pBatch);
+            static void GMM_STDCALL CpuBltGetCachePolicy(uint64_t FootprintBytes, BOOLEAN Upload, GMM_RES_CPU_BLT_CACHE_HINT Hint, int *pTemporal, uint32_t *pPrefetchBytes);
+            BOOLEAN GMM_STDCALL CpuBltGetPackedLayout(GMM_RES_FILE_LAYOUT Order, uint32_t RowAlignment, uint32_t MipLevels, uint32_t ArraySize, CPU_BLT_PACKED_LAYOUT *pLayout);
+            BOOLEAN GMM_STDCALL DirtyTilesOp(GMM_RES_DIRTY_TILES *pDirty, const GMM_RES_COPY_BLT *pBlt, uint32_t Action);
 
             /* Inline functions */
 
@@ -204,6 +247,19 @@ namespace GmmLib
             uint32_t                   GMM_STDCALL GetQPitch();
             GMM_STATUS              GMM_STDCALL GetOffset(GMM_REQ_OFFSET_INFO &ReqInfo);
             BOOLEAN                 GMM_STDCALL CpuBlt(GMM_RES_COPY_BLT *pBlt);
+            BOOLEAN                 GMM_STDCALL CpuBltParallel(GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers);
+            BOOLEAN                 GMM_STDCALL CpuBltBatch(GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts);
+            BOOLEAN                 GMM_STDCALL CpuBltStream(GMM_RES_COPY_BLT_STREAM *pStream);
+            BOOLEAN                 GMM_STDCALL CpuBltFromFile(const GMM_RES_FILE_BLT *pFileBlt);
+            BOOLEAN                 GMM_STDCALL CpuBltAllSubresources(const GMM_RES_SUBRESOURCES_BLT *pSubresourcesBlt);
+            BOOLEAN                 GMM_STDCALL CpuBltPlanar(const GMM_RES_PLANAR_BLT *pPlanarBlt);
+            GMM_RES_CPU_BLT_ASYNC*  GMM_STDCALL CpuBltAsync(const GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, PFN_GMM_RES_CPU_BLT_COMPLETE pfnComplete, void *pCallbackContext);
+            BOOLEAN                 GMM_STDCALL CpuFill(GMM_RES_FILL *pFill);
+            BOOLEAN                 GMM_STDCALL GetTileHashes(const void *pData, GMM_RES_TILE_HASHES *pTileHashes);
+            static uint32_t         GMM_STDCALL DiffTileHashes(const GMM_RES_TILE_HASHES *pOld, const GMM_RES_TILE_HASHES *pNew, uint32_t *pChangedTiles, uint32_t MaxChangedTiles);
+            BOOLEAN                 GMM_STDCALL InitDirtyTiles(GMM_RES_DIRTY_TILES *pDirty);
+            BOOLEAN                 GMM_STDCALL MarkDirtyTiles(GMM_RES_DIRTY_TILES *pDirty, const GMM_RES_COPY_BLT *pRect);
+            BOOLEAN                 GMM_STDCALL FlushDirtyTiles(GMM_RES_DIRTY_TILES *pDirty, GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts);
             BOOLEAN                 GMM_STDCALL GetMappingSpanDesc(GMM_GET_MAPPING *pMapping);
             BOOLEAN                 GMM_STDCALL Is64KBPageSuitable();
             void                    GMM_STDCALL GetTiledResourceMipPacking(UINT *pNumPackedMips,
@@ -352,6 +352,23 @@ typedef enum
     GMM_AUX_SURF    // Total Aux Surface (CCS + CC + Padding)
 } GMM_UNIFIED_AUX_TYPE;
 
+//===========================================================================
+// typedef:
+//        GMM_RES_CPU_BLT_CACHE_HINT
+//
+// Description:
+//     How a GmmResCpuBlt should access the swizzled (GPU) surface: with regular,
+//     cache-allocating loads/stores (best when the copy fits in the CPU caches
+//     and is soon followed by CPU reads), or non-temporal ones (best for copies
+//     large enough to thrash the caches).
+//---------------------------------------------------------------------------
+typedef enum GMM_RES_CPU_BLT_CACHE_HINT_ENUM
+{
+    GMM_RES_CPU_BLT_CACHE_AUTO = 0,     // Uploads: choose from copy footprint vs. LLC/eDRAM sizes (see GmmGetCacheSizes). Downloads: streaming.
+    GMM_RES_CPU_BLT_CACHE_TEMPORAL,     // Regular loads/stores; no software prefetch.
+    GMM_RES_CPU_BLT_CACHE_STREAMING,    // Non-temporal loads/stores (MOVNTDQA/MOVNTDQ), with software prefetch of linear source.
+} GMM_RES_CPU_BLT_CACHE_HINT;
+
 //===========================================================================
 // typedef:
 //        GMM_RES_COPY_BLT
@@ -366,7 +383,7 @@ typedef struct GMM_RES_COPY_BLT_REC
         void            *pData;         // Pointer to base of the mapped resource data (e.g. D3DDDICB_LOCK.pData).
         uint32_t           Slice;          // Array/Volume Slice or Cube Face; zero if N/A.
         uint32_t           MipLevel;       // Index of applicable MIP, or zero if N/A.
-        //uint32_t         MsaaSample;     // Index of applicable MSAA sample, or zero if N/A.
+        //uint32_t         MsaaSample;     // See Msaa.Sample.
         uint32_t           OffsetX;        // Pixel offset from left-edge of specified (Slice/MipLevel) subresource.
         uint32_t           OffsetY;        // Pixel row offset from top of specified subresource.
         uint32_t           OffsetSubpixel; // Byte offset into the surface pixel of the applicable subpixel.
@@ -378,7 +395,7 @@ typedef struct GMM_RES_COPY_BLT_REC
         uint32_t           RowPitch;       // Row pitch in bytes of pData surface.
         uint32_t           SlicePitch;     // Slice pitch in bytes of pData surface; ignored if Blt.Slices <= 1.
         uint32_t           PixelPitch;     // Number of bytes from one pData pixel to its horizontal neighbor; 0 = "Same as GPU Resource".
-        //uint32_t         MsaaSamplePitch;// Number of bytes from one pData MSAA sample to the next; ignored if Blt.MsaaSamples <= 1.
+        //uint32_t         MsaaSamplePitch;// See Msaa.SamplePitch.
         uint32_t           BufferSize;     // Number of bytes at pData. (Value used only in asserts to catch overuns.)
     }               Sys;                // Description of system memory surface being BLT'ed to/from the GPU surface.
 
@@ -388,11 +405,244 @@ typedef struct GMM_RES_COPY_BLT_REC
         uint32_t           Height;         // Copy height in pixel rows; 0 = "Full Height" of specified subresource.
         uint32_t           Slices;         // Number of slices being copied; 0 = 1 = "N/A or single slice".
         uint32_t           BytesPerPixel;  // Number of bytes to copy, per pixel; 0 = "Same as Sys.PixelPitch".
-        //uint32_t         MsaaSamples;    // Number of samples to copy per pixel; 0 = 1 = "N/A or single sample".
+        //uint32_t         MsaaSamples;    // See Msaa.Samples.
         BOOLEAN         Upload;         // TRUE = Sys-->Gpu; FALSE = Gpu-->Sys.
+        const CPU_SWIZZLE_BLT_CONVERT *pConvert; // Conversion of each pixel from source to destination format (e.g. Sys BGRA8 --> Gpu RGBA8), or NULL if none. Requires BytesPerPixel = 0, and tiled resource.
+        GMM_RES_CPU_BLT_CACHE_HINT CacheHint; // Temporal vs. non-temporal access of tiled resource; 0 = GMM_RES_CPU_BLT_CACHE_AUTO.
     }               Blt;                // Description of the BLT being performed.
+
+    // MSAA members are appended (rather than filling the placeholders above)
+    // so the offsets of all pre-existing members are unchanged for callers
+    // built against the earlier layout.
+    struct // MSAA Description...
+    {
+        uint32_t           Sample;         // Index of first MSAA sample of the GPU resource, or zero if N/A.
+        uint32_t           SamplePitch;    // Number of bytes from one Sys.pData MSAA sample to the next; ignored if Msaa.Samples <= 1.
+        uint32_t           Samples;        // Number of samples to copy per pixel; 0 = 1 = "N/A or single sample".
+    }               Msaa;               // MSAA samples involved in BLT.
 } GMM_RES_COPY_BLT;
 
+//===========================================================================
+// typedef:
+//        GMM_RES_FILL
+//
+// Description:
+//     Describes a GmmResCpuFill operation: Fill of a resource rectangle with
+//     a repeating byte pattern (e.g. clear color), without source buffer.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_FILL_REC
+{
+    struct // GPU Surface Description...
+    {
+        void            *pData;         // Pointer to base of the mapped resource data (e.g. D3DDDICB_LOCK.pData).
+        uint32_t           Slice;          // Array/Volume Slice or Cube Face; zero if N/A.
+        uint32_t           MipLevel;       // Index of applicable MIP, or zero if N/A.
+        uint32_t           MsaaSample;     // Index of applicable MSAA sample, or zero if N/A.
+        uint32_t           OffsetX;        // Pixel offset from left-edge of specified (Slice/MipLevel) subresource.
+        uint32_t           OffsetY;        // Pixel row offset from top of specified subresource (or, for planar, of Y plane).
+    }               Gpu;                // Surface description of GPU resource being filled.
+
+    struct // Pattern Description...
+    {
+        const void      *pData;         // Pointer to pattern, repeated across each row from left edge of fill rectangle.
+        uint32_t           Size;           // Size of pattern in bytes (1..16)--e.g. resource pixel (or compression block) size.
+    }               Pattern;            // Description of the fill pattern.
+
+    struct // Fill Description...
+    {
+        uint32_t           Width;          // Fill width in pixels; 0 = "Full Width" of specified subresource.
+        uint32_t           Height;         // Fill height in pixel rows; 0 = "Full Height" of specified subresource.
+        uint32_t           Slices;         // Number of slices being filled; 0 = 1 = "N/A or single slice".
+        uint32_t           MsaaSamples;    // Number of samples to fill per pixel; 0 = 1 = "N/A or single sample".
+    }               Fill;               // Description of the fill being performed.
+} GMM_RES_FILL;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_TILE_HASHES
+//
+// Description:
+//     Per-tile hash map of a resource's main surface, as computed by
+//     GmmResGetTileHashes and compared by GmmResDiffTileHashes.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_TILE_HASHES_REC
+{
+    uint32_t            *pHashes;       // Per-tile hashes, in memory order of resource's tiles; NULL to query NumTiles/TileSize only.
+    uint32_t            NumTiles;       // In: Number of elements at pHashes. Out: Number of tiles in resource.
+    uint32_t            TileSize;       // Out: Bytes covered by each hash--tile size, or 4KB pages for linear resources.
+} GMM_RES_TILE_HASHES;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_DIRTY_TILES
+//
+// Description:
+//     Dirty-tile tracker of a resource's main surface: Rectangles marked by
+//     GmmResMarkDirtyTiles are recorded as the set of tiles they touch, and
+//     GmmResFlushDirtyTiles then uploads only those tiles.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_DIRTY_TILES_REC
+{
+    uint32_t            *pBits;         // Bitmap, one bit per tile (in memory order, as GMM_RES_TILE_HASHES); NULL to query NumTiles/TileSize only.
+    uint32_t            NumTiles;       // In: Number of tiles pBits has room for. Out: Number of tiles in resource.
+    uint32_t            TileSize;       // Out: Bytes covered by each bit--tile size, or 4KB pages for linear resources.
+    uint32_t            NumDirty;       // Out: Number of tiles currently dirty.
+} GMM_RES_DIRTY_TILES;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_CPU_BLT_WORKERS
+//
+// Description:
+//     Describes the workers a GmmResCpuBltParallel operation is split across.
+//     The BLT is divided into bands along tile-row boundaries (so no two
+//     tasks touch the same tile), and each band is run as one task.
+//---------------------------------------------------------------------------
+typedef void (GMM_STDCALL *PFN_GMM_WORKER_TASK)(void *pTaskContext, uint32_t TaskIndex);
+
+typedef struct GMM_RES_CPU_BLT_WORKERS_REC
+{
+    uint32_t            NumWorkers;     // Maximum number of tasks to split BLT into; 0 = "One per internal pool thread, plus the calling thread" (with pfnRunTasks: "One per CPU").
+
+    // Caller-supplied worker pool; NULL = Use GmmLib's internal pool. Must 
+    // call pfnTask(pTaskContext, i) once for each i in [0, NumTasks), in any 
+    // order or concurrency, and return only once all tasks have completed.
+    void (GMM_STDCALL   *pfnRunTasks)(void *pPoolContext, uint32_t NumTasks, PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext);
+    void                *pPoolContext;  // Passed through to pfnRunTasks.
+} GMM_RES_CPU_BLT_WORKERS;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_COPY_BLT_BAND
+//
+// Description:
+//     Describes one band of a GmmResCpuBltStream operation--i.e. a run of
+//     rows of one slice, whose linear data is staged at pData.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_COPY_BLT_BAND_REC
+{
+    void                *pData;         // Band's linear data, Blt.Sys.RowPitch bytes per row.
+    uint32_t            Size;           // Number of bytes at pData covered by band.
+    uint32_t            Index;          // Sequence number of band within stream.
+    uint32_t            Slice;          // Array/Volume Slice or Cube Face of band.
+    uint32_t            OffsetY;        // Pixel row of band's first row within subresource.
+    uint32_t            Height;         // Number of pixel rows in band.
+} GMM_RES_COPY_BLT_BAND;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_COPY_BLT_STREAM
+//
+// Description:
+//     Describes a GmmResCpuBltStream operation: A GmmResCpuBlt whose linear
+//     data is produced (upload) or consumed (download) band-by-band through
+//     a callback, using a fixed amount of caller-provided staging memory.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_COPY_BLT_STREAM_REC
+{
+    // BLT description as for GmmResCpuBlt, except Sys.pData, Sys.SlicePitch,
+    // and Sys.BufferSize are ignored (band data is staged in pStaging), and
+    // Msaa.Samples must be <= 1.
+    GMM_RES_COPY_BLT    Blt;
+
+    void                *pStaging;      // Staging memory for one band--or two, so a band's callback can overlap transfer of its neighbor.
+    uint32_t            StagingSize;    // Number of bytes at pStaging.
+    uint32_t            BandHeight;     // Maximum pixel rows per band; 0 = "As many as staging permits". Bands are aligned to tile rows where possible.
+    const GMM_RES_CPU_BLT_WORKERS *pWorkers; // NULL = Run callbacks and transfers serially on calling thread; else overlap them on given workers (see ::GMM_RES_CPU_BLT_WORKERS).
+
+    // Called once per band, in band order (possibly on a worker thread, but 
+    // never concurrently with itself)--for upload, to fill pBand->pData; for 
+    // download, to consume it. Returning FALSE aborts the stream.
+    BOOLEAN (GMM_STDCALL *pfnBand)(void *pContext, const GMM_RES_COPY_BLT_BAND *pBand);
+    void                *pContext;      // Passed through to pfnBand.
+} GMM_RES_COPY_BLT_STREAM;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_FILE_BLT
+//
+// Description:
+//     Describes a GmmResCpuBltFromFile operation: Upload of all subresources
+//     of a resource from a file holding their linear images back-to-back
+//     (e.g. payload of a raw or DDS-style texture file).
+//---------------------------------------------------------------------------
+typedef enum GMM_RES_FILE_LAYOUT_ENUM
+{
+    GMM_RES_FILE_LAYOUT_SLICE_MAJOR = 0,    // For each array slice (or cube face), all of its mips (e.g. DDS).
+    GMM_RES_FILE_LAYOUT_MIP_MAJOR,          // For each mip, all of its array slices (or cube faces) (e.g. KTX).
+} GMM_RES_FILE_LAYOUT;
+
+typedef struct GMM_RES_FILE_BLT_REC
+{
+    void                *pGpuData;      // Pointer to base of the mapped resource data.
+    const char          *pFileName;     // Path of file to read, or NULL to use FileDescriptor.
+    int                 FileDescriptor; // Open, readable descriptor of file; ignored if pFileName given.
+    uint64_t            FileOffset;     // Byte offset into file of first subresource's data.
+    GMM_RES_FILE_LAYOUT Layout;         // Order of subresources in file. (3D mips always hold their depth slices contiguously.)
+    uint32_t            RowAlignment;   // Alignment, in bytes, of each row's start; 0 = 1 = "Tightly packed".
+    uint32_t            MipLevels;      // Number of mips in file; 0 = "All mips of resource".
+    uint32_t            ArraySize;      // Number of array slices (or cube faces) in file; 0 = "All of resource".
+} GMM_RES_FILE_BLT;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_SUBRESOURCES_BLT
+//
+// Description:
+//     Describes a GmmResCpuBltAllSubresources operation: Transfer of all
+//     subresources of a resource to/from a buffer holding their linear images
+//     back-to-back, in the same layouts as GMM_RES_FILE_BLT.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_SUBRESOURCES_BLT_REC
+{
+    void                *pGpuData;      // Pointer to base of the mapped resource data.
+    void                *pSysData;      // Pointer to first subresource's linear image.
+    uint64_t            SysBufferSize;  // Size of pSysData buffer, in bytes.
+    GMM_RES_FILE_LAYOUT Layout;         // Order of subresources in buffer. (3D mips always hold their depth slices contiguously.)
+    uint32_t            RowAlignment;   // Alignment, in bytes, of each row's start; 0 = 1 = "Tightly packed".
+    uint32_t            MipLevels;      // Number of mips in buffer; 0 = "All mips of resource".
+    uint32_t            ArraySize;      // Number of array slices (or cube faces) in buffer; 0 = "All of resource".
+    BOOLEAN             Upload;         // TRUE = Sys-->GPU, FALSE = GPU-->Sys.
+} GMM_RES_SUBRESOURCES_BLT;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_PLANAR_BLT
+//
+// Description:
+//     Describes a GmmResCpuBltPlanar operation: Transfer of a whole planar YUV
+//     frame (anchored at the resource origin) to/from separate linear images
+//     of its planes.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_PLANAR_BLT_REC
+{
+    void                *pGpuData;      // Pointer to base of the mapped resource data.
+    struct
+    {
+        void            *pData;         // Pointer to plane's linear image; NULL = "Skip plane".
+        uint32_t        RowPitch;       // Row pitch of pData, in bytes.
+    }                   Sys[GMM_MAX_PLANE]; // Indexed by GMM_YUV_PLANE. UV-packed formats (NV12, P010, etc.) use GMM_PLANE_U for the interleaved UV plane.
+    uint32_t            Width;          // Frame width, in Y-plane pixels; 0 = "Full Width".
+    uint32_t            Height;         // Frame height, in Y-plane rows; 0 = "Full Height".
+    BOOLEAN             Upload;         // TRUE = Sys-->GPU, FALSE = GPU-->Sys.
+} GMM_RES_PLANAR_BLT;
+
+//===========================================================================
+// typedef:
+//        GMM_RES_CPU_BLT_ASYNC
+//
+// Description:
+//     Opaque completion handle of a GmmResCpuBltAsync operation. Poll with
+//     GmmResCpuBltAsyncIsComplete, block with GmmResCpuBltAsyncWait, and free
+//     with GmmResCpuBltAsyncRelease.
+//---------------------------------------------------------------------------
+typedef struct GMM_RES_CPU_BLT_ASYNC_REC GMM_RES_CPU_BLT_ASYNC;
+
+// Optional completion callback--called on the thread that finished the BLT
+// (before the handle is signaled), so keep it short (e.g. kick off the next
+// stage of a pipeline). Must not wait on or release the handle.
+typedef void (GMM_STDCALL *PFN_GMM_RES_CPU_BLT_COMPLETE)(void *pCallbackContext, BOOLEAN Success);
+
 //===========================================================================
 // typedef:
 //        GMM_GET_MAPPING
@@ -452,6 +702,22 @@ BOOLEAN             GMM_STDCALL GmmIsStdTilingSupported(GMM_RESCREATE_PARAMS *pC
 GMM_RESOURCE_INFO*  GMM_STDCALL GmmResCopy(GMM_RESOURCE_INFO *pGmmResource);
 void                GMM_STDCALL GmmResMemcpy(void *pDst, void *pSrc);
 BOOLEAN             GMM_STDCALL GmmResCpuBlt(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT *pBlt);
+BOOLEAN             GMM_STDCALL GmmResCpuBltParallel(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers);
+BOOLEAN             GMM_STDCALL GmmResCpuBltBatch(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts);
+BOOLEAN             GMM_STDCALL GmmResCpuBltStream(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_COPY_BLT_STREAM *pStream);
+BOOLEAN             GMM_STDCALL GmmResCpuBltFromFile(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_FILE_BLT *pFileBlt);
+BOOLEAN             GMM_STDCALL GmmResCpuBltAllSubresources(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_SUBRESOURCES_BLT *pSubresourcesBlt);
+BOOLEAN             GMM_STDCALL GmmResCpuBltPlanar(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_PLANAR_BLT *pPlanarBlt);
+GMM_RES_CPU_BLT_ASYNC* GMM_STDCALL GmmResCpuBltAsync(GMM_RESOURCE_INFO *pGmmResource, const GMM_RES_COPY_BLT *pBlt, const GMM_RES_CPU_BLT_WORKERS *pWorkers, PFN_GMM_RES_CPU_BLT_COMPLETE pfnComplete, void *pCallbackContext);
+BOOLEAN             GMM_STDCALL GmmResCpuBltAsyncIsComplete(GMM_RES_CPU_BLT_ASYNC *pAsync);
+BOOLEAN             GMM_STDCALL GmmResCpuBltAsyncWait(GMM_RES_CPU_BLT_ASYNC *pAsync);
+void                GMM_STDCALL GmmResCpuBltAsyncRelease(GMM_RES_CPU_BLT_ASYNC *pAsync);
+BOOLEAN             GMM_STDCALL GmmResCpuFill(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_FILL *pFill);
+BOOLEAN             GMM_STDCALL GmmResGetTileHashes(GMM_RESOURCE_INFO *pGmmResource, const void *pData, GMM_RES_TILE_HASHES *pTileHashes);
+uint32_t            GMM_STDCALL GmmResDiffTileHashes(const GMM_RES_TILE_HASHES *pOld, const GMM_RES_TILE_HASHES *pNew, uint32_t *pChangedTiles, uint32_t MaxChangedTiles);
+BOOLEAN             GMM_STDCALL GmmResInitDirtyTiles(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_DIRTY_TILES *pDirty);
+BOOLEAN             GMM_STDCALL GmmResMarkDirtyTiles(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_DIRTY_TILES *pDirty, const GMM_RES_COPY_BLT *pRect);
+BOOLEAN             GMM_STDCALL GmmResFlushDirtyTiles(GMM_RESOURCE_INFO *pGmmResource, GMM_RES_DIRTY_TILES *pDirty, GMM_RES_COPY_BLT *pBlts, uint32_t NumBlts);
 GMM_RESOURCE_INFO*  GMM_STDCALL GmmResCreate(GMM_RESCREATE_PARAMS *pCreateParams);
 void                GMM_STDCALL GmmResFree(GMM_RESOURCE_INFO *pGmmResource);
 GMM_GFX_SIZE_T      GMM_STDCALL GmmResGetSizeMainSurface(const GMM_RESOURCE_INFO *pResourceInfo);
@@ -0,0 +1,193 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+
+#pragma once
+
+#include <pthread.h>
+#include "../Common/GmmHeapTree.h"
+#include "../Common/GmmHeapBuddy.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// @file GmmHeapLin.h
+/// @brief Linux definitions of the user-mode GMM_HEAP (VA sub-allocator) and its
+///        API, matching the Windows External/Windows/GmmHeap.h interface.
+///
+/////////////////////////////////////////////////////////////////////////////////////
+
+// GmmUmSetupHeap Flags (GMM_HEAP.HeapType)...
+#define GMM_OTHER_HEAP                      0x0
+#define GMM_TRVA_HEAP                       0x1             // Tiled resource VA.
+#define GMM_FLAT_HEAP                       0x2
+#define GMM_BUDDY_HEAP                      0x3             // Power-of-two blocks, aligned (relative to BaseAddress) to their size.
+#define HEAP_TYPE_MASK                      0xf
+#define GMM_PROCESS_HEAP                    (__BIT(8))      // One heap per adapter, shared by all its devices in the process.
+#define GMM_HEAP_NO_THREAD_CACHE            (__BIT(9))      // Don't cache freed blocks per thread (see GMM_HEAP_THREAD_CACHE).
+
+// Allocation alignment by heap type...
+#define GMM_HEAP_ALIGN_SIZE                 1
+#define GMM_TRVA_HEAP_ALIGN_SIZE            GMM_KBYTE(64)
+#define GMM_FLAT_HEAP_ALIGN_SIZE            GMM_KBYTE(4)
+#define GMM_BUDDY_HEAP_ALIGN_SIZE           GMM_KBYTE(4)    // Smallest block.
+
+#define __GMM_MAX_NUM_OF_FREE_HEAP_NODES    64              // Heap nodes in pool's first slab...
+#define __GMM_MAX_NUM_OF_SLAB_HEAP_NODES    4096            // ...doubling per slab up to this.
+#define __GMM_HEAP_NODE_SLAB_ALIGN          64              // Slab (cache line) alignment.
+#define __GMM_NODE_SIGNATURE                0xfe            // Fill of freed nodes (debug).
+
+// Freed blocks of the common small sizes are kept in per-thread "magazines",
+// so most small allocations and frees never touch the heap's (shared) lock.
+#define GMM_HEAP_THREAD_CACHE               1
+#define GMM_HEAP_MAGAZINE_GRANULE           GMM_KBYTE(4)    // Cached sizes: multiples of this...
+#define GMM_HEAP_MAGAZINE_NUM_CLASSES       16              // ...up to this many granules,
+#define GMM_HEAP_MAGAZINE_DEPTH             16              // this many blocks per size.
+
+typedef void *GMM_ESCAPE_HANDLE;
+typedef int (*GMM_ESCAPE_FUNC_TYPE)(GMM_ESCAPE_HANDLE hAdapter, GMM_ESCAPE_HANDLE hDevice, void *pData, uint32_t DataSize);
+
+//===========================================================================
+// typedef:
+//        GMM_HEAPNODE
+//
+// Description:
+//     Free block of a GMM_HEAP. Free blocks form an address-ordered list
+//     (pNext/pPrev, between head and tail sentinels), and are indexed by
+//     address and by size for best-fit/coalescing lookups.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAPNODE_REC
+{
+    GMM_GFX_ADDRESS             BlockAddr;
+    GMM_GFX_SIZE_T              BlockSize;
+    struct GMM_HEAPNODE_REC     *pNext;
+    struct GMM_HEAPNODE_REC     *pPrev;
+    GMM_HEAP_TREE_LINK          ByAddr;
+    GMM_HEAP_TREE_LINK          BySize;
+    GMM_GFX_SIZE_T              IndexedSize;    // BlockSize as of last (re)indexing--counted in GMM_HEAP_STATS.
+} GMM_HEAPNODE;
+
+#define GMM_HEAP_STATS_NUM_BUCKETS          64
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP_STATS
+//
+// Description:
+//     Heap occupancy/fragmentation snapshot (GmmHeapGetStats). Kept up to
+//     date, atomically, by the heap's alloc/free paths, so taking one is
+//     cheap and lock-free. Blocks held in thread magazines count as
+//     allocated.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_STATS_REC
+{
+    GMM_GFX_SIZE_T  Size;
+    GMM_GFX_SIZE_T  FreeSize;
+    GMM_GFX_SIZE_T  LargestFreeBlock;
+    uint64_t        NumFreeBlocks;
+    uint64_t        FreeBlockHistogram[GMM_HEAP_STATS_NUM_BUCKETS]; // [n]: free blocks of [2^n, 2^(n+1)) bytes.
+
+    uint64_t        NumAllocs;          // Blocks allocated from the heap proper...
+    uint64_t        NumFailedAllocs;    // (GmmAllocateHeapVA failures)
+    uint64_t        NumFrees;           // ...and freed to it (including magazine flushes).
+    uint64_t        NumCachedAllocs;    // Blocks allocated from thread magazines...
+    uint64_t        NumCachedFrees;     // ...and freed to them.
+
+    uint64_t        NumSearches;        // Free block searches...
+    uint64_t        SearchSteps;        // ...and free blocks they examined.
+    double          AverageSearchLength;
+} GMM_HEAP_STATS;
+
+typedef struct GMM_HEAP_NODE_SLAB_REC GMM_HEAP_NODE_SLAB; // Chunk of heap nodes (GmmHeap.c).
+typedef struct GMM_HEAP_MAGAZINE_REC GMM_HEAP_MAGAZINE;  // Per-thread free block cache (GmmHeap.c).
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP_NODE_POOL
+//
+// Description:
+//     A heap's GMM_HEAPNODE allocator. Nodes are carved from slabs--large,
+//     cache-line-aligned chunks, growing geometrically--and recycled most
+//     recently freed first, so the nodes in use stay packed together. All
+//     slabs are released at once on heap reset.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_NODE_POOL_REC
+{
+    GMM_HEAPNODE        *pFreeNodes;    // Freed nodes, most recent first.
+    GMM_HEAP_NODE_SLAB  *pSlabs;        // Newest first.
+    uint32_t            NumSlabs;
+    uint32_t            NumNodes;       // In all slabs.
+    uint32_t            SlabNodes;      // Size of next slab.
+} GMM_HEAP_NODE_POOL;
+
+//===========================================================================
+// typedef:
+//        GMM_HEAP
+//
+// Description:
+//     User-mode VA heap: sub-allocates [BaseAddress, BaseAddress + Size).
+//     Thread-safe; Lock is only needed when a thread's magazine can't serve
+//     a request.
+//---------------------------------------------------------------------------
+typedef struct GMM_HEAP_REC
+{
+    GMM_GFX_ADDRESS     BaseAddress;
+    GMM_GFX_SIZE_T      Size;
+    GMM_GFX_SIZE_T      FreeSize;       // Excludes blocks held in magazines.
+    uint32_t            HeapType;       // GmmUmSetupHeap Flags.
+    uint32_t            NumContexts;
+    GMM_HEAPNODE        *pFreeHeap;     // Free list head sentinel.
+    GMM_HEAP_NODE_POOL  NodePool;
+    GMM_HEAP_TREE       FreeByAddr;
+    GMM_HEAP_TREE       FreeBySize;
+    GMM_HEAP_BUDDY      Buddy;          // GMM_BUDDY_HEAP's (instead of free list).
+    GMM_HEAP_STATS      Stats;          // Running counts (atomically updated; see GmmHeapGetStats).
+    pthread_mutex_t     Lock;           // Recursive, like the Windows CRITICAL_SECTION.
+
+    pthread_key_t       MagazineKey;    // Calling thread's GMM_HEAP_MAGAZINE.
+    int                 MagazineKeyValid;
+    GMM_HEAP_MAGAZINE   *pMagazines;    // All threads' magazines (under Lock).
+} GMM_HEAP;
+
+GMM_HEAP*       GMM_STDCALL GmmUmSetupHeap(GMM_ESCAPE_HANDLE hAdapter, GMM_ESCAPE_HANDLE hDevice, GMM_GFX_ADDRESS GfxAddress, GMM_GFX_SIZE_T Size, uint32_t Flags, GMM_ESCAPE_FUNC_TYPE pfnEscape);
+GMM_STATUS      GMM_STDCALL GmmUmDestroypHeap(GMM_ESCAPE_HANDLE hAdapter, GMM_ESCAPE_HANDLE hDevice, GMM_HEAP **pHeapObj, GMM_ESCAPE_FUNC_TYPE pfnEscape);
+GMM_GFX_ADDRESS GMM_STDCALL GmmAllocateHeapVA(GMM_HEAP *pHeapObj, GMM_GFX_SIZE_T AllocSize);
+GMM_STATUS      GMM_STDCALL GmmFreeHeapVA(GMM_HEAP *pHeapObj, GMM_GFX_ADDRESS AllocVA, GMM_GFX_SIZE_T AllocSize);
+GMM_STATUS      GMM_STDCALL GmmHeapGetStats(GMM_HEAP *pHeapObj, GMM_HEAP_STATS *pStats);
+
+// Process heap registry (on Windows, kept by the KMD via pfnEscape)...
+GMM_HEAP*       GmmGetSharedHeapObject(GMM_ESCAPE_HANDLE hAdapter, GMM_ESCAPE_HANDLE hDevice, GMM_ESCAPE_FUNC_TYPE pfnEscape);
+void            GmmSetSharedHeapObject(GMM_ESCAPE_HANDLE hAdapter, GMM_ESCAPE_HANDLE hDevice, GMM_HEAP *pHeapObj, GMM_ESCAPE_FUNC_TYPE pfnEscape);
+
+// GmmLib internal...
+GMM_STATUS      __GmmSetupHeap(struct GMM_CONTEXT_REC *pGmmContext, GMM_HEAP *pHeapObj, GMM_GFX_ADDRESS GfxAddress, GMM_GFX_SIZE_T Size, GMM_GFX_SIZE_T Pitch, uint32_t Flags);
+GMM_STATUS      __GmmInitHeap(struct GMM_CONTEXT_REC *pGmmContext, GMM_HEAP *pHeapObj);
+void            __GmmFreeHeapBlockGfxAddress(struct GMM_CONTEXT_REC *pGmmContext, GMM_HEAP *pHeapObj, GMM_GFX_ADDRESS GfxAddress, GMM_GFX_SIZE_T Size);
+BOOLEAN         __GmmAllocAlignHeapBlockGfxAddress(struct GMM_CONTEXT_REC *pGmmContext, GMM_HEAP *pHeapObj, GMM_GFX_SIZE_T Size, uint32_t AlignValue, GMM_GFX_ADDRESS *pGfxAddress);
+GMM_STATUS      __GmmUmInitHeapNodePool(GMM_HEAP_NODE_POOL *pNodePool, uint32_t NumNodes);
+void            __GmmUmDestroyHeapNodePool(GMM_HEAP_NODE_POOL *pNodePool);
+void            __GmmUmResetHeap(GMM_HEAP *pHeapObj);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
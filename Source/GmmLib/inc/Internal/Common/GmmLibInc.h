@@ -63,6 +63,8 @@ extern "C" {
 }
 #endif /*__cplusplus*/
 
+#include "Internal/Common/GmmWorkerPool.h"              // C++ (std::thread); outside extern "C"
+
 #ifndef DXGKDDI_INTERFACE_VERSION_WDDM1_3
 //WinBlue DDK definitions
 #define D3DKMT_CROSS_ADAPTER_RESOURCE_PITCH_ALIGNMENT   128
@@ -0,0 +1,88 @@
+/*==============================================================================
+Copyright(c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files(the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and / or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+============================================================================*/
+#pragma once
+
+#if(defined(__cplusplus) && !defined(__GMM_KMD__))
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace GmmLib
+{
+    /////////////////////////////////////////////////////////////////////////
+    /// Pool of worker threads used to split CPU-heavy GmmLib operations
+    /// (e.g. GmmResCpuBltParallel) across cores.
+    ///
+    /// Work is submitted as batches of independent, indexed tasks. The
+    /// submitting thread helps execute its own batch, so a pool without
+    /// threads (e.g. on a single-core system) degrades to serial execution
+    /// on the calling thread.
+    /////////////////////////////////////////////////////////////////////////
+    class NON_PAGED_SECTION WorkerPool : public GmmMemAllocator
+    {
+        private:
+            struct TASK_BATCH
+            {
+                PFN_GMM_WORKER_TASK     pfnTask;
+                void                    *pTaskContext;
+                uint32_t                NumTasks;
+                uint32_t                NextTask;       ///< Index of next task to hand out.
+                uint32_t                NumCompleted;   ///< Number of tasks that have returned.
+                bool                    Detached;       ///< Queued by Submit--no waiter, so freed by pool on completion.
+            };
+
+            std::mutex                  Lock;
+            std::condition_variable     WorkAvailable;  ///< Signaled when batch queued or pool exiting.
+            std::condition_variable     BatchCompleted; ///< Signaled when last task of a batch completes.
+            std::deque<TASK_BATCH *>    PendingBatches; ///< Batches with tasks not yet handed out.
+            std::vector<std::thread>    Threads;
+            bool                        Exiting;
+
+            void                        WorkerMain();
+            void                        RunNextTask(std::unique_lock<std::mutex> &Locked, TASK_BATCH *pBatch);
+
+        public:
+            WorkerPool(uint32_t NumThreads);
+            ~WorkerPool();
+
+            void GMM_STDCALL            RunTasks(uint32_t NumTasks, PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext);
+            void GMM_STDCALL            Submit(PFN_GMM_WORKER_TASK pfnTask, void *pTaskContext);
+
+            static uint32_t GMM_STDCALL GetDefaultNumThreads();
+
+            /////////////////////////////////////////////////////////////////////////
+            /// Returns the number of threads owned by the pool (not counting
+            /// threads calling RunTasks).
+            /////////////////////////////////////////////////////////////////////////
+            GMM_INLINE uint32_t GMM_STDCALL GetNumThreads()
+            {
+                return static_cast<uint32_t>(Threads.size());
+            }
+    };
+}
+
+#endif // #if(defined(__cplusplus) && !defined(__GMM_KMD__))